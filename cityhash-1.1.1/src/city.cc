@@ -31,6 +31,7 @@
 #include "city.h"
 
 #include <algorithm>
+#include <assert.h>
 #include <string.h>  // for memcpy and memset
 
 using namespace std;
@@ -392,6 +393,407 @@ uint64 CityHash64WithSeeds(const char *s, size_t len,
   return HashLen16(CityHash64(s, len) - seed0, seed1);
 }
 
+// CityHashCrc64() absorbs input words with the CRC32C instruction, which
+// takes a cycle per 8 bytes where CityHash64() needs several multiplies,
+// and only mixes at the end.  CPUs without SSE4.2 get the same results
+// from a table-driven CRC32C.
+
+// The 64-bit finalizer from Murmur3.  It is a bijection.
+static uint64 fmix64(uint64 h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// crc32c_tables[k][b] is the CRC32C of byte b followed by k zero bytes.
+// Filled in on the first use of SoftwareCrc32c.
+static uint32 crc32c_tables[8][256];
+
+static bool InitCrc32cTables() {
+  for (int b = 0; b < 256; b++) {
+    uint32 crc = b;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc >> 1) ^ (0x82f63b78 & (0 - (crc & 1)));
+    }
+    crc32c_tables[0][b] = crc;
+  }
+  for (int b = 0; b < 256; b++) {
+    for (int k = 1; k < 8; k++) {
+      uint32 crc = crc32c_tables[k - 1][b];
+      crc32c_tables[k][b] = (crc >> 8) ^ crc32c_tables[0][crc & 0xff];
+    }
+  }
+  return true;
+}
+
+// What _mm_crc32_u64(crc, v) computes, eight table lookups at a time.
+struct SoftwareCrc32c {
+  static uint64 Update(uint64 crc, uint64 v) {
+    uint64 x = (crc & 0xffffffff) ^ v;
+    return crc32c_tables[7][x & 0xff] ^
+        crc32c_tables[6][(x >> 8) & 0xff] ^
+        crc32c_tables[5][(x >> 16) & 0xff] ^
+        crc32c_tables[4][(x >> 24) & 0xff] ^
+        crc32c_tables[3][(x >> 32) & 0xff] ^
+        crc32c_tables[2][(x >> 40) & 0xff] ^
+        crc32c_tables[1][(x >> 48) & 0xff] ^
+        crc32c_tables[0][x >> 56];
+  }
+};
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define CITY_HARDWARE_CRC32C 1
+
+struct HardwareCrc32c {
+  static uint64 Update(uint64 crc, uint64 v) {
+    return _mm_crc32_u64(crc, v);
+  }
+};
+
+static inline bool HaveHardwareCrc32c() {
+  return true;
+}
+#elif defined(__GNUC__) && defined(__x86_64__)
+#define CITY_HARDWARE_CRC32C 1
+
+// Without -msse4.2 the intrinsic cannot be inlined into code that also
+// runs on older CPUs, so the instruction is emitted directly and only
+// executed once the CPU has been checked for it.
+struct HardwareCrc32c {
+  static uint64 Update(uint64 crc, uint64 v) {
+    __asm__("crc32q %1, %0" : "+r"(crc) : "rm"(v));
+    return crc;
+  }
+};
+
+static inline bool HaveHardwareCrc32c() {
+  return __builtin_cpu_supports("sse4.2");
+}
+#endif
+
+template <typename Crc32c>
+static inline uint64 HashCrc64(const char *s, size_t len) {
+  if (len <= 8) {
+    // w is distinct for distinct inputs of the same length, and so is
+    // the value passed to fmix64().
+    uint64 w;
+    if (len >= 4) {
+      w = Fetch32(s) | (static_cast<uint64>(Fetch32(s + len - 4)) << 32);
+    } else if (len > 0) {
+      w = static_cast<uint8>(s[0]) |
+          (static_cast<uint64>(static_cast<uint8>(s[len >> 1])) << 8) |
+          (static_cast<uint64>(static_cast<uint8>(s[len - 1])) << 16);
+    } else {
+      w = 0;
+    }
+    return fmix64((Crc32c::Update(k0 + len, w) << 32) | (w >> 32));
+  }
+  if (len <= 16) {
+    uint64 a = Fetch64(s);
+    uint64 b = Fetch64(s + len - 8);
+    uint64 x = Crc32c::Update(Crc32c::Update(len, a), b);
+    uint64 y = Crc32c::Update(Crc32c::Update(k2, b), a);
+    return fmix64((x << 32) | y);
+  }
+  // Four independent CRC lanes, one word each per 32 bytes, and then the
+  // last 32 bytes (or, for len < 32, two words from each end).
+  uint64 x = len, y = k0, z = k1, w = k2;
+  if (len > 32) {
+    const char *end = s + len - 32;
+    do {
+      x = Crc32c::Update(x, Fetch64(s));
+      y = Crc32c::Update(y, Fetch64(s + 8));
+      z = Crc32c::Update(z, Fetch64(s + 16));
+      w = Crc32c::Update(w, Fetch64(s + 24));
+      s += 32;
+    } while (s < end);
+    s = end;
+    len = 32;
+  }
+  x = Crc32c::Update(x, Fetch64(s + 8));
+  y = Crc32c::Update(y, Fetch64(s + len - 16));
+  z = Crc32c::Update(z, Fetch64(s + len - 8));
+  w = Crc32c::Update(w, Fetch64(s));
+  return HashLen16((x << 32) | y, (z << 32) | w);
+}
+
+// Kept out of line so that the hardware path in CityHashCrc64() needs no
+// more registers than it uses itself.
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+static uint64 SoftwareHashCrc64(const char *s, size_t len) {
+  static const bool tables_ready = InitCrc32cTables();
+  (void) tables_ready;
+  return HashCrc64<SoftwareCrc32c>(s, len);
+}
+
+#if defined(CITY_HARDWARE_CRC32C) && !defined(__SSE4_2__) && defined(__ELF__)
+// Without -msse4.2 the CPU is checked once, when the library is loaded,
+// and calls go straight to the chosen implementation.  Checking it on
+// every call made 12- to 32-byte keys about a quarter slower, which was
+// enough to lose to CityHash64() there.
+static uint64 HardwareHashCrc64(const char *s, size_t len) {
+  return HashCrc64<HardwareCrc32c>(s, len);
+}
+
+extern "C" {
+static uint64 (*ResolveCityHashCrc64())(const char *, size_t) {
+  __builtin_cpu_init();  // Resolvers run before constructors.
+  return HaveHardwareCrc32c() ? HardwareHashCrc64 : SoftwareHashCrc64;
+}
+}
+
+uint64 CityHashCrc64(const char *s, size_t len)
+    __attribute__((ifunc("ResolveCityHashCrc64")));
+#else
+uint64 CityHashCrc64(const char *s, size_t len) {
+#ifdef CITY_HARDWARE_CRC32C
+  if (LIKELY(HaveHardwareCrc32c())) {
+    return HashCrc64<HardwareCrc32c>(s, len);
+  }
+#endif
+  return SoftwareHashCrc64(s, len);
+}
+#endif
+
+// CityHash64Batch() hashes keys in groups of SIMD lanes when the CPU has
+// AVX-512 (eight lanes) or AVX2 (four lanes).  A group whose keys are all
+// 4..7, all 8..16 or all 17..32 bytes long is hashed in one pass over the
+// lanes, each lane computing exactly what HashLen0to16() or HashLen17to32()
+// would; any other group, and the tail, goes through CityHash64() one key at
+// a time.  AVX2 has no 64-bit multiply, so it only pays off for 4..16 bytes.
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+
+#define CITY_TARGET_AVX2 __attribute__((target("avx2")))
+#define CITY_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512dq")))
+
+CITY_TARGET_AVX2 static inline __m256i Mul(__m256i a, __m256i b) {
+  // The low 64 bits of a * b, from three 32x32->64 multiplies.
+  __m256i lo = _mm256_mul_epu32(a, b);
+  __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                   _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+  return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+}
+
+CITY_TARGET_AVX2 static inline __m256i Rotate(__m256i val, int shift) {
+  return _mm256_or_si256(_mm256_srli_epi64(val, shift),
+                         _mm256_slli_epi64(val, 64 - shift));
+}
+
+CITY_TARGET_AVX2 static inline __m256i ShiftMix(__m256i val) {
+  return _mm256_xor_si256(val, _mm256_srli_epi64(val, 47));
+}
+
+CITY_TARGET_AVX2 static inline __m256i HashLen16(__m256i u, __m256i v,
+                                                __m256i mul) {
+  __m256i a = ShiftMix(Mul(_mm256_xor_si256(u, v), mul));
+  __m256i b = ShiftMix(Mul(_mm256_xor_si256(v, a), mul));
+  return Mul(b, mul);
+}
+
+CITY_TARGET_AVX512 static inline __m512i Mul(__m512i a, __m512i b) {
+  return _mm512_mullo_epi64(a, b);
+}
+
+// The shifts are the zero-masked forms with every lane selected.  The
+// unmasked ones merge into _mm512_undefined_epi32(), which GCC 12
+// reports as maybe uninitialized once they are inlined.
+CITY_TARGET_AVX512 static inline __m512i ShiftRight(__m512i val, int shift) {
+  return _mm512_maskz_srli_epi64(0xff, val, shift);
+}
+
+CITY_TARGET_AVX512 static inline __m512i ShiftLeft(__m512i val, int shift) {
+  return _mm512_maskz_slli_epi64(0xff, val, shift);
+}
+
+CITY_TARGET_AVX512 static inline __m512i Rotate(__m512i val, int shift) {
+  return _mm512_or_si512(ShiftRight(val, shift), ShiftLeft(val, 64 - shift));
+}
+
+CITY_TARGET_AVX512 static inline __m512i ShiftMix(__m512i val) {
+  return _mm512_xor_si512(val, ShiftRight(val, 47));
+}
+
+CITY_TARGET_AVX512 static inline __m512i HashLen16(__m512i u, __m512i v,
+                                                  __m512i mul) {
+  __m512i a = ShiftMix(Mul(_mm512_xor_si512(u, v), mul));
+  __m512i b = ShiftMix(Mul(_mm512_xor_si512(v, a), mul));
+  return Mul(b, mul);
+}
+
+// Lane i hashes keys[i], whose length is lane i of len.
+#define LANES4(f) _mm256_set_epi64x(f(3), f(2), f(1), f(0))
+#define LANES8(f) _mm512_set_epi64(f(7), f(6), f(5), f(4), \
+                                   f(3), f(2), f(1), f(0))
+#define WORD0(i) Fetch32(keys[i])
+#define WORD4(i) Fetch32(keys[i] + lens[i] - 4)
+#define HEAD0(i) Fetch64(keys[i])
+#define HEAD8(i) Fetch64(keys[i] + 8)
+#define TAIL8(i) Fetch64(keys[i] + lens[i] - 8)
+#define TAIL16(i) Fetch64(keys[i] + lens[i] - 16)
+
+CITY_TARGET_AVX2 static inline __m256i HashLen4to7x4(
+    const char *const *keys, const size_t *lens, __m256i len) {
+  __m256i mul = _mm256_add_epi64(_mm256_set1_epi64x(k2),
+                                 _mm256_add_epi64(len, len));
+  __m256i a = _mm256_slli_epi64(LANES4(WORD0), 3);
+  return HashLen16(_mm256_add_epi64(len, a), LANES4(WORD4), mul);
+}
+
+CITY_TARGET_AVX2 static inline __m256i HashLen8to16x4(
+    const char *const *keys, const size_t *lens, __m256i len) {
+  __m256i mul = _mm256_add_epi64(_mm256_set1_epi64x(k2),
+                                 _mm256_add_epi64(len, len));
+  __m256i a = _mm256_add_epi64(LANES4(HEAD0), _mm256_set1_epi64x(k2));
+  __m256i b = LANES4(TAIL8);
+  __m256i c = _mm256_add_epi64(Mul(Rotate(b, 37), mul), a);
+  __m256i d = Mul(_mm256_add_epi64(Rotate(a, 25), b), mul);
+  return HashLen16(c, d, mul);
+}
+
+CITY_TARGET_AVX512 static inline __m512i HashLen4to7x8(
+    const char *const *keys, const size_t *lens, __m512i len) {
+  __m512i mul = _mm512_add_epi64(_mm512_set1_epi64(k2),
+                                 _mm512_add_epi64(len, len));
+  __m512i a = ShiftLeft(LANES8(WORD0), 3);
+  return HashLen16(_mm512_add_epi64(len, a), LANES8(WORD4), mul);
+}
+
+CITY_TARGET_AVX512 static inline __m512i HashLen8to16x8(
+    const char *const *keys, const size_t *lens, __m512i len) {
+  __m512i mul = _mm512_add_epi64(_mm512_set1_epi64(k2),
+                                 _mm512_add_epi64(len, len));
+  __m512i a = _mm512_add_epi64(LANES8(HEAD0), _mm512_set1_epi64(k2));
+  __m512i b = LANES8(TAIL8);
+  __m512i c = _mm512_add_epi64(Mul(Rotate(b, 37), mul), a);
+  __m512i d = Mul(_mm512_add_epi64(Rotate(a, 25), b), mul);
+  return HashLen16(c, d, mul);
+}
+
+CITY_TARGET_AVX512 static inline __m512i HashLen17to32x8(
+    const char *const *keys, const size_t *lens, __m512i len) {
+  __m512i mul = _mm512_add_epi64(_mm512_set1_epi64(k2),
+                                 _mm512_add_epi64(len, len));
+  __m512i a = Mul(LANES8(HEAD0), _mm512_set1_epi64(k1));
+  __m512i b = LANES8(HEAD8);
+  __m512i c = Mul(LANES8(TAIL8), mul);
+  __m512i d = Mul(LANES8(TAIL16), _mm512_set1_epi64(k2));
+  __m512i u = _mm512_add_epi64(
+      _mm512_add_epi64(Rotate(_mm512_add_epi64(a, b), 43), Rotate(c, 30)), d);
+  __m512i v = _mm512_add_epi64(
+      _mm512_add_epi64(a, Rotate(_mm512_add_epi64(b, _mm512_set1_epi64(k2)),
+                                 18)), c);
+  return HashLen16(u, v, mul);
+}
+
+#undef LANES4
+#undef LANES8
+#undef WORD0
+#undef WORD4
+#undef HEAD0
+#undef HEAD8
+#undef TAIL8
+#undef TAIL16
+
+static void HashBatchScalar(const char *const *keys, const size_t *lens,
+                            size_t n, uint64 *out) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = CityHash64(keys[i], lens[i]);
+  }
+}
+
+// The length checks compare signed 64-bit lanes, which is exact for any
+// length an object can have.
+CITY_TARGET_AVX2 static bool AllInRange(__m256i len, long long lo, long long hi) {
+  __m256i ok = _mm256_and_si256(
+      _mm256_cmpgt_epi64(len, _mm256_set1_epi64x(lo - 1)),
+      _mm256_cmpgt_epi64(_mm256_set1_epi64x(hi + 1), len));
+  return _mm256_movemask_pd(_mm256_castsi256_pd(ok)) == 0xf;
+}
+
+CITY_TARGET_AVX2 static void HashBatchAvx2(const char *const *keys,
+                                           const size_t *lens, size_t n,
+                                           uint64 *out) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i len =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lens + i));
+    __m256i *dst = reinterpret_cast<__m256i *>(out + i);
+    if (AllInRange(len, 4, 7)) {
+      _mm256_storeu_si256(dst, HashLen4to7x4(keys + i, lens + i, len));
+    } else if (AllInRange(len, 8, 16)) {
+      _mm256_storeu_si256(dst, HashLen8to16x4(keys + i, lens + i, len));
+    } else {
+      HashBatchScalar(keys + i, lens + i, 4, out + i);
+    }
+  }
+  HashBatchScalar(keys + i, lens + i, n - i, out + i);
+}
+
+CITY_TARGET_AVX512 static bool AllInRange(__m512i len, long long lo, long long hi) {
+  return (_mm512_cmpge_epi64_mask(len, _mm512_set1_epi64(lo)) &
+          _mm512_cmple_epi64_mask(len, _mm512_set1_epi64(hi))) == 0xff;
+}
+
+CITY_TARGET_AVX512 static void HashBatchAvx512(const char *const *keys,
+                                               const size_t *lens, size_t n,
+                                               uint64 *out) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m512i len = _mm512_loadu_si512(lens + i);
+    if (AllInRange(len, 4, 7)) {
+      _mm512_storeu_si512(out + i, HashLen4to7x8(keys + i, lens + i, len));
+    } else if (AllInRange(len, 8, 16)) {
+      _mm512_storeu_si512(out + i, HashLen8to16x8(keys + i, lens + i, len));
+    } else if (AllInRange(len, 17, 32)) {
+      _mm512_storeu_si512(out + i, HashLen17to32x8(keys + i, lens + i, len));
+    } else {
+      HashBatchScalar(keys + i, lens + i, 8, out + i);
+    }
+  }
+  HashBatchScalar(keys + i, lens + i, n - i, out + i);
+}
+
+typedef void (*HashBatchFn)(const char *const *keys, const size_t *lens,
+                            size_t n, uint64 *out);
+
+static HashBatchFn SelectHashBatch() {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+    return HashBatchAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return HashBatchAvx2;
+  }
+  return HashBatchScalar;
+}
+
+void CityHash64Batch(const char *const *keys, const size_t *lens, size_t n,
+                     uint64 *out) {
+  // Selected on first use rather than at static initialization, so that
+  // CityHash64Batch() also works when called from another file's static
+  // initializer.
+  static const HashBatchFn hash_batch = SelectHashBatch();
+  hash_batch(keys, lens, n, out);
+}
+
+#else  // !(defined(__GNUC__) && defined(__x86_64__))
+
+void CityHash64Batch(const char *const *keys, const size_t *lens, size_t n,
+                     uint64 *out) {
+  for (size_t i = 0; i < n; i++) {
+    out[i] = CityHash64(keys[i], lens[i]);
+  }
+}
+
+#endif
+
 // A subroutine for CityHash128().  Returns a decent 128-bit hash for strings
 // of any length representable in signed long.  Based on City and Murmur.
 static uint128 CityMurmur(const char *s, size_t len, uint128 seed) {
@@ -424,44 +826,65 @@ static uint128 CityMurmur(const char *s, size_t len, uint128 seed) {
   return uint128(a ^ b, HashLen16(b, a));
 }
 
-uint128 CityHash128WithSeed(const char *s, size_t len, uint128 seed) {
-  if (len < 128) {
-    return CityMurmur(s, len, seed);
-  }
+// The state of CityHash128WithSeed() between 128-byte blocks of a long
+// input.  Keep 56 bytes of state: v, w, x, y, and z.
+struct City128State {
+  uint64 v0, v1, w0, w1, x, y, z;
+};
 
-  // We expect len >= 128 to be the common case.  Keep 56 bytes of state:
-  // v, w, x, y, and z.
-  pair<uint64, uint64> v, w;
+// Starts hashing len >= 128 bytes, the first 128 of which are at s.
+static inline void City128Init(const char *s, size_t len, uint128 seed,
+                               City128State *st) {
   uint64 x = Uint128Low64(seed);
   uint64 y = Uint128High64(seed);
   uint64 z = len * k1;
-  v.first = Rotate(y ^ k1, 49) * k1 + Fetch64(s);
-  v.second = Rotate(v.first, 42) * k1 + Fetch64(s + 8);
-  w.first = Rotate(y + z, 35) * k1 + x;
-  w.second = Rotate(x + Fetch64(s + 88), 53) * k1;
+  st->v0 = Rotate(y ^ k1, 49) * k1 + Fetch64(s);
+  st->v1 = Rotate(st->v0, 42) * k1 + Fetch64(s + 8);
+  st->w0 = Rotate(y + z, 35) * k1 + x;
+  st->w1 = Rotate(x + Fetch64(s + 88), 53) * k1;
+  st->x = x;
+  st->y = y;
+  st->z = z;
+}
 
+// Hashes the 128 bytes at s.
+static inline void City128Block(const char *s, City128State *st) {
+  pair<uint64, uint64> v(st->v0, st->v1), w(st->w0, st->w1);
+  uint64 x = st->x, y = st->y, z = st->z;
   // This is the same inner loop as CityHash64(), manually unrolled.
-  do {
-    x = Rotate(x + y + v.first + Fetch64(s + 8), 37) * k1;
-    y = Rotate(y + v.second + Fetch64(s + 48), 42) * k1;
-    x ^= w.second;
-    y += v.first + Fetch64(s + 40);
-    z = Rotate(z + w.first, 33) * k1;
-    v = WeakHashLen32WithSeeds(s, v.second * k1, x + w.first);
-    w = WeakHashLen32WithSeeds(s + 32, z + w.second, y + Fetch64(s + 16));
-    std::swap(z, x);
-    s += 64;
-    x = Rotate(x + y + v.first + Fetch64(s + 8), 37) * k1;
-    y = Rotate(y + v.second + Fetch64(s + 48), 42) * k1;
-    x ^= w.second;
-    y += v.first + Fetch64(s + 40);
-    z = Rotate(z + w.first, 33) * k1;
-    v = WeakHashLen32WithSeeds(s, v.second * k1, x + w.first);
-    w = WeakHashLen32WithSeeds(s + 32, z + w.second, y + Fetch64(s + 16));
-    std::swap(z, x);
-    s += 64;
-    len -= 128;
-  } while (LIKELY(len >= 128));
+  x = Rotate(x + y + v.first + Fetch64(s + 8), 37) * k1;
+  y = Rotate(y + v.second + Fetch64(s + 48), 42) * k1;
+  x ^= w.second;
+  y += v.first + Fetch64(s + 40);
+  z = Rotate(z + w.first, 33) * k1;
+  v = WeakHashLen32WithSeeds(s, v.second * k1, x + w.first);
+  w = WeakHashLen32WithSeeds(s + 32, z + w.second, y + Fetch64(s + 16));
+  std::swap(z, x);
+  s += 64;
+  x = Rotate(x + y + v.first + Fetch64(s + 8), 37) * k1;
+  y = Rotate(y + v.second + Fetch64(s + 48), 42) * k1;
+  x ^= w.second;
+  y += v.first + Fetch64(s + 40);
+  z = Rotate(z + w.first, 33) * k1;
+  v = WeakHashLen32WithSeeds(s, v.second * k1, x + w.first);
+  w = WeakHashLen32WithSeeds(s + 32, z + w.second, y + Fetch64(s + 16));
+  std::swap(z, x);
+  st->v0 = v.first;
+  st->v1 = v.second;
+  st->w0 = w.first;
+  st->w1 = w.second;
+  st->x = x;
+  st->y = y;
+  st->z = z;
+}
+
+// Hashes the last len < 128 bytes, which are at s, and returns the result.
+// Reads the 128 bytes that end at s + len, some of which may already have
+// been passed to City128Block().
+static inline uint128 City128Finish(const char *s, size_t len,
+                                    const City128State *st) {
+  pair<uint64, uint64> v(st->v0, st->v1), w(st->w0, st->w1);
+  uint64 x = st->x, y = st->y, z = st->z;
   x += Rotate(v.first + z, 49) * k0;
   y = y * k0 + Rotate(w.second, 37);
   z = z * k0 + Rotate(w.first, 27);
@@ -487,6 +910,22 @@ uint128 CityHash128WithSeed(const char *s, size_t len, uint128 seed) {
                  HashLen16(x + w.second, y + v.second));
 }
 
+uint128 CityHash128WithSeed(const char *s, size_t len, uint128 seed) {
+  if (len < 128) {
+    return CityMurmur(s, len, seed);
+  }
+
+  // We expect len >= 128 to be the common case.
+  City128State st;
+  City128Init(s, len, seed, &st);
+  do {
+    City128Block(s, &st);
+    s += 128;
+    len -= 128;
+  } while (LIKELY(len >= 128));
+  return City128Finish(s, len, &st);
+}
+
 uint128 CityHash128(const char *s, size_t len) {
   return len >= 16 ?
       CityHash128WithSeed(s + 16, len - 16,
@@ -498,25 +937,28 @@ uint128 CityHash128(const char *s, size_t len) {
 #include "citycrc.h"
 #include <nmmintrin.h>
 
-// Requires len >= 240.
-static void CityHashCrc256Long(const char *s, size_t len,
-                               uint32 seed, uint64 *result) {
-  uint64 a = Fetch64(s + 56) + k0;
-  uint64 b = Fetch64(s + 96) + k0;
-  uint64 c = result[0] = HashLen16(b, len);
-  uint64 d = result[1] = Fetch64(s + 120) * k0 + len;
-  uint64 e = Fetch64(s + 184) + seed;
-  uint64 f = 0;
-  uint64 g = 0;
-  uint64 h = c + d;
-  uint64 x = seed;
-  uint64 y = 0;
-  uint64 z = 0;
+// The state of CityHashCrc256Long() between 240-byte blocks.
+struct Crc256State {
+  uint64 a, b, c, d, e, f, g, h, x, y, z;
+  uint64 result[2];
+};
+
+// Starts hashing len >= 240 bytes, the first 240 of which are at s.
+static inline void Crc256Init(const char *s, size_t len, uint32 seed,
+                              Crc256State *st) {
+  st->a = Fetch64(s + 56) + k0;
+  st->b = Fetch64(s + 96) + k0;
+  st->c = st->result[0] = HashLen16(st->b, len);
+  st->d = st->result[1] = Fetch64(s + 120) * k0 + len;
+  st->e = Fetch64(s + 184) + seed;
+  st->f = 0;
+  st->g = 0;
+  st->h = st->c + st->d;
+  st->x = seed;
+  st->y = 0;
+  st->z = 0;
+}
 
-  // 240 bytes of input per iter.
-  size_t iters = len / 240;
-  len -= iters * 240;
-  do {
 #undef CHUNK
 #define CHUNK(r)                                \
     PERMUTE3(x, z, y);                          \
@@ -539,14 +981,28 @@ static void CityHashCrc256Long(const char *s, size_t len,
     c += e;                                     \
     s += 40
 
-    CHUNK(0); PERMUTE3(a, h, c);
-    CHUNK(33); PERMUTE3(a, h, f);
-    CHUNK(0); PERMUTE3(b, h, f);
-    CHUNK(42); PERMUTE3(b, h, d);
-    CHUNK(0); PERMUTE3(b, h, e);
-    CHUNK(33); PERMUTE3(a, h, e);
-  } while (--iters > 0);
+// Hashes the 240 bytes at s.
+static inline void Crc256Block(const char *s, Crc256State *st) {
+  uint64 a = st->a, b = st->b, c = st->c, d = st->d, e = st->e, f = st->f;
+  uint64 g = st->g, h = st->h, x = st->x, y = st->y, z = st->z;
+  CHUNK(0); PERMUTE3(a, h, c);
+  CHUNK(33); PERMUTE3(a, h, f);
+  CHUNK(0); PERMUTE3(b, h, f);
+  CHUNK(42); PERMUTE3(b, h, d);
+  CHUNK(0); PERMUTE3(b, h, e);
+  CHUNK(33); PERMUTE3(a, h, e);
+  st->a = a; st->b = b; st->c = c; st->d = d; st->e = e; st->f = f;
+  st->g = g; st->h = h; st->x = x; st->y = y; st->z = z;
+}
 
+// Hashes the last len < 240 bytes, which are at s, and sets result[0] ...
+// result[3].  Reads the 40 bytes that end at s + len even if len < 40.
+static inline void Crc256Finish(const char *s, size_t len,
+                                const Crc256State *st, uint64 *result) {
+  uint64 a = st->a, b = st->b, c = st->c, d = st->d, e = st->e, f = st->f;
+  uint64 g = st->g, h = st->h, x = st->x, y = st->y, z = st->z;
+  result[0] = st->result[0];
+  result[1] = st->result[1];
   while (len >= 40) {
     CHUNK(29);
     e ^= Rotate(a, 20);
@@ -586,6 +1042,22 @@ static void CityHashCrc256Long(const char *s, size_t len,
   result[3] = a + result[2];
 }
 
+// Requires len >= 240.
+static void CityHashCrc256Long(const char *s, size_t len,
+                               uint32 seed, uint64 *result) {
+  Crc256State st;
+  Crc256Init(s, len, seed, &st);
+
+  // 240 bytes of input per iter.
+  size_t iters = len / 240;
+  len -= iters * 240;
+  do {
+    Crc256Block(s, &st);
+    s += 240;
+  } while (--iters > 0);
+  Crc256Finish(s, len, &st, result);
+}
+
 // Requires len < 240.
 static void CityHashCrc256Short(const char *s, size_t len, uint64 *result) {
   char buf[240];
@@ -626,3 +1098,134 @@ uint128 CityHashCrc128(const char *s, size_t len) {
 }
 
 #endif
+
+// CityHasher cuts the input where the one-shot functions do: for
+// CityHash128(), a 16-byte seed, 128-byte blocks and a tail of less than
+// 128 bytes; for CityHashCrc128(), 240-byte blocks and a tail.  Hashing the
+// tail reads back into the last block, so that block is kept in
+// buf_[0, block_size_) and the tail is collected right after it.  Inputs
+// that the one-shot functions hash without blocks are buffered whole.
+
+CityHasher::CityHasher(size_t len) {
+  Init(len, false);
+}
+
+CityHasher::CityHasher(size_t len, bool crc) {
+  Init(len, crc);
+}
+
+void CityHasher::Init(size_t len, bool crc) {
+  len_ = len;
+  done_ = 0;
+  blocks_done_ = 0;
+  crc_ = false;
+  seed_ = uint128(k0, k1);
+#ifdef __SSE4_2__
+  if (crc && len > 900) {
+    crc_ = true;
+    prefix_ = 0;
+    block_size_ = 240;
+    blocks_ = len / 240;
+    return;
+  }
+#else
+  (void)crc;  // CityHashCrc128() is only built with SSE4.2.
+#endif
+  if (len >= 16 + 128) {
+    prefix_ = 16;
+    block_size_ = 128;
+    blocks_ = (len - 16) / 128;
+  } else {
+    prefix_ = 0;
+    block_size_ = 0;
+    blocks_ = 0;
+  }
+}
+
+void CityHasher::Update(const char *s, size_t n) {
+  assert(n <= len_ - done_);
+  n = std::min(n, len_ - done_);
+  if (block_size_ == 0) {
+    memcpy(buf_ + done_, s, n);
+    done_ += n;
+    return;
+  }
+  const size_t b = block_size_;
+  while (n > 0) {
+    size_t take;
+    if (done_ < prefix_) {
+      take = std::min(n, prefix_ - done_);
+      memcpy(buf_ + done_, s, take);
+      if (done_ + take == prefix_) {
+        seed_ = uint128(Fetch64(buf_), Fetch64(buf_ + 8) + k0);
+      }
+    } else if (blocks_done_ < blocks_) {
+      const size_t pending = (done_ - prefix_) % b;
+      if (pending == 0 && n >= b) {
+        // Whole blocks are hashed straight from the caller's buffer.
+        take = b;
+        HashBlock(s);
+      } else {
+        take = std::min(n, b - pending);
+        memcpy(buf_ + b + pending, s, take);
+        if (pending + take == b) {
+          HashBlock(buf_ + b);
+        }
+      }
+    } else {
+      take = n;
+      memcpy(buf_ + b + (done_ - prefix_ - blocks_ * b), s, take);
+    }
+    s += take;
+    n -= take;
+    done_ += take;
+  }
+}
+
+void CityHasher::HashBlock(const char *s) {
+#ifdef __SSE4_2__
+  if (crc_) {
+    Crc256State st;
+    if (blocks_done_ == 0) {
+      Crc256Init(s, len_, 0, &st);
+    } else {
+      memcpy(&st, state_, sizeof(st));
+    }
+    Crc256Block(s, &st);
+    memcpy(state_, &st, sizeof(st));
+  } else
+#endif
+  {
+    City128State st;
+    if (blocks_done_ == 0) {
+      City128Init(s, len_ - prefix_, seed_, &st);
+    } else {
+      memcpy(&st, state_, sizeof(st));
+    }
+    City128Block(s, &st);
+    memcpy(state_, &st, sizeof(st));
+  }
+  if (++blocks_done_ == blocks_ && s != buf_) {
+    memcpy(buf_, s, block_size_);
+  }
+}
+
+uint128 CityHasher::Finalize() {
+  if (block_size_ == 0) {
+    return CityHash128(buf_, len_);
+  }
+  const char *tail = buf_ + block_size_;
+  const size_t tail_len = len_ - prefix_ - blocks_ * block_size_;
+#ifdef __SSE4_2__
+  if (crc_) {
+    Crc256State st;
+    memcpy(&st, state_, sizeof(st));
+    uint64 result[4];
+    Crc256Finish(tail, tail_len, &st, result);
+    return uint128(result[2], result[3]);
+  }
+#endif
+  City128State st;
+  memcpy(&st, state_, sizeof(st));
+  return City128Finish(tail, tail_len, &st);
+}
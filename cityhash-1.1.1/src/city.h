@@ -86,6 +86,37 @@ uint64 CityHash64WithSeed(const char *buf, size_t len, uint64 seed);
 uint64 CityHash64WithSeeds(const char *buf, size_t len,
                            uint64 seed0, uint64 seed1);
 
+// Hash function for a byte array, built on the CRC32C instruction of
+// SSE4.2 when the CPU has it and on an equivalent table lookup otherwise;
+// the results are the same either way.  Meant for hash tables.  Distinct
+// inputs of the same length up to 8 bytes never collide.
+//
+// On x86-64 CPUs with SSE4.2 it hashes keys of a given length about 1.1x
+// to 1.4x as fast as CityHash64() up to 32 bytes, and 1.4x to 2.5x as fast
+// beyond that.  When the length changes unpredictably from one key to the
+// next, mispredicted branches dominate and the two are about even.  The
+// table lookup is 2x to 3x slower than CityHash64(), so on other CPUs
+// prefer CityHash64().
+uint64 CityHashCrc64(const char *buf, size_t len);
+
+// Hash functor over CityHashCrc64() for hash containers, such as
+// sparsehash's dense_hash_map<std::string, V, CityHashCrc64Hasher>.  Keys
+// may be of any type with data() and size(), e.g. std::string, StringPiece
+// or leveldb::Slice.
+struct CityHashCrc64Hasher {
+  template <typename String>
+  size_t operator()(const String& s) const {
+    return static_cast<size_t>(CityHashCrc64(s.data(), s.size()));
+  }
+};
+
+// Hashes n byte arrays at once, setting out[i] to
+// CityHash64(keys[i], lens[i]).  On x86-64 CPUs with AVX2 or AVX-512, runs
+// of keys of 4 to 32 bytes are hashed several at a time in SIMD lanes,
+// which is faster than a loop over CityHash64() for such keys.
+void CityHash64Batch(const char *const *keys, const size_t *lens, size_t n,
+                     uint64 *out);
+
 // Hash function for a byte array.
 uint128 CityHash128(const char *s, size_t len);
 
@@ -93,6 +124,50 @@ uint128 CityHash128(const char *s, size_t len);
 // hashed into the result.
 uint128 CityHash128WithSeed(const char *s, size_t len, uint128 seed);
 
+// Computes CityHash128() of a byte array that arrives in pieces, such as
+// the chunks of a stream, without concatenating them first.  The state is
+// a fixed few hundred bytes whatever the input size.  CityHash128() mixes
+// the length of the input in before its first byte, so the total length
+// must be known up front:
+//
+//   CityHasher hasher(total_len);
+//   while (...) hasher.Update(piece, piece_len);
+//   uint128 hash = hasher.Finalize();
+class CityHasher {
+ public:
+  // len is the number of bytes that will be passed to Update() in total.
+  explicit CityHasher(size_t len);
+
+  // Hashes the next n bytes of the input.  Pieces may have any size, but
+  // together they must not exceed the len given to the constructor.
+  // Debug builds assert this; with NDEBUG the excess bytes are dropped,
+  // and the hash is that of the first len bytes.
+  void Update(const char *s, size_t n);
+
+  // Returns the hash of the whole input.  Requires that all len bytes have
+  // been passed to Update().
+  uint128 Finalize();
+
+ protected:
+  // crc selects CityHashCrc128() instead; see CityHasherCrc in citycrc.h.
+  CityHasher(size_t len, bool crc);
+
+ private:
+  void Init(size_t len, bool crc);
+  void HashBlock(const char *s);
+
+  size_t len_;         // Total length of the input.
+  size_t done_;        // Bytes passed to Update() so far.
+  size_t prefix_;      // Leading bytes that seed the block hash.
+  size_t block_size_;  // 128, 240, or 0 if the input is buffered whole.
+  size_t blocks_;      // Blocks in the input, all but the tail.
+  size_t blocks_done_;
+  bool crc_;
+  uint128 seed_;
+  uint64 state_[13];   // City128State or Crc256State in city.cc.
+  char buf_[480];      // Pending block, and the last block for the tail.
+};
+
 // Hash function for a byte array.  Most useful in 32-bit binaries.
 uint32 CityHash32(const char *buf, size_t len);
 
@@ -40,4 +40,11 @@ uint128 CityHashCrc128WithSeed(const char *s, size_t len, uint128 seed);
 // Hash function for a byte array.  Sets result[0] ... result[3].
 void CityHashCrc256(const char *s, size_t len, uint64 *result);
 
+// Computes CityHashCrc128() of a byte array that arrives in pieces; see
+// CityHasher in city.h.
+class CityHasherCrc : public CityHasher {
+ public:
+  explicit CityHasherCrc(size_t len) : CityHasher(len, true) {}
+};
+
 #endif  // CITY_HASH_CRC_H_
@@ -63,6 +63,21 @@ lzo1x_decompress_safe   ( const lzo_bytep src, lzo_uint  src_len,
                                 lzo_bytep dst, lzo_uintp dst_len,
                                 lzo_voidp wrkmem /* NOT USED */ );
 
+/* decompression using unaligned 64-bit wild copies, selected at runtime
+ * when the CPU supports them and falling back to lzo1x_decompress and
+ * lzo1x_decompress_safe otherwise. Unlike lzo1x_decompress, *dst_len
+ * must hold the size of dst on entry for both variants; no byte outside
+ * of dst is ever written. The results equal the portable versions. */
+LZO_EXTERN(int)
+lzo1x_decompress_wild   ( const lzo_bytep src, lzo_uint  src_len,
+                                lzo_bytep dst, lzo_uintp dst_len,
+                                lzo_voidp wrkmem /* NOT USED */ );
+
+LZO_EXTERN(int)
+lzo1x_decompress_wild_safe ( const lzo_bytep src, lzo_uint  src_len,
+                                   lzo_bytep dst, lzo_uintp dst_len,
+                                   lzo_voidp wrkmem /* NOT USED */ );
+
 
 /***********************************************************************
 //
@@ -0,0 +1,115 @@
+/* lzo1x_dw.c -- LZO1X decompression with runtime-selected wild copies
+
+   This file is part of the LZO real-time data compression library.
+
+   Copyright (C) 1996-2014 Markus Franz Xaver Johannes Oberhumer
+   All Rights Reserved.
+
+   The LZO library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of
+   the License, or (at your option) any later version.
+
+   The LZO library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the LZO library; see the file COPYING.
+   If not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+   Markus F.X.J. Oberhumer
+   <markus@oberhumer.com>
+   http://www.oberhumer.com/opensource/lzo/
+ */
+
+
+#include "config1x.h"
+
+#if (LZO_ARCH_AMD64 || LZO_ARCH_I386) && defined(__GNUC__)
+#include <cpuid.h>
+#endif
+
+
+/***********************************************************************
+// the two kernels, built from lzo1x_dw.ch
+************************************************************************/
+
+#undef LZO_TEST_OVERRUN
+#define DO_DECOMPRESS       lzo1x_decompress_wild_kernel
+#include "lzo1x_dw.ch"
+#undef DO_DECOMPRESS
+
+#define LZO_TEST_OVERRUN 1
+#define DO_DECOMPRESS       lzo1x_decompress_wild_safe_kernel
+#include "lzo1x_dw.ch"
+#undef DO_DECOMPRESS
+
+
+/***********************************************************************
+// runtime selection
+//
+// The kernels are correct everywhere, but they only pay off when an
+// unaligned 8-byte word can be moved with a single load and store.
+// Whether that holds is probed once on the first call; the result is
+// a plain int so a racing first call merely repeats the probe.
+************************************************************************/
+
+static int lzo1x_wild_state = -1;
+
+static int lzo1x_wild_probe(void)
+{
+#if !(LZO_OPT_UNALIGNED32)
+    return 0;
+#elif (LZO_ARCH_AMD64 || LZO_ARCH_I386) && defined(__GNUC__)
+    /* SSE2 guarantees a single 64-bit unaligned move on x86 */
+    unsigned a = 0, b = 0, c = 0, d = 0;
+    if (!__get_cpuid(1, &a, &b, &c, &d))
+        return 0;
+    return (d & bit_SSE2) != 0;
+#elif (LZO_OPT_UNALIGNED64)
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+static __lzo_inline int lzo1x_wild_enabled(void)
+{
+    int s = lzo1x_wild_state;
+    if __lzo_unlikely(s < 0)
+        lzo1x_wild_state = s = lzo1x_wild_probe();
+    return s;
+}
+
+
+/***********************************************************************
+// public entry points
+************************************************************************/
+
+LZO_PUBLIC(int)
+lzo1x_decompress_wild   ( const lzo_bytep in , lzo_uint  in_len,
+                                lzo_bytep out, lzo_uintp out_len,
+                                lzo_voidp wrkmem )
+{
+    if (lzo1x_wild_enabled())
+        return lzo1x_decompress_wild_kernel(in, in_len, out, out_len);
+    return lzo1x_decompress(in, in_len, out, out_len, wrkmem);
+}
+
+LZO_PUBLIC(int)
+lzo1x_decompress_wild_safe ( const lzo_bytep in , lzo_uint  in_len,
+                                   lzo_bytep out, lzo_uintp out_len,
+                                   lzo_voidp wrkmem )
+{
+    if (lzo1x_wild_enabled())
+        return lzo1x_decompress_wild_safe_kernel(in, in_len, out, out_len);
+    return lzo1x_decompress_safe(in, in_len, out, out_len, wrkmem);
+}
+
+
+/*
+vi:ts=4:et
+*/
@@ -0,0 +1,194 @@
+/* wildcopy.c -- test lzo1x_decompress_wild near the end of the output
+
+   This file is part of the LZO real-time data compression library.
+
+   Copyright (C) 1996-2014 Markus Franz Xaver Johannes Oberhumer
+   All Rights Reserved.
+
+   The LZO library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation; either version 2 of
+   the License, or (at your option) any later version.
+
+   The LZO library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with the LZO library; see the file COPYING.
+   If not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+
+   Markus F.X.J. Oberhumer
+   <markus@oberhumer.com>
+   http://www.oberhumer.com/opensource/lzo/
+ */
+
+
+#include "lzo/lzoconf.h"
+#include "lzo/lzo1x.h"
+
+/* utility layer */
+#define WANT_LZO_MALLOC 1
+#include "examples/portab.h"
+
+
+/*************************************************************************
+// The wild decompressors copy 8 or 16 bytes at a time and only fall
+// back to exact copies close to the end of the output.  Every input
+// here ends with a match and then a literal run of 0 to 24 bytes, so
+// that both kinds of run end at each distance from the output end
+// that the kernels treat specially.  The output buffer is exactly as
+// long as the data and followed by guard bytes that must stay intact.
+**************************************************************************/
+
+#define MAX_LEN     256
+#define GUARD       32
+#define GUARD_BYTE  0xa5
+
+static lzo_uint32_t seed = 1;
+
+static unsigned char next_byte(void)
+{
+    seed = seed * 1103515245UL + 12345;
+    return (unsigned char) (seed >> 16);
+}
+
+static int check(const lzo_bytep in, lzo_uint in_len,
+                 lzo_bytep comp, lzo_bytep out, lzo_voidp wrkmem,
+                 const char *name)
+{
+    lzo_uint comp_len = in_len + in_len / 16 + 64 + 3;
+    lzo_uint out_len;
+    lzo_uint i;
+    int safe, r;
+
+    r = lzo1x_1_compress(in, in_len, comp, &comp_len, wrkmem);
+    if (r != LZO_E_OK)
+    {
+        printf("%s: compression failed (%d) !!!\n", name, r);
+        return 1;
+    }
+    for (safe = 0; safe < 2; safe++)
+    {
+        lzo_memset(out, GUARD_BYTE, in_len + GUARD);
+        out_len = in_len;
+        if (safe)
+            r = lzo1x_decompress_wild_safe(comp, comp_len, out, &out_len, NULL);
+        else
+            r = lzo1x_decompress_wild(comp, comp_len, out, &out_len, NULL);
+        if (r != LZO_E_OK || out_len != in_len ||
+            lzo_memcmp(out, in, in_len) != 0)
+        {
+            printf("%s: %s round trip of %lu bytes failed (%d) !!!\n", name,
+                   safe ? "safe" : "fast", (unsigned long) in_len, r);
+            return 1;
+        }
+        for (i = 0; i < GUARD; i++)
+            if (out[in_len + i] != GUARD_BYTE)
+            {
+                printf("%s: %s wrote past %lu bytes !!!\n", name,
+                       safe ? "safe" : "fast", (unsigned long) in_len);
+                return 1;
+            }
+    }
+
+    /* one byte short: the safe variant must stop without overrunning */
+    if (in_len > 0)
+    {
+        lzo_memset(out, GUARD_BYTE, in_len + GUARD);
+        out_len = in_len - 1;
+        r = lzo1x_decompress_wild_safe(comp, comp_len, out, &out_len, NULL);
+        if (r != LZO_E_OUTPUT_OVERRUN)
+        {
+            printf("%s: safe decompression of %lu bytes into %lu "
+                   "returned %d !!!\n", name, (unsigned long) in_len,
+                   (unsigned long) (in_len - 1), r);
+            return 1;
+        }
+        for (i = in_len - 1; i < in_len + GUARD; i++)
+            if (out[i] != GUARD_BYTE)
+            {
+                printf("%s: safe wrote past %lu bytes !!!\n", name,
+                       (unsigned long) (in_len - 1));
+                return 1;
+            }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    lzo_bytep in;
+    lzo_bytep comp;
+    lzo_bytep out;
+    lzo_voidp wrkmem;
+    lzo_uint n, m, k, i, lit;
+    long tests = 0;
+
+    if (argc < 0 && argv == NULL)   /* avoid warning about unused args */
+        return 0;
+
+    if (lzo_init() != LZO_E_OK)
+    {
+        printf("lzo_init() failed !!!\n");
+        return 4;
+    }
+
+    in = (lzo_bytep) lzo_malloc(MAX_LEN);
+    comp = (lzo_bytep) lzo_malloc(MAX_LEN + MAX_LEN / 16 + 64 + 3);
+    out = (lzo_bytep) lzo_malloc(MAX_LEN + GUARD);
+    wrkmem = (lzo_voidp) lzo_malloc(LZO1X_1_MEM_COMPRESS);
+    if (in == NULL || comp == NULL || out == NULL || wrkmem == NULL)
+    {
+        printf("out of memory\n");
+        return 3;
+    }
+
+/* literals only, of every length */
+    for (n = 0; n <= 64; n++)
+    {
+        for (i = 0; i < n; i++)
+            in[i] = next_byte();
+        if (check(in, n, comp, out, wrkmem, "literals"))
+            return 1;
+        tests++;
+    }
+
+/* a run of one byte: a match overlapping its own output */
+    for (n = 1; n <= 128; n++)
+    {
+        lzo_memset(in, 'a', n);
+        if (check(in, n, comp, out, wrkmem, "run"))
+            return 1;
+        tests++;
+    }
+
+/* literals, a match of m bytes at distance lit, then k literals */
+    for (lit = 4; lit <= 40; lit += 12)
+        for (m = 3; m <= 48; m++)
+            for (k = 0; k <= 24; k++)
+            {
+                n = 0;
+                for (i = 0; i < lit; i++)
+                    in[n++] = next_byte();
+                for (i = 0; i < m; i++, n++)
+                    in[n] = in[i % lit];
+                for (i = 0; i < k; i++)
+                    in[n++] = next_byte();
+                if (check(in, n, comp, out, wrkmem, "match"))
+                    return 1;
+                tests++;
+            }
+
+    lzo_free(wrkmem);
+    lzo_free(out);
+    lzo_free(comp);
+    lzo_free(in);
+    printf("Wild copy test passed (%ld inputs).\n", tests);
+    return 0;
+}
+
+
+/* vim:set ts=4 sw=4 et: */
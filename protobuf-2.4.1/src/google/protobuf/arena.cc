@@ -0,0 +1,152 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+
+#include <google/protobuf/arena.h>
+
+namespace google {
+namespace protobuf {
+
+#ifndef _MSC_VER    // MSVC doesn't like definitions of inline constants, GCC
+                    // requires them.
+const size_t Arena::kDefaultStartBlockSize;
+const size_t Arena::kDefaultMaxBlockSize;
+const size_t Arena::kAlignment;
+#endif  // _MSC_VER
+
+Arena::Arena() {
+  Init(kDefaultStartBlockSize, kDefaultMaxBlockSize);
+}
+
+Arena::Arena(size_t start_block_size, size_t max_block_size) {
+  Init(start_block_size, max_block_size);
+}
+
+Arena::Arena(char* initial_block, size_t initial_block_size) {
+  Init(kDefaultStartBlockSize, kDefaultMaxBlockSize);
+  // The block header must be aligned, and the block must hold more than it.
+  size_t skip = (kAlignment - reinterpret_cast<uintptr_t>(initial_block) %
+                 kAlignment) % kAlignment;
+  if (initial_block_size > skip + sizeof(Block) + kAlignment) {
+    initial_block_ = reinterpret_cast<Block*>(initial_block + skip);
+    initial_block_->next = NULL;
+    initial_block_->pos = sizeof(Block);
+    initial_block_->size = initial_block_size - skip;
+    current_ = initial_block_;
+    space_allocated_ = initial_block_->size;
+  }
+}
+
+Arena::~Arena() {
+  RunCleanups();
+  FreeBlocks();
+}
+
+void Arena::Init(size_t start_block_size, size_t max_block_size) {
+  current_ = NULL;
+  initial_block_ = NULL;
+  cleanups_ = NULL;
+  next_block_size_ = max(start_block_size, sizeof(Block) + kAlignment);
+  max_block_size_ = max(max_block_size, next_block_size_);
+  space_allocated_ = 0;
+}
+
+void* Arena::AllocateFromNewBlock(size_t n) {
+  // The rest of the current block is wasted.  Blocks grow geometrically,
+  // so the waste is bounded by the size of the biggest allocation.
+  size_t size = max(next_block_size_, sizeof(Block) + n);
+  next_block_size_ = min(next_block_size_ * 2, max_block_size_);
+
+  Block* block = reinterpret_cast<Block*>(new char[size]);
+  block->next = current_;
+  block->pos = sizeof(Block) + n;
+  block->size = size;
+  current_ = block;
+  space_allocated_ += size;
+  return reinterpret_cast<char*>(block) + sizeof(Block);
+}
+
+void Arena::AddCleanup(void* object, void (*cleanup)(void*)) {
+  Cleanup* node = static_cast<Cleanup*>(AllocateAligned(sizeof(Cleanup)));
+  node->next = cleanups_;
+  node->object = object;
+  node->cleanup = cleanup;
+  cleanups_ = node;
+}
+
+void Arena::RunCleanups() {
+  // A cleanup may add more cleanups (a destructor releasing an object to
+  // the arena), so keep going until the list stays empty.
+  while (cleanups_ != NULL) {
+    Cleanup* node = cleanups_;
+    cleanups_ = NULL;
+    for (; node != NULL; node = node->next) {
+      node->cleanup(node->object);
+    }
+  }
+}
+
+void Arena::FreeBlocks() {
+  Block* block = current_;
+  while (block != NULL) {
+    Block* next = block->next;
+    if (block != initial_block_) {
+      delete [] reinterpret_cast<char*>(block);
+    }
+    block = next;
+  }
+  current_ = NULL;
+}
+
+uint64 Arena::Reset() {
+  uint64 space_allocated = space_allocated_;
+  RunCleanups();
+  FreeBlocks();
+  space_allocated_ = 0;
+  if (initial_block_ != NULL) {
+    initial_block_->next = NULL;
+    initial_block_->pos = sizeof(Block);
+    current_ = initial_block_;
+    space_allocated_ = initial_block_->size;
+  }
+  return space_allocated;
+}
+
+uint64 Arena::SpaceUsed() const {
+  uint64 space_used = 0;
+  for (const Block* block = current_; block != NULL; block = block->next) {
+    space_used += block->pos - sizeof(Block);
+  }
+  return space_used;
+}
+
+}  // namespace protobuf
+}  // namespace google
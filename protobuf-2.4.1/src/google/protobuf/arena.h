@@ -0,0 +1,228 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Arena is a memory pool that protocol messages can be allocated from.
+// A message created on an Arena allocates its sub-messages, strings and
+// repeated field arrays from the same Arena, and all of them are freed
+// together when the Arena is destroyed or Reset(), instead of one at a
+// time by the messages' destructors.  For a server that parses a request,
+// handles it and throws it away, this turns most of the malloc() and
+// free() calls for the request into pointer increments.
+//
+//   Arena arena;
+//   MyRequest* request = Arena::CreateMessage<MyRequest>(&arena);
+//   request->ParseFromString(data);
+//   ...
+//   // No delete: the arena frees request and everything in it.
+//
+// A message on an Arena is owned by the Arena and must not be deleted.
+// Its release_*() accessors return heap-allocated copies, and Swap()
+// with a message on a different Arena (or on the heap) copies instead
+// of swapping pointers, so objects never move from one owner to another.
+//
+// An Arena is not thread-safe: it must only be used by one thread at a
+// time, like the messages allocated from it.
+
+#ifndef GOOGLE_PROTOBUF_ARENA_H__
+#define GOOGLE_PROTOBUF_ARENA_H__
+
+#include <new>
+#include <stddef.h>
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class Arena;
+
+namespace internal {
+
+// Whether T is a generated message class.  Those declare the marker type
+// below and have a constructor taking the Arena, so that they can put
+// their own fields on it.
+template <typename T>
+struct is_arena_constructable {
+  template <typename U>
+  static char Test(const typename U::InternalArenaConstructable_*);
+  template <typename U>
+  static int Test(...);
+
+  static const bool value = sizeof(Test<T>(NULL)) == sizeof(char);
+};
+
+template <bool b> struct arena_bool_constant {};
+
+template <typename T>
+void arena_destruct_object(void* object) {
+  reinterpret_cast<T*>(object)->~T();
+}
+
+template <typename T>
+void arena_delete_object(void* object) {
+  delete reinterpret_cast<T*>(object);
+}
+
+}  // namespace internal
+
+class LIBPROTOBUF_EXPORT Arena {
+ public:
+  // Default sizes of the blocks the Arena allocates.  The first block has
+  // kDefaultStartBlockSize bytes and each block after it is twice as big
+  // as the one before, up to kDefaultMaxBlockSize.
+  static const size_t kDefaultStartBlockSize = 256;
+  static const size_t kDefaultMaxBlockSize = 8192;
+
+  Arena();
+  Arena(size_t start_block_size, size_t max_block_size);
+
+  // Uses initial_block, which must outlive the Arena, as the first block,
+  // so that a request whose messages fit in it (a buffer on the stack, or
+  // one reused from request to request) does not call malloc() at all.
+  // The Arena never frees initial_block.
+  Arena(char* initial_block, size_t initial_block_size);
+
+  // Frees every object on the Arena.
+  ~Arena();
+
+  // Creates a message of type T, which must be a generated message class,
+  // on arena.  If arena is NULL, the message is allocated on the heap and
+  // owned by the caller, as with "new T".
+  template <typename T>
+  static T* CreateMessage(Arena* arena) {
+    if (arena == NULL) return new T;
+    return arena->CreateInternal<T>(internal::arena_bool_constant<true>());
+  }
+
+  // Creates a default-constructed T on arena, or on the heap if arena is
+  // NULL.  The Arena calls T's destructor when it is reset.  If T is a
+  // generated message class, this is the same as CreateMessage().
+  template <typename T>
+  static T* Create(Arena* arena) {
+    if (arena == NULL) return new T;
+    return arena->CreateInternal<T>(
+        internal::arena_bool_constant<
+            internal::is_arena_constructable<T>::value>());
+  }
+
+  // Allocates an uninitialized array of n T's, which must be a type with
+  // no constructor or destructor, on arena, or with new[] if arena is NULL.
+  // Arrays on an Arena are never freed individually.
+  template <typename T>
+  static T* CreateArray(Arena* arena, size_t n) {
+    if (arena == NULL) return new T[n];
+    return static_cast<T*>(arena->AllocateAligned(n * sizeof(T)));
+  }
+
+  // Passes ownership of a heap-allocated object to the Arena, which
+  // deletes it when it is reset.
+  template <typename T>
+  void Own(T* object) {
+    if (object != NULL) {
+      AddCleanup(object, &internal::arena_delete_object<T>);
+    }
+  }
+
+  // Returns n bytes of memory, aligned for any type, which the Arena frees
+  // when it is reset.
+  void* AllocateAligned(size_t n) {
+    n = (n + kAlignment - 1) & ~(kAlignment - 1);
+    if (current_ != NULL && current_->size - current_->pos >= n) {
+      void* result = reinterpret_cast<char*>(current_) + current_->pos;
+      current_->pos += n;
+      return result;
+    }
+    return AllocateFromNewBlock(n);
+  }
+
+  // Arranges for cleanup(object) to be called when the Arena is reset.
+  // Cleanups run in the reverse of the order they were added.
+  void AddCleanup(void* object, void (*cleanup)(void*));
+
+  // Frees every object on the Arena, leaving it empty and ready to be used
+  // again.  Keeps the initial block, if any, but frees all the others.
+  // Returns the number of bytes the Arena had allocated.
+  uint64 Reset();
+
+  // Returns the number of bytes in the Arena's blocks.
+  uint64 SpaceAllocated() const { return space_allocated_; }
+
+  // Returns the number of bytes handed out, which is less than
+  // SpaceAllocated() by the unused tails of the blocks.
+  uint64 SpaceUsed() const;
+
+ private:
+  static const size_t kAlignment = 8;
+
+  // Each block starts with this header; its memory follows.
+  struct Block {
+    Block* next;
+    size_t pos;   // offset of the first free byte
+    size_t size;  // size of the block, including this header
+  };
+
+  struct Cleanup {
+    Cleanup* next;
+    void* object;
+    void (*cleanup)(void*);
+  };
+
+  template <typename T>
+  T* CreateInternal(internal::arena_bool_constant<true>) {
+    T* result = new (AllocateAligned(sizeof(T))) T(this);
+    AddCleanup(result, &internal::arena_destruct_object<T>);
+    return result;
+  }
+
+  template <typename T>
+  T* CreateInternal(internal::arena_bool_constant<false>) {
+    T* result = new (AllocateAligned(sizeof(T))) T();
+    AddCleanup(result, &internal::arena_destruct_object<T>);
+    return result;
+  }
+
+  void Init(size_t start_block_size, size_t max_block_size);
+  void* AllocateFromNewBlock(size_t n);
+  void RunCleanups();
+  void FreeBlocks();
+
+  Block* current_;         // block being allocated from, newest first
+  Block* initial_block_;   // caller's block, or NULL
+  Cleanup* cleanups_;      // most recently added first
+  size_t next_block_size_;
+  size_t max_block_size_;
+  uint64 space_allocated_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(Arena);
+};
+
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_ARENA_H__
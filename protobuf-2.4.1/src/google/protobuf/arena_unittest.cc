@@ -0,0 +1,342 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <string>
+
+#include <google/protobuf/arena.h>
+
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+#include <google/protobuf/repeated_field.h>
+#include <google/protobuf/test_util.h>
+#include <google/protobuf/unittest.pb.h>
+#include <google/protobuf/stubs/common.h>
+#include <google/protobuf/testing/googletest.h>
+#include <gtest/gtest.h>
+
+namespace google {
+using protobuf_unittest::TestAllTypes;
+
+namespace protobuf {
+namespace {
+
+// Counts how many times its destructor runs.
+class Counted {
+ public:
+  explicit Counted(int* count) : count_(count) {}
+  ~Counted() { ++*count_; }
+
+ private:
+  int* count_;
+};
+
+// Default-constructible type, for Arena::Create().
+class Flagged {
+ public:
+  Flagged() : destroyed_(NULL) {}
+  ~Flagged() { if (destroyed_ != NULL) *destroyed_ = true; }
+
+  bool* destroyed_;
+};
+
+TEST(ArenaTest, AllocateAligned) {
+  Arena arena;
+  EXPECT_EQ(0, arena.SpaceAllocated());
+
+  char* a = static_cast<char*>(arena.AllocateAligned(3));
+  char* b = static_cast<char*>(arena.AllocateAligned(1));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(a) % 8);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(b) % 8);
+  EXPECT_EQ(8, b - a);
+  EXPECT_EQ(Arena::kDefaultStartBlockSize, arena.SpaceAllocated());
+
+  // Allocations bigger than a block get a block of their own.
+  arena.AllocateAligned(Arena::kDefaultMaxBlockSize * 2);
+  EXPECT_GT(arena.SpaceAllocated(), Arena::kDefaultMaxBlockSize * 2);
+  EXPECT_LE(arena.SpaceUsed(), arena.SpaceAllocated());
+
+  uint64 allocated = arena.SpaceAllocated();
+  EXPECT_EQ(allocated, arena.Reset());
+  EXPECT_EQ(0, arena.SpaceAllocated());
+  EXPECT_EQ(0, arena.SpaceUsed());
+}
+
+TEST(ArenaTest, InitialBlock) {
+  char buffer[1024];
+  Arena arena(buffer, sizeof(buffer));
+
+  char* p = static_cast<char*>(arena.AllocateAligned(100));
+  EXPECT_GE(p, buffer);
+  EXPECT_LT(p, buffer + sizeof(buffer));
+  EXPECT_EQ(sizeof(buffer), arena.SpaceAllocated());
+
+  // Once the initial block is full the Arena allocates more.
+  arena.AllocateAligned(sizeof(buffer));
+  EXPECT_GT(arena.SpaceAllocated(), sizeof(buffer));
+
+  // Reset keeps the initial block and starts over at its beginning.
+  arena.Reset();
+  EXPECT_EQ(sizeof(buffer), arena.SpaceAllocated());
+  EXPECT_EQ(p, arena.AllocateAligned(100));
+}
+
+TEST(ArenaTest, OwnAndCreate) {
+  int count = 0;
+  bool destroyed = false;
+  {
+    Arena arena;
+    arena.Own(new Counted(&count));
+    arena.Own(new Counted(&count));
+    arena.Own(static_cast<Counted*>(NULL));
+    Arena::Create<Flagged>(&arena)->destroyed_ = &destroyed;
+    EXPECT_EQ(0, count);
+
+    arena.Reset();
+    EXPECT_EQ(2, count);
+    EXPECT_TRUE(destroyed);
+
+    // The Arena is usable again after Reset().
+    arena.Own(new Counted(&count));
+  }
+  EXPECT_EQ(3, count);
+
+  // With no Arena, Create() and CreateArray() use the heap.
+  Flagged* flagged = Arena::Create<Flagged>(NULL);
+  delete flagged;
+  int* array = Arena::CreateArray<int>(NULL, 10);
+  delete [] array;
+}
+
+TEST(ArenaTest, Message) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  EXPECT_EQ(&arena, message->GetArena());
+
+  TestUtil::SetAllFields(message);
+  TestUtil::ExpectAllFieldsSet(*message);
+
+  // Sub-messages and repeated fields share the message's Arena.
+  EXPECT_EQ(&arena, message->optional_nested_message().GetArena());
+  EXPECT_EQ(&arena, message->repeated_nested_message(0).GetArena());
+  EXPECT_EQ(&arena, message->repeated_int32().GetArena());
+  EXPECT_EQ(&arena, message->repeated_string().GetArena());
+
+  message->Clear();
+  TestUtil::ExpectClear(*message);
+  TestUtil::SetAllFields(message);
+  TestUtil::ExpectAllFieldsSet(*message);
+
+  // Messages made by New() on the Arena are on it too.
+  TestAllTypes* other = message->New(&arena);
+  EXPECT_EQ(&arena, other->GetArena());
+  other->CopyFrom(*message);
+  TestUtil::ExpectAllFieldsSet(*other);
+}
+
+TEST(ArenaTest, HeapMessage) {
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(NULL);
+  EXPECT_TRUE(message->GetArena() == NULL);
+  TestUtil::SetAllFields(message);
+  EXPECT_TRUE(message->mutable_optional_nested_message()->GetArena() == NULL);
+  delete message;
+
+  // New(Arena*) works through the Message interface too.
+  Arena arena;
+  const Message& prototype = TestAllTypes::default_instance();
+  Message* owned = prototype.New(&arena);
+  EXPECT_EQ(&arena, owned->GetArena());
+}
+
+TEST(ArenaTest, Parse) {
+  TestAllTypes source;
+  TestUtil::SetAllFields(&source);
+  string data = source.SerializeAsString();
+
+  char buffer[256];
+  Arena arena(buffer, sizeof(buffer));
+  for (int i = 0; i < 3; i++) {
+    TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+    ASSERT_TRUE(message->ParseFromString(data));
+    TestUtil::ExpectAllFieldsSet(*message);
+    EXPECT_EQ(data, message->SerializeAsString());
+    arena.Reset();
+  }
+}
+
+TEST(ArenaTest, Release) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  message->mutable_optional_nested_message()->set_bb(12);
+  message->set_optional_string("foo");
+
+  // release_*() on an Arena returns heap copies the caller owns.
+  scoped_ptr<TestAllTypes::NestedMessage> nested(
+      message->release_optional_nested_message());
+  EXPECT_TRUE(nested->GetArena() == NULL);
+  EXPECT_EQ(12, nested->bb());
+  EXPECT_FALSE(message->has_optional_nested_message());
+
+  scoped_ptr<string> str(message->release_optional_string());
+  EXPECT_EQ("foo", *str);
+  EXPECT_FALSE(message->has_optional_string());
+}
+
+TEST(ArenaTest, Swap) {
+  Arena arena1;
+  Arena arena2;
+  TestAllTypes* message1 = Arena::CreateMessage<TestAllTypes>(&arena1);
+  TestAllTypes* message2 = Arena::CreateMessage<TestAllTypes>(&arena2);
+  TestUtil::SetAllFields(message1);
+  message2->set_optional_int32(5);
+
+  // Swapping across Arenas copies, leaving each message on its own Arena.
+  message1->Swap(message2);
+  TestUtil::ExpectAllFieldsSet(*message2);
+  EXPECT_EQ(5, message1->optional_int32());
+  EXPECT_FALSE(message1->has_optional_string());
+  EXPECT_EQ(&arena2, message2->optional_nested_message().GetArena());
+
+  TestAllTypes heap_message;
+  heap_message.Swap(message2);
+  TestUtil::ExpectAllFieldsSet(heap_message);
+  TestUtil::ExpectClear(*message2);
+  EXPECT_TRUE(heap_message.optional_nested_message().GetArena() == NULL);
+
+  // Within one Arena, Swap() swaps.
+  TestAllTypes* message3 = Arena::CreateMessage<TestAllTypes>(&arena1);
+  TestUtil::SetAllFields(message3);
+  message1->Swap(message3);
+  TestUtil::ExpectAllFieldsSet(*message1);
+  EXPECT_EQ(5, message3->optional_int32());
+}
+
+TEST(ArenaTest, LazyField) {
+  protobuf_unittest::TestLazyMessage source;
+  TestUtil::SetAllFields(source.mutable_lazy_child());
+  string data = source.SerializeAsString();
+
+  Arena arena;
+  protobuf_unittest::TestLazyMessage* message =
+      Arena::CreateMessage<protobuf_unittest::TestLazyMessage>(&arena);
+  ASSERT_TRUE(message->ParseFromString(data));
+  TestUtil::ExpectAllFieldsSet(message->lazy_child());
+  EXPECT_EQ(&arena, message->lazy_child().GetArena());
+  EXPECT_EQ(data, message->SerializeAsString());
+
+  scoped_ptr<TestAllTypes> child(message->release_lazy_child());
+  EXPECT_TRUE(child->GetArena() == NULL);
+  TestUtil::ExpectAllFieldsSet(*child);
+  EXPECT_FALSE(message->has_lazy_child());
+}
+
+TEST(ArenaTest, Reflection) {
+  Arena arena;
+  TestAllTypes* message = Arena::CreateMessage<TestAllTypes>(&arena);
+  const Reflection* reflection = message->GetReflection();
+  const Descriptor* descriptor = message->GetDescriptor();
+
+  reflection->SetString(message, descriptor->FindFieldByName(
+      "optional_string"), "bar");
+  EXPECT_EQ("bar", message->optional_string());
+
+  Message* nested = reflection->MutableMessage(message,
+      descriptor->FindFieldByName("optional_nested_message"));
+  EXPECT_EQ(&arena, nested->GetArena());
+
+  Message* added = reflection->AddMessage(message,
+      descriptor->FindFieldByName("repeated_nested_message"));
+  EXPECT_EQ(&arena, added->GetArena());
+  EXPECT_EQ(1, message->repeated_nested_message_size());
+
+  message->Clear();
+  TestUtil::ReflectionTester tester(TestAllTypes::descriptor());
+  tester.SetAllFieldsViaReflection(message);
+  tester.ExpectAllFieldsSetViaReflection(*message);
+  TestAllTypes copy;
+  copy.CopyFrom(*message);
+  tester.ExpectAllFieldsSetViaReflection(copy);
+}
+
+TEST(ArenaTest, RepeatedField) {
+  Arena arena;
+  RepeatedField<int> field(&arena);
+  for (int i = 0; i < 100; i++) field.Add(i);
+  EXPECT_EQ(100, field.size());
+  EXPECT_EQ(99, field.Get(99));
+  EXPECT_GT(arena.SpaceUsed(), 100 * sizeof(int));
+
+  RepeatedField<int> other(&arena);
+  other.Add(7);
+  other.Swap(&field);
+  EXPECT_EQ(1, field.size());
+  EXPECT_EQ(100, other.size());
+
+  RepeatedField<int> heap;
+  heap.Add(1);
+  heap.Add(2);
+  heap.Swap(&field);
+  EXPECT_EQ(2, field.size());
+  EXPECT_EQ(1, heap.size());
+  EXPECT_EQ(7, heap.Get(0));
+}
+
+TEST(ArenaTest, RepeatedPtrField) {
+  Arena arena;
+  RepeatedPtrField<string> field(&arena);
+  field.Add()->assign("a");
+  field.Add()->assign("b");
+
+  // AddAllocated() hands the string to the Arena.
+  field.AddAllocated(new string("c"));
+  EXPECT_EQ(3, field.size());
+  EXPECT_EQ("c", field.Get(2));
+
+  // ReleaseLast() returns a heap copy.
+  scoped_ptr<string> last(field.ReleaseLast());
+  EXPECT_EQ("c", *last);
+  EXPECT_EQ(2, field.size());
+
+  field.RemoveLast();
+  field.AddCleared(new string);
+  scoped_ptr<string> cleared(field.ReleaseCleared());
+  EXPECT_TRUE(cleared->empty());
+
+  RepeatedPtrField<string> heap;
+  heap.Add()->assign("x");
+  heap.Swap(&field);
+  EXPECT_EQ(1, field.size());
+  EXPECT_EQ("x", field.Get(0));
+  EXPECT_EQ(1, heap.size());
+  EXPECT_EQ("a", heap.Get(0));
+}
+
+}  // namespace
+}  // namespace protobuf
+}  // namespace google
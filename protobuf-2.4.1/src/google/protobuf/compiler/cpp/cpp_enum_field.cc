@@ -222,7 +222,7 @@ GenerateSwappingCode(io::Printer* printer) const {
 
 void RepeatedEnumFieldGenerator::
 GenerateConstructorCode(io::Printer* printer) const {
-  // Not needed for repeated fields.
+  printer->Print(variables_, "$name$_.InternalSetArena(_arena_);\n");
 }
 
 void RepeatedEnumFieldGenerator::
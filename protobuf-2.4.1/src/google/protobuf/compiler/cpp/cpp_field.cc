@@ -109,12 +109,17 @@ FieldGenerator* FieldGeneratorMap::MakeGenerator(const FieldDescriptor* field) {
   } else {
     switch (field->cpp_type()) {
       case FieldDescriptor::CPPTYPE_MESSAGE:
+        if (IsLazy(field)) {
+          return new LazyMessageFieldGenerator(field);
+        }
         return new MessageFieldGenerator(field);
       case FieldDescriptor::CPPTYPE_STRING:
         switch (field->options().ctype()) {
           default:  // StringFieldGenerator handles unknown ctypes.
           case FieldOptions::STRING:
             return new StringFieldGenerator(field);
+          case FieldOptions::STRING_PIECE:
+            return new StringPieceFieldGenerator(field);
         }
       case FieldDescriptor::CPPTYPE_ENUM:
         return new EnumFieldGenerator(field);
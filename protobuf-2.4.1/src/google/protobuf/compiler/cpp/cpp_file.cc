@@ -128,7 +128,10 @@ void FileGenerator::GenerateHeader(io::Printer* printer) {
 
   // OK, it's now safe to #include other files.
   printer->Print(
+    "#include <google/protobuf/arena.h>\n"
     "#include <google/protobuf/generated_message_util.h>\n"
+    "#include <google/protobuf/lazy_field.h>\n"
+    "#include <google/protobuf/string_piece_field.h>\n"
     "#include <google/protobuf/repeated_field.h>\n"
     "#include <google/protobuf/extension_set.h>\n");
 
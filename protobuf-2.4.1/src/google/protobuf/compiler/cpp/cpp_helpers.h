@@ -150,6 +150,28 @@ inline bool HasFastArraySerialization(const FileDescriptor* file) {
   return file->options().optimize_for() == FileOptions::SPEED;
 }
 
+// Should MergePartialFromCodedStream() parse through a per-message table
+// rather than a switch?  The table is much smaller but slower, so it is only
+// used when optimizing for code size, which otherwise parses by reflection.
+inline bool HasTableDrivenParser(const FileDescriptor* file) {
+  return file->options().optimize_for() == FileOptions::CODE_SIZE;
+}
+
+// Is this field a singular sub-message that is parsed lazily?  The lazy
+// option has no effect on other fields.
+inline bool IsLazy(const FieldDescriptor* field) {
+  return field->options().lazy() && !field->is_repeated() &&
+         field->type() == FieldDescriptor::TYPE_MESSAGE;
+}
+
+// Is this field a singular string stored as an internal::StringPieceField?
+// Repeated fields with ctype=STRING_PIECE are still stored as strings.
+inline bool IsStringPiece(const FieldDescriptor* field) {
+  return field->options().ctype() == FieldOptions::STRING_PIECE &&
+         !field->is_repeated() &&
+         field->cpp_type() == FieldDescriptor::CPPTYPE_STRING;
+}
+
 
 }  // namespace cpp
 }  // namespace compiler
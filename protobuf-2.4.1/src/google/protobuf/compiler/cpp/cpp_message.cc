@@ -497,9 +497,13 @@ GenerateClassDefinition(io::Printer* printer) {
   printer->Print(vars,
     "void Swap($classname$* other);\n"
     "\n"
+    "inline ::google::protobuf::Arena* GetArena() const { return _arena_; }\n"
+    "typedef void InternalArenaConstructable_;\n"
+    "\n"
     "// implements Message ----------------------------------------------\n"
     "\n"
-    "$classname$* New() const;\n");
+    "$classname$* New() const;\n"
+    "$classname$* New(::google::protobuf::Arena* arena) const;\n");
 
   if (HasGeneratedMethods(descriptor_->file())) {
     if (HasDescriptorMethods(descriptor_->file())) {
@@ -526,11 +530,17 @@ GenerateClassDefinition(io::Printer* printer) {
       printer->Print(
         "::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;\n");
     }
+  } else if (HasTableDrivenParser(descriptor_->file())) {
+    printer->Print(
+      "bool MergePartialFromCodedStream(\n"
+      "    ::google::protobuf::io::CodedInputStream* input);\n");
   }
 
   printer->Print(vars,
     "int GetCachedSize() const { return _cached_size_; }\n"
     "private:\n"
+    "explicit $classname$(::google::protobuf::Arena* arena);\n"
+    "friend class ::google::protobuf::Arena;\n"
     "void SharedCtor();\n"
     "void SharedDtor();\n"
     "void SetCachedSize(int size) const;\n"
@@ -612,6 +622,10 @@ GenerateClassDefinition(io::Printer* printer) {
 
   // Members assumed to align to 8 bytes:
 
+  printer->Print(
+    "::google::protobuf::Arena* _arena_;\n"
+    "\n");
+
   if (descriptor_->extension_range_count() > 0) {
     printer->Print(
       "::google::protobuf::internal::ExtensionSet _extensions_;\n"
@@ -899,6 +913,9 @@ GenerateClassMethods(io::Printer* printer) {
 
     GenerateIsInitialized(printer);
     printer->Print("\n");
+  } else if (HasTableDrivenParser(descriptor_->file())) {
+    GenerateMergeFromCodedStream(printer);
+    printer->Print("\n");
   }
 
   GenerateSwap(printer);
@@ -975,6 +992,11 @@ GenerateSharedDestructorCode(io::Printer* printer) {
     "void $classname$::SharedDtor() {\n",
     "classname", classname_);
   printer->Indent();
+
+  // Everything a message on an Arena allocated is freed with the Arena.
+  printer->Print(
+    "if (_arena_ != NULL) return;\n");
+
   // Write the destructors for each field.
   for (int i = 0; i < descriptor_->field_count(); i++) {
     field_generators_.get(descriptor_->field(i))
@@ -991,7 +1013,7 @@ GenerateSharedDestructorCode(io::Printer* printer) {
   for (int i = 0; i < descriptor_->field_count(); i++) {
     const FieldDescriptor* field = descriptor_->field(i);
 
-    if (!field->is_repeated() &&
+    if (!field->is_repeated() && !IsLazy(field) &&
         field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
       printer->Print("  delete $name$_;\n",
                      "name", FieldName(field));
@@ -1009,10 +1031,15 @@ void MessageGenerator::
 GenerateStructors(io::Printer* printer) {
   string superclass = SuperClassName(descriptor_);
 
-  // Generate the default constructor.
+  // Generate the default constructor, and the one used by Arena.
   printer->Print(
     "$classname$::$classname$()\n"
-    "  : $superclass$() {\n"
+    "  : $superclass$(), _arena_(NULL) {\n"
+    "  SharedCtor();\n"
+    "}\n"
+    "\n"
+    "$classname$::$classname$(::google::protobuf::Arena* arena)\n"
+    "  : $superclass$(), _arena_(arena) {\n"
     "  SharedCtor();\n"
     "}\n",
     "classname", classname_,
@@ -1029,10 +1056,11 @@ GenerateStructors(io::Printer* printer) {
   // constructed yet at that time.
   // TODO(kenton):  Maybe all message fields (even for non-default messages)
   //   should be initialized to point at default instances rather than NULL?
+  // Lazy fields return the default instance when they are empty.
   for (int i = 0; i < descriptor_->field_count(); i++) {
     const FieldDescriptor* field = descriptor_->field(i);
 
-    if (!field->is_repeated() &&
+    if (!field->is_repeated() && !IsLazy(field) &&
         field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
       printer->Print(
           "  $name$_ = const_cast< $type$*>(&$type$::default_instance());\n",
@@ -1047,7 +1075,7 @@ GenerateStructors(io::Printer* printer) {
   // Generate the copy constructor.
   printer->Print(
     "$classname$::$classname$(const $classname$& from)\n"
-    "  : $superclass$() {\n"
+    "  : $superclass$(), _arena_(NULL) {\n"
     "  SharedCtor();\n"
     "  MergeFrom(from);\n"
     "}\n"
@@ -1102,6 +1130,10 @@ GenerateStructors(io::Printer* printer) {
     "\n"
     "$classname$* $classname$::New() const {\n"
     "  return new $classname$;\n"
+    "}\n"
+    "\n"
+    "$classname$* $classname$::New(::google::protobuf::Arena* arena) const {\n"
+    "  return ::google::protobuf::Arena::CreateMessage<$classname$>(arena);\n"
     "}\n",
     "classname", classname_,
     "adddescriptorsname",
@@ -1203,6 +1235,17 @@ GenerateSwap(io::Printer* printer) {
   printer->Indent();
 
   if (HasGeneratedMethods(descriptor_->file())) {
+    // Fields cannot move from one Arena (or the heap) to another, so
+    // messages on different ones swap by copying.
+    printer->Print(
+      "if (_arena_ != other->_arena_) {\n"
+      "  $classname$ temp(*other);\n"
+      "  other->CopyFrom(*this);\n"
+      "  CopyFrom(temp);\n"
+      "  return;\n"
+      "}\n",
+      "classname", classname_);
+
     for (int i = 0; i < descriptor_->field_count(); i++) {
       const FieldDescriptor* field = descriptor_->field(i);
       field_generators_.get(field).GenerateSwappingCode(printer);
@@ -1385,6 +1428,11 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
     return;
   }
 
+  if (HasTableDrivenParser(descriptor_->file())) {
+    GenerateTableDrivenMergeFromCodedStream(printer);
+    return;
+  }
+
   printer->Print(
     "bool $classname$::MergePartialFromCodedStream(\n"
     "    ::google::protobuf::io::CodedInputStream* input) {\n"
@@ -1580,6 +1628,174 @@ GenerateMergeFromCodedStream(io::Printer* printer) {
     "}\n");
 }
 
+void MessageGenerator::
+GenerateTableDrivenMergeFromCodedStream(io::Printer* printer) {
+  // Fields are parsed by WireFormatLite::ParseFromTable(), from a table
+  // describing them, rather than by a switch statement per message.  This
+  // is slower than the switch for most messages but much smaller.
+  printer->Print(
+    "bool $classname$::MergePartialFromCodedStream(\n"
+    "    ::google::protobuf::io::CodedInputStream* input) {\n",
+    "classname", classname_);
+  printer->Indent();
+
+  if (descriptor_->field_count() > 0) {
+    printer->Print(
+      "static const ::google::protobuf::internal::ParseTableField kFields[] = {\n");
+    printer->Indent();
+
+    scoped_array<const FieldDescriptor*> ordered_fields(
+      SortFieldsByNumber(descriptor_));
+
+    for (int i = 0; i < descriptor_->field_count(); i++) {
+      const FieldDescriptor* field = ordered_fields[i];
+
+      map<string, string> vars;
+      vars["classname"] = classname_;
+      vars["name"] = FieldName(field);
+      vars["tag"] = SimpleItoa(WireFormat::MakeTag(field));
+      vars["has_bit"] =
+          field->is_repeated() ? "-1" : SimpleItoa(field->index());
+      vars["type"] = FieldDescriptorProto_Type_Name(
+          static_cast<FieldDescriptorProto_Type>(field->type()));
+      vars["packed"] = field->options().packed() ? "true" : "false";
+      vars["lazy"] = IsLazy(field) ? "true" : "false";
+      vars["string_piece"] = IsStringPiece(field) ? "true" : "false";
+      vars["default_string"] = "NULL";
+      vars["new_message"] = "NULL";
+      vars["is_valid"] = "NULL";
+      switch (field->cpp_type()) {
+        case FieldDescriptor::CPPTYPE_STRING:
+          if (!field->is_repeated() && !IsStringPiece(field)) {
+            vars["default_string"] = field->default_value_string().empty() ?
+                "&::google::protobuf::internal::kEmptyString" :
+                "&_default_" + FieldName(field) + "_";
+          }
+          break;
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          vars["new_message"] =
+              "&::google::protobuf::internal::NewMessageOf< " +
+              FieldMessageTypeName(field) + " >";
+          break;
+        case FieldDescriptor::CPPTYPE_ENUM:
+          vars["is_valid"] =
+              "&" + ClassName(field->enum_type(), true) + "_IsValid";
+          break;
+        default:
+          break;
+      }
+
+      PrintFieldComment(printer, field);
+      printer->Print(vars,
+        "{ $tag$u, GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET("
+          "$classname$, $name$_),\n"
+        "  $has_bit$, ::google::protobuf::internal::WireFormatLite::$type$, "
+          "$packed$, $lazy$, $string_piece$,\n"
+        "  $default_string$, $new_message$, $is_valid$ },\n");
+    }
+
+    printer->Outdent();
+    printer->Print("};\n");
+  }
+
+  map<string, string> vars;
+  vars["classname"] = classname_;
+  vars["fields"] = descriptor_->field_count() > 0 ? "kFields" : "NULL";
+  vars["num_fields"] = SimpleItoa(descriptor_->field_count());
+  vars["has_extensions"] =
+      descriptor_->extension_range_count() > 0 ? "true" : "false";
+  vars["verify_utf8"] = HasUtf8Verification(descriptor_->file()) ?
+      "&::google::protobuf::internal::WireFormat::VerifyParsedUTF8String" :
+      "NULL";
+  printer->Print(vars,
+    "static const ::google::protobuf::internal::ParseTable kTable = {\n"
+    "  $fields$, $num_fields$,\n"
+    "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET("
+      "$classname$, _has_bits_[0]),\n"
+    "  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET($classname$, _arena_),\n"
+    "  $has_extensions$,\n"
+    "  $verify_utf8$,\n"
+    "};\n");
+
+  if (HasUnknownFields(descriptor_->file())) {
+    printer->Print(
+      "::google::protobuf::internal::UnknownFieldSetFieldSkipper skipper(\n"
+      "    mutable_unknown_fields());\n");
+  } else {
+    printer->Print(
+      "::google::protobuf::internal::FieldSkipper skipper;\n");
+  }
+  printer->Print(
+    "::google::protobuf::uint32 tag;\n");
+
+  if (descriptor_->extension_range_count() == 0) {
+    printer->Print(
+      "return ::google::protobuf::internal::WireFormatLite::ParseFromTable(\n"
+      "    input, kTable, this, &skipper, &tag);\n");
+    printer->Outdent();
+    printer->Print("}\n");
+    return;
+  }
+
+  // ParseFromTable() stops at tags it does not know, which may be
+  // extensions.
+  printer->Print(
+    "#define DO_(EXPRESSION) if (!(EXPRESSION)) return false\n"
+    "while (true) {\n"
+    "  DO_(::google::protobuf::internal::WireFormatLite::ParseFromTable(\n"
+    "      input, kTable, this, &skipper, &tag));\n"
+    "  if (tag == 0 ||\n"
+    "      ::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==\n"
+    "      ::google::protobuf::internal::WireFormatLite::WIRETYPE_END_GROUP) {\n"
+    "    return true;\n"
+    "  }\n");
+  printer->Indent();
+
+  printer->Print(
+    "if (");
+  for (int i = 0; i < descriptor_->extension_range_count(); i++) {
+    const Descriptor::ExtensionRange* range =
+      descriptor_->extension_range(i);
+    if (i > 0) printer->Print(" ||\n    ");
+
+    uint32 start_tag = WireFormatLite::MakeTag(
+      range->start, static_cast<WireFormatLite::WireType>(0));
+    uint32 end_tag = WireFormatLite::MakeTag(
+      range->end, static_cast<WireFormatLite::WireType>(0));
+
+    if (range->end > FieldDescriptor::kMaxNumber) {
+      printer->Print(
+        "($start$u <= tag)",
+        "start", SimpleItoa(start_tag));
+    } else {
+      printer->Print(
+        "($start$u <= tag && tag < $end$u)",
+        "start", SimpleItoa(start_tag),
+        "end", SimpleItoa(end_tag));
+    }
+  }
+  printer->Print(") {\n");
+  if (HasUnknownFields(descriptor_->file())) {
+    printer->Print(
+      "  DO_(_extensions_.ParseField(tag, input, default_instance_,\n"
+      "                              mutable_unknown_fields()));\n");
+  } else {
+    printer->Print(
+      "  DO_(_extensions_.ParseField(tag, input, default_instance_));\n");
+  }
+  printer->Print(
+    "  continue;\n"
+    "}\n"
+    "DO_(skipper.SkipField(input, tag));\n");
+
+  printer->Outdent();
+  printer->Outdent();
+  printer->Print(
+    "  }\n"                   // while
+    "#undef DO_\n"
+    "}\n");
+}
+
 void MessageGenerator::GenerateSerializeOneField(
     io::Printer* printer, const FieldDescriptor* field, bool to_array) {
   PrintFieldComment(printer, field);
@@ -1904,6 +2120,13 @@ GenerateIsInitialized(io::Printer* printer) {
           "  if (!this->$name$(i).IsInitialized()) return false;\n"
           "}\n",
           "name", FieldName(field));
+      } else if (IsLazy(field)) {
+        // Don't parse a lazy field just to check it.
+        printer->Print(
+          "if (has_$name$()) {\n"
+          "  if (!$name$_.IsInitialized()) return false;\n"
+          "}\n",
+          "name", FieldName(field));
       } else {
         printer->Print(
           "if (has_$name$()) {\n"
@@ -87,13 +87,18 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "}\n"
     "inline $type$* $classname$::mutable_$name$() {\n"
     "  set_has_$name$();\n"
-    "  if ($name$_ == NULL) $name$_ = new $type$;\n"
+    "  if ($name$_ == NULL) {\n"
+    "    $name$_ = ::google::protobuf::Arena::CreateMessage< $type$ >(_arena_);\n"
+    "  }\n"
     "  return $name$_;\n"
     "}\n"
     "inline $type$* $classname$::release_$name$() {\n"
     "  clear_has_$name$();\n"
     "  $type$* temp = $name$_;\n"
     "  $name$_ = NULL;\n"
+    "  if (_arena_ != NULL && temp != NULL) {\n"
+    "    temp = new $type$(*temp);\n"
+    "  }\n"
     "  return temp;\n"
     "}\n");
 }
@@ -158,6 +163,99 @@ GenerateByteSize(io::Printer* printer) const {
 
 // ===================================================================
 
+LazyMessageFieldGenerator::
+LazyMessageFieldGenerator(const FieldDescriptor* descriptor)
+  : descriptor_(descriptor) {
+  SetMessageVariables(descriptor, &variables_);
+}
+
+LazyMessageFieldGenerator::~LazyMessageFieldGenerator() {}
+
+void LazyMessageFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::LazyField $name$_;\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateAccessorDeclarations(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline const $type$& $name$() const$deprecation$;\n"
+    "inline $type$* mutable_$name$()$deprecation$;\n"
+    "inline $type$* release_$name$()$deprecation$;\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline const $type$& $classname$::$name$() const {\n"
+    "  return static_cast<const $type$&>(\n"
+    "      $name$_.Get($type$::default_instance()));\n"
+    "}\n"
+    "inline $type$* $classname$::mutable_$name$() {\n"
+    "  set_has_$name$();\n"
+    "  return static_cast<$type$*>(\n"
+    "      $name$_.Mutable($type$::default_instance()));\n"
+    "}\n"
+    "inline $type$* $classname$::release_$name$() {\n"
+    "  clear_has_$name$();\n"
+    "  return static_cast<$type$*>(\n"
+    "      $name$_.Release($type$::default_instance()));\n"
+    "}\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Clear();\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  printer->Print(variables_,
+    "set_has_$name$();\n"
+    "$name$_.MergeFrom(from.$name$_);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Swap(&other->$name$_);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.InternalSetArena(_arena_);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  // The bytes are kept as they are; they are parsed on first access.
+  printer->Print(variables_,
+    "DO_($name$_.MergeFromCodedStream(input));\n"
+    "set_has_$name$();\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  printer->Print(variables_,
+    "$name$_.WriteTo($number$, output);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  printer->Print(variables_,
+    "target = $name$_.WriteToArray($number$, target);\n");
+}
+
+void LazyMessageFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  printer->Print(variables_,
+    "int size = $name$_.ByteSize();\n"
+    "total_size += $tag_size$ + size +\n"
+    "  ::google::protobuf::io::CodedOutputStream::VarintSize32(size);\n");
+}
+
+// ===================================================================
+
 RepeatedMessageFieldGenerator::
 RepeatedMessageFieldGenerator(const FieldDescriptor* descriptor)
   : descriptor_(descriptor) {
@@ -225,7 +323,7 @@ GenerateSwappingCode(io::Printer* printer) const {
 
 void RepeatedMessageFieldGenerator::
 GenerateConstructorCode(io::Printer* printer) const {
-  // Not needed for repeated fields.
+  printer->Print(variables_, "$name$_.InternalSetArena(_arena_);\n");
 }
 
 void RepeatedMessageFieldGenerator::
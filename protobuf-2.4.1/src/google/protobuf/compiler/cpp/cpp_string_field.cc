@@ -80,12 +80,15 @@ void StringFieldGenerator::
 GenerateAccessorDeclarations(io::Printer* printer) const {
   // If we're using StringFieldGenerator for a field with a ctype, it's
   // because that ctype isn't actually implemented.  In particular, this is
-  // true of ctype=CORD and ctype=STRING_PIECE in the open source release.
-  // We aren't releasing Cord because it has too many Google-specific
-  // dependencies and we aren't releasing StringPiece because it's hardly
-  // useful outside of Google and because it would get confusing to have
-  // multiple instances of the StringPiece class in different libraries (PCRE
-  // already includes it for their C++ bindings, which came from Google).
+  // true of ctype=CORD, and of repeated fields with ctype=STRING_PIECE, in
+  // the open source release.  We aren't releasing Cord because it has too
+  // many Google-specific dependencies and we aren't releasing StringPiece
+  // because it's hardly useful outside of Google and because it would get
+  // confusing to have multiple instances of the StringPiece class in
+  // different libraries (PCRE already includes it for their C++ bindings,
+  // which came from Google).  Singular ctype=STRING_PIECE fields are
+  // generated by StringPieceFieldGenerator, below, using the library's own
+  // internal::StringPieceField instead.
   //
   // In any case, we make all the accessors private while still actually
   // using a string to represent the field internally.  This way, we can
@@ -127,14 +130,14 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "inline void $classname$::set_$name$(const ::std::string& value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == &$default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "}\n"
     "inline void $classname$::set_$name$(const char* value) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == &$default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);\n"
     "  }\n"
     "  $name$_->assign(value);\n"
     "}\n"
@@ -142,19 +145,18 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == &$default_variable$) {\n"
-    "    $name$_ = new ::std::string;\n"
+    "    $name$_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);\n"
     "  }\n"
     "  $name$_->assign(reinterpret_cast<const char*>(value), size);\n"
     "}\n"
     "inline ::std::string* $classname$::mutable_$name$() {\n"
     "  set_has_$name$();\n"
     "  if ($name$_ == &$default_variable$) {\n");
-  if (descriptor_->default_value_string().empty()) {
-    printer->Print(variables_,
-      "    $name$_ = new ::std::string;\n");
-  } else {
+  printer->Print(variables_,
+    "    $name$_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);\n");
+  if (!descriptor_->default_value_string().empty()) {
     printer->Print(variables_,
-      "    $name$_ = new ::std::string($default_variable$);\n");
+      "    $name$_->assign($default_variable$);\n");
   }
   printer->Print(variables_,
     "  }\n"
@@ -167,6 +169,9 @@ GenerateInlineAccessorDefinitions(io::Printer* printer) const {
     "  } else {\n"
     "    ::std::string* temp = $name$_;\n"
     "    $name$_ = const_cast< ::std::string*>(&$default_variable$);\n"
+    "    if (_arena_ != NULL) {\n"
+    "      temp = new ::std::string(*temp);\n"
+    "    }\n"
     "    return temp;\n"
     "  }\n"
     "}\n");
@@ -272,6 +277,153 @@ GenerateByteSize(io::Printer* printer) const {
 
 // ===================================================================
 
+StringPieceFieldGenerator::
+StringPieceFieldGenerator(const FieldDescriptor* descriptor)
+  : descriptor_(descriptor) {
+  SetStringVariables(descriptor, &variables_);
+  variables_["default_length"] =
+      SimpleItoa(descriptor->default_value_string().size());
+}
+
+StringPieceFieldGenerator::~StringPieceFieldGenerator() {}
+
+void StringPieceFieldGenerator::
+GeneratePrivateMembers(io::Printer* printer) const {
+  printer->Print(variables_,
+    "::google::protobuf::internal::StringPieceField $name$_;\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateAccessorDeclarations(io::Printer* printer) const {
+  // The set_alias_ accessor points the field at bytes the caller keeps
+  // alive, as parsing does when the input has aliasing enabled.
+  printer->Print(variables_,
+    "inline const ::google::protobuf::internal::StringPieceField& $name$() const"
+                 "$deprecation$;\n"
+    "inline void set_$name$(const ::std::string& value)$deprecation$;\n"
+    "inline void set_$name$(const char* value)$deprecation$;\n"
+    "inline void set_$name$(const $pointer_type$* value, size_t size)"
+                 "$deprecation$;\n"
+    "inline void set_alias_$name$(const $pointer_type$* value, size_t size)"
+                 "$deprecation$;\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateInlineAccessorDefinitions(io::Printer* printer) const {
+  printer->Print(variables_,
+    "inline const ::google::protobuf::internal::StringPieceField&\n"
+    "$classname$::$name$() const {\n"
+    "  return $name$_;\n"
+    "}\n"
+    "inline void $classname$::set_$name$(const ::std::string& value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(value);\n"
+    "}\n"
+    "inline void $classname$::set_$name$(const char* value) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(value);\n"
+    "}\n"
+    "inline "
+    "void $classname$::set_$name$(const $pointer_type$* value, size_t size) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.Set(reinterpret_cast<const char*>(value), size);\n"
+    "}\n"
+    "inline void $classname$::set_alias_$name$(\n"
+    "    const $pointer_type$* value, size_t size) {\n"
+    "  set_has_$name$();\n"
+    "  $name$_.SetAlias(reinterpret_cast<const char*>(value), size);\n"
+    "}\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSetToDefault(io::Printer* printer) const {
+  // A non-empty default value is aliased, like the string literal it is.
+  if (descriptor_->default_value_string().empty()) {
+    printer->Print(variables_, "$name$_.Clear();\n");
+  } else {
+    printer->Print(variables_,
+      "$name$_.SetAlias($default$, $default_length$);\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateClearingCode(io::Printer* printer) const {
+  GenerateSetToDefault(printer);
+}
+
+void StringPieceFieldGenerator::
+GenerateMergingCode(io::Printer* printer) const {
+  // The value is copied: from may alias input that this message outlives.
+  printer->Print(variables_,
+    "set_$name$(from.$name$().data(), from.$name$().size());\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSwappingCode(io::Printer* printer) const {
+  printer->Print(variables_, "$name$_.Swap(&other->$name$_);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateConstructorCode(io::Printer* printer) const {
+  if (!descriptor_->default_value_string().empty()) {
+    GenerateSetToDefault(printer);
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateMergeFromCodedStream(io::Printer* printer) const {
+  printer->Print(variables_,
+    "DO_(::google::protobuf::internal::WireFormatLite::Read$declared_type$(\n"
+    "      input, &$name$_));\n"
+    "set_has_$name$();\n");
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().size(),\n"
+      "  ::google::protobuf::internal::WireFormat::PARSE);\n");
+  }
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizes(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().size(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_,
+    "::google::protobuf::internal::WireFormatLite::Write$declared_type$(\n"
+    "  $number$, this->$name$(), output);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const {
+  if (HasUtf8Verification(descriptor_->file()) &&
+      descriptor_->type() == FieldDescriptor::TYPE_STRING) {
+    printer->Print(variables_,
+      "::google::protobuf::internal::WireFormat::VerifyUTF8String(\n"
+      "  this->$name$().data(), this->$name$().size(),\n"
+      "  ::google::protobuf::internal::WireFormat::SERIALIZE);\n");
+  }
+  printer->Print(variables_,
+    "target =\n"
+    "  ::google::protobuf::internal::WireFormatLite::Write$declared_type$ToArray(\n"
+    "    $number$, this->$name$(), target);\n");
+}
+
+void StringPieceFieldGenerator::
+GenerateByteSize(io::Printer* printer) const {
+  printer->Print(variables_,
+    "total_size += $tag_size$ +\n"
+    "  ::google::protobuf::internal::WireFormatLite::$declared_type$Size(\n"
+    "    this->$name$());\n");
+}
+
+// ===================================================================
+
 RepeatedStringFieldGenerator::
 RepeatedStringFieldGenerator(const FieldDescriptor* descriptor)
   : descriptor_(descriptor) {
@@ -386,7 +538,7 @@ GenerateSwappingCode(io::Printer* printer) const {
 
 void RepeatedStringFieldGenerator::
 GenerateConstructorCode(io::Printer* printer) const {
-  // Not needed for repeated fields.
+  printer->Print(variables_, "$name$_.InternalSetArena(_arena_);\n");
 }
 
 void RepeatedStringFieldGenerator::
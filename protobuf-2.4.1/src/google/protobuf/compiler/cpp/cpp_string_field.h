@@ -71,6 +71,36 @@ class StringFieldGenerator : public FieldGenerator {
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(StringFieldGenerator);
 };
 
+// A singular string field with [ctype=STRING_PIECE], stored as an
+// internal::StringPieceField.
+class StringPieceFieldGenerator : public FieldGenerator {
+ public:
+  explicit StringPieceFieldGenerator(const FieldDescriptor* descriptor);
+  ~StringPieceFieldGenerator();
+
+  // implements FieldGenerator ---------------------------------------
+  void GeneratePrivateMembers(io::Printer* printer) const;
+  void GenerateAccessorDeclarations(io::Printer* printer) const;
+  void GenerateInlineAccessorDefinitions(io::Printer* printer) const;
+  void GenerateClearingCode(io::Printer* printer) const;
+  void GenerateMergingCode(io::Printer* printer) const;
+  void GenerateSwappingCode(io::Printer* printer) const;
+  void GenerateConstructorCode(io::Printer* printer) const;
+  void GenerateMergeFromCodedStream(io::Printer* printer) const;
+  void GenerateSerializeWithCachedSizes(io::Printer* printer) const;
+  void GenerateSerializeWithCachedSizesToArray(io::Printer* printer) const;
+  void GenerateByteSize(io::Printer* printer) const;
+
+ private:
+  // Prints code that resets the field to its default value.
+  void GenerateSetToDefault(io::Printer* printer) const;
+
+  const FieldDescriptor* descriptor_;
+  map<string, string> variables_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(StringPieceFieldGenerator);
+};
+
 class RepeatedStringFieldGenerator : public FieldGenerator {
  public:
   explicit RepeatedStringFieldGenerator(const FieldDescriptor* descriptor);
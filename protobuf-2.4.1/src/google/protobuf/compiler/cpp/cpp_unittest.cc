@@ -244,6 +244,213 @@ TEST(GeneratedMessageTest, ReleaseMessage) {
   EXPECT_FALSE(message.has_optional_nested_message());
 }
 
+TEST(GeneratedMessageTest, LazyField) {
+  // A lazy field has the same accessors and values as an eager one.
+  unittest::TestLazyMessage message;
+  EXPECT_FALSE(message.has_lazy_child());
+  EXPECT_EQ(&unittest::TestAllTypes::default_instance(),
+            &message.lazy_child());
+
+  TestUtil::SetAllFields(message.mutable_lazy_child());
+  TestUtil::SetAllFields(message.mutable_eager_child());
+  EXPECT_TRUE(message.has_lazy_child());
+  TestUtil::ExpectAllFieldsSet(message.lazy_child());
+
+  string data = message.SerializeAsString();
+  unittest::TestLazyMessage parsed;
+  ASSERT_TRUE(parsed.ParseFromString(data));
+  EXPECT_TRUE(parsed.has_lazy_child());
+  EXPECT_EQ(data, parsed.SerializeAsString());
+  TestUtil::ExpectAllFieldsSet(parsed.lazy_child());
+  TestUtil::ExpectAllFieldsSet(parsed.eager_child());
+
+  TestUtil::ModifyRepeatedFields(parsed.mutable_lazy_child());
+  TestUtil::ExpectRepeatedFieldsModified(parsed.lazy_child());
+
+  parsed.clear_lazy_child();
+  EXPECT_FALSE(parsed.has_lazy_child());
+  TestUtil::ExpectClear(parsed.lazy_child());
+}
+
+TEST(GeneratedMessageTest, LazyFieldKeepsBytes) {
+  // Until it is modified, a lazy field is serialized from the bytes it was
+  // parsed from, even ones that serializing the parsed message would not
+  // reproduce.  Here the sub-message sets optional_int32 twice.
+  unittest::TestAllTypes first, second;
+  first.set_optional_int32(1);
+  second.set_optional_int32(2);
+  string child = first.SerializeAsString() + second.SerializeAsString();
+  string data = "\x0a" + string(1, static_cast<char>(child.size())) + child;
+
+  unittest::TestLazyMessage message;
+  ASSERT_TRUE(message.ParseFromString(data));
+  EXPECT_EQ(data, message.SerializeAsString());
+
+  // Reading the field does not change the bytes.
+  EXPECT_EQ(2, message.lazy_child().optional_int32());
+  EXPECT_EQ(data, message.SerializeAsString());
+
+  // Modifying it does.
+  message.mutable_lazy_child()->set_optional_int64(3);
+  unittest::TestLazyMessage expected;
+  expected.mutable_lazy_child()->set_optional_int32(2);
+  expected.mutable_lazy_child()->set_optional_int64(3);
+  EXPECT_EQ(expected.SerializeAsString(), message.SerializeAsString());
+}
+
+TEST(GeneratedMessageTest, LazyFieldMerge) {
+  unittest::TestLazyMessage message1, message2;
+  message1.mutable_lazy_child()->set_optional_int32(1);
+  message1.mutable_lazy_child()->add_repeated_int32(1);
+  message2.mutable_lazy_child()->set_optional_int64(2);
+  message2.mutable_lazy_child()->add_repeated_int32(2);
+
+  // The field occurs twice in the input.
+  unittest::TestLazyMessage merged;
+  ASSERT_TRUE(merged.ParseFromString(message1.SerializeAsString() +
+                                     message2.SerializeAsString()));
+
+  // Merge an unparsed field into an empty one and into an unparsed one.
+  unittest::TestLazyMessage twice;
+  twice.MergeFrom(merged);
+  twice.MergeFrom(merged);
+  ASSERT_EQ(4, twice.lazy_child().repeated_int32_size());
+  EXPECT_EQ(2, twice.lazy_child().repeated_int32(3));
+
+  EXPECT_EQ(1, merged.lazy_child().optional_int32());
+  EXPECT_EQ(2, merged.lazy_child().optional_int64());
+  ASSERT_EQ(2, merged.lazy_child().repeated_int32_size());
+  EXPECT_EQ(1, merged.lazy_child().repeated_int32(0));
+  EXPECT_EQ(2, merged.lazy_child().repeated_int32(1));
+
+  // Merge a modified field into an unparsed one, and the other way around.
+  unittest::TestLazyMessage parsed1;
+  ASSERT_TRUE(parsed1.ParseFromString(message1.SerializeAsString()));
+  parsed1.MergeFrom(message2);
+  message2.MergeFrom(merged);
+  EXPECT_EQ(1, parsed1.lazy_child().optional_int32());
+  EXPECT_EQ(2, parsed1.lazy_child().optional_int64());
+  ASSERT_EQ(2, parsed1.lazy_child().repeated_int32_size());
+  EXPECT_EQ(1, message2.lazy_child().optional_int32());
+  ASSERT_EQ(3, message2.lazy_child().repeated_int32_size());
+}
+
+TEST(GeneratedMessageTest, LazyFieldRequired) {
+  // Missing required fields in a lazy field are not noticed until it is
+  // parsed.
+  unittest::TestLazyMessage message;
+  message.mutable_lazy_required()->set_a(1);
+  EXPECT_FALSE(message.IsInitialized());
+
+  unittest::TestLazyMessage parsed;
+  ASSERT_TRUE(parsed.ParseFromString(message.SerializePartialAsString()));
+  EXPECT_TRUE(parsed.IsInitialized());
+  EXPECT_EQ(1, parsed.lazy_required().a());
+  EXPECT_FALSE(parsed.IsInitialized());
+}
+
+TEST(GeneratedMessageTest, LazyFieldSwapAndRelease) {
+  unittest::TestLazyMessage message1, message2;
+  TestUtil::SetAllFields(message1.mutable_lazy_child());
+  ASSERT_TRUE(message2.ParseFromString(message1.SerializeAsString()));
+  message1.Clear();
+  message1.mutable_lazy_child()->set_optional_int32(5);
+
+  message1.Swap(&message2);
+  TestUtil::ExpectAllFieldsSet(message1.lazy_child());
+  EXPECT_EQ(5, message2.lazy_child().optional_int32());
+
+  scoped_ptr<unittest::TestAllTypes> child(message1.release_lazy_child());
+  EXPECT_FALSE(message1.has_lazy_child());
+  TestUtil::ExpectAllFieldsSet(*child);
+  TestUtil::ExpectClear(message1.lazy_child());
+
+  unittest::TestLazyMessage empty;
+  EXPECT_EQ(NULL, empty.release_lazy_child());
+}
+
+TEST(GeneratedMessageTest, StringPieceField) {
+  unittest::TestAllTypes message;
+  EXPECT_FALSE(message.has_optional_string_piece());
+  EXPECT_TRUE(message.optional_string_piece().empty());
+  EXPECT_EQ("abc", message.default_string_piece().ToString());
+
+  message.set_optional_string_piece("foo");
+  message.set_default_string_piece(string("bar"));
+  EXPECT_TRUE(message.has_optional_string_piece());
+  EXPECT_EQ("foo", message.optional_string_piece().ToString());
+  EXPECT_EQ("bar", message.default_string_piece().ToString());
+
+  unittest::TestAllTypes copy(message);
+  message.Clear();
+  EXPECT_FALSE(message.has_optional_string_piece());
+  EXPECT_TRUE(message.optional_string_piece().empty());
+  EXPECT_EQ("abc", message.default_string_piece().ToString());
+  EXPECT_EQ("foo", copy.optional_string_piece().ToString());
+
+  message.Swap(&copy);
+  EXPECT_EQ("foo", message.optional_string_piece().ToString());
+  EXPECT_EQ("abc", copy.default_string_piece().ToString());
+
+  unittest::TestAllTypes parsed;
+  ASSERT_TRUE(parsed.ParseFromString(message.SerializeAsString()));
+  EXPECT_EQ("foo", parsed.optional_string_piece().ToString());
+  EXPECT_EQ("bar", parsed.default_string_piece().ToString());
+}
+
+TEST(GeneratedMessageTest, StringPieceFieldAliasing) {
+  unittest::TestAllTypes message;
+  message.set_optional_string(string(100, 'a'));
+  message.set_optional_string_piece(string(100, 'b'));
+  string data = message.SerializeAsString();
+  const char* begin = data.data();
+  const char* end = data.data() + data.size();
+
+  {
+    // Without aliasing, the value is copied.
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(begin),
+                               data.size());
+    unittest::TestAllTypes parsed;
+    ASSERT_TRUE(parsed.MergeFromCodedStream(&input));
+    const char* value = parsed.optional_string_piece().data();
+    EXPECT_FALSE(value >= begin && value < end);
+    EXPECT_EQ(data, parsed.SerializeAsString());
+  }
+
+  {
+    // With it, the field points into the input.  Other strings are copied.
+    io::CodedInputStream input(reinterpret_cast<const uint8*>(begin),
+                               data.size());
+    input.EnableAliasing(true);
+    unittest::TestAllTypes parsed;
+    ASSERT_TRUE(parsed.MergeFromCodedStream(&input));
+    const char* value = parsed.optional_string_piece().data();
+    EXPECT_TRUE(value >= begin && value < end);
+    value = parsed.optional_string().data();
+    EXPECT_FALSE(value >= begin && value < end);
+    EXPECT_EQ(string(100, 'b'), parsed.optional_string_piece().ToString());
+    EXPECT_EQ(data, parsed.SerializeAsString());
+
+    // Copying the message copies the value.
+    unittest::TestAllTypes copy(parsed);
+    value = copy.optional_string_piece().data();
+    EXPECT_FALSE(value >= begin && value < end);
+    EXPECT_EQ(string(100, 'b'), copy.optional_string_piece().ToString());
+  }
+
+  {
+    // A value split across the buffers of the underlying stream is copied.
+    io::ArrayInputStream array(begin, data.size(), 64);
+    io::CodedInputStream input(&array);
+    input.EnableAliasing(true);
+    unittest::TestAllTypes parsed;
+    ASSERT_TRUE(parsed.MergeFromCodedStream(&input));
+    const char* value = parsed.optional_string_piece().data();
+    EXPECT_FALSE(value >= begin && value < end);
+    EXPECT_EQ(string(100, 'b'), parsed.optional_string_piece().ToString());
+  }
+}
+
 TEST(GeneratedMessageTest, Clear) {
   // Set every field to a unique value, clear the message, then check that
   // it is cleared.
@@ -713,6 +920,68 @@ TEST(GeneratedMessageTest, TestOptimizedForSize) {
   EXPECT_EQ(2, message2.msg().c());
 }
 
+TEST(GeneratedMessageTest, ParseOptimizedForSize) {
+  // Messages optimized for size parse from a table.  Check that this reads
+  // every kind of field the same way the reflection-based parser does.
+  protobuf_unittest::TestAllKindsOptimizedForSize message, message2;
+  message.set_int32_value(-1);
+  message.set_sint64_value(-123456789012LL);
+  message.set_fixed32_value(7);
+  message.set_double_value(1.5);
+  message.set_bool_value(true);
+  message.set_string_value("foo");
+  message.set_bytes_value("bar");
+  message.set_enum_value(unittest::FOREIGN_BAZ);
+  message.mutable_message_value()->set_c(1);
+  message.mutable_groupvalue()->set_a(2);
+  message.add_repeated_int32(3);
+  message.add_repeated_int32(4);
+  message.add_packed_sint32(-5);
+  message.add_packed_sint32(6);
+  message.add_repeated_string("baz");
+  message.add_repeated_message()->set_c(7);
+  message.set_string_piece_value("qux");
+  message.mutable_lazy_message()->set_c(8);
+
+  // Follow with a packed field's value sent unpacked, an undefined enum
+  // value and an unknown field.
+  string data = message.SerializeAsString();
+  data.append("\x68\x0e", 2);      // packed_sint32: 7
+  data.append("\x40\x63", 2);      // enum_value: 99
+  data.append("\xa0\x06\x01", 3);  // 100: 1
+
+  ASSERT_TRUE(message2.ParseFromString(data));
+  EXPECT_EQ(-1, message2.int32_value());
+  EXPECT_EQ(-123456789012LL, message2.sint64_value());
+  EXPECT_EQ(7, message2.fixed32_value());
+  EXPECT_EQ(1.5, message2.double_value());
+  EXPECT_TRUE(message2.bool_value());
+  EXPECT_EQ("foo", message2.string_value());
+  EXPECT_EQ("bar", message2.bytes_value());
+  EXPECT_EQ(unittest::FOREIGN_BAZ, message2.enum_value());
+  EXPECT_EQ(1, message2.message_value().c());
+  EXPECT_EQ(2, message2.groupvalue().a());
+  ASSERT_EQ(2, message2.repeated_int32_size());
+  EXPECT_EQ(4, message2.repeated_int32(1));
+  ASSERT_EQ(3, message2.packed_sint32_size());
+  EXPECT_EQ(-5, message2.packed_sint32(0));
+  EXPECT_EQ(7, message2.packed_sint32(2));
+  ASSERT_EQ(1, message2.repeated_string_size());
+  EXPECT_EQ("baz", message2.repeated_string(0));
+  ASSERT_EQ(1, message2.repeated_message_size());
+  EXPECT_EQ(7, message2.repeated_message(0).c());
+  EXPECT_EQ("qux", message2.string_piece_value().ToString());
+  EXPECT_EQ(8, message2.lazy_message().c());
+  EXPECT_EQ(2, message2.unknown_fields().field_count());
+
+  DynamicMessageFactory factory;
+  scoped_ptr<Message> dynamic_message(
+      factory.GetPrototype(message.GetDescriptor())->New());
+  ASSERT_TRUE(dynamic_message->ParseFromString(data));
+  EXPECT_EQ(dynamic_message->SerializeAsString(),
+            message2.SerializeAsString());
+}
+
 TEST(GeneratedMessageTest, TestEmbedOptimizedForSize) {
   // Verifies that something optimized for speed can contain something optimized
   // for size.
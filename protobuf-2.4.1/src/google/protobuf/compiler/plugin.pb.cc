@@ -165,7 +165,12 @@ const int CodeGeneratorRequest::kProtoFileFieldNumber;
 #endif  // !_MSC_VER
 
 CodeGeneratorRequest::CodeGeneratorRequest()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+CodeGeneratorRequest::CodeGeneratorRequest(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -173,14 +178,16 @@ void CodeGeneratorRequest::InitAsDefaultInstance() {
 }
 
 CodeGeneratorRequest::CodeGeneratorRequest(const CodeGeneratorRequest& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void CodeGeneratorRequest::SharedCtor() {
   _cached_size_ = 0;
+  file_to_generate_.InternalSetArena(_arena_);
   parameter_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  proto_file_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -189,6 +196,7 @@ CodeGeneratorRequest::~CodeGeneratorRequest() {
 }
 
 void CodeGeneratorRequest::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (parameter_ != &::google::protobuf::internal::kEmptyString) {
     delete parameter_;
   }
@@ -216,6 +224,10 @@ CodeGeneratorRequest* CodeGeneratorRequest::New() const {
   return new CodeGeneratorRequest;
 }
 
+CodeGeneratorRequest* CodeGeneratorRequest::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<CodeGeneratorRequest>(arena);
+}
+
 void CodeGeneratorRequest::Clear() {
   if (_has_bits_[1 / 32] & (0xffu << (1 % 32))) {
     if (has_parameter()) {
@@ -453,6 +465,12 @@ bool CodeGeneratorRequest::IsInitialized() const {
 
 void CodeGeneratorRequest::Swap(CodeGeneratorRequest* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      CodeGeneratorRequest temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     file_to_generate_.Swap(&other->file_to_generate_);
     std::swap(parameter_, other->parameter_);
     proto_file_.Swap(&other->proto_file_);
@@ -480,7 +498,12 @@ const int CodeGeneratorResponse_File::kContentFieldNumber;
 #endif  // !_MSC_VER
 
 CodeGeneratorResponse_File::CodeGeneratorResponse_File()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+CodeGeneratorResponse_File::CodeGeneratorResponse_File(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -488,7 +511,7 @@ void CodeGeneratorResponse_File::InitAsDefaultInstance() {
 }
 
 CodeGeneratorResponse_File::CodeGeneratorResponse_File(const CodeGeneratorResponse_File& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -506,6 +529,7 @@ CodeGeneratorResponse_File::~CodeGeneratorResponse_File() {
 }
 
 void CodeGeneratorResponse_File::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -539,6 +563,10 @@ CodeGeneratorResponse_File* CodeGeneratorResponse_File::New() const {
   return new CodeGeneratorResponse_File;
 }
 
+CodeGeneratorResponse_File* CodeGeneratorResponse_File::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<CodeGeneratorResponse_File>(arena);
+}
+
 void CodeGeneratorResponse_File::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -791,6 +819,12 @@ bool CodeGeneratorResponse_File::IsInitialized() const {
 
 void CodeGeneratorResponse_File::Swap(CodeGeneratorResponse_File* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      CodeGeneratorResponse_File temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     std::swap(insertion_point_, other->insertion_point_);
     std::swap(content_, other->content_);
@@ -817,7 +851,12 @@ const int CodeGeneratorResponse::kFileFieldNumber;
 #endif  // !_MSC_VER
 
 CodeGeneratorResponse::CodeGeneratorResponse()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+CodeGeneratorResponse::CodeGeneratorResponse(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -825,7 +864,7 @@ void CodeGeneratorResponse::InitAsDefaultInstance() {
 }
 
 CodeGeneratorResponse::CodeGeneratorResponse(const CodeGeneratorResponse& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -833,6 +872,7 @@ CodeGeneratorResponse::CodeGeneratorResponse(const CodeGeneratorResponse& from)
 void CodeGeneratorResponse::SharedCtor() {
   _cached_size_ = 0;
   error_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  file_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -841,6 +881,7 @@ CodeGeneratorResponse::~CodeGeneratorResponse() {
 }
 
 void CodeGeneratorResponse::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (error_ != &::google::protobuf::internal::kEmptyString) {
     delete error_;
   }
@@ -868,6 +909,10 @@ CodeGeneratorResponse* CodeGeneratorResponse::New() const {
   return new CodeGeneratorResponse;
 }
 
+CodeGeneratorResponse* CodeGeneratorResponse::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<CodeGeneratorResponse>(arena);
+}
+
 void CodeGeneratorResponse::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_error()) {
@@ -1056,6 +1101,12 @@ bool CodeGeneratorResponse::IsInitialized() const {
 
 void CodeGeneratorResponse::Swap(CodeGeneratorResponse* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      CodeGeneratorResponse temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(error_, other->error_);
     file_.Swap(&other->file_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
@@ -19,7 +19,10 @@
 #error regenerate this file with a newer version of protoc.
 #endif
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/generated_message_reflection.h>
@@ -66,9 +69,13 @@ class LIBPROTOC_EXPORT CodeGeneratorRequest : public ::google::protobuf::Message
   
   void Swap(CodeGeneratorRequest* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   CodeGeneratorRequest* New() const;
+  CodeGeneratorRequest* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const CodeGeneratorRequest& from);
@@ -84,6 +91,8 @@ class LIBPROTOC_EXPORT CodeGeneratorRequest : public ::google::protobuf::Message
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit CodeGeneratorRequest(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -139,6 +148,8 @@ class LIBPROTOC_EXPORT CodeGeneratorRequest : public ::google::protobuf::Message
   inline void set_has_parameter();
   inline void clear_has_parameter();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::google::protobuf::RepeatedPtrField< ::std::string> file_to_generate_;
@@ -182,9 +193,13 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse_File : public ::google::protobuf::M
   
   void Swap(CodeGeneratorResponse_File* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   CodeGeneratorResponse_File* New() const;
+  CodeGeneratorResponse_File* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const CodeGeneratorResponse_File& from);
@@ -200,6 +215,8 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse_File : public ::google::protobuf::M
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit CodeGeneratorResponse_File(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -253,6 +270,8 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse_File : public ::google::protobuf::M
   inline void set_has_content();
   inline void clear_has_content();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -296,9 +315,13 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse : public ::google::protobuf::Messag
   
   void Swap(CodeGeneratorResponse* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   CodeGeneratorResponse* New() const;
+  CodeGeneratorResponse* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const CodeGeneratorResponse& from);
@@ -314,6 +337,8 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse : public ::google::protobuf::Messag
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit CodeGeneratorResponse(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -355,6 +380,8 @@ class LIBPROTOC_EXPORT CodeGeneratorResponse : public ::google::protobuf::Messag
   inline void set_has_error();
   inline void clear_has_error();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* error_;
@@ -443,28 +470,28 @@ inline const ::std::string& CodeGeneratorRequest::parameter() const {
 inline void CodeGeneratorRequest::set_parameter(const ::std::string& value) {
   set_has_parameter();
   if (parameter_ == &::google::protobuf::internal::kEmptyString) {
-    parameter_ = new ::std::string;
+    parameter_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   parameter_->assign(value);
 }
 inline void CodeGeneratorRequest::set_parameter(const char* value) {
   set_has_parameter();
   if (parameter_ == &::google::protobuf::internal::kEmptyString) {
-    parameter_ = new ::std::string;
+    parameter_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   parameter_->assign(value);
 }
 inline void CodeGeneratorRequest::set_parameter(const char* value, size_t size) {
   set_has_parameter();
   if (parameter_ == &::google::protobuf::internal::kEmptyString) {
-    parameter_ = new ::std::string;
+    parameter_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   parameter_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* CodeGeneratorRequest::mutable_parameter() {
   set_has_parameter();
   if (parameter_ == &::google::protobuf::internal::kEmptyString) {
-    parameter_ = new ::std::string;
+    parameter_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return parameter_;
 }
@@ -475,6 +502,9 @@ inline ::std::string* CodeGeneratorRequest::release_parameter() {
   } else {
     ::std::string* temp = parameter_;
     parameter_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -530,28 +560,28 @@ inline const ::std::string& CodeGeneratorResponse_File::name() const {
 inline void CodeGeneratorResponse_File::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void CodeGeneratorResponse_File::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void CodeGeneratorResponse_File::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* CodeGeneratorResponse_File::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -562,6 +592,9 @@ inline ::std::string* CodeGeneratorResponse_File::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -588,28 +621,28 @@ inline const ::std::string& CodeGeneratorResponse_File::insertion_point() const
 inline void CodeGeneratorResponse_File::set_insertion_point(const ::std::string& value) {
   set_has_insertion_point();
   if (insertion_point_ == &::google::protobuf::internal::kEmptyString) {
-    insertion_point_ = new ::std::string;
+    insertion_point_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   insertion_point_->assign(value);
 }
 inline void CodeGeneratorResponse_File::set_insertion_point(const char* value) {
   set_has_insertion_point();
   if (insertion_point_ == &::google::protobuf::internal::kEmptyString) {
-    insertion_point_ = new ::std::string;
+    insertion_point_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   insertion_point_->assign(value);
 }
 inline void CodeGeneratorResponse_File::set_insertion_point(const char* value, size_t size) {
   set_has_insertion_point();
   if (insertion_point_ == &::google::protobuf::internal::kEmptyString) {
-    insertion_point_ = new ::std::string;
+    insertion_point_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   insertion_point_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* CodeGeneratorResponse_File::mutable_insertion_point() {
   set_has_insertion_point();
   if (insertion_point_ == &::google::protobuf::internal::kEmptyString) {
-    insertion_point_ = new ::std::string;
+    insertion_point_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return insertion_point_;
 }
@@ -620,6 +653,9 @@ inline ::std::string* CodeGeneratorResponse_File::release_insertion_point() {
   } else {
     ::std::string* temp = insertion_point_;
     insertion_point_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -646,28 +682,28 @@ inline const ::std::string& CodeGeneratorResponse_File::content() const {
 inline void CodeGeneratorResponse_File::set_content(const ::std::string& value) {
   set_has_content();
   if (content_ == &::google::protobuf::internal::kEmptyString) {
-    content_ = new ::std::string;
+    content_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   content_->assign(value);
 }
 inline void CodeGeneratorResponse_File::set_content(const char* value) {
   set_has_content();
   if (content_ == &::google::protobuf::internal::kEmptyString) {
-    content_ = new ::std::string;
+    content_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   content_->assign(value);
 }
 inline void CodeGeneratorResponse_File::set_content(const char* value, size_t size) {
   set_has_content();
   if (content_ == &::google::protobuf::internal::kEmptyString) {
-    content_ = new ::std::string;
+    content_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   content_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* CodeGeneratorResponse_File::mutable_content() {
   set_has_content();
   if (content_ == &::google::protobuf::internal::kEmptyString) {
-    content_ = new ::std::string;
+    content_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return content_;
 }
@@ -678,6 +714,9 @@ inline ::std::string* CodeGeneratorResponse_File::release_content() {
   } else {
     ::std::string* temp = content_;
     content_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -708,28 +747,28 @@ inline const ::std::string& CodeGeneratorResponse::error() const {
 inline void CodeGeneratorResponse::set_error(const ::std::string& value) {
   set_has_error();
   if (error_ == &::google::protobuf::internal::kEmptyString) {
-    error_ = new ::std::string;
+    error_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   error_->assign(value);
 }
 inline void CodeGeneratorResponse::set_error(const char* value) {
   set_has_error();
   if (error_ == &::google::protobuf::internal::kEmptyString) {
-    error_ = new ::std::string;
+    error_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   error_->assign(value);
 }
 inline void CodeGeneratorResponse::set_error(const char* value, size_t size) {
   set_has_error();
   if (error_ == &::google::protobuf::internal::kEmptyString) {
-    error_ = new ::std::string;
+    error_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   error_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* CodeGeneratorResponse::mutable_error() {
   set_has_error();
   if (error_ == &::google::protobuf::internal::kEmptyString) {
-    error_ = new ::std::string;
+    error_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return error_;
 }
@@ -740,6 +779,9 @@ inline ::std::string* CodeGeneratorResponse::release_error() {
   } else {
     ::std::string* temp = error_;
     error_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
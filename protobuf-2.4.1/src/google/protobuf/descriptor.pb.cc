@@ -302,9 +302,10 @@ void protobuf_AssignDesc_google_2fprotobuf_2fdescriptor_2eproto() {
       ::google::protobuf::MessageFactory::generated_factory(),
       sizeof(MessageOptions));
   FieldOptions_descriptor_ = file->message_type(10);
-  static const int FieldOptions_offsets_[5] = {
+  static const int FieldOptions_offsets_[6] = {
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, ctype_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, packed_),
+    GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, lazy_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, deprecated_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, experimental_map_key_),
     GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(FieldOptions, uninterpreted_option_),
@@ -625,35 +626,36 @@ void protobuf_AddDesc_google_2fprotobuf_2fdescriptor_2eproto() {
     "false\022.\n\037no_standard_descriptor_accessor"
     "\030\002 \001(\010:\005false\022C\n\024uninterpreted_option\030\347\007"
     " \003(\0132$.google.protobuf.UninterpretedOpti"
-    "on*\t\010\350\007\020\200\200\200\200\002\"\224\002\n\014FieldOptions\022:\n\005ctype\030"
+    "on*\t\010\350\007\020\200\200\200\200\002\"\251\002\n\014FieldOptions\022:\n\005ctype\030"
     "\001 \001(\0162#.google.protobuf.FieldOptions.CTy"
-    "pe:\006STRING\022\016\n\006packed\030\002 \001(\010\022\031\n\ndeprecated"
-    "\030\003 \001(\010:\005false\022\034\n\024experimental_map_key\030\t "
-    "\001(\t\022C\n\024uninterpreted_option\030\347\007 \003(\0132$.goo"
-    "gle.protobuf.UninterpretedOption\"/\n\005CTyp"
-    "e\022\n\n\006STRING\020\000\022\010\n\004CORD\020\001\022\020\n\014STRING_PIECE\020"
-    "\002*\t\010\350\007\020\200\200\200\200\002\"]\n\013EnumOptions\022C\n\024uninterpr"
-    "eted_option\030\347\007 \003(\0132$.google.protobuf.Uni"
-    "nterpretedOption*\t\010\350\007\020\200\200\200\200\002\"b\n\020EnumValue"
-    "Options\022C\n\024uninterpreted_option\030\347\007 \003(\0132$"
-    ".google.protobuf.UninterpretedOption*\t\010\350"
-    "\007\020\200\200\200\200\002\"`\n\016ServiceOptions\022C\n\024uninterpret"
-    "ed_option\030\347\007 \003(\0132$.google.protobuf.Unint"
-    "erpretedOption*\t\010\350\007\020\200\200\200\200\002\"_\n\rMethodOptio"
-    "ns\022C\n\024uninterpreted_option\030\347\007 \003(\0132$.goog"
-    "le.protobuf.UninterpretedOption*\t\010\350\007\020\200\200\200"
-    "\200\002\"\236\002\n\023UninterpretedOption\022;\n\004name\030\002 \003(\013"
-    "2-.google.protobuf.UninterpretedOption.N"
-    "amePart\022\030\n\020identifier_value\030\003 \001(\t\022\032\n\022pos"
-    "itive_int_value\030\004 \001(\004\022\032\n\022negative_int_va"
-    "lue\030\005 \001(\003\022\024\n\014double_value\030\006 \001(\001\022\024\n\014strin"
-    "g_value\030\007 \001(\014\022\027\n\017aggregate_value\030\010 \001(\t\0323"
-    "\n\010NamePart\022\021\n\tname_part\030\001 \002(\t\022\024\n\014is_exte"
-    "nsion\030\002 \002(\010\"|\n\016SourceCodeInfo\022:\n\010locatio"
-    "n\030\001 \003(\0132(.google.protobuf.SourceCodeInfo"
-    ".Location\032.\n\010Location\022\020\n\004path\030\001 \003(\005B\002\020\001\022"
-    "\020\n\004span\030\002 \003(\005B\002\020\001B)\n\023com.google.protobuf"
-    "B\020DescriptorProtosH\001", 3940);
+    "pe:\006STRING\022\016\n\006packed\030\002 \001(\010\022\023\n\004lazy\030\005 \001(\010"
+    ":\005false\022\031\n\ndeprecated\030\003 \001(\010:\005false\022\034\n\024ex"
+    "perimental_map_key\030\t \001(\t\022C\n\024uninterprete"
+    "d_option\030\347\007 \003(\0132$.google.protobuf.Uninte"
+    "rpretedOption\"/\n\005CType\022\n\n\006STRING\020\000\022\010\n\004CO"
+    "RD\020\001\022\020\n\014STRING_PIECE\020\002*\t\010\350\007\020\200\200\200\200\002\"]\n\013Enu"
+    "mOptions\022C\n\024uninterpreted_option\030\347\007 \003(\0132"
+    "$.google.protobuf.UninterpretedOption*\t\010"
+    "\350\007\020\200\200\200\200\002\"b\n\020EnumValueOptions\022C\n\024uninterp"
+    "reted_option\030\347\007 \003(\0132$.google.protobuf.Un"
+    "interpretedOption*\t\010\350\007\020\200\200\200\200\002\"`\n\016ServiceO"
+    "ptions\022C\n\024uninterpreted_option\030\347\007 \003(\0132$."
+    "google.protobuf.UninterpretedOption*\t\010\350\007"
+    "\020\200\200\200\200\002\"_\n\rMethodOptions\022C\n\024uninterpreted"
+    "_option\030\347\007 \003(\0132$.google.protobuf.Uninter"
+    "pretedOption*\t\010\350\007\020\200\200\200\200\002\"\236\002\n\023Uninterprete"
+    "dOption\022;\n\004name\030\002 \003(\0132-.google.protobuf."
+    "UninterpretedOption.NamePart\022\030\n\020identifi"
+    "er_value\030\003 \001(\t\022\032\n\022positive_int_value\030\004 \001"
+    "(\004\022\032\n\022negative_int_value\030\005 \001(\003\022\024\n\014double"
+    "_value\030\006 \001(\001\022\024\n\014string_value\030\007 \001(\014\022\027\n\017ag"
+    "gregate_value\030\010 \001(\t\0323\n\010NamePart\022\021\n\tname_"
+    "part\030\001 \002(\t\022\024\n\014is_extension\030\002 \002(\010\"|\n\016Sour"
+    "ceCodeInfo\022:\n\010location\030\001 \003(\0132(.google.pr"
+    "otobuf.SourceCodeInfo.Location\032.\n\010Locati"
+    "on\022\020\n\004path\030\001 \003(\005B\002\020\001\022\020\n\004span\030\002 \003(\005B\002\020\001B)"
+    "\n\023com.google.protobufB\020DescriptorProtosH"
+    "\001", 3961);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "google/protobuf/descriptor.proto", &protobuf_RegisterTypes);
   FileDescriptorSet::default_instance_ = new FileDescriptorSet();
@@ -714,7 +716,12 @@ const int FileDescriptorSet::kFileFieldNumber;
 #endif  // !_MSC_VER
 
 FileDescriptorSet::FileDescriptorSet()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+FileDescriptorSet::FileDescriptorSet(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -722,13 +729,14 @@ void FileDescriptorSet::InitAsDefaultInstance() {
 }
 
 FileDescriptorSet::FileDescriptorSet(const FileDescriptorSet& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void FileDescriptorSet::SharedCtor() {
   _cached_size_ = 0;
+  file_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -737,6 +745,7 @@ FileDescriptorSet::~FileDescriptorSet() {
 }
 
 void FileDescriptorSet::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -761,6 +770,10 @@ FileDescriptorSet* FileDescriptorSet::New() const {
   return new FileDescriptorSet;
 }
 
+FileDescriptorSet* FileDescriptorSet::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<FileDescriptorSet>(arena);
+}
+
 void FileDescriptorSet::Clear() {
   file_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -896,6 +909,12 @@ bool FileDescriptorSet::IsInitialized() const {
 
 void FileDescriptorSet::Swap(FileDescriptorSet* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      FileDescriptorSet temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     file_.Swap(&other->file_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -927,7 +946,12 @@ const int FileDescriptorProto::kSourceCodeInfoFieldNumber;
 #endif  // !_MSC_VER
 
 FileDescriptorProto::FileDescriptorProto()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+FileDescriptorProto::FileDescriptorProto(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -937,7 +961,7 @@ void FileDescriptorProto::InitAsDefaultInstance() {
 }
 
 FileDescriptorProto::FileDescriptorProto(const FileDescriptorProto& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -946,6 +970,11 @@ void FileDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
   package_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  dependency_.InternalSetArena(_arena_);
+  message_type_.InternalSetArena(_arena_);
+  enum_type_.InternalSetArena(_arena_);
+  service_.InternalSetArena(_arena_);
+  extension_.InternalSetArena(_arena_);
   options_ = NULL;
   source_code_info_ = NULL;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -956,6 +985,7 @@ FileDescriptorProto::~FileDescriptorProto() {
 }
 
 void FileDescriptorProto::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -988,6 +1018,10 @@ FileDescriptorProto* FileDescriptorProto::New() const {
   return new FileDescriptorProto;
 }
 
+FileDescriptorProto* FileDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<FileDescriptorProto>(arena);
+}
+
 void FileDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -1487,6 +1521,12 @@ bool FileDescriptorProto::IsInitialized() const {
 
 void FileDescriptorProto::Swap(FileDescriptorProto* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      FileDescriptorProto temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     std::swap(package_, other->package_);
     dependency_.Swap(&other->dependency_);
@@ -1519,7 +1559,12 @@ const int DescriptorProto_ExtensionRange::kEndFieldNumber;
 #endif  // !_MSC_VER
 
 DescriptorProto_ExtensionRange::DescriptorProto_ExtensionRange()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+DescriptorProto_ExtensionRange::DescriptorProto_ExtensionRange(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -1527,7 +1572,7 @@ void DescriptorProto_ExtensionRange::InitAsDefaultInstance() {
 }
 
 DescriptorProto_ExtensionRange::DescriptorProto_ExtensionRange(const DescriptorProto_ExtensionRange& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -1544,6 +1589,7 @@ DescriptorProto_ExtensionRange::~DescriptorProto_ExtensionRange() {
 }
 
 void DescriptorProto_ExtensionRange::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -1568,6 +1614,10 @@ DescriptorProto_ExtensionRange* DescriptorProto_ExtensionRange::New() const {
   return new DescriptorProto_ExtensionRange;
 }
 
+DescriptorProto_ExtensionRange* DescriptorProto_ExtensionRange::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<DescriptorProto_ExtensionRange>(arena);
+}
+
 void DescriptorProto_ExtensionRange::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     start_ = 0;
@@ -1741,6 +1791,12 @@ bool DescriptorProto_ExtensionRange::IsInitialized() const {
 
 void DescriptorProto_ExtensionRange::Swap(DescriptorProto_ExtensionRange* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      DescriptorProto_ExtensionRange temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(start_, other->start_);
     std::swap(end_, other->end_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
@@ -1771,7 +1827,12 @@ const int DescriptorProto::kOptionsFieldNumber;
 #endif  // !_MSC_VER
 
 DescriptorProto::DescriptorProto()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+DescriptorProto::DescriptorProto(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -1780,7 +1841,7 @@ void DescriptorProto::InitAsDefaultInstance() {
 }
 
 DescriptorProto::DescriptorProto(const DescriptorProto& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -1788,6 +1849,11 @@ DescriptorProto::DescriptorProto(const DescriptorProto& from)
 void DescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  field_.InternalSetArena(_arena_);
+  extension_.InternalSetArena(_arena_);
+  nested_type_.InternalSetArena(_arena_);
+  enum_type_.InternalSetArena(_arena_);
+  extension_range_.InternalSetArena(_arena_);
   options_ = NULL;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
@@ -1797,6 +1863,7 @@ DescriptorProto::~DescriptorProto() {
 }
 
 void DescriptorProto::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -1825,6 +1892,10 @@ DescriptorProto* DescriptorProto::New() const {
   return new DescriptorProto;
 }
 
+DescriptorProto* DescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<DescriptorProto>(arena);
+}
+
 void DescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -2220,6 +2291,12 @@ bool DescriptorProto::IsInitialized() const {
 
 void DescriptorProto::Swap(DescriptorProto* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      DescriptorProto temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     field_.Swap(&other->field_);
     extension_.Swap(&other->extension_);
@@ -2332,7 +2409,12 @@ const int FieldDescriptorProto::kOptionsFieldNumber;
 #endif  // !_MSC_VER
 
 FieldDescriptorProto::FieldDescriptorProto()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+FieldDescriptorProto::FieldDescriptorProto(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -2341,7 +2423,7 @@ void FieldDescriptorProto::InitAsDefaultInstance() {
 }
 
 FieldDescriptorProto::FieldDescriptorProto(const FieldDescriptorProto& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -2364,6 +2446,7 @@ FieldDescriptorProto::~FieldDescriptorProto() {
 }
 
 void FieldDescriptorProto::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -2401,6 +2484,10 @@ FieldDescriptorProto* FieldDescriptorProto::New() const {
   return new FieldDescriptorProto;
 }
 
+FieldDescriptorProto* FieldDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<FieldDescriptorProto>(arena);
+}
+
 void FieldDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -2870,6 +2957,12 @@ bool FieldDescriptorProto::IsInitialized() const {
 
 void FieldDescriptorProto::Swap(FieldDescriptorProto* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      FieldDescriptorProto temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     std::swap(number_, other->number_);
     std::swap(label_, other->label_);
@@ -2902,7 +2995,12 @@ const int EnumDescriptorProto::kOptionsFieldNumber;
 #endif  // !_MSC_VER
 
 EnumDescriptorProto::EnumDescriptorProto()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+EnumDescriptorProto::EnumDescriptorProto(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -2911,7 +3009,7 @@ void EnumDescriptorProto::InitAsDefaultInstance() {
 }
 
 EnumDescriptorProto::EnumDescriptorProto(const EnumDescriptorProto& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -2919,6 +3017,7 @@ EnumDescriptorProto::EnumDescriptorProto(const EnumDescriptorProto& from)
 void EnumDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  value_.InternalSetArena(_arena_);
   options_ = NULL;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
@@ -2928,6 +3027,7 @@ EnumDescriptorProto::~EnumDescriptorProto() {
 }
 
 void EnumDescriptorProto::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -2956,6 +3056,10 @@ EnumDescriptorProto* EnumDescriptorProto::New() const {
   return new EnumDescriptorProto;
 }
 
+EnumDescriptorProto* EnumDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<EnumDescriptorProto>(arena);
+}
+
 void EnumDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -3190,6 +3294,12 @@ bool EnumDescriptorProto::IsInitialized() const {
 
 void EnumDescriptorProto::Swap(EnumDescriptorProto* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      EnumDescriptorProto temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     value_.Swap(&other->value_);
     std::swap(options_, other->options_);
@@ -3217,7 +3327,12 @@ const int EnumValueDescriptorProto::kOptionsFieldNumber;
 #endif  // !_MSC_VER
 
 EnumValueDescriptorProto::EnumValueDescriptorProto()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+EnumValueDescriptorProto::EnumValueDescriptorProto(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -3226,7 +3341,7 @@ void EnumValueDescriptorProto::InitAsDefaultInstance() {
 }
 
 EnumValueDescriptorProto::EnumValueDescriptorProto(const EnumValueDescriptorProto& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -3244,6 +3359,7 @@ EnumValueDescriptorProto::~EnumValueDescriptorProto() {
 }
 
 void EnumValueDescriptorProto::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -3272,6 +3388,10 @@ EnumValueDescriptorProto* EnumValueDescriptorProto::New() const {
   return new EnumValueDescriptorProto;
 }
 
+EnumValueDescriptorProto* EnumValueDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<EnumValueDescriptorProto>(arena);
+}
+
 void EnumValueDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -3502,6 +3622,12 @@ bool EnumValueDescriptorProto::IsInitialized() const {
 
 void EnumValueDescriptorProto::Swap(EnumValueDescriptorProto* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      EnumValueDescriptorProto temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     std::swap(number_, other->number_);
     std::swap(options_, other->options_);
@@ -3529,7 +3655,12 @@ const int ServiceDescriptorProto::kOptionsFieldNumber;
 #endif  // !_MSC_VER
 
 ServiceDescriptorProto::ServiceDescriptorProto()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+ServiceDescriptorProto::ServiceDescriptorProto(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -3538,7 +3669,7 @@ void ServiceDescriptorProto::InitAsDefaultInstance() {
 }
 
 ServiceDescriptorProto::ServiceDescriptorProto(const ServiceDescriptorProto& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -3546,6 +3677,7 @@ ServiceDescriptorProto::ServiceDescriptorProto(const ServiceDescriptorProto& fro
 void ServiceDescriptorProto::SharedCtor() {
   _cached_size_ = 0;
   name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  method_.InternalSetArena(_arena_);
   options_ = NULL;
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
@@ -3555,6 +3687,7 @@ ServiceDescriptorProto::~ServiceDescriptorProto() {
 }
 
 void ServiceDescriptorProto::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -3583,6 +3716,10 @@ ServiceDescriptorProto* ServiceDescriptorProto::New() const {
   return new ServiceDescriptorProto;
 }
 
+ServiceDescriptorProto* ServiceDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<ServiceDescriptorProto>(arena);
+}
+
 void ServiceDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -3817,6 +3954,12 @@ bool ServiceDescriptorProto::IsInitialized() const {
 
 void ServiceDescriptorProto::Swap(ServiceDescriptorProto* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      ServiceDescriptorProto temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     method_.Swap(&other->method_);
     std::swap(options_, other->options_);
@@ -3845,7 +3988,12 @@ const int MethodDescriptorProto::kOptionsFieldNumber;
 #endif  // !_MSC_VER
 
 MethodDescriptorProto::MethodDescriptorProto()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+MethodDescriptorProto::MethodDescriptorProto(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -3854,7 +4002,7 @@ void MethodDescriptorProto::InitAsDefaultInstance() {
 }
 
 MethodDescriptorProto::MethodDescriptorProto(const MethodDescriptorProto& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -3873,6 +4021,7 @@ MethodDescriptorProto::~MethodDescriptorProto() {
 }
 
 void MethodDescriptorProto::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_ != &::google::protobuf::internal::kEmptyString) {
     delete name_;
   }
@@ -3907,6 +4056,10 @@ MethodDescriptorProto* MethodDescriptorProto::New() const {
   return new MethodDescriptorProto;
 }
 
+MethodDescriptorProto* MethodDescriptorProto::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<MethodDescriptorProto>(arena);
+}
+
 void MethodDescriptorProto::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name()) {
@@ -4202,6 +4355,12 @@ bool MethodDescriptorProto::IsInitialized() const {
 
 void MethodDescriptorProto::Swap(MethodDescriptorProto* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      MethodDescriptorProto temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_, other->name_);
     std::swap(input_type_, other->input_type_);
     std::swap(output_type_, other->output_type_);
@@ -4259,7 +4418,12 @@ const int FileOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
 FileOptions::FileOptions()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+FileOptions::FileOptions(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -4267,7 +4431,7 @@ void FileOptions::InitAsDefaultInstance() {
 }
 
 FileOptions::FileOptions(const FileOptions& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -4282,6 +4446,7 @@ void FileOptions::SharedCtor() {
   cc_generic_services_ = false;
   java_generic_services_ = false;
   py_generic_services_ = false;
+  uninterpreted_option_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -4290,6 +4455,7 @@ FileOptions::~FileOptions() {
 }
 
 void FileOptions::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (java_package_ != &::google::protobuf::internal::kEmptyString) {
     delete java_package_;
   }
@@ -4320,6 +4486,10 @@ FileOptions* FileOptions::New() const {
   return new FileOptions;
 }
 
+FileOptions* FileOptions::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<FileOptions>(arena);
+}
+
 void FileOptions::Clear() {
   _extensions_.Clear();
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -4798,6 +4968,12 @@ bool FileOptions::IsInitialized() const {
 
 void FileOptions::Swap(FileOptions* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      FileOptions temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(java_package_, other->java_package_);
     std::swap(java_outer_classname_, other->java_outer_classname_);
     std::swap(java_multiple_files_, other->java_multiple_files_);
@@ -4832,7 +5008,12 @@ const int MessageOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
 MessageOptions::MessageOptions()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+MessageOptions::MessageOptions(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -4840,7 +5021,7 @@ void MessageOptions::InitAsDefaultInstance() {
 }
 
 MessageOptions::MessageOptions(const MessageOptions& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -4849,6 +5030,7 @@ void MessageOptions::SharedCtor() {
   _cached_size_ = 0;
   message_set_wire_format_ = false;
   no_standard_descriptor_accessor_ = false;
+  uninterpreted_option_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -4857,6 +5039,7 @@ MessageOptions::~MessageOptions() {
 }
 
 void MessageOptions::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -4881,6 +5064,10 @@ MessageOptions* MessageOptions::New() const {
   return new MessageOptions;
 }
 
+MessageOptions* MessageOptions::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<MessageOptions>(arena);
+}
+
 void MessageOptions::Clear() {
   _extensions_.Clear();
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
@@ -5109,6 +5296,12 @@ bool MessageOptions::IsInitialized() const {
 
 void MessageOptions::Swap(MessageOptions* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      MessageOptions temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(message_set_wire_format_, other->message_set_wire_format_);
     std::swap(no_standard_descriptor_accessor_, other->no_standard_descriptor_accessor_);
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
@@ -5156,13 +5349,19 @@ const int FieldOptions::CType_ARRAYSIZE;
 #ifndef _MSC_VER
 const int FieldOptions::kCtypeFieldNumber;
 const int FieldOptions::kPackedFieldNumber;
+const int FieldOptions::kLazyFieldNumber;
 const int FieldOptions::kDeprecatedFieldNumber;
 const int FieldOptions::kExperimentalMapKeyFieldNumber;
 const int FieldOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
 FieldOptions::FieldOptions()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+FieldOptions::FieldOptions(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -5170,7 +5369,7 @@ void FieldOptions::InitAsDefaultInstance() {
 }
 
 FieldOptions::FieldOptions(const FieldOptions& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -5179,8 +5378,10 @@ void FieldOptions::SharedCtor() {
   _cached_size_ = 0;
   ctype_ = 0;
   packed_ = false;
+  lazy_ = false;
   deprecated_ = false;
   experimental_map_key_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+  uninterpreted_option_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -5189,6 +5390,7 @@ FieldOptions::~FieldOptions() {
 }
 
 void FieldOptions::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (experimental_map_key_ != &::google::protobuf::internal::kEmptyString) {
     delete experimental_map_key_;
   }
@@ -5216,11 +5418,16 @@ FieldOptions* FieldOptions::New() const {
   return new FieldOptions;
 }
 
+FieldOptions* FieldOptions::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<FieldOptions>(arena);
+}
+
 void FieldOptions::Clear() {
   _extensions_.Clear();
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     ctype_ = 0;
     packed_ = false;
+    lazy_ = false;
     deprecated_ = false;
     if (has_experimental_map_key()) {
       if (experimental_map_key_ != &::google::protobuf::internal::kEmptyString) {
@@ -5287,6 +5494,22 @@ bool FieldOptions::MergePartialFromCodedStream(
         } else {
           goto handle_uninterpreted;
         }
+        if (input->ExpectTag(40)) goto parse_lazy;
+        break;
+      }
+      
+      // optional bool lazy = 5 [default = false];
+      case 5: {
+        if (::google::protobuf::internal::WireFormatLite::GetTagWireType(tag) ==
+            ::google::protobuf::internal::WireFormatLite::WIRETYPE_VARINT) {
+         parse_lazy:
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &lazy_)));
+          set_has_lazy();
+        } else {
+          goto handle_uninterpreted;
+        }
         if (input->ExpectTag(74)) goto parse_experimental_map_key;
         break;
       }
@@ -5362,6 +5585,11 @@ void FieldOptions::SerializeWithCachedSizes(
     ::google::protobuf::internal::WireFormatLite::WriteBool(3, this->deprecated(), output);
   }
   
+  // optional bool lazy = 5 [default = false];
+  if (has_lazy()) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(5, this->lazy(), output);
+  }
+  
   // optional string experimental_map_key = 9;
   if (has_experimental_map_key()) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -5405,6 +5633,11 @@ void FieldOptions::SerializeWithCachedSizes(
     target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(3, this->deprecated(), target);
   }
   
+  // optional bool lazy = 5 [default = false];
+  if (has_lazy()) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(5, this->lazy(), target);
+  }
+  
   // optional string experimental_map_key = 9;
   if (has_experimental_map_key()) {
     ::google::protobuf::internal::WireFormat::VerifyUTF8String(
@@ -5448,6 +5681,11 @@ int FieldOptions::ByteSize() const {
       total_size += 1 + 1;
     }
     
+    // optional bool lazy = 5 [default = false];
+    if (has_lazy()) {
+      total_size += 1 + 1;
+    }
+    
     // optional bool deprecated = 3 [default = false];
     if (has_deprecated()) {
       total_size += 1 + 1;
@@ -5504,6 +5742,9 @@ void FieldOptions::MergeFrom(const FieldOptions& from) {
     if (from.has_packed()) {
       set_packed(from.packed());
     }
+    if (from.has_lazy()) {
+      set_lazy(from.lazy());
+    }
     if (from.has_deprecated()) {
       set_deprecated(from.deprecated());
     }
@@ -5538,8 +5779,15 @@ bool FieldOptions::IsInitialized() const {
 
 void FieldOptions::Swap(FieldOptions* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      FieldOptions temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(ctype_, other->ctype_);
     std::swap(packed_, other->packed_);
+    std::swap(lazy_, other->lazy_);
     std::swap(deprecated_, other->deprecated_);
     std::swap(experimental_map_key_, other->experimental_map_key_);
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
@@ -5566,7 +5814,12 @@ const int EnumOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
 EnumOptions::EnumOptions()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+EnumOptions::EnumOptions(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -5574,13 +5827,14 @@ void EnumOptions::InitAsDefaultInstance() {
 }
 
 EnumOptions::EnumOptions(const EnumOptions& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void EnumOptions::SharedCtor() {
   _cached_size_ = 0;
+  uninterpreted_option_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -5589,6 +5843,7 @@ EnumOptions::~EnumOptions() {
 }
 
 void EnumOptions::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -5613,6 +5868,10 @@ EnumOptions* EnumOptions::New() const {
   return new EnumOptions;
 }
 
+EnumOptions* EnumOptions::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<EnumOptions>(arena);
+}
+
 void EnumOptions::Clear() {
   _extensions_.Clear();
   uninterpreted_option_.Clear();
@@ -5766,6 +6025,12 @@ bool EnumOptions::IsInitialized() const {
 
 void EnumOptions::Swap(EnumOptions* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      EnumOptions temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -5790,7 +6055,12 @@ const int EnumValueOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
 EnumValueOptions::EnumValueOptions()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+EnumValueOptions::EnumValueOptions(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -5798,13 +6068,14 @@ void EnumValueOptions::InitAsDefaultInstance() {
 }
 
 EnumValueOptions::EnumValueOptions(const EnumValueOptions& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void EnumValueOptions::SharedCtor() {
   _cached_size_ = 0;
+  uninterpreted_option_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -5813,6 +6084,7 @@ EnumValueOptions::~EnumValueOptions() {
 }
 
 void EnumValueOptions::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -5837,6 +6109,10 @@ EnumValueOptions* EnumValueOptions::New() const {
   return new EnumValueOptions;
 }
 
+EnumValueOptions* EnumValueOptions::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<EnumValueOptions>(arena);
+}
+
 void EnumValueOptions::Clear() {
   _extensions_.Clear();
   uninterpreted_option_.Clear();
@@ -5990,6 +6266,12 @@ bool EnumValueOptions::IsInitialized() const {
 
 void EnumValueOptions::Swap(EnumValueOptions* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      EnumValueOptions temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -6014,7 +6296,12 @@ const int ServiceOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
 ServiceOptions::ServiceOptions()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+ServiceOptions::ServiceOptions(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -6022,13 +6309,14 @@ void ServiceOptions::InitAsDefaultInstance() {
 }
 
 ServiceOptions::ServiceOptions(const ServiceOptions& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void ServiceOptions::SharedCtor() {
   _cached_size_ = 0;
+  uninterpreted_option_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -6037,6 +6325,7 @@ ServiceOptions::~ServiceOptions() {
 }
 
 void ServiceOptions::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -6061,6 +6350,10 @@ ServiceOptions* ServiceOptions::New() const {
   return new ServiceOptions;
 }
 
+ServiceOptions* ServiceOptions::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<ServiceOptions>(arena);
+}
+
 void ServiceOptions::Clear() {
   _extensions_.Clear();
   uninterpreted_option_.Clear();
@@ -6214,6 +6507,12 @@ bool ServiceOptions::IsInitialized() const {
 
 void ServiceOptions::Swap(ServiceOptions* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      ServiceOptions temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -6238,7 +6537,12 @@ const int MethodOptions::kUninterpretedOptionFieldNumber;
 #endif  // !_MSC_VER
 
 MethodOptions::MethodOptions()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+MethodOptions::MethodOptions(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -6246,13 +6550,14 @@ void MethodOptions::InitAsDefaultInstance() {
 }
 
 MethodOptions::MethodOptions(const MethodOptions& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void MethodOptions::SharedCtor() {
   _cached_size_ = 0;
+  uninterpreted_option_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -6261,6 +6566,7 @@ MethodOptions::~MethodOptions() {
 }
 
 void MethodOptions::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -6285,6 +6591,10 @@ MethodOptions* MethodOptions::New() const {
   return new MethodOptions;
 }
 
+MethodOptions* MethodOptions::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<MethodOptions>(arena);
+}
+
 void MethodOptions::Clear() {
   _extensions_.Clear();
   uninterpreted_option_.Clear();
@@ -6438,6 +6748,12 @@ bool MethodOptions::IsInitialized() const {
 
 void MethodOptions::Swap(MethodOptions* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      MethodOptions temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     uninterpreted_option_.Swap(&other->uninterpreted_option_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -6463,7 +6779,12 @@ const int UninterpretedOption_NamePart::kIsExtensionFieldNumber;
 #endif  // !_MSC_VER
 
 UninterpretedOption_NamePart::UninterpretedOption_NamePart()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+UninterpretedOption_NamePart::UninterpretedOption_NamePart(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -6471,7 +6792,7 @@ void UninterpretedOption_NamePart::InitAsDefaultInstance() {
 }
 
 UninterpretedOption_NamePart::UninterpretedOption_NamePart(const UninterpretedOption_NamePart& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
@@ -6488,6 +6809,7 @@ UninterpretedOption_NamePart::~UninterpretedOption_NamePart() {
 }
 
 void UninterpretedOption_NamePart::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (name_part_ != &::google::protobuf::internal::kEmptyString) {
     delete name_part_;
   }
@@ -6515,6 +6837,10 @@ UninterpretedOption_NamePart* UninterpretedOption_NamePart::New() const {
   return new UninterpretedOption_NamePart;
 }
 
+UninterpretedOption_NamePart* UninterpretedOption_NamePart::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<UninterpretedOption_NamePart>(arena);
+}
+
 void UninterpretedOption_NamePart::Clear() {
   if (_has_bits_[0 / 32] & (0xffu << (0 % 32))) {
     if (has_name_part()) {
@@ -6701,6 +7027,12 @@ bool UninterpretedOption_NamePart::IsInitialized() const {
 
 void UninterpretedOption_NamePart::Swap(UninterpretedOption_NamePart* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      UninterpretedOption_NamePart temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     std::swap(name_part_, other->name_part_);
     std::swap(is_extension_, other->is_extension_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
@@ -6731,7 +7063,12 @@ const int UninterpretedOption::kAggregateValueFieldNumber;
 #endif  // !_MSC_VER
 
 UninterpretedOption::UninterpretedOption()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+UninterpretedOption::UninterpretedOption(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -6739,13 +7076,14 @@ void UninterpretedOption::InitAsDefaultInstance() {
 }
 
 UninterpretedOption::UninterpretedOption(const UninterpretedOption& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void UninterpretedOption::SharedCtor() {
   _cached_size_ = 0;
+  name_.InternalSetArena(_arena_);
   identifier_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
   positive_int_value_ = GOOGLE_ULONGLONG(0);
   negative_int_value_ = GOOGLE_LONGLONG(0);
@@ -6760,6 +7098,7 @@ UninterpretedOption::~UninterpretedOption() {
 }
 
 void UninterpretedOption::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (identifier_value_ != &::google::protobuf::internal::kEmptyString) {
     delete identifier_value_;
   }
@@ -6793,6 +7132,10 @@ UninterpretedOption* UninterpretedOption::New() const {
   return new UninterpretedOption;
 }
 
+UninterpretedOption* UninterpretedOption::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<UninterpretedOption>(arena);
+}
+
 void UninterpretedOption::Clear() {
   if (_has_bits_[1 / 32] & (0xffu << (1 % 32))) {
     if (has_identifier_value()) {
@@ -7187,6 +7530,12 @@ bool UninterpretedOption::IsInitialized() const {
 
 void UninterpretedOption::Swap(UninterpretedOption* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      UninterpretedOption temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     name_.Swap(&other->name_);
     std::swap(identifier_value_, other->identifier_value_);
     std::swap(positive_int_value_, other->positive_int_value_);
@@ -7217,7 +7566,12 @@ const int SourceCodeInfo_Location::kSpanFieldNumber;
 #endif  // !_MSC_VER
 
 SourceCodeInfo_Location::SourceCodeInfo_Location()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+SourceCodeInfo_Location::SourceCodeInfo_Location(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -7225,13 +7579,15 @@ void SourceCodeInfo_Location::InitAsDefaultInstance() {
 }
 
 SourceCodeInfo_Location::SourceCodeInfo_Location(const SourceCodeInfo_Location& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void SourceCodeInfo_Location::SharedCtor() {
   _cached_size_ = 0;
+  path_.InternalSetArena(_arena_);
+  span_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -7240,6 +7596,7 @@ SourceCodeInfo_Location::~SourceCodeInfo_Location() {
 }
 
 void SourceCodeInfo_Location::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -7264,6 +7621,10 @@ SourceCodeInfo_Location* SourceCodeInfo_Location::New() const {
   return new SourceCodeInfo_Location;
 }
 
+SourceCodeInfo_Location* SourceCodeInfo_Location::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<SourceCodeInfo_Location>(arena);
+}
+
 void SourceCodeInfo_Location::Clear() {
   path_.Clear();
   span_.Clear();
@@ -7481,6 +7842,12 @@ bool SourceCodeInfo_Location::IsInitialized() const {
 
 void SourceCodeInfo_Location::Swap(SourceCodeInfo_Location* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      SourceCodeInfo_Location temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     path_.Swap(&other->path_);
     span_.Swap(&other->span_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
@@ -7505,7 +7872,12 @@ const int SourceCodeInfo::kLocationFieldNumber;
 #endif  // !_MSC_VER
 
 SourceCodeInfo::SourceCodeInfo()
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
+  SharedCtor();
+}
+
+SourceCodeInfo::SourceCodeInfo(::google::protobuf::Arena* arena)
+  : ::google::protobuf::Message(), _arena_(arena) {
   SharedCtor();
 }
 
@@ -7513,13 +7885,14 @@ void SourceCodeInfo::InitAsDefaultInstance() {
 }
 
 SourceCodeInfo::SourceCodeInfo(const SourceCodeInfo& from)
-  : ::google::protobuf::Message() {
+  : ::google::protobuf::Message(), _arena_(NULL) {
   SharedCtor();
   MergeFrom(from);
 }
 
 void SourceCodeInfo::SharedCtor() {
   _cached_size_ = 0;
+  location_.InternalSetArena(_arena_);
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
 }
 
@@ -7528,6 +7901,7 @@ SourceCodeInfo::~SourceCodeInfo() {
 }
 
 void SourceCodeInfo::SharedDtor() {
+  if (_arena_ != NULL) return;
   if (this != default_instance_) {
   }
 }
@@ -7552,6 +7926,10 @@ SourceCodeInfo* SourceCodeInfo::New() const {
   return new SourceCodeInfo;
 }
 
+SourceCodeInfo* SourceCodeInfo::New(::google::protobuf::Arena* arena) const {
+  return ::google::protobuf::Arena::CreateMessage<SourceCodeInfo>(arena);
+}
+
 void SourceCodeInfo::Clear() {
   location_.Clear();
   ::memset(_has_bits_, 0, sizeof(_has_bits_));
@@ -7684,6 +8062,12 @@ bool SourceCodeInfo::IsInitialized() const {
 
 void SourceCodeInfo::Swap(SourceCodeInfo* other) {
   if (other != this) {
+    if (_arena_ != other->_arena_) {
+      SourceCodeInfo temp(*other);
+      other->CopyFrom(*this);
+      CopyFrom(temp);
+      return;
+    }
     location_.Swap(&other->location_);
     std::swap(_has_bits_[0], other->_has_bits_[0]);
     _unknown_fields_.Swap(&other->_unknown_fields_);
@@ -19,7 +19,10 @@
 #error regenerate this file with a newer version of protoc.
 #endif
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/generated_message_reflection.h>
@@ -176,9 +179,13 @@ class LIBPROTOBUF_EXPORT FileDescriptorSet : public ::google::protobuf::Message
   
   void Swap(FileDescriptorSet* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   FileDescriptorSet* New() const;
+  FileDescriptorSet* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const FileDescriptorSet& from);
@@ -194,6 +201,8 @@ class LIBPROTOBUF_EXPORT FileDescriptorSet : public ::google::protobuf::Message
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit FileDescriptorSet(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -220,6 +229,8 @@ class LIBPROTOBUF_EXPORT FileDescriptorSet : public ::google::protobuf::Message
   // @@protoc_insertion_point(class_scope:google.protobuf.FileDescriptorSet)
  private:
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::google::protobuf::RepeatedPtrField< ::google::protobuf::FileDescriptorProto > file_;
@@ -261,9 +272,13 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   
   void Swap(FileDescriptorProto* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   FileDescriptorProto* New() const;
+  FileDescriptorProto* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const FileDescriptorProto& from);
@@ -279,6 +294,8 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit FileDescriptorProto(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -403,6 +420,8 @@ class LIBPROTOBUF_EXPORT FileDescriptorProto : public ::google::protobuf::Messag
   inline void set_has_source_code_info();
   inline void clear_has_source_code_info();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -452,9 +471,13 @@ class LIBPROTOBUF_EXPORT DescriptorProto_ExtensionRange : public ::google::proto
   
   void Swap(DescriptorProto_ExtensionRange* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   DescriptorProto_ExtensionRange* New() const;
+  DescriptorProto_ExtensionRange* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const DescriptorProto_ExtensionRange& from);
@@ -470,6 +493,8 @@ class LIBPROTOBUF_EXPORT DescriptorProto_ExtensionRange : public ::google::proto
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit DescriptorProto_ExtensionRange(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -502,6 +527,8 @@ class LIBPROTOBUF_EXPORT DescriptorProto_ExtensionRange : public ::google::proto
   inline void set_has_end();
   inline void clear_has_end();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::google::protobuf::int32 start_;
@@ -544,9 +571,13 @@ class LIBPROTOBUF_EXPORT DescriptorProto : public ::google::protobuf::Message {
   
   void Swap(DescriptorProto* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   DescriptorProto* New() const;
+  DescriptorProto* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const DescriptorProto& from);
@@ -562,6 +593,8 @@ class LIBPROTOBUF_EXPORT DescriptorProto : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit DescriptorProto(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -661,6 +694,8 @@ class LIBPROTOBUF_EXPORT DescriptorProto : public ::google::protobuf::Message {
   inline void set_has_options();
   inline void clear_has_options();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -708,9 +743,13 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   
   void Swap(FieldDescriptorProto* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   FieldDescriptorProto* New() const;
+  FieldDescriptorProto* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const FieldDescriptorProto& from);
@@ -726,6 +765,8 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit FieldDescriptorProto(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -894,6 +935,8 @@ class LIBPROTOBUF_EXPORT FieldDescriptorProto : public ::google::protobuf::Messa
   inline void set_has_options();
   inline void clear_has_options();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -942,9 +985,13 @@ class LIBPROTOBUF_EXPORT EnumDescriptorProto : public ::google::protobuf::Messag
   
   void Swap(EnumDescriptorProto* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   EnumDescriptorProto* New() const;
+  EnumDescriptorProto* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const EnumDescriptorProto& from);
@@ -960,6 +1007,8 @@ class LIBPROTOBUF_EXPORT EnumDescriptorProto : public ::google::protobuf::Messag
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit EnumDescriptorProto(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1009,6 +1058,8 @@ class LIBPROTOBUF_EXPORT EnumDescriptorProto : public ::google::protobuf::Messag
   inline void set_has_options();
   inline void clear_has_options();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -1052,9 +1103,13 @@ class LIBPROTOBUF_EXPORT EnumValueDescriptorProto : public ::google::protobuf::M
   
   void Swap(EnumValueDescriptorProto* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   EnumValueDescriptorProto* New() const;
+  EnumValueDescriptorProto* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const EnumValueDescriptorProto& from);
@@ -1070,6 +1125,8 @@ class LIBPROTOBUF_EXPORT EnumValueDescriptorProto : public ::google::protobuf::M
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit EnumValueDescriptorProto(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1116,6 +1173,8 @@ class LIBPROTOBUF_EXPORT EnumValueDescriptorProto : public ::google::protobuf::M
   inline void set_has_options();
   inline void clear_has_options();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -1159,9 +1218,13 @@ class LIBPROTOBUF_EXPORT ServiceDescriptorProto : public ::google::protobuf::Mes
   
   void Swap(ServiceDescriptorProto* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   ServiceDescriptorProto* New() const;
+  ServiceDescriptorProto* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const ServiceDescriptorProto& from);
@@ -1177,6 +1240,8 @@ class LIBPROTOBUF_EXPORT ServiceDescriptorProto : public ::google::protobuf::Mes
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit ServiceDescriptorProto(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1226,6 +1291,8 @@ class LIBPROTOBUF_EXPORT ServiceDescriptorProto : public ::google::protobuf::Mes
   inline void set_has_options();
   inline void clear_has_options();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -1269,9 +1336,13 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
   
   void Swap(MethodDescriptorProto* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   MethodDescriptorProto* New() const;
+  MethodDescriptorProto* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const MethodDescriptorProto& from);
@@ -1287,6 +1358,8 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit MethodDescriptorProto(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1350,6 +1423,8 @@ class LIBPROTOBUF_EXPORT MethodDescriptorProto : public ::google::protobuf::Mess
   inline void set_has_options();
   inline void clear_has_options();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_;
@@ -1394,9 +1469,13 @@ class LIBPROTOBUF_EXPORT FileOptions : public ::google::protobuf::Message {
   
   void Swap(FileOptions* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   FileOptions* New() const;
+  FileOptions* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const FileOptions& from);
@@ -1412,6 +1491,8 @@ class LIBPROTOBUF_EXPORT FileOptions : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit FileOptions(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1544,6 +1625,8 @@ class LIBPROTOBUF_EXPORT FileOptions : public ::google::protobuf::Message {
   inline void set_has_py_generic_services();
   inline void clear_has_py_generic_services();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::internal::ExtensionSet _extensions_;
   
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
@@ -1595,9 +1678,13 @@ class LIBPROTOBUF_EXPORT MessageOptions : public ::google::protobuf::Message {
   
   void Swap(MessageOptions* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   MessageOptions* New() const;
+  MessageOptions* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const MessageOptions& from);
@@ -1613,6 +1700,8 @@ class LIBPROTOBUF_EXPORT MessageOptions : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit MessageOptions(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1658,6 +1747,8 @@ class LIBPROTOBUF_EXPORT MessageOptions : public ::google::protobuf::Message {
   inline void set_has_no_standard_descriptor_accessor();
   inline void clear_has_no_standard_descriptor_accessor();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::internal::ExtensionSet _extensions_;
   
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
@@ -1703,9 +1794,13 @@ class LIBPROTOBUF_EXPORT FieldOptions : public ::google::protobuf::Message {
   
   void Swap(FieldOptions* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   FieldOptions* New() const;
+  FieldOptions* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const FieldOptions& from);
@@ -1721,6 +1816,8 @@ class LIBPROTOBUF_EXPORT FieldOptions : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit FieldOptions(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1771,6 +1868,13 @@ class LIBPROTOBUF_EXPORT FieldOptions : public ::google::protobuf::Message {
   inline bool packed() const;
   inline void set_packed(bool value);
   
+  // optional bool lazy = 5 [default = false];
+  inline bool has_lazy() const;
+  inline void clear_lazy();
+  static const int kLazyFieldNumber = 5;
+  inline bool lazy() const;
+  inline void set_lazy(bool value);
+  
   // optional bool deprecated = 3 [default = false];
   inline bool has_deprecated() const;
   inline void clear_deprecated();
@@ -1808,23 +1912,28 @@ class LIBPROTOBUF_EXPORT FieldOptions : public ::google::protobuf::Message {
   inline void clear_has_ctype();
   inline void set_has_packed();
   inline void clear_has_packed();
+  inline void set_has_lazy();
+  inline void clear_has_lazy();
   inline void set_has_deprecated();
   inline void clear_has_deprecated();
   inline void set_has_experimental_map_key();
   inline void clear_has_experimental_map_key();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::internal::ExtensionSet _extensions_;
   
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   int ctype_;
   bool packed_;
+  bool lazy_;
   bool deprecated_;
   ::std::string* experimental_map_key_;
   ::google::protobuf::RepeatedPtrField< ::google::protobuf::UninterpretedOption > uninterpreted_option_;
   
   mutable int _cached_size_;
-  ::google::protobuf::uint32 _has_bits_[(5 + 31) / 32];
+  ::google::protobuf::uint32 _has_bits_[(6 + 31) / 32];
   
   friend void LIBPROTOBUF_EXPORT protobuf_AddDesc_google_2fprotobuf_2fdescriptor_2eproto();
   friend void protobuf_AssignDesc_google_2fprotobuf_2fdescriptor_2eproto();
@@ -1860,9 +1969,13 @@ class LIBPROTOBUF_EXPORT EnumOptions : public ::google::protobuf::Message {
   
   void Swap(EnumOptions* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   EnumOptions* New() const;
+  EnumOptions* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const EnumOptions& from);
@@ -1878,6 +1991,8 @@ class LIBPROTOBUF_EXPORT EnumOptions : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit EnumOptions(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1905,6 +2020,8 @@ class LIBPROTOBUF_EXPORT EnumOptions : public ::google::protobuf::Message {
   // @@protoc_insertion_point(class_scope:google.protobuf.EnumOptions)
  private:
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::internal::ExtensionSet _extensions_;
   
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
@@ -1948,9 +2065,13 @@ class LIBPROTOBUF_EXPORT EnumValueOptions : public ::google::protobuf::Message {
   
   void Swap(EnumValueOptions* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   EnumValueOptions* New() const;
+  EnumValueOptions* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const EnumValueOptions& from);
@@ -1966,6 +2087,8 @@ class LIBPROTOBUF_EXPORT EnumValueOptions : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit EnumValueOptions(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -1993,6 +2116,8 @@ class LIBPROTOBUF_EXPORT EnumValueOptions : public ::google::protobuf::Message {
   // @@protoc_insertion_point(class_scope:google.protobuf.EnumValueOptions)
  private:
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::internal::ExtensionSet _extensions_;
   
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
@@ -2036,9 +2161,13 @@ class LIBPROTOBUF_EXPORT ServiceOptions : public ::google::protobuf::Message {
   
   void Swap(ServiceOptions* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   ServiceOptions* New() const;
+  ServiceOptions* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const ServiceOptions& from);
@@ -2054,6 +2183,8 @@ class LIBPROTOBUF_EXPORT ServiceOptions : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit ServiceOptions(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -2081,6 +2212,8 @@ class LIBPROTOBUF_EXPORT ServiceOptions : public ::google::protobuf::Message {
   // @@protoc_insertion_point(class_scope:google.protobuf.ServiceOptions)
  private:
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::internal::ExtensionSet _extensions_;
   
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
@@ -2124,9 +2257,13 @@ class LIBPROTOBUF_EXPORT MethodOptions : public ::google::protobuf::Message {
   
   void Swap(MethodOptions* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   MethodOptions* New() const;
+  MethodOptions* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const MethodOptions& from);
@@ -2142,6 +2279,8 @@ class LIBPROTOBUF_EXPORT MethodOptions : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit MethodOptions(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -2169,6 +2308,8 @@ class LIBPROTOBUF_EXPORT MethodOptions : public ::google::protobuf::Message {
   // @@protoc_insertion_point(class_scope:google.protobuf.MethodOptions)
  private:
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::internal::ExtensionSet _extensions_;
   
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
@@ -2212,9 +2353,13 @@ class LIBPROTOBUF_EXPORT UninterpretedOption_NamePart : public ::google::protobu
   
   void Swap(UninterpretedOption_NamePart* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   UninterpretedOption_NamePart* New() const;
+  UninterpretedOption_NamePart* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const UninterpretedOption_NamePart& from);
@@ -2230,6 +2375,8 @@ class LIBPROTOBUF_EXPORT UninterpretedOption_NamePart : public ::google::protobu
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit UninterpretedOption_NamePart(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -2266,6 +2413,8 @@ class LIBPROTOBUF_EXPORT UninterpretedOption_NamePart : public ::google::protobu
   inline void set_has_is_extension();
   inline void clear_has_is_extension();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::std::string* name_part_;
@@ -2308,9 +2457,13 @@ class LIBPROTOBUF_EXPORT UninterpretedOption : public ::google::protobuf::Messag
   
   void Swap(UninterpretedOption* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   UninterpretedOption* New() const;
+  UninterpretedOption* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const UninterpretedOption& from);
@@ -2326,6 +2479,8 @@ class LIBPROTOBUF_EXPORT UninterpretedOption : public ::google::protobuf::Messag
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit UninterpretedOption(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -2420,6 +2575,8 @@ class LIBPROTOBUF_EXPORT UninterpretedOption : public ::google::protobuf::Messag
   inline void set_has_aggregate_value();
   inline void clear_has_aggregate_value();
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::google::protobuf::RepeatedPtrField< ::google::protobuf::UninterpretedOption_NamePart > name_;
@@ -2467,9 +2624,13 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo_Location : public ::google::protobuf::Me
   
   void Swap(SourceCodeInfo_Location* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   SourceCodeInfo_Location* New() const;
+  SourceCodeInfo_Location* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const SourceCodeInfo_Location& from);
@@ -2485,6 +2646,8 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo_Location : public ::google::protobuf::Me
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit SourceCodeInfo_Location(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -2523,6 +2686,8 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo_Location : public ::google::protobuf::Me
   // @@protoc_insertion_point(class_scope:google.protobuf.SourceCodeInfo.Location)
  private:
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::google::protobuf::RepeatedField< ::google::protobuf::int32 > path_;
@@ -2567,9 +2732,13 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo : public ::google::protobuf::Message {
   
   void Swap(SourceCodeInfo* other);
   
+  inline ::google::protobuf::Arena* GetArena() const { return _arena_; }
+  typedef void InternalArenaConstructable_;
+  
   // implements Message ----------------------------------------------
   
   SourceCodeInfo* New() const;
+  SourceCodeInfo* New(::google::protobuf::Arena* arena) const;
   void CopyFrom(const ::google::protobuf::Message& from);
   void MergeFrom(const ::google::protobuf::Message& from);
   void CopyFrom(const SourceCodeInfo& from);
@@ -2585,6 +2754,8 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo : public ::google::protobuf::Message {
   ::google::protobuf::uint8* SerializeWithCachedSizesToArray(::google::protobuf::uint8* output) const;
   int GetCachedSize() const { return _cached_size_; }
   private:
+  explicit SourceCodeInfo(::google::protobuf::Arena* arena);
+  friend class ::google::protobuf::Arena;
   void SharedCtor();
   void SharedDtor();
   void SetCachedSize(int size) const;
@@ -2613,6 +2784,8 @@ class LIBPROTOBUF_EXPORT SourceCodeInfo : public ::google::protobuf::Message {
   // @@protoc_insertion_point(class_scope:google.protobuf.SourceCodeInfo)
  private:
   
+  ::google::protobuf::Arena* _arena_;
+  
   ::google::protobuf::UnknownFieldSet _unknown_fields_;
   
   ::google::protobuf::RepeatedPtrField< ::google::protobuf::SourceCodeInfo_Location > location_;
@@ -2685,28 +2858,28 @@ inline const ::std::string& FileDescriptorProto::name() const {
 inline void FileDescriptorProto::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void FileDescriptorProto::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void FileDescriptorProto::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FileDescriptorProto::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -2717,6 +2890,9 @@ inline ::std::string* FileDescriptorProto::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -2743,28 +2919,28 @@ inline const ::std::string& FileDescriptorProto::package() const {
 inline void FileDescriptorProto::set_package(const ::std::string& value) {
   set_has_package();
   if (package_ == &::google::protobuf::internal::kEmptyString) {
-    package_ = new ::std::string;
+    package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   package_->assign(value);
 }
 inline void FileDescriptorProto::set_package(const char* value) {
   set_has_package();
   if (package_ == &::google::protobuf::internal::kEmptyString) {
-    package_ = new ::std::string;
+    package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   package_->assign(value);
 }
 inline void FileDescriptorProto::set_package(const char* value, size_t size) {
   set_has_package();
   if (package_ == &::google::protobuf::internal::kEmptyString) {
-    package_ = new ::std::string;
+    package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   package_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FileDescriptorProto::mutable_package() {
   set_has_package();
   if (package_ == &::google::protobuf::internal::kEmptyString) {
-    package_ = new ::std::string;
+    package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return package_;
 }
@@ -2775,6 +2951,9 @@ inline ::std::string* FileDescriptorProto::release_package() {
   } else {
     ::std::string* temp = package_;
     package_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -2942,13 +3121,18 @@ inline const ::google::protobuf::FileOptions& FileDescriptorProto::options() con
 }
 inline ::google::protobuf::FileOptions* FileDescriptorProto::mutable_options() {
   set_has_options();
-  if (options_ == NULL) options_ = new ::google::protobuf::FileOptions;
+  if (options_ == NULL) {
+    options_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::FileOptions >(_arena_);
+  }
   return options_;
 }
 inline ::google::protobuf::FileOptions* FileDescriptorProto::release_options() {
   clear_has_options();
   ::google::protobuf::FileOptions* temp = options_;
   options_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::FileOptions(*temp);
+  }
   return temp;
 }
 
@@ -2971,13 +3155,18 @@ inline const ::google::protobuf::SourceCodeInfo& FileDescriptorProto::source_cod
 }
 inline ::google::protobuf::SourceCodeInfo* FileDescriptorProto::mutable_source_code_info() {
   set_has_source_code_info();
-  if (source_code_info_ == NULL) source_code_info_ = new ::google::protobuf::SourceCodeInfo;
+  if (source_code_info_ == NULL) {
+    source_code_info_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::SourceCodeInfo >(_arena_);
+  }
   return source_code_info_;
 }
 inline ::google::protobuf::SourceCodeInfo* FileDescriptorProto::release_source_code_info() {
   clear_has_source_code_info();
   ::google::protobuf::SourceCodeInfo* temp = source_code_info_;
   source_code_info_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::SourceCodeInfo(*temp);
+  }
   return temp;
 }
 
@@ -3055,28 +3244,28 @@ inline const ::std::string& DescriptorProto::name() const {
 inline void DescriptorProto::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void DescriptorProto::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void DescriptorProto::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* DescriptorProto::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -3087,6 +3276,9 @@ inline ::std::string* DescriptorProto::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3235,13 +3427,18 @@ inline const ::google::protobuf::MessageOptions& DescriptorProto::options() cons
 }
 inline ::google::protobuf::MessageOptions* DescriptorProto::mutable_options() {
   set_has_options();
-  if (options_ == NULL) options_ = new ::google::protobuf::MessageOptions;
+  if (options_ == NULL) {
+    options_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::MessageOptions >(_arena_);
+  }
   return options_;
 }
 inline ::google::protobuf::MessageOptions* DescriptorProto::release_options() {
   clear_has_options();
   ::google::protobuf::MessageOptions* temp = options_;
   options_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::MessageOptions(*temp);
+  }
   return temp;
 }
 
@@ -3271,28 +3468,28 @@ inline const ::std::string& FieldDescriptorProto::name() const {
 inline void FieldDescriptorProto::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void FieldDescriptorProto::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void FieldDescriptorProto::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FieldDescriptorProto::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -3303,6 +3500,9 @@ inline ::std::string* FieldDescriptorProto::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3397,28 +3597,28 @@ inline const ::std::string& FieldDescriptorProto::type_name() const {
 inline void FieldDescriptorProto::set_type_name(const ::std::string& value) {
   set_has_type_name();
   if (type_name_ == &::google::protobuf::internal::kEmptyString) {
-    type_name_ = new ::std::string;
+    type_name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   type_name_->assign(value);
 }
 inline void FieldDescriptorProto::set_type_name(const char* value) {
   set_has_type_name();
   if (type_name_ == &::google::protobuf::internal::kEmptyString) {
-    type_name_ = new ::std::string;
+    type_name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   type_name_->assign(value);
 }
 inline void FieldDescriptorProto::set_type_name(const char* value, size_t size) {
   set_has_type_name();
   if (type_name_ == &::google::protobuf::internal::kEmptyString) {
-    type_name_ = new ::std::string;
+    type_name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   type_name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FieldDescriptorProto::mutable_type_name() {
   set_has_type_name();
   if (type_name_ == &::google::protobuf::internal::kEmptyString) {
-    type_name_ = new ::std::string;
+    type_name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return type_name_;
 }
@@ -3429,6 +3629,9 @@ inline ::std::string* FieldDescriptorProto::release_type_name() {
   } else {
     ::std::string* temp = type_name_;
     type_name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3455,28 +3658,28 @@ inline const ::std::string& FieldDescriptorProto::extendee() const {
 inline void FieldDescriptorProto::set_extendee(const ::std::string& value) {
   set_has_extendee();
   if (extendee_ == &::google::protobuf::internal::kEmptyString) {
-    extendee_ = new ::std::string;
+    extendee_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   extendee_->assign(value);
 }
 inline void FieldDescriptorProto::set_extendee(const char* value) {
   set_has_extendee();
   if (extendee_ == &::google::protobuf::internal::kEmptyString) {
-    extendee_ = new ::std::string;
+    extendee_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   extendee_->assign(value);
 }
 inline void FieldDescriptorProto::set_extendee(const char* value, size_t size) {
   set_has_extendee();
   if (extendee_ == &::google::protobuf::internal::kEmptyString) {
-    extendee_ = new ::std::string;
+    extendee_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   extendee_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FieldDescriptorProto::mutable_extendee() {
   set_has_extendee();
   if (extendee_ == &::google::protobuf::internal::kEmptyString) {
-    extendee_ = new ::std::string;
+    extendee_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return extendee_;
 }
@@ -3487,6 +3690,9 @@ inline ::std::string* FieldDescriptorProto::release_extendee() {
   } else {
     ::std::string* temp = extendee_;
     extendee_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3513,28 +3719,28 @@ inline const ::std::string& FieldDescriptorProto::default_value() const {
 inline void FieldDescriptorProto::set_default_value(const ::std::string& value) {
   set_has_default_value();
   if (default_value_ == &::google::protobuf::internal::kEmptyString) {
-    default_value_ = new ::std::string;
+    default_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   default_value_->assign(value);
 }
 inline void FieldDescriptorProto::set_default_value(const char* value) {
   set_has_default_value();
   if (default_value_ == &::google::protobuf::internal::kEmptyString) {
-    default_value_ = new ::std::string;
+    default_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   default_value_->assign(value);
 }
 inline void FieldDescriptorProto::set_default_value(const char* value, size_t size) {
   set_has_default_value();
   if (default_value_ == &::google::protobuf::internal::kEmptyString) {
-    default_value_ = new ::std::string;
+    default_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   default_value_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FieldDescriptorProto::mutable_default_value() {
   set_has_default_value();
   if (default_value_ == &::google::protobuf::internal::kEmptyString) {
-    default_value_ = new ::std::string;
+    default_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return default_value_;
 }
@@ -3545,6 +3751,9 @@ inline ::std::string* FieldDescriptorProto::release_default_value() {
   } else {
     ::std::string* temp = default_value_;
     default_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3568,13 +3777,18 @@ inline const ::google::protobuf::FieldOptions& FieldDescriptorProto::options() c
 }
 inline ::google::protobuf::FieldOptions* FieldDescriptorProto::mutable_options() {
   set_has_options();
-  if (options_ == NULL) options_ = new ::google::protobuf::FieldOptions;
+  if (options_ == NULL) {
+    options_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::FieldOptions >(_arena_);
+  }
   return options_;
 }
 inline ::google::protobuf::FieldOptions* FieldDescriptorProto::release_options() {
   clear_has_options();
   ::google::protobuf::FieldOptions* temp = options_;
   options_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::FieldOptions(*temp);
+  }
   return temp;
 }
 
@@ -3604,28 +3818,28 @@ inline const ::std::string& EnumDescriptorProto::name() const {
 inline void EnumDescriptorProto::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void EnumDescriptorProto::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void EnumDescriptorProto::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* EnumDescriptorProto::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -3636,6 +3850,9 @@ inline ::std::string* EnumDescriptorProto::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3684,13 +3901,18 @@ inline const ::google::protobuf::EnumOptions& EnumDescriptorProto::options() con
 }
 inline ::google::protobuf::EnumOptions* EnumDescriptorProto::mutable_options() {
   set_has_options();
-  if (options_ == NULL) options_ = new ::google::protobuf::EnumOptions;
+  if (options_ == NULL) {
+    options_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::EnumOptions >(_arena_);
+  }
   return options_;
 }
 inline ::google::protobuf::EnumOptions* EnumDescriptorProto::release_options() {
   clear_has_options();
   ::google::protobuf::EnumOptions* temp = options_;
   options_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::EnumOptions(*temp);
+  }
   return temp;
 }
 
@@ -3720,28 +3942,28 @@ inline const ::std::string& EnumValueDescriptorProto::name() const {
 inline void EnumValueDescriptorProto::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void EnumValueDescriptorProto::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void EnumValueDescriptorProto::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* EnumValueDescriptorProto::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -3752,6 +3974,9 @@ inline ::std::string* EnumValueDescriptorProto::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3797,13 +4022,18 @@ inline const ::google::protobuf::EnumValueOptions& EnumValueDescriptorProto::opt
 }
 inline ::google::protobuf::EnumValueOptions* EnumValueDescriptorProto::mutable_options() {
   set_has_options();
-  if (options_ == NULL) options_ = new ::google::protobuf::EnumValueOptions;
+  if (options_ == NULL) {
+    options_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::EnumValueOptions >(_arena_);
+  }
   return options_;
 }
 inline ::google::protobuf::EnumValueOptions* EnumValueDescriptorProto::release_options() {
   clear_has_options();
   ::google::protobuf::EnumValueOptions* temp = options_;
   options_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::EnumValueOptions(*temp);
+  }
   return temp;
 }
 
@@ -3833,28 +4063,28 @@ inline const ::std::string& ServiceDescriptorProto::name() const {
 inline void ServiceDescriptorProto::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void ServiceDescriptorProto::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void ServiceDescriptorProto::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* ServiceDescriptorProto::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -3865,6 +4095,9 @@ inline ::std::string* ServiceDescriptorProto::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -3913,13 +4146,18 @@ inline const ::google::protobuf::ServiceOptions& ServiceDescriptorProto::options
 }
 inline ::google::protobuf::ServiceOptions* ServiceDescriptorProto::mutable_options() {
   set_has_options();
-  if (options_ == NULL) options_ = new ::google::protobuf::ServiceOptions;
+  if (options_ == NULL) {
+    options_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::ServiceOptions >(_arena_);
+  }
   return options_;
 }
 inline ::google::protobuf::ServiceOptions* ServiceDescriptorProto::release_options() {
   clear_has_options();
   ::google::protobuf::ServiceOptions* temp = options_;
   options_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::ServiceOptions(*temp);
+  }
   return temp;
 }
 
@@ -3949,28 +4187,28 @@ inline const ::std::string& MethodDescriptorProto::name() const {
 inline void MethodDescriptorProto::set_name(const ::std::string& value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void MethodDescriptorProto::set_name(const char* value) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(value);
 }
 inline void MethodDescriptorProto::set_name(const char* value, size_t size) {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* MethodDescriptorProto::mutable_name() {
   set_has_name();
   if (name_ == &::google::protobuf::internal::kEmptyString) {
-    name_ = new ::std::string;
+    name_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_;
 }
@@ -3981,6 +4219,9 @@ inline ::std::string* MethodDescriptorProto::release_name() {
   } else {
     ::std::string* temp = name_;
     name_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -4007,28 +4248,28 @@ inline const ::std::string& MethodDescriptorProto::input_type() const {
 inline void MethodDescriptorProto::set_input_type(const ::std::string& value) {
   set_has_input_type();
   if (input_type_ == &::google::protobuf::internal::kEmptyString) {
-    input_type_ = new ::std::string;
+    input_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   input_type_->assign(value);
 }
 inline void MethodDescriptorProto::set_input_type(const char* value) {
   set_has_input_type();
   if (input_type_ == &::google::protobuf::internal::kEmptyString) {
-    input_type_ = new ::std::string;
+    input_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   input_type_->assign(value);
 }
 inline void MethodDescriptorProto::set_input_type(const char* value, size_t size) {
   set_has_input_type();
   if (input_type_ == &::google::protobuf::internal::kEmptyString) {
-    input_type_ = new ::std::string;
+    input_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   input_type_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* MethodDescriptorProto::mutable_input_type() {
   set_has_input_type();
   if (input_type_ == &::google::protobuf::internal::kEmptyString) {
-    input_type_ = new ::std::string;
+    input_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return input_type_;
 }
@@ -4039,6 +4280,9 @@ inline ::std::string* MethodDescriptorProto::release_input_type() {
   } else {
     ::std::string* temp = input_type_;
     input_type_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -4065,28 +4309,28 @@ inline const ::std::string& MethodDescriptorProto::output_type() const {
 inline void MethodDescriptorProto::set_output_type(const ::std::string& value) {
   set_has_output_type();
   if (output_type_ == &::google::protobuf::internal::kEmptyString) {
-    output_type_ = new ::std::string;
+    output_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   output_type_->assign(value);
 }
 inline void MethodDescriptorProto::set_output_type(const char* value) {
   set_has_output_type();
   if (output_type_ == &::google::protobuf::internal::kEmptyString) {
-    output_type_ = new ::std::string;
+    output_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   output_type_->assign(value);
 }
 inline void MethodDescriptorProto::set_output_type(const char* value, size_t size) {
   set_has_output_type();
   if (output_type_ == &::google::protobuf::internal::kEmptyString) {
-    output_type_ = new ::std::string;
+    output_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   output_type_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* MethodDescriptorProto::mutable_output_type() {
   set_has_output_type();
   if (output_type_ == &::google::protobuf::internal::kEmptyString) {
-    output_type_ = new ::std::string;
+    output_type_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return output_type_;
 }
@@ -4097,6 +4341,9 @@ inline ::std::string* MethodDescriptorProto::release_output_type() {
   } else {
     ::std::string* temp = output_type_;
     output_type_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -4120,13 +4367,18 @@ inline const ::google::protobuf::MethodOptions& MethodDescriptorProto::options()
 }
 inline ::google::protobuf::MethodOptions* MethodDescriptorProto::mutable_options() {
   set_has_options();
-  if (options_ == NULL) options_ = new ::google::protobuf::MethodOptions;
+  if (options_ == NULL) {
+    options_ = ::google::protobuf::Arena::CreateMessage< ::google::protobuf::MethodOptions >(_arena_);
+  }
   return options_;
 }
 inline ::google::protobuf::MethodOptions* MethodDescriptorProto::release_options() {
   clear_has_options();
   ::google::protobuf::MethodOptions* temp = options_;
   options_ = NULL;
+  if (_arena_ != NULL && temp != NULL) {
+    temp = new ::google::protobuf::MethodOptions(*temp);
+  }
   return temp;
 }
 
@@ -4156,28 +4408,28 @@ inline const ::std::string& FileOptions::java_package() const {
 inline void FileOptions::set_java_package(const ::std::string& value) {
   set_has_java_package();
   if (java_package_ == &::google::protobuf::internal::kEmptyString) {
-    java_package_ = new ::std::string;
+    java_package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   java_package_->assign(value);
 }
 inline void FileOptions::set_java_package(const char* value) {
   set_has_java_package();
   if (java_package_ == &::google::protobuf::internal::kEmptyString) {
-    java_package_ = new ::std::string;
+    java_package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   java_package_->assign(value);
 }
 inline void FileOptions::set_java_package(const char* value, size_t size) {
   set_has_java_package();
   if (java_package_ == &::google::protobuf::internal::kEmptyString) {
-    java_package_ = new ::std::string;
+    java_package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   java_package_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FileOptions::mutable_java_package() {
   set_has_java_package();
   if (java_package_ == &::google::protobuf::internal::kEmptyString) {
-    java_package_ = new ::std::string;
+    java_package_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return java_package_;
 }
@@ -4188,6 +4440,9 @@ inline ::std::string* FileOptions::release_java_package() {
   } else {
     ::std::string* temp = java_package_;
     java_package_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -4214,28 +4469,28 @@ inline const ::std::string& FileOptions::java_outer_classname() const {
 inline void FileOptions::set_java_outer_classname(const ::std::string& value) {
   set_has_java_outer_classname();
   if (java_outer_classname_ == &::google::protobuf::internal::kEmptyString) {
-    java_outer_classname_ = new ::std::string;
+    java_outer_classname_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   java_outer_classname_->assign(value);
 }
 inline void FileOptions::set_java_outer_classname(const char* value) {
   set_has_java_outer_classname();
   if (java_outer_classname_ == &::google::protobuf::internal::kEmptyString) {
-    java_outer_classname_ = new ::std::string;
+    java_outer_classname_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   java_outer_classname_->assign(value);
 }
 inline void FileOptions::set_java_outer_classname(const char* value, size_t size) {
   set_has_java_outer_classname();
   if (java_outer_classname_ == &::google::protobuf::internal::kEmptyString) {
-    java_outer_classname_ = new ::std::string;
+    java_outer_classname_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   java_outer_classname_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FileOptions::mutable_java_outer_classname() {
   set_has_java_outer_classname();
   if (java_outer_classname_ == &::google::protobuf::internal::kEmptyString) {
-    java_outer_classname_ = new ::std::string;
+    java_outer_classname_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return java_outer_classname_;
 }
@@ -4246,6 +4501,9 @@ inline ::std::string* FileOptions::release_java_outer_classname() {
   } else {
     ::std::string* temp = java_outer_classname_;
     java_outer_classname_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -4530,15 +4788,37 @@ inline void FieldOptions::set_packed(bool value) {
   packed_ = value;
 }
 
+// optional bool lazy = 5 [default = false];
+inline bool FieldOptions::has_lazy() const {
+  return (_has_bits_[0] & 0x00000004u) != 0;
+}
+inline void FieldOptions::set_has_lazy() {
+  _has_bits_[0] |= 0x00000004u;
+}
+inline void FieldOptions::clear_has_lazy() {
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline void FieldOptions::clear_lazy() {
+  lazy_ = false;
+  clear_has_lazy();
+}
+inline bool FieldOptions::lazy() const {
+  return lazy_;
+}
+inline void FieldOptions::set_lazy(bool value) {
+  set_has_lazy();
+  lazy_ = value;
+}
+
 // optional bool deprecated = 3 [default = false];
 inline bool FieldOptions::has_deprecated() const {
-  return (_has_bits_[0] & 0x00000004u) != 0;
+  return (_has_bits_[0] & 0x00000008u) != 0;
 }
 inline void FieldOptions::set_has_deprecated() {
-  _has_bits_[0] |= 0x00000004u;
+  _has_bits_[0] |= 0x00000008u;
 }
 inline void FieldOptions::clear_has_deprecated() {
-  _has_bits_[0] &= ~0x00000004u;
+  _has_bits_[0] &= ~0x00000008u;
 }
 inline void FieldOptions::clear_deprecated() {
   deprecated_ = false;
@@ -4554,13 +4834,13 @@ inline void FieldOptions::set_deprecated(bool value) {
 
 // optional string experimental_map_key = 9;
 inline bool FieldOptions::has_experimental_map_key() const {
-  return (_has_bits_[0] & 0x00000008u) != 0;
+  return (_has_bits_[0] & 0x00000010u) != 0;
 }
 inline void FieldOptions::set_has_experimental_map_key() {
-  _has_bits_[0] |= 0x00000008u;
+  _has_bits_[0] |= 0x00000010u;
 }
 inline void FieldOptions::clear_has_experimental_map_key() {
-  _has_bits_[0] &= ~0x00000008u;
+  _has_bits_[0] &= ~0x00000010u;
 }
 inline void FieldOptions::clear_experimental_map_key() {
   if (experimental_map_key_ != &::google::protobuf::internal::kEmptyString) {
@@ -4574,28 +4854,28 @@ inline const ::std::string& FieldOptions::experimental_map_key() const {
 inline void FieldOptions::set_experimental_map_key(const ::std::string& value) {
   set_has_experimental_map_key();
   if (experimental_map_key_ == &::google::protobuf::internal::kEmptyString) {
-    experimental_map_key_ = new ::std::string;
+    experimental_map_key_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   experimental_map_key_->assign(value);
 }
 inline void FieldOptions::set_experimental_map_key(const char* value) {
   set_has_experimental_map_key();
   if (experimental_map_key_ == &::google::protobuf::internal::kEmptyString) {
-    experimental_map_key_ = new ::std::string;
+    experimental_map_key_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   experimental_map_key_->assign(value);
 }
 inline void FieldOptions::set_experimental_map_key(const char* value, size_t size) {
   set_has_experimental_map_key();
   if (experimental_map_key_ == &::google::protobuf::internal::kEmptyString) {
-    experimental_map_key_ = new ::std::string;
+    experimental_map_key_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   experimental_map_key_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* FieldOptions::mutable_experimental_map_key() {
   set_has_experimental_map_key();
   if (experimental_map_key_ == &::google::protobuf::internal::kEmptyString) {
-    experimental_map_key_ = new ::std::string;
+    experimental_map_key_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return experimental_map_key_;
 }
@@ -4606,6 +4886,9 @@ inline ::std::string* FieldOptions::release_experimental_map_key() {
   } else {
     ::std::string* temp = experimental_map_key_;
     experimental_map_key_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -4777,28 +5060,28 @@ inline const ::std::string& UninterpretedOption_NamePart::name_part() const {
 inline void UninterpretedOption_NamePart::set_name_part(const ::std::string& value) {
   set_has_name_part();
   if (name_part_ == &::google::protobuf::internal::kEmptyString) {
-    name_part_ = new ::std::string;
+    name_part_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_part_->assign(value);
 }
 inline void UninterpretedOption_NamePart::set_name_part(const char* value) {
   set_has_name_part();
   if (name_part_ == &::google::protobuf::internal::kEmptyString) {
-    name_part_ = new ::std::string;
+    name_part_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_part_->assign(value);
 }
 inline void UninterpretedOption_NamePart::set_name_part(const char* value, size_t size) {
   set_has_name_part();
   if (name_part_ == &::google::protobuf::internal::kEmptyString) {
-    name_part_ = new ::std::string;
+    name_part_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   name_part_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* UninterpretedOption_NamePart::mutable_name_part() {
   set_has_name_part();
   if (name_part_ == &::google::protobuf::internal::kEmptyString) {
-    name_part_ = new ::std::string;
+    name_part_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return name_part_;
 }
@@ -4809,6 +5092,9 @@ inline ::std::string* UninterpretedOption_NamePart::release_name_part() {
   } else {
     ::std::string* temp = name_part_;
     name_part_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -4886,28 +5172,28 @@ inline const ::std::string& UninterpretedOption::identifier_value() const {
 inline void UninterpretedOption::set_identifier_value(const ::std::string& value) {
   set_has_identifier_value();
   if (identifier_value_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_value_ = new ::std::string;
+    identifier_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   identifier_value_->assign(value);
 }
 inline void UninterpretedOption::set_identifier_value(const char* value) {
   set_has_identifier_value();
   if (identifier_value_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_value_ = new ::std::string;
+    identifier_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   identifier_value_->assign(value);
 }
 inline void UninterpretedOption::set_identifier_value(const char* value, size_t size) {
   set_has_identifier_value();
   if (identifier_value_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_value_ = new ::std::string;
+    identifier_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   identifier_value_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* UninterpretedOption::mutable_identifier_value() {
   set_has_identifier_value();
   if (identifier_value_ == &::google::protobuf::internal::kEmptyString) {
-    identifier_value_ = new ::std::string;
+    identifier_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return identifier_value_;
 }
@@ -4918,6 +5204,9 @@ inline ::std::string* UninterpretedOption::release_identifier_value() {
   } else {
     ::std::string* temp = identifier_value_;
     identifier_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -5010,28 +5299,28 @@ inline const ::std::string& UninterpretedOption::string_value() const {
 inline void UninterpretedOption::set_string_value(const ::std::string& value) {
   set_has_string_value();
   if (string_value_ == &::google::protobuf::internal::kEmptyString) {
-    string_value_ = new ::std::string;
+    string_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   string_value_->assign(value);
 }
 inline void UninterpretedOption::set_string_value(const char* value) {
   set_has_string_value();
   if (string_value_ == &::google::protobuf::internal::kEmptyString) {
-    string_value_ = new ::std::string;
+    string_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   string_value_->assign(value);
 }
 inline void UninterpretedOption::set_string_value(const void* value, size_t size) {
   set_has_string_value();
   if (string_value_ == &::google::protobuf::internal::kEmptyString) {
-    string_value_ = new ::std::string;
+    string_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   string_value_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* UninterpretedOption::mutable_string_value() {
   set_has_string_value();
   if (string_value_ == &::google::protobuf::internal::kEmptyString) {
-    string_value_ = new ::std::string;
+    string_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return string_value_;
 }
@@ -5042,6 +5331,9 @@ inline ::std::string* UninterpretedOption::release_string_value() {
   } else {
     ::std::string* temp = string_value_;
     string_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
@@ -5068,28 +5360,28 @@ inline const ::std::string& UninterpretedOption::aggregate_value() const {
 inline void UninterpretedOption::set_aggregate_value(const ::std::string& value) {
   set_has_aggregate_value();
   if (aggregate_value_ == &::google::protobuf::internal::kEmptyString) {
-    aggregate_value_ = new ::std::string;
+    aggregate_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   aggregate_value_->assign(value);
 }
 inline void UninterpretedOption::set_aggregate_value(const char* value) {
   set_has_aggregate_value();
   if (aggregate_value_ == &::google::protobuf::internal::kEmptyString) {
-    aggregate_value_ = new ::std::string;
+    aggregate_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   aggregate_value_->assign(value);
 }
 inline void UninterpretedOption::set_aggregate_value(const char* value, size_t size) {
   set_has_aggregate_value();
   if (aggregate_value_ == &::google::protobuf::internal::kEmptyString) {
-    aggregate_value_ = new ::std::string;
+    aggregate_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   aggregate_value_->assign(reinterpret_cast<const char*>(value), size);
 }
 inline ::std::string* UninterpretedOption::mutable_aggregate_value() {
   set_has_aggregate_value();
   if (aggregate_value_ == &::google::protobuf::internal::kEmptyString) {
-    aggregate_value_ = new ::std::string;
+    aggregate_value_ = ::google::protobuf::Arena::Create< ::std::string>(_arena_);
   }
   return aggregate_value_;
 }
@@ -5100,6 +5392,9 @@ inline ::std::string* UninterpretedOption::release_aggregate_value() {
   } else {
     ::std::string* temp = aggregate_value_;
     aggregate_value_ = const_cast< ::std::string*>(&::google::protobuf::internal::kEmptyString);
+    if (_arena_ != NULL) {
+      temp = new ::std::string(*temp);
+    }
     return temp;
   }
 }
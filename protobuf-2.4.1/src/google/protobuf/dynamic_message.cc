@@ -72,8 +72,10 @@
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/lazy_field.h>
 #include <google/protobuf/reflection_ops.h>
 #include <google/protobuf/repeated_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/wire_format.h>
 
@@ -83,6 +85,9 @@ namespace protobuf {
 using internal::WireFormat;
 using internal::ExtensionSet;
 using internal::GeneratedMessageReflection;
+using internal::IsLazyField;
+using internal::LazyField;
+using internal::StringPieceField;
 
 
 // ===================================================================
@@ -123,10 +128,13 @@ int FieldSpaceUsed(const FieldDescriptor* field) {
       case FD::CPPTYPE_FLOAT  : return sizeof(float   );
       case FD::CPPTYPE_BOOL   : return sizeof(bool    );
       case FD::CPPTYPE_ENUM   : return sizeof(int     );
-      case FD::CPPTYPE_MESSAGE: return sizeof(Message*);
+      case FD::CPPTYPE_MESSAGE:
+        return IsLazyField(field) ? sizeof(LazyField) : sizeof(Message*);
 
       case FD::CPPTYPE_STRING:
         switch (field->options().ctype()) {
+          case FieldOptions::STRING_PIECE:
+            return sizeof(StringPieceField);
           default:  // TODO(kenton):  Support other string reps.
           case FieldOptions::STRING:
             return sizeof(string*);
@@ -190,6 +198,8 @@ class DynamicMessage : public Message {
   // implements Message ----------------------------------------------
 
   Message* New() const;
+  // Message::New(Arena*) calls New() and has the Arena own the result.
+  using Message::New;
 
   int GetCachedSize() const;
   void SetCachedSize(int size) const;
@@ -271,6 +281,15 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
 
       case FieldDescriptor::CPPTYPE_STRING:
         switch (field->options().ctype()) {
+          case FieldOptions::STRING_PIECE:
+            if (!field->is_repeated()) {
+              const string& default_value = field->default_value_string();
+              new(field_ptr) StringPieceField();
+              reinterpret_cast<StringPieceField*>(field_ptr)->SetAlias(
+                  default_value.data(), default_value.size());
+              break;
+            }
+            // Repeated fields are stored as strings; fall through.
           default:  // TODO(kenton):  Support other string reps.
           case FieldOptions::STRING:
             if (!field->is_repeated()) {
@@ -291,7 +310,9 @@ DynamicMessage::DynamicMessage(const TypeInfo* type_info)
         break;
 
       case FieldDescriptor::CPPTYPE_MESSAGE: {
-        if (!field->is_repeated()) {
+        if (IsLazyField(field)) {
+          new(field_ptr) LazyField();
+        } else if (!field->is_repeated()) {
           new(field_ptr) Message*(NULL);
         } else {
           new(field_ptr) RepeatedPtrField<Message>();
@@ -359,6 +380,9 @@ DynamicMessage::~DynamicMessage() {
 
     } else if (field->cpp_type() == FieldDescriptor::CPPTYPE_STRING) {
       switch (field->options().ctype()) {
+        case FieldOptions::STRING_PIECE:
+          reinterpret_cast<StringPieceField*>(field_ptr)->~StringPieceField();
+          break;
         default:  // TODO(kenton):  Support other string reps.
         case FieldOptions::STRING: {
           string* ptr = *reinterpret_cast<string**>(field_ptr);
@@ -368,6 +392,8 @@ DynamicMessage::~DynamicMessage() {
           break;
         }
       }
+    } else if (IsLazyField(field)) {
+      reinterpret_cast<LazyField*>(field_ptr)->~LazyField();
     } else if ((field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) &&
                !is_prototype()) {
       Message* message = *reinterpret_cast<Message**>(field_ptr);
@@ -391,7 +417,7 @@ void DynamicMessage::CrossLinkPrototypes() {
     void* field_ptr = OffsetToPointer(type_info_->offsets[i]);
 
     if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE &&
-        !field->is_repeated()) {
+        !field->is_repeated() && !IsLazyField(field)) {
       // For fields with message types, we need to cross-link with the
       // prototype for the field's type.
       // For singular fields, the field is just a pointer which should
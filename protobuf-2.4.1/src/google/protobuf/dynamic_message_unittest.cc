@@ -134,6 +134,33 @@ TEST_F(DynamicMessageTest, Extensions) {
   reflection_tester.ExpectAllFieldsSetViaReflection(*message);
 }
 
+TEST_F(DynamicMessageTest, LazyField) {
+  // Check that a lazy field reads and writes the same values as an eager one.
+  const Descriptor* lazy_descriptor =
+    pool_.FindMessageTypeByName("protobuf_unittest.TestLazyMessage");
+  ASSERT_TRUE(lazy_descriptor != NULL);
+  const FieldDescriptor* field = lazy_descriptor->FindFieldByName("lazy_child");
+  scoped_ptr<Message> message(factory_.GetPrototype(lazy_descriptor)->New());
+  const Reflection* reflection = message->GetReflection();
+  TestUtil::ReflectionTester reflection_tester(descriptor_);
+
+  reflection_tester.SetAllFieldsViaReflection(
+    reflection->MutableMessage(message.get(), field));
+  string data = message->SerializeAsString();
+
+  scoped_ptr<Message> parsed(message->New());
+  ASSERT_TRUE(parsed->ParseFromString(data));
+  EXPECT_TRUE(reflection->HasField(*parsed, field));
+  reflection_tester.ExpectAllFieldsSetViaReflection(
+    reflection->GetMessage(*parsed, field));
+  EXPECT_EQ(data, parsed->SerializeAsString());
+
+  reflection->ClearField(parsed.get(), field);
+  EXPECT_FALSE(reflection->HasField(*parsed, field));
+  reflection_tester.ExpectClearViaReflection(
+    reflection->GetMessage(*parsed, field));
+}
+
 TEST_F(DynamicMessageTest, PackedFields) {
   // Check that packed fields work properly.
   scoped_ptr<Message> message(packed_prototype_->New());
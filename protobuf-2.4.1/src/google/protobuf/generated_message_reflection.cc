@@ -34,11 +34,14 @@
 
 #include <algorithm>
 #include <google/protobuf/generated_message_reflection.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/descriptor.h>
 #include <google/protobuf/descriptor.pb.h>
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/extension_set.h>
 #include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/stubs/common.h>
 
 namespace google {
@@ -71,6 +74,26 @@ const string& NameOfEnum(const EnumDescriptor* descriptor, int value) {
   return (d == NULL ? kEmptyString : d->name());
 }
 
+bool IsLazyField(const FieldDescriptor* field) {
+  return field->options().lazy() && !field->is_repeated() &&
+         !field->is_extension() &&
+         field->type() == FieldDescriptor::TYPE_MESSAGE;
+}
+
+int LazyField::SpaceUsedExcludingSelf() const {
+  // A LazyField in a message with reflection holds a Message.
+  MutexLock lock(&mutex_);
+  int total_size = StringSpaceUsedExcludingSelf(bytes_);
+  if (message_ != NULL) {
+    total_size += static_cast<const Message*>(message_)->SpaceUsed();
+  }
+  return total_size;
+}
+
+int StringPieceField::SpaceUsedExcludingSelf() const {
+  return StringSpaceUsedExcludingSelf(buffer_);
+}
+
 // ===================================================================
 // Helpers for reporting usage errors (e.g. trying to use GetInt32() on
 // a string field).
@@ -268,6 +291,10 @@ int GeneratedMessageReflection::SpaceUsed(const Message& message) const {
 
         case FieldDescriptor::CPPTYPE_STRING: {
           switch (field->options().ctype()) {
+            case FieldOptions::STRING_PIECE:
+              total_size += GetRaw<StringPieceField>(message, field)
+                              .SpaceUsedExcludingSelf();
+              break;
             default:  // TODO(kenton):  Support other string reps.
             case FieldOptions::STRING: {
               const string* ptr = GetField<const string*>(message, field);
@@ -289,7 +316,10 @@ int GeneratedMessageReflection::SpaceUsed(const Message& message) const {
         }
 
         case FieldDescriptor::CPPTYPE_MESSAGE:
-          if (&message == default_instance_) {
+          if (IsLazyField(field)) {
+            total_size +=
+                GetRaw<LazyField>(message, field).SpaceUsedExcludingSelf();
+          } else if (&message == default_instance_) {
             // For singular fields, the prototype just stores a pointer to the
             // external type's prototype, so there is no extra memory usage.
           } else {
@@ -327,6 +357,16 @@ void GeneratedMessageReflection::Swap(
     << "\").  Note that the exact same class is required; not just the same "
        "descriptor.";
 
+  if (message1->GetArena() != message2->GetArena()) {
+    // Fields cannot move from one Arena (or the heap) to another, so copy.
+    Message* temp = message1->New();
+    temp->MergeFrom(*message1);
+    message1->CopyFrom(*message2);
+    message2->CopyFrom(*temp);
+    delete temp;
+    return;
+  }
+
   uint32* has_bits1 = MutableHasBits(message1);
   uint32* has_bits2 = MutableHasBits(message2);
   int has_bits_size = (descriptor_->field_count() + 31) / 32;
@@ -380,11 +420,24 @@ void GeneratedMessageReflection::Swap(
           SWAP_VALUES(DOUBLE, double);
           SWAP_VALUES(BOOL  , bool  );
           SWAP_VALUES(ENUM  , int   );
-          SWAP_VALUES(MESSAGE, Message*);
 #undef SWAP_VALUES
 
+        case FieldDescriptor::CPPTYPE_MESSAGE:
+          if (IsLazyField(field)) {
+            MutableRaw<LazyField>(message1, field)->Swap(
+                MutableRaw<LazyField>(message2, field));
+          } else {
+            std::swap(*MutableRaw<Message*>(message1, field),
+                      *MutableRaw<Message*>(message2, field));
+          }
+          break;
+
         case FieldDescriptor::CPPTYPE_STRING:
           switch (field->options().ctype()) {
+            case FieldOptions::STRING_PIECE:
+              MutableRaw<StringPieceField>(message1, field)->Swap(
+                  MutableRaw<StringPieceField>(message2, field));
+              break;
             default:  // TODO(kenton):  Support other string reps.
             case FieldOptions::STRING:
               std::swap(*MutableRaw<string*>(message1, field),
@@ -487,8 +540,16 @@ void GeneratedMessageReflection::ClearField(
 
         case FieldDescriptor::CPPTYPE_STRING: {
           switch (field->options().ctype()) {
+            case FieldOptions::STRING_PIECE: {
+              // The descriptor outlives the message, so its copy of the
+              // default value can be aliased.
+              const string& default_value = field->default_value_string();
+              MutableRaw<StringPieceField>(message, field)->SetAlias(
+                  default_value.data(), default_value.size());
+              break;
+            }
             default:  // TODO(kenton):  Support other string reps.
-            case FieldOptions::STRING:
+            case FieldOptions::STRING: {
               const string* default_ptr = DefaultRaw<const string*>(field);
               string** value = MutableRaw<string*>(message, field);
               if (*value != default_ptr) {
@@ -499,12 +560,17 @@ void GeneratedMessageReflection::ClearField(
                 }
               }
               break;
+            }
           }
           break;
         }
 
         case FieldDescriptor::CPPTYPE_MESSAGE:
-          (*MutableRaw<Message*>(message, field))->Clear();
+          if (IsLazyField(field)) {
+            MutableRaw<LazyField>(message, field)->Clear();
+          } else {
+            (*MutableRaw<Message*>(message, field))->Clear();
+          }
           break;
       }
     }
@@ -748,6 +814,8 @@ string GeneratedMessageReflection::GetString(
                                               field->default_value_string());
   } else {
     switch (field->options().ctype()) {
+      case FieldOptions::STRING_PIECE:
+        return GetField<StringPieceField>(message, field).ToString();
       default:  // TODO(kenton):  Support other string reps.
       case FieldOptions::STRING:
         return *GetField<const string*>(message, field);
@@ -767,6 +835,12 @@ const string& GeneratedMessageReflection::GetStringReference(
                                               field->default_value_string());
   } else {
     switch (field->options().ctype()) {
+      case FieldOptions::STRING_PIECE: {
+        const StringPieceField& value =
+            GetField<StringPieceField>(message, field);
+        scratch->assign(value.data(), value.size());
+        return *scratch;
+      }
       default:  // TODO(kenton):  Support other string reps.
       case FieldOptions::STRING:
         return *GetField<const string*>(message, field);
@@ -787,11 +861,15 @@ void GeneratedMessageReflection::SetString(
                                                    field->type(), value, field);
   } else {
     switch (field->options().ctype()) {
+      case FieldOptions::STRING_PIECE:
+        MutableField<StringPieceField>(message, field)->Set(value);
+        break;
       default:  // TODO(kenton):  Support other string reps.
       case FieldOptions::STRING: {
         string** ptr = MutableField<string*>(message, field);
         if (*ptr == DefaultRaw<const string*>(field)) {
-          *ptr = new string(value);
+          *ptr = Arena::Create<string>(message->GetArena());
+          (*ptr)->assign(value);
         } else {
           (*ptr)->assign(value);
         }
@@ -965,6 +1043,11 @@ const Message& GeneratedMessageReflection::GetMessage(
         GetExtensionSet(message).GetMessage(
           field->number(), field->message_type(),
           factory == NULL ? message_factory_ : factory));
+  } else if (IsLazyField(field)) {
+    // The field's own type, not one from factory, since generated code
+    // casts the message the field creates.
+    return static_cast<const Message&>(GetRaw<LazyField>(message, field).Get(
+        *message_factory_->GetPrototype(field->message_type())));
   } else {
     const Message* result = GetRaw<const Message*>(message, field);
     if (result == NULL) {
@@ -983,11 +1066,15 @@ Message* GeneratedMessageReflection::MutableMessage(
     return static_cast<Message*>(
         MutableExtensionSet(message)->MutableMessage(field,
           factory == NULL ? message_factory_ : factory));
+  } else if (IsLazyField(field)) {
+    return static_cast<Message*>(
+        MutableField<LazyField>(message, field)->Mutable(
+            *message_factory_->GetPrototype(field->message_type())));
   } else {
     Message** result = MutableField<Message*>(message, field);
     if (*result == NULL) {
       const Message* default_message = DefaultRaw<const Message*>(field);
-      *result = default_message->New();
+      *result = default_message->New(message->GetArena());
     }
     return *result;
   }
@@ -1044,8 +1131,8 @@ Message* GeneratedMessageReflection::AddMessage(
       } else {
         prototype = &repeated->Get<GenericTypeHandler<Message> >(0);
       }
-      result = prototype->New();
-      repeated->AddAllocated<GenericTypeHandler<Message> >(result);
+      result = prototype->New(repeated->GetArena());
+      repeated->UnsafeArenaAddAllocated<GenericTypeHandler<Message> >(result);
     }
     return result;
   }
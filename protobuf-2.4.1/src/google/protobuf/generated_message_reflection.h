@@ -41,6 +41,7 @@
 #include <string>
 #include <vector>
 #include <google/protobuf/message.h>
+#include <google/protobuf/generated_message_util.h>
 #include <google/protobuf/unknown_field_set.h>
 
 
@@ -101,7 +102,7 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
   //                  the start of the message object, of each field.  These can
   //                  be computed at compile time using the
   //                  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET() macro, defined
-  //                  below.
+  //                  in generated_message_util.h.
   //   has_bits_offset:  Offset in the message of an array of uint32s of size
   //                  descriptor->field_count()/32, rounded up.  This is a
   //                  bitfield where each bit indicates whether or not the
@@ -344,25 +345,6 @@ class LIBPROTOBUF_EXPORT GeneratedMessageReflection : public Reflection {
   GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(GeneratedMessageReflection);
 };
 
-// Returns the offset of the given field within the given aggregate type.
-// This is equivalent to the ANSI C offsetof() macro.  However, according
-// to the C++ standard, offsetof() only works on POD types, and GCC
-// enforces this requirement with a warning.  In practice, this rule is
-// unnecessarily strict; there is probably no compiler or platform on
-// which the offsets of the direct fields of a class are non-constant.
-// Fields inherited from superclasses *can* have non-constant offsets,
-// but that's not what this macro will be used for.
-//
-// Note that we calculate relative to the pointer value 16 here since if we
-// just use zero, GCC complains about dereferencing a NULL pointer.  We
-// choose 16 rather than some other number just in case the compiler would
-// be confused by an unaligned pointer.
-#define GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(TYPE, FIELD)    \
-  static_cast<int>(                                           \
-    reinterpret_cast<const char*>(                            \
-      &reinterpret_cast<const TYPE*>(16)->FIELD) -            \
-    reinterpret_cast<const char*>(16))
-
 // There are some places in proto2 where dynamic_cast would be useful as an
 // optimization.  For example, take Message::MergeFrom(const Message& other).
 // For a given generated message FooMessage, we generate these two methods:
@@ -417,6 +399,11 @@ bool ParseNamedEnum(const EnumDescriptor* descriptor,
 // descriptor.h.
 LIBPROTOBUF_EXPORT const string& NameOfEnum(const EnumDescriptor* descriptor, int value);
 
+// Returns true if the field is a singular sub-message with [lazy=true],
+// which generated code and DynamicMessage store as a LazyField.  The option
+// has no effect on other fields.
+LIBPROTOBUF_EXPORT bool IsLazyField(const FieldDescriptor* field);
+
 }  // namespace internal
 }  // namespace protobuf
 
@@ -207,6 +207,35 @@ TEST(GeneratedMessageReflectionTest, SwapUnknown) {
   EXPECT_EQ(1, message2.unknown_fields().field_count());
 }
 
+TEST(GeneratedMessageReflectionTest, LazyField) {
+  unittest::TestLazyMessage message;
+  const Reflection* reflection = message.GetReflection();
+  const FieldDescriptor* field =
+    message.GetDescriptor()->FindFieldByName("lazy_child");
+  TestUtil::ReflectionTester reflection_tester(
+    unittest::TestAllTypes::descriptor());
+
+  reflection_tester.SetAllFieldsViaReflection(
+    reflection->MutableMessage(&message, field));
+  TestUtil::ExpectAllFieldsSet(message.lazy_child());
+
+  unittest::TestLazyMessage parsed;
+  ASSERT_TRUE(parsed.ParseFromString(message.SerializeAsString()));
+  EXPECT_TRUE(reflection->HasField(parsed, field));
+  reflection_tester.ExpectAllFieldsSetViaReflection(
+    reflection->GetMessage(parsed, field));
+
+  unittest::TestLazyMessage empty;
+  reflection->Swap(&parsed, &empty);
+  EXPECT_FALSE(parsed.has_lazy_child());
+  TestUtil::ExpectAllFieldsSet(empty.lazy_child());
+  EXPECT_LT(parsed.SpaceUsed(), empty.SpaceUsed());
+
+  reflection->ClearField(&empty, field);
+  EXPECT_FALSE(empty.has_lazy_child());
+  TestUtil::ExpectClear(empty.lazy_child());
+}
+
 TEST(GeneratedMessageReflectionTest, RemoveLast) {
   unittest::TestAllTypes message;
   TestUtil::ReflectionTester reflection_tester(
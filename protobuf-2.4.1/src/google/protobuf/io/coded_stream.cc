@@ -287,40 +287,6 @@ bool CodedInputStream::ReadLittleEndian64Fallback(uint64* value) {
   return true;
 }
 
-namespace {
-
-inline const uint8* ReadVarint32FromArray(
-    const uint8* buffer, uint32* value) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
-inline const uint8* ReadVarint32FromArray(const uint8* buffer, uint32* value) {
-  // Fast path:  We have enough bytes left in the buffer to guarantee that
-  // this read won't cross the end, so we can skip the checks.
-  const uint8* ptr = buffer;
-  uint32 b;
-  uint32 result;
-
-  b = *(ptr++); result  = (b & 0x7F)      ; if (!(b & 0x80)) goto done;
-  b = *(ptr++); result |= (b & 0x7F) <<  7; if (!(b & 0x80)) goto done;
-  b = *(ptr++); result |= (b & 0x7F) << 14; if (!(b & 0x80)) goto done;
-  b = *(ptr++); result |= (b & 0x7F) << 21; if (!(b & 0x80)) goto done;
-  b = *(ptr++); result |=  b         << 28; if (!(b & 0x80)) goto done;
-
-  // If the input is larger than 32 bits, we still need to read it all
-  // and discard the high-order bits.
-  for (int i = 0; i < kMaxVarintBytes - kMaxVarint32Bytes; i++) {
-    b = *(ptr++); if (!(b & 0x80)) goto done;
-  }
-
-  // We have overrun the maximum size of a varint (10 bytes).  Assume
-  // the data is corrupt.
-  return NULL;
-
- done:
-  *value = result;
-  return ptr;
-}
-
-}  // namespace
-
 bool CodedInputStream::ReadVarint32Slow(uint32* value) {
   uint64 result;
   // Directly invoke ReadVarint64Fallback, since we already tried to optimize
@@ -335,9 +301,11 @@ bool CodedInputStream::ReadVarint32Fallback(uint32* value) {
       // Optimization:  If the varint ends at exactly the end of the buffer,
       // we can detect that and still use the fast path.
       (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80))) {
-    const uint8* end = ReadVarint32FromArray(buffer_, value);
+    uint64 result;
+    const uint8* end = ReadVarint64FromArray(buffer_, buffer_end_, &result);
     if (end == NULL) return false;
     buffer_ = end;
+    *value = static_cast<uint32>(result);
     return true;
   } else {
     // Really slow case: we will incur the cost of an extra function call here,
@@ -378,13 +346,13 @@ uint32 CodedInputStream::ReadTagFallback() {
       // Optimization:  If the varint ends at exactly the end of the buffer,
       // we can detect that and still use the fast path.
       (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80))) {
-    uint32 tag;
-    const uint8* end = ReadVarint32FromArray(buffer_, &tag);
+    uint64 tag;
+    const uint8* end = ReadVarint64FromArray(buffer_, buffer_end_, &tag);
     if (end == NULL) {
       return 0;
     }
     buffer_ = end;
-    return tag;
+    return static_cast<uint32>(tag);
   } else {
     // We are commonly at a limit when attempting to read tags. Try to quickly
     // detect this case without making another function call.
@@ -429,36 +397,10 @@ bool CodedInputStream::ReadVarint64Fallback(uint64* value) {
       // Optimization:  If the varint ends at exactly the end of the buffer,
       // we can detect that and still use the fast path.
       (buffer_end_ > buffer_ && !(buffer_end_[-1] & 0x80))) {
-    // Fast path:  We have enough bytes left in the buffer to guarantee that
-    // this read won't cross the end, so we can skip the checks.
-
-    const uint8* ptr = buffer_;
-    uint32 b;
-
-    // Splitting into 32-bit pieces gives better performance on 32-bit
-    // processors.
-    uint32 part0 = 0, part1 = 0, part2 = 0;
-
-    b = *(ptr++); part0  = (b & 0x7F)      ; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part0 |= (b & 0x7F) <<  7; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part0 |= (b & 0x7F) << 14; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part0 |= (b & 0x7F) << 21; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part1  = (b & 0x7F)      ; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part1 |= (b & 0x7F) <<  7; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part1 |= (b & 0x7F) << 14; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part1 |= (b & 0x7F) << 21; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part2  = (b & 0x7F)      ; if (!(b & 0x80)) goto done;
-    b = *(ptr++); part2 |= (b & 0x7F) <<  7; if (!(b & 0x80)) goto done;
-
-    // We have overrun the maximum size of a varint (10 bytes).  The data
-    // must be corrupt.
-    return NULL;
-
-   done:
-    Advance(ptr - buffer_);
-    *value = (static_cast<uint64>(part0)      ) |
-             (static_cast<uint64>(part1) << 28) |
-             (static_cast<uint64>(part2) << 56);
+    // Fast path:  The varint ends before the end of the buffer.
+    const uint8* end = ReadVarint64FromArray(buffer_, buffer_end_, value);
+    if (end == NULL) return false;
+    buffer_ = end;
     return true;
   } else {
     return ReadVarint64Slow(value);
@@ -205,6 +205,24 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   inline bool InternalReadStringInline(string* buffer,
                                        int size) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // Enables or disables aliasing, which is disabled by default.  While it
+  // is enabled, fields declared with [ctype=STRING_PIECE] are parsed by
+  // pointing them at their bytes in the input, rather than copying them.
+  // Other string fields are still copied.  This is only safe if the input
+  // -- the flat array, or the buffers returned by the ZeroCopyInputStream
+  // -- stays alive and unchanged for as long as the parsed message refers
+  // to it.  The buffers of an ArrayInputStream are parts of its array, but
+  // those of a CopyingInputStreamAdaptor (and so of a FileInputStream) are
+  // reused, so aliasing must not be enabled when reading from one.
+  void EnableAliasing(bool enabled) { aliasing_enabled_ = enabled; }
+
+  // If aliasing is enabled and the next size bytes are all in the current
+  // buffer, points *data at them, skips them, and returns true.  Otherwise
+  // returns false without reading anything.  This should only be used by
+  // the protobuf implementation.
+  inline bool InternalReadAliasedInline(const void** data,
+                                        int size) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
+
 
   // Read a 32-bit little-endian integer.
   bool ReadLittleEndian32(uint32* value);
@@ -227,6 +245,13 @@ class LIBPROTOBUF_EXPORT CodedInputStream {
   // Read an unsigned integer with Varint encoding.
   bool ReadVarint64(uint64* value);
 
+  // Reads a varint from the array [buffer, end), like ReadVarint64().
+  // Returns a pointer past it, or NULL if it does not end before end or is
+  // longer than any varint can be.
+  static const uint8* ReadVarint64FromArray(
+      const uint8* buffer, const uint8* end,
+      uint64* value) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
+
   // Read a tag.  This calls ReadVarint32() and returns the result, or returns
   // zero (which is not a valid tag) if ReadVarint32() fails.  Also, it updates
   // the last tag value, which can be checked with LastTagWas().
@@ -781,6 +806,50 @@ inline const uint8* CodedInputStream::ReadLittleEndian64FromArray(
 #endif
 }
 
+// static
+inline const uint8* CodedInputStream::ReadVarint64FromArray(
+    const uint8* buffer, const uint8* end, uint64* value) {
+#if defined(PROTOBUF_LITTLE_ENDIAN)
+  if (GOOGLE_PREDICT_TRUE(end - buffer >= 8)) {
+    // Decode a varint of up to eight bytes as one word, without a branch
+    // per byte.  It ends at the lowest byte whose top bit is clear.
+    uint64 word;
+    memcpy(&word, buffer, sizeof(word));
+    uint64 stops = ~word & GOOGLE_ULONGLONG(0x8080808080808080);
+    if (GOOGLE_PREDICT_TRUE(stops != 0)) {
+      // The bits of the varint's bytes, without the continuation bits.
+      uint64 mask = stops ^ (stops - 1);
+      uint64 x = word & mask & GOOGLE_ULONGLONG(0x7f7f7f7f7f7f7f7f);
+      // Close the gaps between the 7-bit groups: pairs of bytes, then of
+      // 16-bit halves, then of 32-bit halves.
+      x = ((x & GOOGLE_ULONGLONG(0x7f007f007f007f00)) >> 1) |
+          (x & GOOGLE_ULONGLONG(0x007f007f007f007f));
+      x = ((x & GOOGLE_ULONGLONG(0x3fff00003fff0000)) >> 2) |
+          (x & GOOGLE_ULONGLONG(0x00003fff00003fff));
+      x = ((x & GOOGLE_ULONGLONG(0x0fffffff00000000)) >> 4) |
+          (x & GOOGLE_ULONGLONG(0x000000000fffffff));
+      *value = x;
+      // The number of bytes covered by mask is the sum of their low bits,
+      // which the multiplication gathers into the top byte.  This is
+      // portable, unlike counting trailing zeros.
+      return buffer + static_cast<int>(
+          ((mask & GOOGLE_ULONGLONG(0x0101010101010101)) *
+           GOOGLE_ULONGLONG(0x0101010101010101)) >> 56);
+    }
+  }
+#endif
+  uint64 result = 0;
+  for (int shift = 0; shift < 70 && buffer < end; shift += 7) {
+    uint32 b = *buffer++;
+    result |= static_cast<uint64>(b & 0x7F) << shift;
+    if (b < 0x80) {
+      *value = result;
+      return buffer;
+    }
+  }
+  return NULL;
+}
+
 inline bool CodedInputStream::ReadLittleEndian32(uint32* value) {
 #if defined(PROTOBUF_LITTLE_ENDIAN)
   if (GOOGLE_PREDICT_TRUE(BufferSize() >= static_cast<int>(sizeof(*value)))) {
@@ -866,6 +935,14 @@ inline const uint8* CodedInputStream::ExpectTagFromArray(
   return NULL;
 }
 
+inline bool CodedInputStream::InternalReadAliasedInline(const void** data,
+                                                        int size) {
+  if (!aliasing_enabled_ || size < 0 || size > BufferSize()) return false;
+  *data = buffer_;
+  Advance(size);
+  return true;
+}
+
 inline void CodedInputStream::GetDirectBufferPointerInline(const void** data,
                                                            int* size) {
   *data = buffer_;
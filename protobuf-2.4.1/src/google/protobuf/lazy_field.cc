@@ -0,0 +1,171 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/message_lite.h>
+#include <google/protobuf/wire_format_lite_inl.h>
+#include <google/protobuf/io/coded_stream.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+LazyField::~LazyField() {
+  // A message on an Arena is freed with the Arena.
+  if (arena_ == NULL) delete message_;
+}
+
+void LazyField::Parse(const MessageLite& prototype) const {
+  if (message_current_) return;
+  if (message_ == NULL) {
+    message_ = prototype.New(arena_);
+  }
+  // ParsePartialFromArray() clears the message first.  If the bytes do not
+  // parse, we keep what did; the caller has no way to hear about it.
+  message_->ParsePartialFromArray(bytes_.data(), bytes_.size());
+  message_current_ = true;
+}
+
+const MessageLite& LazyField::Get(const MessageLite& prototype) const {
+  MutexLock lock(&mutex_);
+  if (!message_current_) {
+    // Don't allocate a message just to read an empty field.
+    if (message_ == NULL && bytes_.empty()) return prototype;
+    Parse(prototype);
+  }
+  return *message_;
+}
+
+MessageLite* LazyField::Mutable(const MessageLite& prototype) {
+  Parse(prototype);
+  bytes_.clear();
+  bytes_current_ = false;
+  return message_;
+}
+
+MessageLite* LazyField::Release(const MessageLite& prototype) {
+  if (message_ == NULL && bytes_.empty()) return NULL;
+  MessageLite* result;
+  if (message_current_ && arena_ == NULL) {
+    result = message_;
+    message_ = NULL;
+  } else {
+    result = prototype.New();
+    if (message_current_) {
+      result->CheckTypeAndMergeFrom(*message_);
+    } else {
+      result->ParsePartialFromArray(bytes_.data(), bytes_.size());
+    }
+  }
+  Clear();
+  return result;
+}
+
+void LazyField::Clear() {
+  bytes_.clear();
+  bytes_current_ = true;
+  if (message_ != NULL) {
+    message_->Clear();
+    message_current_ = true;
+  } else {
+    message_current_ = false;
+  }
+}
+
+void LazyField::MergeFrom(const LazyField& other) {
+  if (other.bytes_current_) {
+    if (other.bytes_.empty()) return;
+    if (bytes_current_) {
+      // Concatenated encodings of a message merge, so neither side has to
+      // be parsed.
+      bytes_.append(other.bytes_);
+      message_current_ = false;
+    } else {
+      io::CodedInputStream input(
+          reinterpret_cast<const uint8*>(other.bytes_.data()),
+          other.bytes_.size());
+      message_->MergePartialFromCodedStream(&input);
+    }
+  } else {
+    Mutable(*other.message_)->CheckTypeAndMergeFrom(*other.message_);
+  }
+}
+
+void LazyField::Swap(LazyField* other) {
+  std::swap(message_, other->message_);
+  bytes_.swap(other->bytes_);
+  std::swap(bytes_current_, other->bytes_current_);
+  std::swap(message_current_, other->message_current_);
+}
+
+bool LazyField::MergeFromCodedStream(io::CodedInputStream* input) {
+  if (!bytes_current_) {
+    return WireFormatLite::ReadMessage(input, message_);
+  }
+  message_current_ = false;
+  if (bytes_.empty()) {
+    return WireFormatLite::ReadBytes(input, &bytes_);
+  }
+  string more;
+  if (!WireFormatLite::ReadBytes(input, &more)) return false;
+  bytes_.append(more);
+  return true;
+}
+
+bool LazyField::IsInitialized() const {
+  MutexLock lock(&mutex_);
+  return !message_current_ || message_->IsInitialized();
+}
+
+int LazyField::ByteSize() const {
+  return bytes_current_ ? bytes_.size() : message_->ByteSize();
+}
+
+void LazyField::WriteTo(int number, io::CodedOutputStream* output) const {
+  if (bytes_current_) {
+    WireFormatLite::WriteBytes(number, bytes_, output);
+  } else {
+    WireFormatLite::WriteMessageMaybeToArray(number, *message_, output);
+  }
+}
+
+uint8* LazyField::WriteToArray(int number, uint8* target) const {
+  if (bytes_current_) {
+    return WireFormatLite::WriteBytesToArray(number, bytes_, target);
+  } else {
+    return WireFormatLite::WriteMessageToArray(number, *message_, target);
+  }
+}
+
+}  // namespace internal
+}  // namespace protobuf
+}  // namespace google
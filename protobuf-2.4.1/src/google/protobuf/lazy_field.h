@@ -0,0 +1,143 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains LazyField, which holds a singular sub-message field
+// declared with [lazy=true].  It is used by generated code and by
+// GeneratedMessageReflection, and should not be used directly by users.
+
+#ifndef GOOGLE_PROTOBUF_LAZY_FIELD_H__
+#define GOOGLE_PROTOBUF_LAZY_FIELD_H__
+
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+
+class Arena;
+class MessageLite;
+namespace io {
+  class CodedInputStream;
+  class CodedOutputStream;
+}
+
+namespace internal {
+
+// A LazyField keeps the encoded bytes of the sub-message it reads, and
+// parses them only when the message is first accessed.  Until the message
+// is modified, the bytes stay valid, so serializing the field again just
+// copies them.  Merging more bytes into an unparsed field appends them.
+//
+// Since the parse is deferred, a sub-message that is not well-formed does
+// not make parsing the outer message fail; the field then holds whatever
+// part of the bytes parsed.  Likewise, IsInitialized() does not look for
+// missing required fields in a field that has not been parsed.
+//
+// Get() parses the bytes on first access.  The parse is done under mutex_,
+// so that, as for other fields, the const accessors may be called by
+// several threads at once.
+class LIBPROTOBUF_EXPORT LazyField {
+ public:
+  LazyField()
+    : message_(NULL), arena_(NULL),
+      bytes_current_(true), message_current_(false) {}
+  ~LazyField();
+
+  // Sets the Arena the field allocates its message on.  Called by the
+  // constructor of the message containing the field.
+  void InternalSetArena(Arena* arena) { arena_ = arena; }
+
+  // Returns the message, parsing it if necessary.  prototype is the default
+  // instance of the message type, which is returned if the field is empty.
+  const MessageLite& Get(const MessageLite& prototype) const;
+
+  // Returns the message for modification.  The encoded bytes are dropped.
+  MessageLite* Mutable(const MessageLite& prototype);
+
+  // Returns a heap-allocated message with the field's value, which the
+  // caller owns, and leaves the field empty.  Like the release_ accessor of
+  // other message fields, returns NULL if the field has never been set.
+  MessageLite* Release(const MessageLite& prototype);
+
+  void Clear();
+  void MergeFrom(const LazyField& other);
+  // Both fields must be on the same Arena (or on the heap).
+  void Swap(LazyField* other);
+
+  // Reads a length-delimited sub-message and merges it into the field,
+  // without parsing it if the field is still unparsed.
+  bool MergeFromCodedStream(io::CodedInputStream* input);
+
+  // Whether the message has all of its required fields.  An unparsed field
+  // is assumed to be initialized.
+  bool IsInitialized() const;
+
+  // Returns the size of the encoded message, not counting the tag and
+  // length.  Like MessageLite::ByteSize(), this caches the sizes that
+  // the Write methods use.
+  int ByteSize() const;
+
+  // Writes the field, with its tag and length.
+  void WriteTo(int number, io::CodedOutputStream* output) const;
+  uint8* WriteToArray(int number, uint8* target) const;
+
+  // Like Message::SpaceUsed(), but without sizeof(*this).  Defined in
+  // generated_message_reflection.cc, since only a full Message can say how
+  // much space it uses.
+  int SpaceUsedExcludingSelf() const;
+
+ private:
+  // Parses bytes_ into message_ unless it is already current.  Called
+  // with mutex_ held by the const methods.
+  void Parse(const MessageLite& prototype) const;
+
+  // Guards message_ and message_current_ in the const methods, which may
+  // run in several threads at once.  The non-const methods need no lock,
+  // since nothing else may use the field while they run.
+  mutable Mutex mutex_;
+  // message_ is mutable since Get() parses the bytes.
+  mutable MessageLite* message_;
+  string bytes_;
+  Arena* arena_;
+  // Whether bytes_ is an encoding of the field's value.  If not, message_
+  // is current.  An empty field has empty, current bytes_.
+  bool bytes_current_;
+  // Whether message_ is non-NULL and holds the field's value.
+  mutable bool message_current_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(LazyField);
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_LAZY_FIELD_H__
@@ -39,6 +39,7 @@
 
 #include <google/protobuf/stubs/common.h>
 #include <google/protobuf/stubs/once.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/descriptor.pb.h>
@@ -57,6 +58,12 @@ using internal::ReflectionOps;
 
 Message::~Message() {}
 
+Message* Message::New(Arena* arena) const {
+  Message* message = New();
+  if (arena != NULL) arena->Own(message);
+  return message;
+}
+
 void Message::MergeFrom(const Message& from) {
   const Descriptor* descriptor = GetDescriptor();
   GOOGLE_CHECK_EQ(from.GetDescriptor(), descriptor)
@@ -179,6 +179,11 @@ class LIBPROTOBUF_EXPORT Message : public MessageLite {
   // for return-type covariance.)
   virtual Message* New() const = 0;
 
+  // Construct a new instance of the same type on the given Arena, or on the
+  // heap if arena is NULL.  (Also defined in MessageLite, and again here for
+  // return-type covariance.)
+  virtual Message* New(Arena* arena) const;
+
   // Make this message into a copy of the given message.  The given message
   // must have the same descriptor, but need not necessarily be the same class.
   // By default this is just implemented as "Clear(); MergeFrom(from);".
@@ -45,6 +45,8 @@
 namespace google {
 namespace protobuf {
 
+class Arena;
+
 // Interface to light weight protocol messages.
 //
 // This interface is implemented by all protocol message objects.  Non-lite
@@ -82,6 +84,17 @@ class LIBPROTOBUF_EXPORT MessageLite {
   // caller.
   virtual MessageLite* New() const = 0;
 
+  // Construct a new instance of the same type on the given Arena, which
+  // owns it, or on the heap, owned by the caller, if arena is NULL.
+  // Generated classes put the instance and everything in it in the Arena's
+  // memory; the default implementation calls New() and has the Arena
+  // delete the result.
+  virtual MessageLite* New(Arena* arena) const;
+
+  // Returns the Arena the message was created on, or NULL if it is on the
+  // heap.  A message on an Arena allocates its fields from that Arena.
+  virtual Arena* GetArena() const;
+
   // Clear all fields of the message and set them to their default values.
   // Clear() avoids freeing memory, assuming that any memory allocated
   // to hold parts of the message will be needed again to hold the next
@@ -103,7 +116,9 @@ class LIBPROTOBUF_EXPORT MessageLite {
 
   // Parsing ---------------------------------------------------------
   // Methods for parsing in protocol buffer format.  Most of these are
-  // just simple wrappers around MergeFromCodedStream().
+  // just simple wrappers around MergeFromCodedStream().  When parsing into
+  // a message created on an Arena, the sub-messages, strings and repeated
+  // field elements read are allocated from that Arena.
 
   // Fill the message with a protocol buffer parsed from the given input
   // stream.  Returns false on a read error or if the input is in the
@@ -49,6 +49,7 @@
 #include <string>
 #include <iterator>
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/message_lite.h>
 
 namespace google {
@@ -72,6 +73,8 @@ template <typename Element>
 class RepeatedField {
  public:
   RepeatedField();
+  // Allocates the array from arena, if not NULL.  See arena.h.
+  explicit RepeatedField(Arena* arena);
   RepeatedField(const RepeatedField& other);
   ~RepeatedField();
 
@@ -111,12 +114,20 @@ class RepeatedField {
   Element* mutable_data();
   const Element* data() const;
 
-  // Swap entire contents with "other".
+  // Swap entire contents with "other".  If the two fields are on different
+  // Arenas, this copies the elements.
   void Swap(RepeatedField* other);
 
   // Swap two elements.
   void SwapElements(int index1, int index2);
 
+  // Returns the Arena the array is allocated from, or NULL.
+  Arena* GetArena() const { return arena_; }
+
+  // Makes an empty field allocate from arena.  Only for generated code,
+  // whose fields are constructed before the message knows its Arena.
+  void InternalSetArena(Arena* arena);
+
   // STL-like iterator support
   typedef Element* iterator;
   typedef const Element* const_iterator;
@@ -137,6 +148,7 @@ class RepeatedField {
   Element* elements_;
   int      current_size_;
   int      total_size_;
+  Arena*   arena_;
 
   Element  initial_space_[kInitialSize];
 
@@ -164,8 +176,10 @@ namespace internal {
 //   class TypeHandler {
 //    public:
 //     typedef MyType Type;
-//     static Type* New();
-//     static void Delete(Type*);
+//     // Allocates from arena, or from the heap if arena is NULL.
+//     static Type* New(Arena* arena);
+//     // Deletes an object allocated by New(arena); a no-op on an Arena.
+//     static void Delete(Type*, Arena* arena);
 //     static void Clear(Type*);
 //     static void Merge(const Type& from, Type* to);
 //
@@ -186,7 +200,12 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   // use of AddFromCleared(), which is not part of the public interface.
   friend class ExtensionSet;
 
+  // WireFormatLite::ParseFromTable() adds to repeated message fields
+  // without knowing their types, as the reflection implementation does.
+  friend class WireFormatLite;
+
   RepeatedPtrFieldBase();
+  explicit RepeatedPtrFieldBase(Arena* arena);
 
   // Must be called from destructor.
   template <typename TypeHandler>
@@ -222,6 +241,7 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   template <typename TypeHandler>
   const typename TypeHandler::Type* const* data() const;
 
+  // Both fields must be on the same Arena (or both on the heap).
   void Swap(RepeatedPtrFieldBase* other);
 
   void SwapElements(int index1, int index2);
@@ -229,6 +249,9 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   template <typename TypeHandler>
   int SpaceUsedExcludingSelf() const;
 
+  Arena* GetArena() const { return arena_; }
+  void InternalSetArena(Arena* arena);
+
 
   // Advanced memory management --------------------------------------
 
@@ -238,6 +261,11 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
 
   template <typename TypeHandler>
   void AddAllocated(typename TypeHandler::Type* value);
+  // Like AddAllocated(), but value must already be owned by the field's
+  // Arena (or be on the heap if the field is), as when the reflection
+  // implementation creates it with New(GetArena()).
+  template <typename TypeHandler>
+  void UnsafeArenaAddAllocated(typename TypeHandler::Type* value);
   template <typename TypeHandler>
   typename TypeHandler::Type* ReleaseLast();
 
@@ -253,6 +281,7 @@ class LIBPROTOBUF_EXPORT RepeatedPtrFieldBase {
   static const int kInitialSize = 4;
 
   void** elements_;
+  Arena* arena_;
   int    current_size_;
   int    allocated_size_;
   int    total_size_;
@@ -273,8 +302,12 @@ template <typename GenericType>
 class GenericTypeHandler {
  public:
   typedef GenericType Type;
-  static GenericType* New() { return new GenericType; }
-  static void Delete(GenericType* value) { delete value; }
+  static GenericType* New(Arena* arena) {
+    return Arena::Create<GenericType>(arena);
+  }
+  static void Delete(GenericType* value, Arena* arena) {
+    if (arena == NULL) delete value;
+  }
   static void Clear(GenericType* value) { value->Clear(); }
   static void Merge(const GenericType& from, GenericType* to) {
     to->MergeFrom(from);
@@ -299,8 +332,8 @@ inline void GenericTypeHandler<MessageLite>::Merge(
 class LIBPROTOBUF_EXPORT StringTypeHandlerBase {
  public:
   typedef string Type;
-  static string* New();
-  static void Delete(string* value);
+  static string* New(Arena* arena);
+  static void Delete(string* value, Arena* arena);
   static void Clear(string* value) { value->clear(); }
   static void Merge(const string& from, string* to) { *to = from; }
 };
@@ -321,6 +354,9 @@ template <typename Element>
 class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
  public:
   RepeatedPtrField();
+  // Allocates the elements and the array from arena, if not NULL, which
+  // then owns them.  See arena.h.
+  explicit RepeatedPtrField(Arena* arena);
   RepeatedPtrField(const RepeatedPtrField& other);
   ~RepeatedPtrField();
 
@@ -348,12 +384,22 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   Element** mutable_data();
   const Element* const* data() const;
 
-  // Swap entire contents with "other".
+  // Swap entire contents with "other".  If the two fields are on different
+  // Arenas, this copies the elements.
   void Swap(RepeatedPtrField* other);
 
   // Swap two elements.
   void SwapElements(int index1, int index2);
 
+  // Returns the Arena the elements are allocated from, or NULL.
+  Arena* GetArena() const { return RepeatedPtrFieldBase::GetArena(); }
+
+  // Makes an empty field allocate from arena.  Only for generated code,
+  // whose fields are constructed before the message knows its Arena.
+  void InternalSetArena(Arena* arena) {
+    RepeatedPtrFieldBase::InternalSetArena(arena);
+  }
+
   // STL-like iterator support
   typedef internal::RepeatedPtrIterator<Element> iterator;
   typedef internal::RepeatedPtrIterator<const Element> const_iterator;
@@ -379,10 +425,12 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   // does here at Google -- the following methods may be useful.
 
   // Add an already-allocated object, passing ownership to the
-  // RepeatedPtrField.
+  // RepeatedPtrField.  value must be on the heap; if the field is on an
+  // Arena, the Arena takes ownership of it.
   void AddAllocated(Element* value);
   // Remove the last element and return it, passing ownership to the
-  // caller.
+  // caller.  If the field is on an Arena, this returns a heap-allocated
+  // copy of the element instead.
   // Requires:  size() > 0
   Element* ReleaseLast();
 
@@ -400,10 +448,11 @@ class RepeatedPtrField : public internal::RepeatedPtrFieldBase {
   int ClearedCount() const;
   // Add an element to the pool of cleared objects, passing ownership to
   // the RepeatedPtrField.  The element must be cleared prior to calling
-  // this method.
+  // this method.  As with AddAllocated(), it must be on the heap.
   void AddCleared(Element* value);
   // Remove a single element from the cleared pool and return it, passing
   // ownership to the caller.  The element is guaranteed to be cleared.
+  // If the field is on an Arena, this returns a new heap-allocated element.
   // Requires:  ClearedCount() > 0
   Element* ReleaseCleared();
 
@@ -422,20 +471,30 @@ template <typename Element>
 inline RepeatedField<Element>::RepeatedField()
   : elements_(initial_space_),
     current_size_(0),
-    total_size_(kInitialSize) {
+    total_size_(kInitialSize),
+    arena_(NULL) {
+}
+
+template <typename Element>
+inline RepeatedField<Element>::RepeatedField(Arena* arena)
+  : elements_(initial_space_),
+    current_size_(0),
+    total_size_(kInitialSize),
+    arena_(arena) {
 }
 
 template <typename Element>
 inline RepeatedField<Element>::RepeatedField(const RepeatedField& other)
   : elements_(initial_space_),
     current_size_(0),
-    total_size_(kInitialSize) {
+    total_size_(kInitialSize),
+    arena_(NULL) {
   CopyFrom(other);
 }
 
 template <typename Element>
 RepeatedField<Element>::~RepeatedField() {
-  if (elements_ != initial_space_) {
+  if (elements_ != initial_space_ && arena_ == NULL) {
     delete [] elements_;
   }
 }
@@ -534,8 +593,22 @@ inline const Element* RepeatedField<Element>::data() const {
 }
 
 
+template <typename Element>
+inline void RepeatedField<Element>::InternalSetArena(Arena* arena) {
+  GOOGLE_DCHECK(elements_ == initial_space_);
+  arena_ = arena;
+}
+
 template <typename Element>
 void RepeatedField<Element>::Swap(RepeatedField* other) {
+  if (arena_ != other->arena_) {
+    // Each array must stay with the Arena (or heap) it came from.
+    RepeatedField<Element> temp(*other);
+    other->CopyFrom(*this);
+    CopyFrom(temp);
+    return;
+  }
+
   Element* swap_elements     = elements_;
   int      swap_current_size = current_size_;
   int      swap_total_size   = total_size_;
@@ -601,9 +674,9 @@ void RepeatedField<Element>::Reserve(int new_size) {
 
   Element* old_elements = elements_;
   total_size_ = max(total_size_ * 2, new_size);
-  elements_ = new Element[total_size_];
+  elements_ = Arena::CreateArray<Element>(arena_, total_size_);
   MoveArray(elements_, old_elements, current_size_);
-  if (old_elements != initial_space_) {
+  if (old_elements != initial_space_ && arena_ == NULL) {
     delete [] old_elements;
   }
 }
@@ -633,15 +706,31 @@ namespace internal {
 
 inline RepeatedPtrFieldBase::RepeatedPtrFieldBase()
   : elements_(initial_space_),
+    arena_(NULL),
+    current_size_(0),
+    allocated_size_(0),
+    total_size_(kInitialSize) {
+}
+
+inline RepeatedPtrFieldBase::RepeatedPtrFieldBase(Arena* arena)
+  : elements_(initial_space_),
+    arena_(arena),
     current_size_(0),
     allocated_size_(0),
     total_size_(kInitialSize) {
 }
 
+inline void RepeatedPtrFieldBase::InternalSetArena(Arena* arena) {
+  GOOGLE_DCHECK_EQ(allocated_size_, 0);
+  arena_ = arena;
+}
+
 template <typename TypeHandler>
 void RepeatedPtrFieldBase::Destroy() {
+  // On an Arena, the elements and the array belong to the Arena.
+  if (arena_ != NULL) return;
   for (int i = 0; i < allocated_size_; i++) {
-    TypeHandler::Delete(cast<TypeHandler>(elements_[i]));
+    TypeHandler::Delete(cast<TypeHandler>(elements_[i]), NULL);
   }
   if (elements_ != initial_space_) {
     delete [] elements_;
@@ -674,7 +763,7 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::Add() {
   }
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
   ++allocated_size_;
-  typename TypeHandler::Type* result = TypeHandler::New();
+  typename TypeHandler::Type* result = TypeHandler::New(arena_);
   elements_[current_size_++] = result;
   return result;
 }
@@ -758,7 +847,14 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::AddFromCleared() {
 }
 
 template <typename TypeHandler>
-void RepeatedPtrFieldBase::AddAllocated(
+inline void RepeatedPtrFieldBase::AddAllocated(
+    typename TypeHandler::Type* value) {
+  if (arena_ != NULL) arena_->Own(value);
+  UnsafeArenaAddAllocated<TypeHandler>(value);
+}
+
+template <typename TypeHandler>
+void RepeatedPtrFieldBase::UnsafeArenaAddAllocated(
     typename TypeHandler::Type* value) {
   // Make room for the new pointer.
   if (current_size_ == total_size_) {
@@ -770,7 +866,7 @@ void RepeatedPtrFieldBase::AddAllocated(
     // cleared objects awaiting reuse.  We don't want to grow the array in this
     // case because otherwise a loop calling AddAllocated() followed by Clear()
     // would leak memory.
-    TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]));
+    TypeHandler::Delete(cast<TypeHandler>(elements_[current_size_]), arena_);
   } else if (current_size_ < allocated_size_) {
     // We have some cleared objects.  We don't care about their order, so we
     // can just move the first one to the end to make space.
@@ -795,6 +891,12 @@ inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseLast() {
     // with the last allocated element.
     elements_[current_size_] = elements_[allocated_size_];
   }
+  if (arena_ != NULL) {
+    // The element stays with the Arena; the caller gets a copy it can own.
+    typename TypeHandler::Type* copy = TypeHandler::New(NULL);
+    TypeHandler::Merge(*result, copy);
+    result = copy;
+  }
   return result;
 }
 
@@ -806,6 +908,7 @@ inline int RepeatedPtrFieldBase::ClearedCount() const {
 template <typename TypeHandler>
 inline void RepeatedPtrFieldBase::AddCleared(
     typename TypeHandler::Type* value) {
+  if (arena_ != NULL) arena_->Own(value);
   if (allocated_size_ == total_size_) Reserve(total_size_ + 1);
   elements_[allocated_size_++] = value;
 }
@@ -813,7 +916,10 @@ inline void RepeatedPtrFieldBase::AddCleared(
 template <typename TypeHandler>
 inline typename TypeHandler::Type* RepeatedPtrFieldBase::ReleaseCleared() {
   GOOGLE_DCHECK_GT(allocated_size_, current_size_);
-  return cast<TypeHandler>(elements_[--allocated_size_]);
+  typename TypeHandler::Type* result =
+      cast<TypeHandler>(elements_[--allocated_size_]);
+  // Cleared elements are empty, so a new one will do for the caller.
+  return arena_ == NULL ? result : TypeHandler::New(NULL);
 }
 
 }  // namespace internal
@@ -832,6 +938,10 @@ class RepeatedPtrField<string>::TypeHandler
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField() {}
 
+template <typename Element>
+inline RepeatedPtrField<Element>::RepeatedPtrField(Arena* arena)
+  : RepeatedPtrFieldBase(arena) {}
+
 template <typename Element>
 inline RepeatedPtrField<Element>::RepeatedPtrField(
     const RepeatedPtrField& other) {
@@ -904,6 +1014,13 @@ inline const Element* const* RepeatedPtrField<Element>::data() const {
 
 template <typename Element>
 void RepeatedPtrField<Element>::Swap(RepeatedPtrField* other) {
+  if (GetArena() != other->GetArena()) {
+    // Each element must stay with the Arena (or heap) it came from.
+    RepeatedPtrField<Element> temp(*other);
+    other->CopyFrom(*this);
+    CopyFrom(temp);
+    return;
+  }
   RepeatedPtrFieldBase::Swap(other);
 }
 
@@ -0,0 +1,114 @@
+// Protocol Buffers - Google's data interchange format
+// Copyright 2008 Google Inc.  All rights reserved.
+// http://code.google.com/p/protobuf/
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+// notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above
+// copyright notice, this list of conditions and the following disclaimer
+// in the documentation and/or other materials provided with the
+// distribution.
+//     * Neither the name of Google Inc. nor the names of its
+// contributors may be used to endorse or promote products derived from
+// this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+// OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+// LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+// DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+// THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// This file contains StringPieceField, which holds a singular string or
+// bytes field declared with [ctype=STRING_PIECE].
+
+#ifndef GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
+#define GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
+
+#include <algorithm>
+#include <string>
+
+#include <google/protobuf/stubs/common.h>
+
+namespace google {
+namespace protobuf {
+namespace internal {
+
+// The value of a [ctype=STRING_PIECE] field.  It either owns a copy of
+// its bytes, like a string field, or points at bytes owned by someone
+// else: the default value, or the input a message was parsed from with
+// CodedInputStream::EnableAliasing(true).  The generated accessor for the
+// field returns a const reference to one of these.
+class LIBPROTOBUF_EXPORT StringPieceField {
+ public:
+  StringPieceField() : data_(""), size_(0), owned_(false) {}
+
+  const char* data() const { return owned_ ? buffer_.data() : data_; }
+  int size() const { return owned_ ? buffer_.size() : size_; }
+  bool empty() const { return size() == 0; }
+  string ToString() const { return string(data(), size()); }
+
+  // Copies the value into the field.
+  void Set(const char* data, int size) {
+    buffer_.assign(data, size);
+    owned_ = true;
+  }
+  void Set(const string& value) { Set(value.data(), value.size()); }
+  void Set(const char* value) {
+    buffer_.assign(value);
+    owned_ = true;
+  }
+
+  // Points the field at size bytes at data, which must stay alive and
+  // unchanged for as long as the field refers to them.
+  void SetAlias(const char* data, int size) {
+    data_ = data;
+    size_ = size;
+    owned_ = false;
+  }
+
+  // Empties the field, keeping the capacity of any copy it owned.
+  void Clear() { SetAlias("", 0); }
+
+  // Returns the string the field's own copy is kept in, for parsing into.
+  // The field refers to the copy from then on.
+  string* InternalMutableBuffer() {
+    owned_ = true;
+    return &buffer_;
+  }
+
+  void Swap(StringPieceField* other) {
+    std::swap(data_, other->data_);
+    std::swap(size_, other->size_);
+    std::swap(owned_, other->owned_);
+    buffer_.swap(other->buffer_);
+  }
+
+  // Like Message::SpaceUsed(), but without sizeof(*this).  Aliased bytes
+  // are not counted.
+  int SpaceUsedExcludingSelf() const;
+
+ private:
+  // The aliased bytes, if !owned_.  Otherwise the value is buffer_.
+  const char* data_;
+  int size_;
+  bool owned_;
+  string buffer_;
+
+  GOOGLE_DISALLOW_EVIL_CONSTRUCTORS(StringPieceField);
+};
+
+}  // namespace internal
+}  // namespace protobuf
+
+}  // namespace google
+#endif  // GOOGLE_PROTOBUF_STRING_PIECE_FIELD_H__
@@ -229,6 +229,10 @@ class LIBPROTOBUF_EXPORT WireFormat {
   // Verifies that a string field is valid UTF8, logging an error if not.
   static void VerifyUTF8String(const char* data, int size, Operation op);
 
+  // Like VerifyUTF8String(data, size, PARSE).  Generated messages pass this
+  // to WireFormatLite::ParseFromTable(), which cannot verify UTF8 itself.
+  static void VerifyParsedUTF8String(const char* data, int size);
+
  private:
   // Verifies that a string field is valid UTF8, logging an error if not.
   static void VerifyUTF8StringFallback(
@@ -296,6 +300,10 @@ inline void WireFormat::VerifyUTF8String(const char* data, int size,
 #endif
 }
 
+inline void WireFormat::VerifyParsedUTF8String(const char* data, int size) {
+  VerifyUTF8String(data, size, PARSE);
+}
+
 
 }  // namespace internal
 }  // namespace protobuf
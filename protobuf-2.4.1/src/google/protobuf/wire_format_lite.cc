@@ -38,6 +38,9 @@
 #include <string>
 #include <vector>
 #include <google/protobuf/stubs/common.h>
+#include <google/protobuf/arena.h>
+#include <google/protobuf/lazy_field.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/io/coded_stream_inl.h>
 #include <google/protobuf/io/zero_copy_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
@@ -206,6 +209,435 @@ bool WireFormatLite::ReadPackedEnumNoInline(io::CodedInputStream* input,
   return true;
 }
 
+// -------------------------------------------------------------------
+
+namespace {
+
+template <typename Type>
+inline Type* Raw(MessageLite* message, int offset) {
+  return reinterpret_cast<Type*>(reinterpret_cast<char*>(message) + offset);
+}
+
+inline void SetHasBit(uint32* has_bits, int index) {
+  uint32 bit = static_cast<uint32>(index);
+  has_bits[bit / 32] |= static_cast<uint32>(1) << (bit % 32);
+}
+
+// Finds the field with the given number, or returns NULL.
+const ParseTableField* FindParseTableField(const ParseTableField* begin,
+                                           const ParseTableField* end,
+                                           int number) {
+  // Fields are usually numbered from 1 without gaps, so try the field at
+  // the index that would have the number before searching.
+  if (number > 0 && number <= end - begin &&
+      WireFormatLite::GetTagFieldNumber(begin[number - 1].tag) == number) {
+    return begin + number - 1;
+  }
+  while (begin < end) {
+    const ParseTableField* middle = begin + (end - begin) / 2;
+    int middle_number = WireFormatLite::GetTagFieldNumber(middle->tag);
+    if (middle_number < number) {
+      begin = middle + 1;
+    } else if (middle_number > number) {
+      end = middle;
+    } else {
+      return middle;
+    }
+  }
+  return NULL;
+}
+
+// Returns whether tag is for a value of field, if field is a packable
+// repeated field, but packed when field is declared unpacked or unpacked
+// when it is declared packed.
+bool IsOtherPacking(const ParseTableField& field, uint32 tag) {
+  if (field.has_bit >= 0) return false;
+  WireFormatLite::WireType wire_type = WireFormatLite::WireTypeForFieldType(
+      static_cast<WireFormatLite::FieldType>(field.type));
+  if (wire_type == WireFormatLite::WIRETYPE_LENGTH_DELIMITED ||
+      wire_type == WireFormatLite::WIRETYPE_START_GROUP) {
+    return false;
+  }
+  return WireFormatLite::GetTagWireType(tag) ==
+      (field.packed ? wire_type : WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+}
+
+// Reads a value of a primitive field into the field, if it is singular.
+// If it is repeated, reads the run of values that starts there, or if
+// packed is true, a packed run of values.
+template <typename CType, WireFormatLite::FieldType DeclaredType>
+inline bool ReadPrimitiveField(io::CodedInputStream* input, uint32 tag,
+                               const ParseTableField& field, bool packed,
+                               MessageLite* message, uint32* has_bits) {
+  if (field.has_bit >= 0) {
+    if (!WireFormatLite::ReadPrimitive<CType, DeclaredType>(
+            input, Raw<CType>(message, field.offset))) {
+      return false;
+    }
+    SetHasBit(has_bits, field.has_bit);
+    return true;
+  }
+
+  RepeatedField<CType>* values =
+      Raw<RepeatedField<CType> >(message, field.offset);
+  if (packed) {
+    return WireFormatLite::ReadPackedPrimitiveNoInline<CType, DeclaredType>(
+        input, values);
+  }
+  return WireFormatLite::ReadRepeatedPrimitiveNoInline<CType, DeclaredType>(
+      io::CodedOutputStream::VarintSize32(tag), tag, input, values);
+}
+
+// Returns the string to read a value of a string field into: the field
+// itself, allocated on the message's arena if it is still the default,
+// or a new element if the field is repeated.
+inline string* MutableStringField(const ParseTable& table,
+                                  const ParseTableField& field,
+                                  MessageLite* message, uint32* has_bits) {
+  if (field.has_bit < 0) {
+    return Raw<RepeatedPtrField<string> >(message, field.offset)->Add();
+  }
+  string** pointer = Raw<string*>(message, field.offset);
+  if (*pointer == field.default_string) {
+    *pointer = Arena::Create<string>(
+        *Raw<Arena*>(message, table.arena_offset));
+  }
+  SetHasBit(has_bits, field.has_bit);
+  return *pointer;
+}
+
+// Stores a value of a primitive field, or adds it if the field is repeated.
+template <typename CType>
+inline void StorePrimitiveField(const ParseTableField& field, CType value,
+                                MessageLite* message, uint32* has_bits) {
+  if (field.has_bit >= 0) {
+    *Raw<CType>(message, field.offset) = value;
+    SetHasBit(has_bits, field.has_bit);
+  } else {
+    Raw<RepeatedField<CType> >(message, field.offset)->Add(value);
+  }
+}
+
+// Reads a varint from the buffer, which ends at end.  Returns a pointer
+// past it, or NULL if it does not end before end, or within ten bytes.
+inline const uint8* ReadVarintFromBuffer(const uint8* ptr, const uint8* end,
+                                         uint64* value) {
+  if (GOOGLE_PREDICT_TRUE(ptr < end) && *ptr < 0x80) {
+    *value = *ptr;
+    return ptr + 1;
+  }
+  return io::CodedInputStream::ReadVarint64FromArray(ptr, end, value);
+}
+
+// Reads fields straight from the buffer [ptr, end), for as long as the
+// next tag is the one *field_ptr (or the field after it) expects and the
+// field is of a primitive or string type; advances *field_ptr like
+// ParseFromTable does.  Returns a pointer past the last field read.
+// Everything else -- an unexpected tag, a sub-message, a packed field, a
+// value that runs past end -- is left for ParseFromTable to read through
+// the CodedInputStream, so the stream's limits and buffer refills only
+// need handling there.
+inline const uint8* ParseFieldsFromBuffer(
+    const uint8* ptr, const uint8* end, const ParseTable& table,
+    MessageLite* message, uint32* has_bits, FieldSkipper* skipper,
+    const ParseTableField** field_ptr) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
+inline const uint8* ParseFieldsFromBuffer(
+    const uint8* ptr, const uint8* end, const ParseTable& table,
+    MessageLite* message, uint32* has_bits, FieldSkipper* skipper,
+    const ParseTableField** field_ptr) {
+  const ParseTableField* field = *field_ptr;
+  const ParseTableField* fields_end = table.fields + table.num_fields;
+
+  while (ptr < end) {
+    // Only tags of one or two bytes are read here.
+    uint32 tag = ptr[0];
+    const uint8* value_ptr = ptr + 1;
+    if (tag >= 0x80) {
+      if (value_ptr == end || *value_ptr >= 0x80) break;
+      tag = (tag & 0x7F) | (static_cast<uint32>(*value_ptr) << 7);
+      ++value_ptr;
+    }
+    if (!GOOGLE_PREDICT_TRUE(field != fields_end && field->tag == tag)) {
+      if (field == fields_end || field + 1 == fields_end ||
+          field[1].tag != tag) {
+        break;
+      }
+      ++field;
+    }
+
+    // Packed values are left for ParseFromTable too, as are StringPieceFields,
+    // which may alias the input.
+    if (field->packed || field->string_piece) break;
+
+    uint64 varint;
+    switch (field->type) {
+#define HANDLE_VARINT_TYPE(TYPE, CPPTYPE, VALUE)                              \
+      case WireFormatLite::TYPE_##TYPE:                                       \
+        value_ptr = ReadVarintFromBuffer(value_ptr, end, &varint);            \
+        if (value_ptr == NULL) break;                                         \
+        StorePrimitiveField<CPPTYPE>(*field, VALUE, message, has_bits);       \
+        break;
+
+      HANDLE_VARINT_TYPE( INT32,  int32, static_cast<int32>(varint))
+      HANDLE_VARINT_TYPE( INT64,  int64, static_cast<int64>(varint))
+      HANDLE_VARINT_TYPE(UINT32, uint32, static_cast<uint32>(varint))
+      HANDLE_VARINT_TYPE(UINT64, uint64, varint)
+      HANDLE_VARINT_TYPE(SINT32,  int32,
+          WireFormatLite::ZigZagDecode32(static_cast<uint32>(varint)))
+      HANDLE_VARINT_TYPE(SINT64,  int64,
+          WireFormatLite::ZigZagDecode64(varint))
+      HANDLE_VARINT_TYPE(  BOOL,   bool, static_cast<uint32>(varint) != 0)
+#undef HANDLE_VARINT_TYPE
+
+#define HANDLE_FIXED_TYPE(TYPE, CPPTYPE)                                      \
+      case WireFormatLite::TYPE_##TYPE: {                                     \
+        if (end - value_ptr < static_cast<int>(sizeof(CPPTYPE))) {            \
+          value_ptr = NULL;                                                   \
+          break;                                                              \
+        }                                                                     \
+        CPPTYPE value;                                                        \
+        value_ptr = WireFormatLite::ReadPrimitiveFromArray<                   \
+            CPPTYPE, WireFormatLite::TYPE_##TYPE>(value_ptr, &value);         \
+        StorePrimitiveField<CPPTYPE>(*field, value, message, has_bits);       \
+        break;                                                                \
+      }
+
+      HANDLE_FIXED_TYPE( FIXED32, uint32)
+      HANDLE_FIXED_TYPE( FIXED64, uint64)
+      HANDLE_FIXED_TYPE(SFIXED32,  int32)
+      HANDLE_FIXED_TYPE(SFIXED64,  int64)
+      HANDLE_FIXED_TYPE(   FLOAT,  float)
+      HANDLE_FIXED_TYPE(  DOUBLE, double)
+#undef HANDLE_FIXED_TYPE
+
+      case WireFormatLite::TYPE_ENUM: {
+        value_ptr = ReadVarintFromBuffer(value_ptr, end, &varint);
+        if (value_ptr == NULL) break;
+        int value = static_cast<int>(varint);
+        if (field->is_valid(value)) {
+          StorePrimitiveField<int>(*field, value, message, has_bits);
+        } else {
+          skipper->SkipUnknownEnum(WireFormatLite::GetTagFieldNumber(tag),
+                                   value);
+        }
+        break;
+      }
+
+      case WireFormatLite::TYPE_STRING:
+      case WireFormatLite::TYPE_BYTES: {
+        value_ptr = ReadVarintFromBuffer(value_ptr, end, &varint);
+        if (value_ptr == NULL ||
+            varint > static_cast<uint64>(end - value_ptr)) {
+          value_ptr = NULL;
+          break;
+        }
+        string* value = MutableStringField(table, *field, message, has_bits);
+        int size = static_cast<int>(varint);
+        value->assign(reinterpret_cast<const char*>(value_ptr), size);
+        if (field->type == WireFormatLite::TYPE_STRING &&
+            table.verify_utf8 != NULL) {
+          table.verify_utf8(value->data(), size);
+        }
+        value_ptr += size;
+        break;
+      }
+
+      default:
+        value_ptr = NULL;
+        break;
+    }
+    if (value_ptr == NULL) break;
+
+    ptr = value_ptr;
+    if (field->has_bit >= 0) ++field;
+  }
+
+  *field_ptr = field;
+  return ptr;
+}
+
+}  // namespace
+
+bool WireFormatLite::ParseFromTable(io::CodedInputStream* input,
+                                    const ParseTable& table,
+                                    MessageLite* message,
+                                    FieldSkipper* skipper,
+                                    uint32* tag_out) {
+  uint32* has_bits = Raw<uint32>(message, table.has_bits_offset);
+  const ParseTableField* begin = table.fields;
+  const ParseTableField* end = begin + table.num_fields;
+
+  // Fields are usually written in order of number, so we guess that each
+  // tag is for the field after the last one, and only look the tag up
+  // when that is wrong.  The values of a repeated field are read in one
+  // go, as long as they follow each other.
+  const ParseTableField* field = begin;
+
+  while (true) {
+    const void* data;
+    int size;
+    input->GetDirectBufferPointerInline(&data, &size);
+    const uint8* buffer = static_cast<const uint8*>(data);
+    const uint8* buffer_read = ParseFieldsFromBuffer(
+        buffer, buffer + size, table, message, has_bits, skipper, &field);
+    if (buffer_read != buffer) input->Skip(buffer_read - buffer);
+    if (input->ExpectAtEnd()) {
+      // The end of a sub-message: don't bother trying to read a tag.
+      *tag_out = 0;
+      return true;
+    }
+
+    uint32 tag = input->ReadTag();
+    bool packed;
+
+    if (field != end && field->tag == tag) {
+      packed = field->packed;
+    } else {
+      if (tag == 0) {
+        *tag_out = 0;
+        return true;
+      }
+      field = FindParseTableField(begin, end, GetTagFieldNumber(tag));
+      if (field != NULL && field->tag == tag) {
+        packed = field->packed;
+      } else if (field != NULL && IsOtherPacking(*field, tag)) {
+        // A packable field written packed although it is declared unpacked,
+        // or the other way around.  We accept both.
+        packed = !field->packed;
+      } else {
+        if (GetTagWireType(tag) == WIRETYPE_END_GROUP ||
+            table.has_extensions) {
+          *tag_out = tag;
+          return true;
+        }
+        if (!skipper->SkipField(input, tag)) return false;
+        field = end;
+        continue;
+      }
+    }
+
+    switch (field->type) {
+#define HANDLE_TYPE(TYPE, CPPTYPE)                                            \
+      case TYPE_##TYPE:                                                       \
+        if (!ReadPrimitiveField<CPPTYPE, TYPE_##TYPE>(                        \
+                input, tag, *field, packed, message, has_bits)) {             \
+          return false;                                                       \
+        }                                                                     \
+        break;
+
+      HANDLE_TYPE(   INT32,  int32)
+      HANDLE_TYPE(   INT64,  int64)
+      HANDLE_TYPE(  UINT32, uint32)
+      HANDLE_TYPE(  UINT64, uint64)
+      HANDLE_TYPE(  SINT32,  int32)
+      HANDLE_TYPE(  SINT64,  int64)
+      HANDLE_TYPE( FIXED32, uint32)
+      HANDLE_TYPE( FIXED64, uint64)
+      HANDLE_TYPE(SFIXED32,  int32)
+      HANDLE_TYPE(SFIXED64,  int64)
+      HANDLE_TYPE(   FLOAT,  float)
+      HANDLE_TYPE(  DOUBLE, double)
+      HANDLE_TYPE(    BOOL,   bool)
+#undef HANDLE_TYPE
+
+      case TYPE_ENUM: {
+        if (packed) {
+          if (!ReadPackedEnumNoInline(
+                  input, field->is_valid,
+                  Raw<RepeatedField<int> >(message, field->offset))) {
+            return false;
+          }
+          break;
+        }
+        do {
+          int value;
+          if (!ReadPrimitive<int, TYPE_ENUM>(input, &value)) return false;
+          if (!field->is_valid(value)) {
+            skipper->SkipUnknownEnum(GetTagFieldNumber(tag), value);
+          } else if (field->has_bit >= 0) {
+            *Raw<int>(message, field->offset) = value;
+            SetHasBit(has_bits, field->has_bit);
+          } else {
+            Raw<RepeatedField<int> >(message, field->offset)->Add(value);
+          }
+        } while (field->has_bit < 0 && input->ExpectTag(tag));
+        break;
+      }
+
+      case TYPE_STRING:
+      case TYPE_BYTES: {
+        if (field->string_piece) {
+          StringPieceField* value =
+              Raw<StringPieceField>(message, field->offset);
+          if (!ReadBytes(input, value)) return false;
+          SetHasBit(has_bits, field->has_bit);
+          if (field->type == TYPE_STRING && table.verify_utf8 != NULL) {
+            table.verify_utf8(value->data(), value->size());
+          }
+          break;
+        }
+        do {
+          string* value = MutableStringField(table, *field, message, has_bits);
+          if (!ReadBytes(input, value)) return false;
+          if (field->type == TYPE_STRING && table.verify_utf8 != NULL) {
+            table.verify_utf8(value->data(), value->size());
+          }
+        } while (field->has_bit < 0 && input->ExpectTag(tag));
+        break;
+      }
+
+      case TYPE_MESSAGE:
+      case TYPE_GROUP: {
+        if (field->lazy) {
+          if (!Raw<LazyField>(message, field->offset)
+                  ->MergeFromCodedStream(input)) {
+            return false;
+          }
+          SetHasBit(has_bits, field->has_bit);
+          break;
+        }
+        if (field->has_bit >= 0) {
+          MessageLite** pointer = Raw<MessageLite*>(message, field->offset);
+          if (*pointer == NULL) {
+            *pointer =
+                field->new_message(*Raw<Arena*>(message, table.arena_offset));
+          }
+          SetHasBit(has_bits, field->has_bit);
+          if (field->type == TYPE_MESSAGE) {
+            if (!ReadMessage(input, *pointer)) return false;
+          } else {
+            if (!ReadGroup(GetTagFieldNumber(tag), input, *pointer)) {
+              return false;
+            }
+          }
+          break;
+        }
+        RepeatedPtrFieldBase* values =
+            Raw<RepeatedPtrFieldBase>(message, field->offset);
+        do {
+          MessageLite* value =
+              values->AddFromCleared<GenericTypeHandler<MessageLite> >();
+          if (value == NULL) {
+            value = field->new_message(values->GetArena());
+            values->UnsafeArenaAddAllocated<
+                GenericTypeHandler<MessageLite> >(value);
+          }
+          if (field->type == TYPE_MESSAGE) {
+            if (!ReadMessage(input, value)) return false;
+          } else {
+            if (!ReadGroup(GetTagFieldNumber(tag), input, value)) {
+              return false;
+            }
+          }
+        } while (input->ExpectTag(tag));
+        break;
+      }
+    }
+
+    ++field;
+  }
+}
+
 void WireFormatLite::WriteInt32(int field_number, int32 value,
                                 io::CodedOutputStream* output) {
   WriteTag(field_number, WIRETYPE_VARINT, output);
@@ -290,6 +722,19 @@ void WireFormatLite::WriteBytes(int field_number, const string& value,
   output->WriteVarint32(value.size());
   output->WriteString(value);
 }
+void WireFormatLite::WriteString(int field_number,
+                                 const StringPieceField& value,
+                                 io::CodedOutputStream* output) {
+  // String is for UTF-8 text only
+  WriteBytes(field_number, value, output);
+}
+void WireFormatLite::WriteBytes(int field_number,
+                                const StringPieceField& value,
+                                io::CodedOutputStream* output) {
+  WriteTag(field_number, WIRETYPE_LENGTH_DELIMITED, output);
+  output->WriteVarint32(value.size());
+  output->WriteRaw(value.data(), value.size());
+}
 
 
 void WireFormatLite::WriteGroup(int field_number,
@@ -354,6 +799,24 @@ bool WireFormatLite::ReadBytes(io::CodedInputStream* input,
   return input->InternalReadStringInline(value, length);
 }
 
+bool WireFormatLite::ReadString(io::CodedInputStream* input,
+                                StringPieceField* value) {
+  // String is for UTF-8 text only
+  return ReadBytes(input, value);
+}
+bool WireFormatLite::ReadBytes(io::CodedInputStream* input,
+                               StringPieceField* value) {
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+  const void* data;
+  if (input->InternalReadAliasedInline(&data, length)) {
+    value->SetAlias(static_cast<const char*>(data), length);
+    return true;
+  }
+  return input->InternalReadStringInline(value->InternalMutableBuffer(),
+                                         length);
+}
+
 }  // namespace internal
 }  // namespace protobuf
 }  // namespace google
@@ -41,6 +41,7 @@
 #define GOOGLE_PROTOBUF_WIRE_FORMAT_LITE_H__
 
 #include <string>
+#include <google/protobuf/arena.h>
 #include <google/protobuf/message_lite.h>
 
 namespace google {
@@ -57,6 +58,8 @@ namespace protobuf {
 namespace internal {
 
 class StringPieceField;
+class FieldSkipper;
+struct ParseTable;
 
 // This class is for internal use by the protocol buffer library and by
 // protocol-complier-generated message classes.  It must not be called
@@ -290,6 +293,11 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static bool ReadString(input, string* value);
   static bool ReadBytes (input, string* value);
+  // For [ctype=STRING_PIECE] fields.  These point the field at its bytes in
+  // the input if the input has aliasing enabled; see
+  // CodedInputStream::EnableAliasing().
+  static bool ReadString(input, StringPieceField* value);
+  static bool ReadBytes (input, StringPieceField* value);
 
   static inline bool ReadGroup  (field_number, input, MessageLite* value);
   static inline bool ReadMessage(input, MessageLite* value);
@@ -303,6 +311,17 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
   template<typename MessageType>
   static inline bool ReadMessageNoVirtual(input, MessageType* value);
 
+  // Parses fields into a generated message, as described by the table the
+  // protocol compiler emits for its class, until the end of the input or an
+  // end-group tag.  This one loop replaces a switch statement per message
+  // class.  Tags that are not in the table are skipped with skipper, unless
+  // the message has extensions, in which case parsing stops there so that
+  // the generated code can pass the field to the ExtensionSet.  On success,
+  // *tag is the tag parsing stopped at, or 0 at the end of the input.
+  static bool ParseFromTable(input, const ParseTable& table,
+                             MessageLite* message, FieldSkipper* skipper,
+                             uint32* tag);
+
   // Write a tag.  The Write*() functions typically include the tag, so
   // normally there's no need to call this unless using the Write*NoTag()
   // variants.
@@ -342,6 +361,8 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static void WriteString(field_number, const string& value, output);
   static void WriteBytes (field_number, const string& value, output);
+  static void WriteString(field_number, const StringPieceField& value, output);
+  static void WriteBytes (field_number, const StringPieceField& value, output);
 
   static void WriteGroup(
     field_number, const MessageLite& value, output);
@@ -420,6 +441,10 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
     field_number, const string& value, output) INL;
   static inline uint8* WriteBytesToArray(
     field_number, const string& value, output) INL;
+  static inline uint8* WriteStringToArray(
+    field_number, const StringPieceField& value, output) INL;
+  static inline uint8* WriteBytesToArray(
+    field_number, const StringPieceField& value, output) INL;
 
   static inline uint8* WriteGroupToArray(
       field_number, const MessageLite& value, output) INL;
@@ -465,6 +490,8 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
 
   static inline int StringSize(const string& value);
   static inline int BytesSize (const string& value);
+  static inline int StringSize(const StringPieceField& value);
+  static inline int BytesSize (const StringPieceField& value);
 
   static inline int GroupSize  (const MessageLite& value);
   static inline int MessageSize(const MessageLite& value);
@@ -488,6 +515,19 @@ class LIBPROTOBUF_EXPORT WireFormatLite {
       google::protobuf::io::CodedInputStream* input,
       RepeatedField<CType>* value) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
 
+  // A helper method for the packed primitive reader, used for the varint
+  // types.  It decodes the values lying in the stream's buffer directly,
+  // rather than calling ReadPrimitive() for each one.
+  template <typename CType, enum FieldType DeclaredType>
+  static inline bool ReadPackedVarintPrimitive(
+      google::protobuf::io::CodedInputStream* input,
+      RepeatedField<CType>* value) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
+
+  // Converts a varint read off the wire to a value of the given type.
+  template <typename CType, enum FieldType DeclaredType>
+  static inline CType VarintToPrimitive(
+      uint64 varint) GOOGLE_ATTRIBUTE_ALWAYS_INLINE;
+
   static const CppType kFieldTypeToCppTypeMap[];
   static const WireFormatLite::WireType kWireTypeForFieldType[];
 
@@ -516,6 +556,51 @@ class LIBPROTOBUF_EXPORT FieldSkipper {
   virtual void SkipUnknownEnum(int field_number, int value);
 };
 
+// Describes one field of a generated message to ParseFromTable().
+struct ParseTableField {
+  uint32 tag;          // The tag the field is written with.
+  int offset;          // Offset of the field in the message.
+  int has_bit;         // Index of the field's has-bit, or -1 if repeated.
+  uint8 type;          // The WireFormatLite::FieldType of the field.
+  bool packed;         // Whether a repeated field is declared packed.
+  bool lazy;           // Whether a message field is an internal::LazyField.
+  bool string_piece;   // Whether a string field is a StringPieceField.
+
+  // For string and bytes fields, the default value, which the field points
+  // at until it is set.
+  const string* default_string;
+  // For message and group fields, creates a sub-message on the arena; see
+  // NewMessageOf(), below.
+  MessageLite* (*new_message)(Arena* arena);
+  // For enum fields, returns whether a value is one of the enum's.
+  bool (*is_valid)(int);
+};
+
+// Describes a generated message class to ParseFromTable().  The protocol
+// compiler emits one of these in each MergePartialFromCodedStream().
+struct ParseTable {
+  const ParseTableField* fields;  // Sorted by field number.
+  int num_fields;
+  int has_bits_offset;            // Offset of the message's has-bits.
+  int arena_offset;               // Offset of the message's Arena*.
+
+  // Whether the message has extension ranges.
+  bool has_extensions;
+
+  // If not NULL, called on each value parsed into a string field (but not
+  // a bytes field).  Lite messages do not verify UTF-8.
+  void (*verify_utf8)(const char* data, int size);
+};
+
+// Gives ParseTableField a pointer to a function of one type that creates
+// a message of any generated message type.  This does not go through the
+// type's default instance, which does not exist yet while descriptor.proto
+// is parsing its own descriptor.
+template <typename Type>
+MessageLite* NewMessageOf(Arena* arena) {
+  return Arena::CreateMessage<Type>(arena);
+}
+
 // inline methods ====================================================
 
 inline WireFormatLite::CppType
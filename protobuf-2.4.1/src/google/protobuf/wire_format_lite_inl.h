@@ -42,6 +42,7 @@
 #include <google/protobuf/repeated_field.h>
 #include <google/protobuf/wire_format_lite.h>
 #include <google/protobuf/generated_message_util.h>
+#include <google/protobuf/string_piece_field.h>
 #include <google/protobuf/io/coded_stream.h>
 
 
@@ -334,6 +335,106 @@ inline bool WireFormatLite::ReadPackedPrimitive(io::CodedInputStream* input,
   return true;
 }
 
+// Implementation details of VarintToPrimitive.  These match ReadPrimitive:
+// 32-bit types take the low 32 bits of the varint.
+
+#define VARINT_TO_PRIMITIVE(CPPTYPE, DECLARED_TYPE, VALUE)                     \
+template <>                                                                    \
+inline CPPTYPE WireFormatLite::VarintToPrimitive<                              \
+  CPPTYPE, WireFormatLite::DECLARED_TYPE>(uint64 varint) {                     \
+  return VALUE;                                                                \
+}
+
+VARINT_TO_PRIMITIVE( int32,  TYPE_INT32, static_cast<int32>(varint))
+VARINT_TO_PRIMITIVE( int64,  TYPE_INT64, static_cast<int64>(varint))
+VARINT_TO_PRIMITIVE(uint32, TYPE_UINT32, static_cast<uint32>(varint))
+VARINT_TO_PRIMITIVE(uint64, TYPE_UINT64, varint)
+VARINT_TO_PRIMITIVE( int32, TYPE_SINT32,
+                    ZigZagDecode32(static_cast<uint32>(varint)))
+VARINT_TO_PRIMITIVE( int64, TYPE_SINT64, ZigZagDecode64(varint))
+VARINT_TO_PRIMITIVE(  bool,   TYPE_BOOL, static_cast<uint32>(varint) != 0)
+
+#undef VARINT_TO_PRIMITIVE
+
+template <typename CType, enum WireFormatLite::FieldType DeclaredType>
+inline bool WireFormatLite::ReadPackedVarintPrimitive(
+    io::CodedInputStream* input,
+    RepeatedField<CType>* values) {
+  uint32 length;
+  if (!input->ReadVarint32(&length)) return false;
+  io::CodedInputStream::Limit limit = input->PushLimit(length);
+  while (input->BytesUntilLimit() > 0) {
+    // The buffer ends at the limit if the limit is within it, so every
+    // varint that ends in the buffer belongs to the field.
+    const void* void_pointer;
+    int size;
+    input->GetDirectBufferPointerInline(&void_pointer, &size);
+    const uint8* begin = reinterpret_cast<const uint8*>(void_pointer);
+    const uint8* end = begin + size;
+    const uint8* ptr = begin;
+    while (ptr < end) {
+      if (*ptr < 0x80) {
+        // Small values are common in packed fields; if the next eight
+        // values are all one byte long, add them at once.
+        if (end - ptr >= 8) {
+          uint64 word;
+          memcpy(&word, ptr, sizeof(word));
+          if ((word & GOOGLE_ULONGLONG(0x8080808080808080)) == 0) {
+            values->Reserve(values->size() + 8);
+            for (int i = 0; i < 8; i++) {
+              values->AddAlreadyReserved(
+                  VarintToPrimitive<CType, DeclaredType>(ptr[i]));
+            }
+            ptr += 8;
+            continue;
+          }
+        }
+        values->Add(VarintToPrimitive<CType, DeclaredType>(*ptr));
+        ++ptr;
+      } else {
+        uint64 varint;
+        const uint8* next =
+            io::CodedInputStream::ReadVarint64FromArray(ptr, end, &varint);
+        if (next == NULL) break;
+        values->Add(VarintToPrimitive<CType, DeclaredType>(varint));
+        ptr = next;
+      }
+    }
+    if (ptr > begin) {
+      input->Skip(ptr - begin);
+    } else {
+      // The next value crosses the end of the buffer, or is malformed.
+      CType value;
+      if (!ReadPrimitive<CType, DeclaredType>(input, &value)) return false;
+      values->Add(value);
+    }
+  }
+  input->PopLimit(limit);
+  return true;
+}
+
+// Specializations of ReadPackedPrimitive for the varint types, which use
+// the optimized code path.
+#define READ_PACKED_VARINT_PRIMITIVE(CPPTYPE, DECLARED_TYPE)                   \
+template <>                                                                    \
+inline bool WireFormatLite::ReadPackedPrimitive<                               \
+  CPPTYPE, WireFormatLite::DECLARED_TYPE>(                                     \
+    io::CodedInputStream* input,                                               \
+    RepeatedField<CPPTYPE>* values) {                                          \
+  return ReadPackedVarintPrimitive<                                            \
+    CPPTYPE, WireFormatLite::DECLARED_TYPE>(input, values);                    \
+}
+
+READ_PACKED_VARINT_PRIMITIVE( int32,  TYPE_INT32);
+READ_PACKED_VARINT_PRIMITIVE( int64,  TYPE_INT64);
+READ_PACKED_VARINT_PRIMITIVE(uint32, TYPE_UINT32);
+READ_PACKED_VARINT_PRIMITIVE(uint64, TYPE_UINT64);
+READ_PACKED_VARINT_PRIMITIVE( int32, TYPE_SINT32);
+READ_PACKED_VARINT_PRIMITIVE( int64, TYPE_SINT64);
+READ_PACKED_VARINT_PRIMITIVE(  bool,   TYPE_BOOL);
+
+#undef READ_PACKED_VARINT_PRIMITIVE
+
 template <typename CType, enum WireFormatLite::FieldType DeclaredType>
 bool WireFormatLite::ReadPackedPrimitiveNoInline(io::CodedInputStream* input,
                                                  RepeatedField<CType>* values) {
@@ -671,6 +772,20 @@ inline uint8* WireFormatLite::WriteBytesToArray(int field_number,
   target = io::CodedOutputStream::WriteVarint32ToArray(value.size(), target);
   return io::CodedOutputStream::WriteStringToArray(value, target);
 }
+inline uint8* WireFormatLite::WriteStringToArray(int field_number,
+                                                 const StringPieceField& value,
+                                                 uint8* target) {
+  // String is for UTF-8 text only
+  return WriteBytesToArray(field_number, value, target);
+}
+inline uint8* WireFormatLite::WriteBytesToArray(int field_number,
+                                                const StringPieceField& value,
+                                                uint8* target) {
+  target = WriteTagToArray(field_number, WIRETYPE_LENGTH_DELIMITED, target);
+  target = io::CodedOutputStream::WriteVarint32ToArray(value.size(), target);
+  return io::CodedOutputStream::WriteRawToArray(value.data(), value.size(),
+                                                target);
+}
 
 
 inline uint8* WireFormatLite::WriteGroupToArray(int field_number,
@@ -743,6 +858,14 @@ inline int WireFormatLite::BytesSize(const string& value) {
   return io::CodedOutputStream::VarintSize32(value.size()) +
          value.size();
 }
+inline int WireFormatLite::StringSize(const StringPieceField& value) {
+  return io::CodedOutputStream::VarintSize32(value.size()) +
+         value.size();
+}
+inline int WireFormatLite::BytesSize(const StringPieceField& value) {
+  return io::CodedOutputStream::VarintSize32(value.size()) +
+         value.size();
+}
 
 
 inline int WireFormatLite::GroupSize(const MessageLite& value) {
@@ -158,6 +158,43 @@ TEST(WireFormatTest, ParseUnpackedFromPacked) {
   TestUtil::ExpectUnpackedFieldsSet(dest);
 }
 
+TEST(WireFormatTest, ParsePackedVarints) {
+  // Packed varints are decoded straight from the stream's buffer, so make
+  // sure values of every length, and runs of small values, parse the same
+  // whether or not they cross the end of a buffer.
+  unittest::TestPackedTypes source;
+  for (int i = 0; i < 200; i++) {
+    int64 value = i % 3 == 0 ? (GOOGLE_LONGLONG(1) << (i % 64)) - 1 : i % 5;
+    source.add_packed_int64(value);
+    source.add_packed_int64(-value);
+    source.add_packed_sint32(static_cast<int32>(-value));
+    source.add_packed_bool(value & 1);
+  }
+  string data = source.SerializeAsString();
+
+  for (int block_size = 1; block_size <= 17; block_size += 4) {
+    unittest::TestPackedTypes dest;
+    io::ArrayInputStream raw_input(data.data(), data.size(), block_size);
+    io::CodedInputStream input(&raw_input);
+    EXPECT_TRUE(dest.MergePartialFromCodedStream(&input));
+    EXPECT_EQ(source.DebugString(), dest.DebugString()) << block_size;
+  }
+
+  // A varint longer than ten bytes does not parse.
+  string bad;
+  {
+    io::StringOutputStream raw_output(&bad);
+    io::CodedOutputStream output(&raw_output);
+    output.WriteTag(WireFormatLite::MakeTag(
+        unittest::TestPackedTypes::kPackedInt64FieldNumber,
+        WireFormatLite::WIRETYPE_LENGTH_DELIMITED));
+    output.WriteVarint32(11);
+    output.WriteString(string(10, '\xff') + '\x01');
+  }
+  unittest::TestPackedTypes dest;
+  EXPECT_FALSE(dest.ParseFromString(bad));
+}
+
 TEST(WireFormatTest, ParsePackedExtensions) {
   unittest::TestPackedExtensions source, dest;
   string data;
@@ -16,11 +16,14 @@ copy ..\src\google\protobuf\dynamic_message.h include\google\protobuf\dynamic_me
 copy ..\src\google\protobuf\extension_set.h include\google\protobuf\extension_set.h
 copy ..\src\google\protobuf\generated_message_util.h include\google\protobuf\generated_message_util.h
 copy ..\src\google\protobuf\generated_message_reflection.h include\google\protobuf\generated_message_reflection.h
+copy ..\src\google\protobuf\lazy_field.h include\google\protobuf\lazy_field.h
 copy ..\src\google\protobuf\message.h include\google\protobuf\message.h
 copy ..\src\google\protobuf\message_lite.h include\google\protobuf\message_lite.h
 copy ..\src\google\protobuf\reflection_ops.h include\google\protobuf\reflection_ops.h
+copy ..\src\google\protobuf\arena.h include\google\protobuf\arena.h
 copy ..\src\google\protobuf\repeated_field.h include\google\protobuf\repeated_field.h
 copy ..\src\google\protobuf\service.h include\google\protobuf\service.h
+copy ..\src\google\protobuf\string_piece_field.h include\google\protobuf\string_piece_field.h
 copy ..\src\google\protobuf\text_format.h include\google\protobuf\text_format.h
 copy ..\src\google\protobuf\unknown_field_set.h include\google\protobuf\unknown_field_set.h
 copy ..\src\google\protobuf\wire_format.h include\google\protobuf\wire_format.h
@@ -0,0 +1,12 @@
+// All rights reserved.
+//
+// Description: Link to protobuf source header file
+
+#ifndef THIRDPARTY_PROTOBUF_ARENA_H
+#define THIRDPARTY_PROTOBUF_ARENA_H
+#pragma once
+
+#include "thirdparty/protobuf-2.4.1/src/google/protobuf/arena.h"
+
+#endif // THIRDPARTY_PROTOBUF_ARENA_H
+
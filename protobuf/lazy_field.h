@@ -0,0 +1,12 @@
+// All rights reserved.
+//
+// Description: Link to protobuf source header file
+
+#ifndef THIRDPARTY_PROTOBUF_LAZY_FIELD_H
+#define THIRDPARTY_PROTOBUF_LAZY_FIELD_H
+#pragma once
+
+#include "thirdparty/protobuf-2.4.1/src/google/protobuf/lazy_field.h"
+
+#endif // THIRDPARTY_PROTOBUF_LAZY_FIELD_H
+
@@ -16,6 +16,13 @@
 //
 // SearchBitState is a fast replacement for the NFA code on small
 // regexps and texts when SearchOnePass cannot be used.
+//
+// Its scratch space is kept per thread and reused by the next search
+// in the same thread, so that searches of short texts do not allocate.
+
+#ifndef WIN32
+#include <pthread.h>
+#endif
 
 #include "thirdparty/re2-20130115/re2/prog.h"
 #include "thirdparty/re2-20130115/re2/regexp.h"
@@ -28,9 +35,73 @@ struct Job {
   const char* p;
 };
 
+// Scratch space for BitState, reused by one search after another
+// in the same thread.
+struct BitStateScratch {
+  BitStateScratch()
+    : in_use(false), visited(NULL), nvisited(0), job(NULL), maxjob(0),
+      cap(NULL), ncap(0) {}
+  ~BitStateScratch() {
+    delete[] visited;
+    delete[] job;
+    delete[] cap;
+  }
+
+  bool in_use;           // a BitState is using the arrays
+  uint32* visited;       // visited bitmap
+  int nvisited;          //   # of words allocated
+  Job* job;              // job stack
+  int maxjob;            //   # of Jobs allocated
+  const char** cap;      // capture registers
+  int ncap;              //   # of registers allocated
+};
+
+// Largest arrays kept in the scratch space between searches.
+// Bigger ones are allocated for the search and freed after it.
+// Every thread that has run BitState keeps its arrays, so these are
+// only big enough for the short texts that RE2 searches most often.
+static const int kMaxKeptVisited = 8*1024;  // words: 256K (Inst*, char*) bits
+static const int kMaxKeptJobs = 16*1024;
+
+#ifdef WIN32
+
+static BitStateScratch* ThreadScratch() {
+  return NULL;
+}
+
+#else
+
+static pthread_once_t scratch_once = PTHREAD_ONCE_INIT;
+static pthread_key_t scratch_key;
+
+static void DeleteScratch(void* v) {
+  delete static_cast<BitStateScratch*>(v);
+}
+
+static void InitScratchKey() {
+  pthread_key_create(&scratch_key, DeleteScratch);
+}
+
+// Returns the calling thread's scratch space, creating it if needed.
+// It is freed when the thread exits.
+static BitStateScratch* ThreadScratch() {
+  pthread_once(&scratch_once, InitScratchKey);
+  BitStateScratch* scratch =
+      static_cast<BitStateScratch*>(pthread_getspecific(scratch_key));
+  if (scratch == NULL) {
+    scratch = new BitStateScratch;
+    pthread_setspecific(scratch_key, scratch);
+  }
+  return scratch;
+}
+
+#endif  // WIN32
+
 class BitState {
  public:
-  explicit BitState(Prog* prog);
+  // If max_jobs > 0, the search gives up rather than let its job
+  // stack grow past max_jobs entries.
+  BitState(Prog* prog, int max_jobs);
   ~BitState();
 
   // The usual Search prototype.
@@ -39,6 +110,9 @@ class BitState {
               bool anchored, bool longest,
               StringPiece* submatch, int nsubmatch);
 
+  // Whether Search gave up because the job stack was full.
+  bool failed() { return failed_; }
+
  private:
   inline bool ShouldVisit(int id, const char* p);
   void Push(int id, const char* p, int arg);
@@ -66,9 +140,17 @@ class BitState {
   Job *job_;                // stack of text positions to explore
   int njob_;
   int maxjob_;
+  int max_jobs_;            // limit on maxjob_, or 0 for none
+  bool failed_;             // hit max_jobs_
+
+  // This thread's scratch space, or NULL if another BitState
+  // in the thread has it.  Arrays not from it are freed by ~BitState.
+  BitStateScratch* scratch_;
+  bool own_visited_;        // visited_ is not scratch_->visited
+  bool own_cap_;            // cap_ is not scratch_->cap
 };
 
-BitState::BitState(Prog* prog)
+BitState::BitState(Prog* prog, int max_jobs)
   : prog_(prog),
     anchored_(false),
     longest_(false),
@@ -81,20 +163,47 @@ BitState::BitState(Prog* prog)
     nvisited_(0),
     job_(NULL),
     njob_(0),
-    maxjob_(0) {
+    maxjob_(0),
+    max_jobs_(max_jobs),
+    failed_(false),
+    own_visited_(true),
+    own_cap_(true) {
+  scratch_ = ThreadScratch();
+  if (scratch_ != NULL) {
+    if (scratch_->in_use)
+      scratch_ = NULL;
+    else
+      scratch_->in_use = true;
+  }
 }
 
 BitState::~BitState() {
-  delete[] visited_;
-  delete[] job_;
-  delete[] cap_;
+  if (own_visited_)
+    delete[] visited_;
+  if (own_cap_)
+    delete[] cap_;
+  if (scratch_ == NULL) {
+    delete[] job_;
+    return;
+  }
+
+  // The scratch space owns job_, but does not keep a big one.
+  if (scratch_->maxjob > kMaxKeptJobs) {
+    delete[] scratch_->job;
+    scratch_->job = NULL;
+    scratch_->maxjob = 0;
+  }
+  scratch_->in_use = false;
 }
 
 // Should the search visit the pair ip, p?
 // If so, remember that it was visited so that the next time,
 // we don't repeat the visit.
+// The bits for one text position are kept together, because the
+// search visits many instructions at a position before moving on;
+// on long texts that keeps it in cache.
 bool BitState::ShouldVisit(int id, const char* p) {
-  uint n = id * (text_.size() + 1) + (p - text_.begin());
+  uint n = (p - text_.begin()) * prog_->size() + id;
   if (visited_[n/VisitedBits] & (1 << (n & (VisitedBits-1))))
     return false;
   visited_[n/VisitedBits] |= 1 << (n & (VisitedBits-1));
@@ -103,12 +212,24 @@ bool BitState::ShouldVisit(int id, const char* p) {
 
 // Grow the stack.
 bool BitState::GrowStack() {
+  // Give up rather than go past the limit.  Some patterns,
+  // like (a|aa)*, push a job for nearly every byte of the text.
+  if (max_jobs_ > 0 && maxjob_ >= max_jobs_) {
+    failed_ = true;
+    return false;
+  }
   // VLOG(0) << "Reallocate.";
   maxjob_ *= 2;
+  if (max_jobs_ > 0 && maxjob_ > max_jobs_)
+    maxjob_ = max_jobs_;
   Job* newjob = new Job[maxjob_];
   memmove(newjob, job_, njob_*sizeof job_[0]);
   delete[] job_;
   job_ = newjob;
+  if (scratch_ != NULL) {
+    scratch_->job = job_;
+    scratch_->maxjob = maxjob_;
+  }
   if (njob_ >= maxjob_) {
     LOG(DFATAL) << "Job stack overflow.";
     return false;
@@ -145,6 +266,10 @@ bool BitState::TrySearch(int id0, const char* p0) {
   njob_ = 0;
   Push(id0, p0, 0);
   while (njob_ > 0) {
+    // A job was dropped, so what is left cannot be trusted.
+    if (failed_)
+      return false;
+
     // Pop job off stack.
     --njob_;
     int id = job_[njob_].id;
@@ -255,6 +380,8 @@ bool BitState::TrySearch(int id0, const char* p0) {
       case kInstMatch: {
         if (endmatch_ && p != text_.end())
           continue;
+        if (failed_)
+          return false;
 
         // VLOG(0) << "Found match.";
         // We found a match.  If the caller doesn't care
@@ -310,20 +437,49 @@ bool BitState::Search(const StringPiece& text, const StringPiece& context,
   for (int i = 0; i < nsubmatch_; i++)
     submatch_[i] = NULL;
 
-  // Allocate scratch space.
+  // Allocate scratch space, from this thread's if possible.
   nvisited_ = (prog_->size() * (text.size()+1) + VisitedBits-1) / VisitedBits;
-  visited_ = new uint32[nvisited_];
+  if (scratch_ != NULL && nvisited_ <= kMaxKeptVisited) {
+    if (scratch_->nvisited < nvisited_) {
+      delete[] scratch_->visited;
+      scratch_->visited = new uint32[nvisited_];
+      scratch_->nvisited = nvisited_;
+    }
+    visited_ = scratch_->visited;
+    own_visited_ = false;
+  } else {
+    visited_ = new uint32[nvisited_];
+  }
   memset(visited_, 0, nvisited_*sizeof visited_[0]);
   // VLOG(0) << "nvisited_ = " << nvisited_;
 
   ncap_ = 2*nsubmatch;
   if (ncap_ < 2)
     ncap_ = 2;
-  cap_ = new const char*[ncap_];
+  if (scratch_ != NULL) {
+    if (scratch_->ncap < ncap_) {
+      delete[] scratch_->cap;
+      scratch_->cap = new const char*[ncap_];
+      scratch_->ncap = ncap_;
+    }
+    cap_ = scratch_->cap;
+    own_cap_ = false;
+  } else {
+    cap_ = new const char*[ncap_];
+  }
   memset(cap_, 0, ncap_*sizeof cap_[0]);
 
-  maxjob_ = 256;
-  job_ = new Job[maxjob_];
+  if (scratch_ != NULL) {
+    if (scratch_->job == NULL) {
+      scratch_->maxjob = 256;
+      scratch_->job = new Job[scratch_->maxjob];
+    }
+    job_ = scratch_->job;
+    maxjob_ = scratch_->maxjob;
+  } else {
+    maxjob_ = 256;
+    job_ = new Job[maxjob_];
+  }
 
   // Anchored search must start at text.begin().
   if (anchored_) {
@@ -341,6 +497,8 @@ bool BitState::Search(const StringPiece& text, const StringPiece& context,
     cap_[0] = p;
     if (TrySearch(prog_->start(), p))  // Match must be leftmost; done.
       return true;
+    if (failed_)
+      return false;
   }
   return false;
 }
@@ -352,6 +510,20 @@ bool Prog::SearchBitState(const StringPiece& text,
                           MatchKind kind,
                           StringPiece* match,
                           int nmatch) {
+  bool failed;
+  return SearchBitState(text, context, anchor, kind, match, nmatch,
+                        0, &failed);
+}
+
+bool Prog::SearchBitState(const StringPiece& text,
+                          const StringPiece& context,
+                          Anchor anchor,
+                          MatchKind kind,
+                          StringPiece* match,
+                          int nmatch,
+                          int64 max_stack,
+                          bool* failed) {
+  *failed = false;
   // If full match, we ask for an anchored longest match
   // and then check that match[0] == text.
   // So make sure match[0] exists.
@@ -365,11 +537,18 @@ bool Prog::SearchBitState(const StringPiece& text,
   }
 
   // Run the search.
-  BitState b(this);
+  int max_jobs = 0;
+  if (max_stack > 0) {
+    int64 n = max_stack / sizeof(Job);
+    max_jobs = static_cast<int>(min<int64>(max<int64>(n, 256), 1<<28));
+  }
+  BitState b(this, max_jobs);
   bool anchored = anchor == kAnchored;
   bool longest = kind != kFirstMatch;
-  if (!b.Search(text, context, anchored, longest, match, nmatch))
+  if (!b.Search(text, context, anchored, longest, match, nmatch)) {
+    *failed = b.failed();
     return false;
+  }
   if (kind == kFullMatch && match[0].end() != text.end())
     return false;
   return true;
@@ -11,6 +11,7 @@
 #include "thirdparty/re2-20130115/re2/prog.h"
 #include "thirdparty/re2-20130115/re2/re2.h"
 #include "thirdparty/re2-20130115/re2/regexp.h"
+#include "thirdparty/re2-20130115/re2/unicode_casefold.h"
 #include "thirdparty/re2-20130115/re2/walker-inl.h"
 
 namespace re2 {
@@ -132,8 +133,9 @@ class Compiler : public Regexp::Walker<Frag> {
 
   // Compiles alternation of all the re to a new Prog.
   // Each re has a match with an id equal to its index in the vector.
+  // See Prog::CompileSet for match_ends.
   static Prog* CompileSet(const RE2::Options& options, RE2::Anchor anchor,
-                          Regexp* re);
+                          Regexp* re, bool match_ends);
 
   // Interface for Regexp::Walker, which helps traverse the Regexp.
   // The walk is purely post-recursive: given the machines for the
@@ -214,6 +216,16 @@ class Compiler : public Regexp::Walker<Frag> {
   // Returns .* where dot = any byte
   Frag DotStar();
 
+  // Computes a small set of nonempty byte strings, one of which
+  // must begin every match of re.  Returns false if there is none.
+  // Sets *exact if re matches exactly those strings.
+  bool PrefixLiterals(Regexp* re, vector<string>* prefixes, bool* exact);
+
+  // Replaces *prefixes with every string in *prefixes followed by
+  // the encoding of a rune in runes.  Returns false, leaving *prefixes
+  // unchanged, if that would make too many or too long strings.
+  bool AppendRunes(vector<string>* prefixes, const vector<Rune>& runes);
+
  private:
   Prog* prog_;         // Program being built.
   bool failed_;        // Did we give up compiling?
@@ -232,6 +244,7 @@ class Compiler : public Regexp::Walker<Frag> {
   Frag rune_range_;
 
   RE2::Anchor anchor_;  // anchor mode for RE2::Set
+  bool match_ends_;     // RE2::Set matches where each regexp ends
 
   DISALLOW_EVIL_CONSTRUCTORS(Compiler);
 };
@@ -732,7 +745,7 @@ Frag Compiler::PostVisit(Regexp* re, Frag, Frag, Frag* child_frags,
     case kRegexpHaveMatch: {
       Frag f = Match(re->match_id());
       // Remember unanchored match to end of string.
-      if (anchor_ != RE2::ANCHOR_BOTH)
+      if (anchor_ != RE2::ANCHOR_BOTH && !match_ends_)
         f = Cat(DotStar(), Cat(EmptyWidth(kEmptyEndText), f));
       return f;
     }
@@ -981,6 +994,146 @@ void Compiler::Setup(Regexp::ParseFlags flags, int64 max_mem,
   }
 
   anchor_ = anchor;
+  match_ends_ = false;
+}
+
+// Limits on the prefixes handed to Prog::ConfigurePrefixAccel.
+// Longer prefixes only cost more to verify; more of them would not
+// fit in the accelerator's fingerprint buckets.
+static const int kMaxPrefixLiterals = 8;
+static const int kMaxPrefixLength = 16;
+
+// Replaces *a with every concatenation of a string in *a and one in b.
+// Returns false, leaving *a unchanged, if that would make too many
+// strings or a string longer than kMaxPrefixLength.
+static bool CrossPrefixes(vector<string>* a, const vector<string>& b) {
+  if (a->size() * b.size() > kMaxPrefixLiterals)
+    return false;
+  vector<string> v;
+  for (int i = 0; i < a->size(); i++) {
+    for (int j = 0; j < b.size(); j++) {
+      if ((*a)[i].size() + b[j].size() > kMaxPrefixLength)
+        return false;
+      v.push_back((*a)[i] + b[j]);
+    }
+  }
+  a->swap(v);
+  return true;
+}
+
+// Returns r and, if foldcase, the other runes in its folding cycle.
+static vector<Rune> FoldRunes(Rune r, bool foldcase) {
+  vector<Rune> v(1, r);
+  if (foldcase) {
+    for (Rune r1 = CycleFoldRune(r); r1 != r; r1 = CycleFoldRune(r1))
+      v.push_back(r1);
+  }
+  return v;
+}
+
+bool Compiler::AppendRunes(vector<string>* prefixes,
+                           const vector<Rune>& runes) {
+  vector<string> v;
+  for (int i = 0; i < runes.size(); i++) {
+    Rune r = runes[i];
+    if (encoding_ == kEncodingLatin1) {
+      if (r <= 0xFF)
+        v.push_back(string(1, static_cast<char>(r)));
+    } else {
+      char buf[UTFmax];
+      v.push_back(string(buf, runetochar(buf, &r)));
+    }
+  }
+  if (v.empty())
+    return false;
+  return CrossPrefixes(prefixes, v);
+}
+
+bool Compiler::PrefixLiterals(Regexp* re, vector<string>* prefixes,
+                              bool* exact) {
+  prefixes->clear();
+  *exact = false;
+  bool foldcase = (re->parse_flags() & Regexp::FoldCase) != 0;
+  switch (re->op()) {
+    default:
+      return false;
+
+    case kRegexpLiteral:
+      prefixes->push_back("");
+      if (!AppendRunes(prefixes, FoldRunes(re->rune(), foldcase)))
+        return false;
+      *exact = true;
+      return true;
+
+    case kRegexpCharClass: {
+      // Small classes like [Ee] are common in front of literals.
+      CharClass* cc = re->cc();
+      if (cc->empty() || cc->size() > kMaxPrefixLiterals)
+        return false;
+      vector<Rune> runes;
+      for (CharClass::iterator i = cc->begin(); i != cc->end(); ++i) {
+        for (Rune r = i->lo; r <= i->hi; r++)
+          runes.push_back(r);
+      }
+      prefixes->push_back("");
+      if (!AppendRunes(prefixes, runes))
+        return false;
+      *exact = true;
+      return true;
+    }
+
+    case kRegexpLiteralString:
+      if (re->nrunes() == 0)
+        return false;
+      prefixes->push_back("");
+      // Once the strings are too long or too many, stop adding runes:
+      // a prefix of the literal is still required.
+      *exact = true;
+      for (int i = 0; i < re->nrunes(); i++) {
+        if (!AppendRunes(prefixes, FoldRunes(re->runes()[i], foldcase))) {
+          *exact = false;
+          break;
+        }
+      }
+      return !(*prefixes)[0].empty();
+
+    case kRegexpCapture:
+      return PrefixLiterals(re->sub()[0], prefixes, exact);
+
+    case kRegexpConcat: {
+      // The first piece decides; later ones just make the strings longer.
+      if (!PrefixLiterals(re->sub()[0], prefixes, exact))
+        return false;
+      vector<string> v;
+      for (int i = 1; i < re->nsub() && *exact; i++) {
+        bool subexact;
+        if (!PrefixLiterals(re->sub()[i], &v, &subexact) ||
+            !CrossPrefixes(prefixes, v)) {
+          *exact = false;
+          break;
+        }
+        *exact = subexact;
+      }
+      return true;
+    }
+
+    case kRegexpAlternate: {
+      *exact = true;
+      vector<string> v;
+      for (int i = 0; i < re->nsub(); i++) {
+        bool subexact;
+        if (!PrefixLiterals(re->sub()[i], &v, &subexact))
+          return false;
+        if (!subexact)
+          *exact = false;
+        prefixes->insert(prefixes->end(), v.begin(), v.end());
+      }
+      sort(prefixes->begin(), prefixes->end());
+      prefixes->erase(unique(prefixes->begin(), prefixes->end()),
+                      prefixes->end());
+      return prefixes->size() <= kMaxPrefixLiterals;
+    }
+  }
 }
 
 // Compiles re, returning program.
@@ -1005,6 +1158,14 @@ Prog* Compiler::Compile(Regexp* re, bool reversed, int64 max_mem) {
   bool is_anchor_start = IsAnchorStart(&sre, 0);
   bool is_anchor_end = IsAnchorEnd(&sre, 0);
 
+  // If every match of an unanchored forward search must begin with
+  // one of a few literals, the DFA can look for those to skip ahead.
+  vector<string> prefixes;
+  bool prefixes_exact;
+  if (!reversed && !is_anchor_start &&
+      !c.PrefixLiterals(sre, &prefixes, &prefixes_exact))
+    prefixes.clear();
+
   // Generate fragment for entire regexp.
   Frag f = c.WalkExponential(sre, kNullFrag, 2*c.max_inst_);
   sre->Decref();
@@ -1035,6 +1196,8 @@ Prog* Compiler::Compile(Regexp* re, bool reversed, int64 max_mem) {
   }
 
   c.prog_->set_reversed(reversed);
+  if (!prefixes.empty())
+    c.prog_->ConfigurePrefixAccel(prefixes);
 
   // Hand ownership of prog_ to caller.
   return c.Finish();
@@ -1090,11 +1253,21 @@ Frag Compiler::DotStar() {
 
 // Compiles RE set to Prog.
 Prog* Compiler::CompileSet(const RE2::Options& options, RE2::Anchor anchor,
-                           Regexp* re) {
+                           Regexp* re, bool match_ends) {
   Compiler c;
 
   Regexp::ParseFlags pf = static_cast<Regexp::ParseFlags>(options.ParseFlags());
   c.Setup(pf, options.max_mem(), anchor);
+  c.match_ends_ = match_ends;
+
+  // As in Compile, if every match of an unanchored search must begin
+  // with one of a few literals, the DFA can look for those to skip
+  // ahead.  Only the match_ends program runs unanchored searches.
+  vector<string> prefixes;
+  bool prefixes_exact;
+  if (!match_ends || anchor != RE2::UNANCHORED ||
+      !c.PrefixLiterals(re, &prefixes, &prefixes_exact))
+    prefixes.clear();
 
   // Compile alternation of fragments.
   Frag all = c.WalkExponential(re, kNullFrag, 2*c.max_inst_);
@@ -1102,20 +1275,35 @@ Prog* Compiler::CompileSet(const RE2::Options& options, RE2::Anchor anchor,
   if (c.failed_)
     return NULL;
 
-  if (anchor == RE2::UNANCHORED) {
-    // The trailing .* was added while handling kRegexpHaveMatch.
-    // We just have to add the leading one.
-    all = c.Cat(c.DotStar(), all);
-  }
+  if (match_ends) {
+    // Each Match is where its regexp's match ends, so
+    // the anchors must be enforced the usual way.
+    c.prog_->set_start(all.begin);
+    if (anchor == RE2::UNANCHORED)
+      c.prog_->set_start_unanchored(c.Cat(c.DotStar(), all).begin);
+    else
+      c.prog_->set_start_unanchored(all.begin);
+    c.prog_->set_anchor_start(anchor != RE2::UNANCHORED);
+    c.prog_->set_anchor_end(anchor == RE2::ANCHOR_BOTH);
+    if (!prefixes.empty())
+      c.prog_->ConfigurePrefixAccel(prefixes);
+  } else {
+    if (anchor == RE2::UNANCHORED) {
+      // The trailing .* was added while handling kRegexpHaveMatch.
+      // We just have to add the leading one.
+      all = c.Cat(c.DotStar(), all);
+    }
 
-  c.prog_->set_start(all.begin);
-  c.prog_->set_start_unanchored(all.begin);
-  c.prog_->set_anchor_start(true);
-  c.prog_->set_anchor_end(true);
+    c.prog_->set_start(all.begin);
+    c.prog_->set_start_unanchored(all.begin);
+    c.prog_->set_anchor_start(true);
+    c.prog_->set_anchor_end(true);
+  }
 
   Prog* prog = c.Finish();
   if (prog == NULL)
     return NULL;
+  prog->set_dfa_cache_shards(options.dfa_cache_shards());
 
   // Make sure DFA has enough memory to operate,
   // since we're not going to fall back to the NFA.
@@ -1132,8 +1320,8 @@ Prog* Compiler::CompileSet(const RE2::Options& options, RE2::Anchor anchor,
 }
 
 Prog* Prog::CompileSet(const RE2::Options& options, RE2::Anchor anchor,
-                       Regexp* re) {
-  return Compiler::CompileSet(options, anchor, re);
+                       Regexp* re, bool match_ends) {
+  return Compiler::CompileSet(options, anchor, re, match_ends);
 }
 
 }  // namespace re2
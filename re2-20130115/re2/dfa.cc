@@ -48,6 +48,16 @@ static void* memrchr(const void* s, int c, size_t n) {
 // Generates a lot of output -- only useful for debugging.
 static const bool DebugDFA = false;
 
+#ifdef COMPILER_MSVC
+#define DFA_THREAD_LOCAL __declspec(thread)
+#else
+#define DFA_THREAD_LOCAL __thread
+#endif
+
+// Number of DFA cache resets done by the calling thread,
+// so that a Prog can tell whether a search reset a cache.
+static DFA_THREAD_LOCAL int64 thread_cache_resets = 0;
+
 // A DFA implementation of a regular expression program.
 // Since this is entirely a forward declaration mandated by C++,
 // some of the comments here are better understood after reading
@@ -76,6 +86,42 @@ class DFA {
               bool anchored, bool want_earliest_match, bool run_forward,
               bool* failed, const char** ep, vector<int>* matches);
 
+  // Like calling Search(texts[i], contexts[i], ...) for each i < n and
+  // setting matched[i], but takes cache_mutex_ once for the batch.
+  // If "carat" or "dollar", texts[i] can only match if it begins or
+  // ends its context; if "endmatch", the match must end at the end of
+  // texts[i] (at its beginning when running backward).
+  // Returns the number of texts searched: fewer than n only if the
+  // search of the next one failed.
+  int SearchBatch(const StringPiece* texts, const StringPiece* contexts,
+                  int n, bool anchored, bool want_earliest_match,
+                  bool run_forward, bool carat, bool dollar, bool endmatch,
+                  bool* matched);
+
+  // Like Search with kind kManyMatch, running forward, but also notes
+  // in (*ends)[id] where a match of each Match instruction's id ends:
+  // the first place or, if "longest", the last.  Entries that are not
+  // NULL on entry are taken as already found and are not changed unless
+  // "longest".  Returns whether any Match instruction was reached.
+  bool SearchMatchEnds(const StringPiece& text, bool anchored, bool longest,
+                       vector<const char*>* ends, bool* failed);
+
+  // Searches text as the next piece of a stream: see Prog::SearchDFAStream.
+  bool SearchStream(DFAStreamState* ss, const StringPiece& text,
+                    bool anchored, bool at_end, const char** ep,
+                    vector<const char*>* ends, bool* failed);
+
+  // Adds this DFA's counts to *stats, for Prog::AddDFAStats.
+  void AddStats(Prog::DFAStats* stats);
+
+  // Appends the states in the cache, and the arrows between them,
+  // to *v, for Prog::Serialize.
+  void SaveStates(vector<uint32>* v);
+
+  // Loads states saved by SaveStates into the (new) cache,
+  // as many as fit.  Returns false if v is not valid.
+  bool LoadStates(const vector<uint32>& v);
+
   // Builds out all states for the entire DFA.  FOR TESTING ONLY
   // Returns number of states.
   int BuildAllStates();
@@ -181,6 +227,7 @@ class DFA {
     kFbUnknown = -1,   // No analysis has been performed.
     kFbMany = -2,      // Many bytes will lead out of this state.
     kFbNone = -3,      // No bytes lead out of this state.
+    kFbPrefixAccel = -4,  // Use prog_->PrefixAccel to leave this state.
   };
 
   enum {
@@ -223,6 +270,15 @@ class DFA {
   State* RunStateOnByteUnlocked(State*, int);  // cache_mutex_.r <= L < mutex_
   State* RunStateOnByte(State*, int);          // L >= mutex_
 
+  // Returns the empty-width flags that hold just before byte c
+  // when in state.
+  static uint BeforeFlag(State* state, int c);
+
+  // Fills ids with the match ids of the Match instructions that
+  // state reaches on byte c -- the ones that make the next state match.
+  // cache_mutex_.r <= L < mutex_
+  void MatchIdsOnByte(State* state, int c, vector<int>* ids);
+
   // Runs a Workq on a given byte followed by a set of empty-string flags,
   // producing a new Workq in nq.  If a match instruction is encountered,
   // sets *ismatch to true.
@@ -260,7 +316,13 @@ class DFA {
         cache_lock(cache_lock),
         failed(false),
         ep(NULL),
-        matches(NULL) { }
+        matches(NULL),
+        match_ends(NULL),
+        longest_ends(false),
+        match_ends_left(0),
+        prevbyte(-1),
+        resume(NULL),
+        at_end(true) { }
 
     StringPiece text;
     StringPiece context;
@@ -273,6 +335,14 @@ class DFA {
     bool failed;     // "out" parameter: whether search gave up
     const char* ep;  // "out" parameter: end pointer for match
     vector<int>* matches;
+    vector<const char*>* match_ends;  // see SearchMatchEnds
+    bool longest_ends;
+    int match_ends_left;   // NULL entries left in match_ends
+    vector<int> match_ids;  // scratch space for RecordMatchEnds
+    int prevbyte;    // if >= 0, the byte before text, overriding context
+    State* resume;   // if not NULL, the state to start in, for streams;
+                     // "out" parameter: the state at the end of text
+    bool at_end;     // whether text is followed by the end of the input
 
    private:
     DISALLOW_EVIL_CONSTRUCTORS(SearchParams);
@@ -294,6 +364,22 @@ class DFA {
   bool AnalyzeSearch(SearchParams* params);
   bool AnalyzeSearchHelper(SearchParams* params, StartInfo* info, uint flags);
 
+  // Runs the search described by params, for Search and SearchMatchEnds.
+  // cache_mutex_.r <= L < mutex_
+  bool RunSearch(SearchParams* params, bool* failed, const char** epp);
+
+  // Records p in params->match_ends for each id that MatchIdsOnByte
+  // returns for state and c.  Returns whether the search can stop
+  // because every entry already holds its earliest end.
+  // cache_mutex_.r <= L < mutex_
+  bool RecordMatchEnds(SearchParams* params, State* state, int c,
+                       const uint8* p);
+
+  // Returns the cached State for the one saved in ss,
+  // or NULL if the cache is full.
+  // cache_mutex_.r <= L < mutex_
+  State* RestoreStreamState(DFAStreamState* ss);
+
   // The generic search loop, inlined to create specialized versions.
   // cache_mutex_.r <= L < mutex_
   // Might unlock and relock cache_mutex_ via params->cache_lock.
@@ -342,6 +428,7 @@ class DFA {
   Prog::MatchKind kind_;    // The kind of DFA.
   int start_unanchored_;  // start of unanchored program
   bool init_failed_;        // initialization failed (out of memory)
+  int64 max_mem_;           // memory budget, including fixed overhead
 
   Mutex mutex_;  // mutex_ >= cache_mutex_.r
 
@@ -363,6 +450,8 @@ class DFA {
   StateSet state_cache_;   // All States computed so far.
   StartInfo start_[kMaxStart];
   bool cache_warned_;      // have printed to LOG(INFO) about the cache
+  int64 nstates_;          // States created, protected by mutex_
+  int64 nresets_;          // cache resets, protected by cache_mutex_
 };
 
 // Shorthand for casting to uint8*.
@@ -435,11 +524,14 @@ DFA::DFA(Prog* prog, Prog::MatchKind kind, int64 max_mem)
   : prog_(prog),
     kind_(kind),
     init_failed_(false),
+    max_mem_(max_mem),
     q0_(NULL),
     q1_(NULL),
     astack_(NULL),
     mem_budget_(max_mem),
-    cache_warned_(false) {
+    cache_warned_(false),
+    nstates_(0),
+    nresets_(0) {
   if (DebugDFA)
     fprintf(stderr, "\nkind %d\n%s\n", (int)kind_, prog_->DumpUnanchored().c_str());
   int nmark = 0;
@@ -774,6 +866,7 @@ DFA::State* DFA::CachedState(int* inst, int ninst, uint flag) {
 
   // Put state in cache and return it.
   state_cache_.insert(s);
+  nstates_++;
   return s;
 }
 
@@ -963,6 +1056,33 @@ DFA::State* DFA::RunStateOnByteUnlocked(State* state, int c) {
   return RunStateOnByte(state, c);
 }
 
+// Before the byte we have the flags recorded in the State structure
+// itself, plus whatever the byte itself implies.
+uint DFA::BeforeFlag(State* state, int c) {
+  uint beforeflag = state->flag_ & kFlagEmptyMask;
+
+  if (c == '\n') {
+    // Insert implicit $ before \n
+    beforeflag |= kEmptyEndLine;
+  }
+
+  if (c == kByteEndText) {
+    // Insert implicit $ and \z before the fake "end text" byte.
+    beforeflag |= kEmptyEndLine | kEmptyEndText;
+  }
+
+  // The state flag kFlagLastWord says whether the last
+  // byte processed was a word character.  Use that info to
+  // insert empty-width (non-)word boundaries.
+  bool islastword = state->flag_ & kFlagLastWord;
+  bool isword = (c != kByteEndText && Prog::IsWordChar(c));
+  if (isword == islastword)
+    beforeflag |= kEmptyNonWordBoundary;
+  else
+    beforeflag |= kEmptyWordBoundary;
+  return beforeflag;
+}
+
 // Processes input byte c in state, returning new state.
 DFA::State* DFA::RunStateOnByte(State* state, int c) {
   if (DEBUG_MODE)
@@ -998,34 +1118,19 @@ DFA::State* DFA::RunStateOnByte(State* state, int c) {
   StateToWorkq(state, q0_);
 
   // Flags marking the kinds of empty-width things (^ $ etc)
-  // around this byte.  Before the byte we have the flags recorded
-  // in the State structure itself.  After the byte we have
-  // nothing yet (but that will change: read on).
+  // around this byte.  After the byte we have nothing yet
+  // (but that will change: read on).
   uint needflag = state->flag_ >> kFlagNeedShift;
-  uint beforeflag = state->flag_ & kFlagEmptyMask;
-  uint oldbeforeflag = beforeflag;
+  uint beforeflag = BeforeFlag(state, c);
+  uint oldbeforeflag = state->flag_ & kFlagEmptyMask;
   uint afterflag = 0;
 
   if (c == '\n') {
-    // Insert implicit $ and ^ around \n
-    beforeflag |= kEmptyEndLine;
+    // Insert implicit ^ after \n
     afterflag |= kEmptyBeginLine;
   }
 
-  if (c == kByteEndText) {
-    // Insert implicit $ and \z before the fake "end text" byte.
-    beforeflag |= kEmptyEndLine | kEmptyEndText;
-  }
-
-  // The state flag kFlagLastWord says whether the last
-  // byte processed was a word character.  Use that info to
-  // insert empty-width (non-)word boundaries.
-  bool islastword = state->flag_ & kFlagLastWord;
   bool isword = (c != kByteEndText && Prog::IsWordChar(c));
-  if (isword == islastword)
-    beforeflag |= kEmptyNonWordBoundary;
-  else
-    beforeflag |= kEmptyWordBoundary;
 
   // Okay, finally ready to run.
   // Only useful to rerun on empty string if there are new, useful flags.
@@ -1071,6 +1176,41 @@ DFA::State* DFA::RunStateOnByte(State* state, int c) {
   return ns;
 }
 
+// Collects the match ids for a state that RunStateOnByte
+// found to lead to a match on byte c.
+void DFA::MatchIdsOnByte(State* state, int c, vector<int>* ids) {
+  ids->clear();
+  if (prog_->anchor_end() && c != kByteEndText)
+    return;
+
+  // Usually no empty-width flags matter, and the Match
+  // instructions are right there in the state.
+  uint needflag = state->flag_ >> kFlagNeedShift;
+  uint beforeflag = BeforeFlag(state, c);
+  if (!(beforeflag & ~(state->flag_ & kFlagEmptyMask) & needflag)) {
+    for (int i = 0; i < state->ninst_; i++) {
+      if (state->inst_[i] == Mark)
+        continue;
+      Prog::Inst* ip = prog_->inst(state->inst_[i]);
+      if (ip->opcode() == kInstMatch)
+        ids->push_back(ip->match_id());
+    }
+    return;
+  }
+
+  // Otherwise rerun the empty-width instructions, as RunStateOnByte does.
+  MutexLock l(&mutex_);
+  StateToWorkq(state, q0_);
+  RunWorkqOnEmptyString(q0_, q1_, beforeflag);
+  for (Workq::iterator i = q1_->begin(); i != q1_->end(); ++i) {
+    if (q1_->is_mark(*i))
+      continue;
+    Prog::Inst* ip = prog_->inst(*i);
+    if (ip->opcode() == kInstMatch)
+      ids->push_back(ip->match_id());
+  }
+}
+
 
 //////////////////////////////////////////////////////////////////////
 // DFA cache reset.
@@ -1171,6 +1311,8 @@ void DFA::ResetCache(RWLocker* cache_lock) {
   }
   ClearCache();
   mem_budget_ = state_budget_;
+  nresets_++;
+  thread_cache_resets++;
 }
 
 // Typically, a couple States do need to be preserved across a cache
@@ -1284,6 +1426,9 @@ DFA::State* DFA::StateSaver::Restore() {
 // Whether the start state has this property is determined during a
 // pre-compilation pass, and if so, the byte b is passed to the search
 // loop as the "firstbyte" argument, along with a boolean "have_firstbyte".
+// Similarly, if the bytes leading out of the start state are all first
+// bytes of the literals the Prog says must begin any match, "firstbyte"
+// is kFbPrefixAccel and the Prog's multi-literal scanner is used instead.
 //
 // Fourth, the desired behavior is to search for the leftmost-best match
 // (approximately, the same one that Perl would find), which is not
@@ -1332,7 +1477,11 @@ inline bool DFA::InlinedSearchLoop(SearchParams* params,
   bool matched = false;
   State* s = start;
 
-  if (s->IsMatch()) {
+  // A stream resumes in the state where the last piece left it.
+  // Any match that state records was found with the last piece.
+  if (params->resume != NULL)
+    s = params->resume;
+  else if (s->IsMatch()) {
     matched = true;
     lastmatch = p;
     if (want_earliest_match) {
@@ -1351,7 +1500,11 @@ inline bool DFA::InlinedSearchLoop(SearchParams* params,
       // If firstbyte isn't found, we can skip to the end
       // of the string.
       if (run_forward) {
-        if ((p = BytePtr(memchr(p, params->firstbyte, ep - p))) == NULL) {
+        if (params->firstbyte == kFbPrefixAccel)
+          p = BytePtr(prog_->PrefixAccel(p, ep - p));
+        else
+          p = BytePtr(memchr(p, params->firstbyte, ep - p));
+        if (p == NULL) {
           p = ep;
           break;
         }
@@ -1432,6 +1585,7 @@ inline bool DFA::InlinedSearchLoop(SearchParams* params,
       }
     }
     if (ns <= SpecialStateMax) {
+      params->resume = ns;
       if (ns == DeadState) {
         params->ep = reinterpret_cast<const char*>(lastmatch);
         return matched;
@@ -1440,9 +1594,8 @@ inline bool DFA::InlinedSearchLoop(SearchParams* params,
       params->ep = reinterpret_cast<const char*>(ep);
       return true;
     }
-    s = ns;
 
-    if (s->IsMatch()) {
+    if (ns->IsMatch()) {
       matched = true;
       // The DFA notices the match one byte late,
       // so adjust p before using it in the match.
@@ -1453,13 +1606,30 @@ inline bool DFA::InlinedSearchLoop(SearchParams* params,
       if (DebugDFA)
         fprintf(stderr, "match @%d! [%s]\n",
                 static_cast<int>(lastmatch - bp),
-                DumpState(s).c_str());
+                DumpState(ns).c_str());
+
+      // The regexps that just matched are the ones whose
+      // Match instructions s reaches on c.
+      if (params->match_ends != NULL &&
+          RecordMatchEnds(params, s, c, lastmatch)) {
+        params->ep = reinterpret_cast<const char*>(lastmatch);
+        return true;
+      }
 
       if (want_earliest_match) {
         params->ep = reinterpret_cast<const char*>(lastmatch);
         return true;
       }
     }
+    s = ns;
+  }
+
+  // If more text follows in another piece, that will say
+  // whether the last byte of this one ends a match.
+  if (!params->at_end) {
+    params->resume = s;
+    params->ep = reinterpret_cast<const char*>(lastmatch);
+    return matched;
   }
 
   // Process one more byte to see if it triggers a match.
@@ -1497,6 +1667,8 @@ inline bool DFA::InlinedSearchLoop(SearchParams* params,
       }
     }
   }
+  if (params->match_ends != NULL && ns > SpecialStateMax && ns->IsMatch())
+    RecordMatchEnds(params, s, lastbyte, p);
   s = ns;
   if (DebugDFA)
     fprintf(stderr, "@_: %s\n", DumpState(s).c_str());
@@ -1553,7 +1725,8 @@ bool DFA::SearchTTT(SearchParams* params) {
 // For debugging, calls the general code directly.
 bool DFA::SlowSearchLoop(SearchParams* params) {
   return InlinedSearchLoop(params,
-                           params->firstbyte >= 0,
+                           params->firstbyte >= 0 ||
+                           params->firstbyte == kFbPrefixAccel,
                            params->want_earliest_match,
                            params->run_forward);
 }
@@ -1574,7 +1747,8 @@ bool DFA::FastSearchLoop(SearchParams* params) {
     &DFA::SearchTTT,
   };
 
-  bool have_firstbyte = (params->firstbyte >= 0);
+  bool have_firstbyte = (params->firstbyte >= 0 ||
+                         params->firstbyte == kFbPrefixAccel);
   int index = 4 * have_firstbyte +
               2 * params->want_earliest_match +
               1 * params->run_forward;
@@ -1623,13 +1797,17 @@ bool DFA::AnalyzeSearch(SearchParams* params) {
   int start;
   uint flags;
   if (params->run_forward) {
-    if (text.begin() == context.begin()) {
+    int c = params->prevbyte;
+    if (c < 0)
+      c = text.begin() == context.begin() ? kByteEndText
+                                          : text.begin()[-1] & 0xFF;
+    if (c == kByteEndText) {
       start = kStartBeginText;
       flags = kEmptyBeginText|kEmptyBeginLine;
-    } else if (text.begin()[-1] == '\n') {
+    } else if (c == '\n') {
       start = kStartBeginLine;
       flags = kEmptyBeginLine;
-    } else if (Prog::IsWordChar(text.begin()[-1] & 0xFF)) {
+    } else if (Prog::IsWordChar(c)) {
       start = kStartAfterWordChar;
       flags = kFlagLastWord;
     } else {
@@ -1717,8 +1895,11 @@ bool DFA::AnalyzeSearchHelper(SearchParams* params, StartInfo* info,
 
   // Compute info->firstbyte by running state on all
   // possible byte values, looking for a single one that
-  // leads to a different state.
+  // leads to a different state.  If the Prog has a prefix
+  // accelerator, also check whether every byte that leads
+  // to a different state begins one of its prefixes.
   int firstbyte = kFbNone;
+  bool prefix_accel = prog_->can_prefix_accel() && !prog_->reversed();
   for (int i = 0; i < 256; i++) {
     State* s = RunStateOnByte(info->start, i);
     if (s == NULL) {
@@ -1729,14 +1910,20 @@ bool DFA::AnalyzeSearchHelper(SearchParams* params, StartInfo* info,
     }
     if (s == info->start)
       continue;
+    if (!prog_->IsPrefixFirstByte(i))
+      prefix_accel = false;
     // Goes to new state...
     if (firstbyte == kFbNone) {
       firstbyte = i;        // ... first one
     } else {
       firstbyte = kFbMany;  // ... too many
-      break;
+      if (!prefix_accel)
+        break;
     }
   }
+  // A single byte is found faster by memchr.
+  if (prefix_accel && firstbyte == kFbMany)
+    firstbyte = kFbPrefixAccel;
   ANNOTATE_HAPPENS_BEFORE(&info->firstbyte);
   WriteMemoryBarrier();  // Synchronize with "quick check" above.
   info->firstbyte = firstbyte;
@@ -1772,31 +1959,123 @@ bool DFA::Search(const StringPiece& text,
   params.want_earliest_match = want_earliest_match;
   params.run_forward = run_forward;
   params.matches = matches;
+  return RunSearch(&params, failed, epp);
+}
 
-  if (!AnalyzeSearch(&params)) {
+int DFA::SearchBatch(const StringPiece* texts,
+                     const StringPiece* contexts,
+                     int n,
+                     bool anchored,
+                     bool want_earliest_match,
+                     bool run_forward,
+                     bool carat,
+                     bool dollar,
+                     bool endmatch,
+                     bool* matched) {
+  if (!ok())
+    return 0;
+
+  RWLocker l(&cache_mutex_);
+  for (int i = 0; i < n; i++) {
+    const StringPiece& text = texts[i];
+    const StringPiece& context = contexts[i];
+    matched[i] = false;
+    if (carat && context.begin() != text.begin())
+      continue;
+    if (dollar && context.end() != text.end())
+      continue;
+    SearchParams params(text, context, &l);
+    params.anchored = anchored;
+    params.want_earliest_match = want_earliest_match;
+    params.run_forward = run_forward;
+    bool failed = false;
+    const char* ep;
+    bool ret = RunSearch(&params, &failed, &ep);
+    if (failed)
+      return i;
+    if (ret && endmatch && ep != (run_forward ? text.end() : text.begin()))
+      ret = false;
+    matched[i] = ret;
+  }
+  return n;
+}
+
+bool DFA::SearchMatchEnds(const StringPiece& text,
+                          bool anchored,
+                          bool longest,
+                          vector<const char*>* ends,
+                          bool* failed) {
+  if (!ok()) {
     *failed = true;
     return false;
   }
-  if (params.start == DeadState)
+  *failed = false;
+  if (kind_ != Prog::kManyMatch) {
+    LOG(DFATAL) << "SearchMatchEnds needs a kManyMatch DFA";
+    *failed = true;
     return false;
-  if (params.start == FullMatchState) {
-    if (run_forward == want_earliest_match)
-      *epp = text.begin();
+  }
+
+  RWLocker l(&cache_mutex_);
+  SearchParams params(text, text, &l);
+  params.anchored = anchored;
+  params.run_forward = true;
+  params.match_ends = ends;
+  params.longest_ends = longest;
+  for (int i = 0; i < ends->size(); i++) {
+    if ((*ends)[i] == NULL)
+      params.match_ends_left++;
+  }
+  const char* ep;
+  return RunSearch(&params, failed, &ep);
+}
+
+bool DFA::RunSearch(SearchParams* params, bool* failed, const char** epp) {
+  if (!AnalyzeSearch(params)) {
+    *failed = true;
+    return false;
+  }
+  if (params->start == DeadState)
+    return false;
+  if (params->start == FullMatchState) {
+    if (params->run_forward == params->want_earliest_match)
+      *epp = params->text.begin();
     else
-      *epp = text.end();
+      *epp = params->text.end();
     return true;
   }
   if (DebugDFA)
-    fprintf(stderr, "start %s\n", DumpState(params.start).c_str());
-  bool ret = FastSearchLoop(&params);
-  if (params.failed) {
+    fprintf(stderr, "start %s\n", DumpState(params->start).c_str());
+  bool ret = FastSearchLoop(params);
+  if (params->failed) {
     *failed = true;
     return false;
   }
-  *epp = params.ep;
+  *epp = params->ep;
   return ret;
 }
 
+bool DFA::RecordMatchEnds(SearchParams* params, State* state, int c,
+                          const uint8* p) {
+  vector<int>* ids = &params->match_ids;
+  vector<const char*>* ends = params->match_ends;
+  const char* end = reinterpret_cast<const char*>(p);
+  MatchIdsOnByte(state, c, ids);
+  for (int i = 0; i < ids->size(); i++) {
+    int id = (*ids)[i];
+    if (id < 0 || id >= ends->size()) {
+      LOG(DFATAL) << "match id " << id << " out of range";
+      continue;
+    }
+    if ((*ends)[id] == NULL)
+      params->match_ends_left--;
+    else if (!params->longest_ends)
+      continue;
+    (*ends)[id] = end;
+  }
+  return !params->longest_ends && params->match_ends_left == 0;
+}
+
 // Deletes dfa.
 //
 // This is a separate function so that
@@ -1810,13 +2089,34 @@ static void DeleteDFA(DFA* dfa) {
   delete dfa;
 }
 
+// Returns a number for the calling thread, handed out in order the
+// first time each thread asks.  Used to pick a DFA cache shard, so
+// that N threads spread over N shards without collisions.
+GLOBAL_MUTEX(thread_index_mutex);
+static int next_thread_index = 0;
+
+static int ThreadIndex() {
+  static DFA_THREAD_LOCAL int index = -1;
+  if (index < 0) {
+    GLOBAL_MUTEX_LOCK(thread_index_mutex);
+    index = next_thread_index;
+    next_thread_index = (next_thread_index + 1) & 0x7FFFFFFF;
+    GLOBAL_MUTEX_UNLOCK(thread_index_mutex);
+  }
+  return index;
+}
+
 DFA* Prog::GetDFA(MatchKind kind) {
+  int shard = 0;
+  if (dfa_cache_shards_ > 1)
+    shard = ThreadIndex() % dfa_cache_shards_;
+
   DFA*volatile* pdfa;
   if (kind == kFirstMatch || kind == kManyMatch) {
-    pdfa = &dfa_first_;
+    pdfa = &dfa_first_[shard];
   } else {
     kind = kLongestMatch;
-    pdfa = &dfa_longest_;
+    pdfa = &dfa_longest_[shard];
   }
 
   // Quick check; okay because of memory barrier below.
@@ -1837,6 +2137,7 @@ DFA* Prog::GetDFA(MatchKind kind) {
   // For a reverse DFA, all the memory goes to the
   // "longest match" DFA, because RE2 never does reverse
   // "first match" searches.
+  // With several shards, each gets an equal share of that.
   int64 m = dfa_mem_/2;
   if (reversed_) {
     if (kind == kLongestMatch || kind == kManyMatch)
@@ -1844,9 +2145,14 @@ DFA* Prog::GetDFA(MatchKind kind) {
     else
       m = 0;
   }
-  dfa = new DFA(this, kind, m);
+  dfa = new DFA(this, kind, m / dfa_cache_shards_);
   delete_dfa_ = DeleteDFA;
 
+  // Start with the states that Deserialize read, if any.
+  const vector<uint32>& saved = dfa_states_[pdfa == &dfa_longest_[shard]];
+  if (!dfa->LoadStates(saved))
+    LOG(ERROR) << "Ignoring bad saved DFA states";
+
   // Synchronize with "quick check" above.
   ANNOTATE_HAPPENS_BEFORE(dfa);
   WriteMemoryBarrier();
@@ -1908,9 +2214,11 @@ bool Prog::SearchDFA(const StringPiece& text, const StringPiece& const_context,
 
   DFA* dfa = GetDFA(kind);
   const char* ep;
+  int64 resets = thread_cache_resets;
   bool matched = dfa->Search(text, context, anchored,
                              want_shortest_match, !reversed_,
                              failed, &ep, matches);
+  NoteDFASearch(resets, *failed);
   if (*failed)
     return false;
   if (!matched)
@@ -1930,6 +2238,305 @@ bool Prog::SearchDFA(const StringPiece& text, const StringPiece& const_context,
   return true;
 }
 
+DFA::State* DFA::RestoreStreamState(DFAStreamState* ss) {
+  MutexLock l(&mutex_);
+  return CachedState(ss->inst.empty() ? NULL : &ss->inst[0],
+                     ss->inst.size(), ss->flag);
+}
+
+bool DFA::SearchStream(DFAStreamState* ss,
+                       const StringPiece& const_text,
+                       bool anchored,
+                       bool at_end,
+                       const char** epp,
+                       vector<const char*>* ends,
+                       bool* failed) {
+  *epp = NULL;
+  *failed = false;
+  if (!ok()) {
+    *failed = true;
+    return false;
+  }
+  if (ss->done)
+    return false;
+
+  // The search loop reports match ends as pointers into text,
+  // so text must point somewhere even when it is empty.
+  StringPiece text = const_text;
+  if (text.begin() == NULL)
+    text = StringPiece("", 0);
+
+  RWLocker l(&cache_mutex_);
+  SearchParams params(text, text, &l);
+  params.anchored = anchored;
+  params.want_earliest_match = (ends == NULL);
+  params.run_forward = true;
+  params.prevbyte = ss->prevbyte < 0 ? kByteEndText : ss->prevbyte;
+  params.at_end = at_end;
+  if (ends != NULL) {
+    params.match_ends = ends;
+    for (int i = 0; i < ends->size(); i++) {
+      if ((*ends)[i] == NULL)
+        params.match_ends_left++;
+    }
+  }
+
+  if (!AnalyzeSearch(&params)) {
+    *failed = true;
+    return false;
+  }
+  if (ss->started) {
+    params.resume = RestoreStreamState(ss);
+    if (params.resume == NULL) {
+      // Out of memory: make room and analyze the start again.
+      ResetCache(params.cache_lock);
+      if (!AnalyzeSearch(&params) ||
+          (params.resume = RestoreStreamState(ss)) == NULL) {
+        LOG(DFATAL) << "SearchStream failed to restore state.";
+        *failed = true;
+        return false;
+      }
+    }
+  } else if (params.start == DeadState) {
+    ss->done = true;
+    return false;
+  } else if (params.start == FullMatchState) {
+    ss->done = true;
+    *epp = text.begin();
+    return ends == NULL;
+  }
+
+  // The prefix accelerator skips a literal that starts in this piece
+  // but does not end in it, so it is only safe for the last piece.
+  if (!at_end && params.firstbyte == kFbPrefixAccel)
+    params.firstbyte = kFbMany;
+
+  bool ret = FastSearchLoop(&params);
+  if (params.failed) {
+    *failed = true;
+    return false;
+  }
+
+  // The stream is done once nothing more can be reported:
+  // at the end, at a dead state, or when the search stopped
+  // because it had found everything it was looking for.
+  if (at_end || params.resume <= SpecialStateMax ||
+      (ends == NULL ? ret : params.match_ends_left == 0)) {
+    ss->done = true;
+  } else {
+    State* s = params.resume;
+    ss->inst.assign(s->inst_, s->inst_ + s->ninst_);
+    ss->flag = s->flag_;
+    ss->started = true;
+    if (!text.empty())
+      ss->prevbyte = text.end()[-1] & 0xFF;
+  }
+  *epp = params.ep;
+  return ret;
+}
+
+bool Prog::SearchDFAStream(DFAStreamState* ss, const StringPiece& text,
+                           bool at_end, Anchor anchor, const char** ep,
+                           vector<const char*>* ends, bool* failed) {
+  *ep = NULL;
+  *failed = false;
+  if (reversed_) {
+    LOG(DFATAL) << "SearchDFAStream on a reversed Prog";
+    *failed = true;
+    return false;
+  }
+  bool anchored = anchor == kAnchored || anchor_start();
+  DFA* dfa = GetDFA(ends != NULL ? kManyMatch : kLongestMatch);
+  int64 resets = thread_cache_resets;
+  bool ret = dfa->SearchStream(ss, text, anchored, at_end, ep, ends, failed);
+  NoteDFASearch(resets, *failed);
+  return ret;
+}
+
+int Prog::SearchDFABatch(const StringPiece* texts,
+                         const StringPiece* contexts, int n,
+                         Anchor anchor, MatchKind kind, bool* matched) {
+  // Decide once what SearchDFA decides for each text (with no match0).
+  bool carat = anchor_start();
+  bool dollar = anchor_end();
+  if (reversed_) {
+    bool t = carat;
+    carat = dollar;
+    dollar = t;
+  }
+  bool anchored = anchor == kAnchored || anchor_start() || kind == kFullMatch;
+  bool endmatch = false;
+  if (kind == kManyMatch) {
+    endmatch = true;
+  } else if (kind == kFullMatch || anchor_end()) {
+    endmatch = true;
+    kind = kLongestMatch;
+  }
+  bool want_shortest_match = false;
+  if (!endmatch) {
+    want_shortest_match = true;
+    kind = kLongestMatch;
+  }
+
+  DFA* dfa = GetDFA(kind);
+  int64 resets = thread_cache_resets;
+  int done = dfa->SearchBatch(texts, contexts, n, anchored,
+                              want_shortest_match, !reversed_,
+                              carat, dollar, endmatch, matched);
+  NoteDFASearch(resets, done < n);
+  return done;
+}
+
+bool Prog::SearchDFAMatchEnds(const StringPiece& text, Anchor anchor,
+                              bool longest, vector<const char*>* ends,
+                              bool* failed) {
+  *failed = false;
+  bool anchored = anchor == kAnchored || anchor_start();
+  DFA* dfa = GetDFA(kManyMatch);
+  int64 resets = thread_cache_resets;
+  bool ret = dfa->SearchMatchEnds(text, anchored, longest, ends, failed);
+  NoteDFASearch(resets, *failed);
+  return ret;
+}
+
+void Prog::NoteDFASearch(int64 resets, bool failed) {
+  if (failed) {
+    MutexLock l(&dfa_mutex_);
+    dfa_failures_++;
+  }
+  if (dfa_event_callback_ == NULL)
+    return;
+  for (; resets < thread_cache_resets; resets++)
+    dfa_event_callback_(dfa_event_arg_, kDFACacheReset);
+  if (failed)
+    dfa_event_callback_(dfa_event_arg_, kDFAFailure);
+}
+
+void DFA::AddStats(Prog::DFAStats* stats) {
+  if (!ok())
+    return;
+  ReaderMutexLock l(&cache_mutex_);
+  MutexLock ml(&mutex_);
+  stats->states += nstates_;
+  stats->cache_resets += nresets_;
+  // mem_budget_ is -1 after a State did not fit.
+  stats->bytes_used += max_mem_ - (mem_budget_ < 0 ? 0 : mem_budget_);
+}
+
+void Prog::AddDFAStats(DFAStats* stats) {
+  MutexLock l(&dfa_mutex_);
+  for (int i = 0; i < dfa_cache_shards_; i++) {
+    if (dfa_first_[i] != NULL)
+      dfa_first_[i]->AddStats(stats);
+    if (dfa_longest_[i] != NULL)
+      dfa_longest_[i]->AddStats(stats);
+  }
+  stats->failures += dfa_failures_;
+}
+
+// The saved states are a sequence of words:
+//   kind_, number of states, then for each state:
+//   flag_, ninst_, inst_[0..ninst_-1], next_[0..nnext-1]
+// where a next_ entry is 0 for NULL, 1 for DeadState,
+// 2 for FullMatchState and 3+i for the i'th state.
+void DFA::SaveStates(vector<uint32>* v) {
+  if (!ok())
+    return;
+  ReaderMutexLock l(&cache_mutex_);
+  MutexLock ml(&mutex_);  // no new states or arrows
+
+  map<State*, int> index;
+  index[NULL] = 0;
+  index[DeadState] = 1;
+  index[FullMatchState] = 2;
+  for (StateSet::iterator it = state_cache_.begin();
+       it != state_cache_.end(); ++it)
+    index.insert(make_pair(*it, index.size()));
+
+  int nnext = prog_->bytemap_range() + 1;
+  v->push_back(kind_);
+  v->push_back(state_cache_.size());
+  for (StateSet::iterator it = state_cache_.begin();
+       it != state_cache_.end(); ++it) {
+    State* s = *it;
+    v->push_back(s->flag_);
+    v->push_back(s->ninst_);
+    for (int i = 0; i < s->ninst_; i++)
+      v->push_back(s->inst_[i]);
+    for (int i = 0; i < nnext; i++)
+      v->push_back(index[s->next_[i]]);
+  }
+}
+
+bool DFA::LoadStates(const vector<uint32>& v) {
+  if (!ok() || v.empty())
+    return true;
+
+  // Check everything first, so as not to load half of a bad list.
+  int nnext = prog_->bytemap_range() + 1;
+  if (v.size() < 2 || v[1] > v.size())
+    return false;
+  if (v[0] != kind_)
+    return true;  // states for another kind of DFA are no use here
+  int nstate = v[1];
+  vector<int> pos(nstate);
+  int i = 2;
+  for (int j = 0; j < nstate; j++) {
+    pos[j] = i;
+    if (v.size() - i < 2 || v[i+1] > v.size() - i - 2)
+      return false;
+    int ninst = v[i+1];
+    i += 2;
+    for (int k = 0; k < ninst; k++, i++) {
+      int id = v[i];
+      if (id < Mark || id >= prog_->size())
+        return false;
+    }
+    if (v.size() - i < nnext)
+      return false;
+    for (int k = 0; k < nnext; k++, i++) {
+      if (v[i] >= nstate + 3)
+        return false;
+    }
+  }
+  if (i != v.size())
+    return false;
+
+  // Leave a quarter of the budget for the states that searches add,
+  // so that the first of those does not throw away the loaded ones.
+  MutexLock l(&mutex_);
+  vector<State*> state(nstate + 3);
+  state[1] = DeadState;
+  state[2] = FullMatchState;
+  for (int j = 0; j < nstate && mem_budget_ > state_budget_/4; j++) {
+    const uint32* p = &v[pos[j]];
+    vector<int> inst(p + 2, p + 2 + p[1]);
+    state[j + 3] = CachedState(inst.empty() ? NULL : &inst[0], inst.size(),
+                               p[0]);
+    if (state[j + 3] == NULL)
+      break;
+  }
+  for (int j = 0; j < nstate; j++) {
+    State* s = state[j + 3];
+    if (s == NULL)
+      continue;
+    const uint32* next = &v[pos[j] + 2 + s->ninst_];
+    for (int k = 0; k < nnext; k++)
+      s->next_[k] = state[next[k]];
+  }
+  return true;
+}
+
+void Prog::SaveDFAStates(DFA* volatile* dfa, vector<uint32>* v) {
+  DFA* d;
+  {
+    MutexLock l(&dfa_mutex_);
+    d = dfa[0];
+  }
+  if (d != NULL)
+    d->SaveStates(v);
+}
+
 // Build out all states in DFA.  Returns number of states.
 int DFA::BuildAllStates() {
   if (!ok())
@@ -2120,11 +2727,12 @@ bool Prog::PossibleMatchRange(string* min, string* max, int maxlen) {
     MutexLock l(&dfa_mutex_);
     // Have to use dfa_longest_ to get all strings for full matches.
     // For example, (a|aa) never matches aa in first-match mode.
-    if (dfa_longest_ == NULL) {
-      dfa_longest_ = new DFA(this, Prog::kLongestMatch, dfa_mem_/2);
+    if (dfa_longest_[0] == NULL) {
+      dfa_longest_[0] = new DFA(this, Prog::kLongestMatch,
+                                dfa_mem_/2 / dfa_cache_shards_);
       delete_dfa_ = DeleteDFA;
     }
-    dfa = dfa_longest_;
+    dfa = dfa_longest_[0];
   }
   return dfa->PossibleMatchRange(min, max, maxlen);
 }
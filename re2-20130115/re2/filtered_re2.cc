@@ -7,18 +7,24 @@
 #include "thirdparty/re2-20130115/re2/filtered_re2.h"
 #include "thirdparty/re2-20130115/re2/prefilter.h"
 #include "thirdparty/re2-20130115/re2/prefilter_tree.h"
+#include "thirdparty/re2-20130115/re2/prog.h"
+#include "thirdparty/re2-20130115/re2/regexp.h"
 
 namespace re2 {
 
 FilteredRE2::FilteredRE2()
     : compiled_(false),
-      prefilter_tree_(new PrefilterTree()) {
+      prefilter_tree_(new PrefilterTree()),
+      has_latin1_(false),
+      has_utf8_(false),
+      atom_prog_(NULL) {
 }
 
 FilteredRE2::~FilteredRE2() {
   for (int i = 0; i < re2_vec_.size(); i++)
     delete re2_vec_[i];
   delete prefilter_tree_;
+  delete atom_prog_;
 }
 
 RE2::ErrorCode FilteredRE2::Add(const StringPiece& pattern,
@@ -35,6 +41,10 @@ RE2::ErrorCode FilteredRE2::Add(const StringPiece& pattern,
   } else {
     *id = re2_vec_.size();
     re2_vec_.push_back(re);
+    if (options.encoding() == RE2::Options::EncodingLatin1)
+      has_latin1_ = true;
+    else
+      has_utf8_ = true;
   }
 
   return code;
@@ -52,6 +62,8 @@ void FilteredRE2::Compile(vector<string>* atoms) {
   }
   atoms->clear();
   prefilter_tree_->Compile(atoms);
+  atoms_ = *atoms;
+  BuildAtomProg();
   compiled_ = true;
 }
 
@@ -89,6 +101,109 @@ bool FilteredRE2::AllMatches(
   return !matching_regexps->empty();
 }
 
+// Builds atom_prog_, a Set program of the atoms, run unanchored to
+// record where each atom ends; the DFA running it does the work of an
+// Aho-Corasick automaton.  Building it in Compile keeps MatchAtoms
+// free of locks: afterwards atom_prog_ and unsearched_atoms_ are only
+// read.
+//
+// Compile lowercases UTF-8 atoms rune by rune and Latin-1 atoms
+// byte by byte (ASCII only), so ignoring case while matching finds
+// every atom that lowercasing the text would.  When both encodings
+// are in use the atoms are matched as Latin-1, which would miss
+// differences in case outside ASCII, so atoms with non-ASCII bytes
+// are left out of the program and always reported instead.
+void FilteredRE2::BuildAtomProg() {
+  RE2::Options options;
+  options.set_utf8(!has_latin1_);
+  options.set_literal(true);
+  options.set_case_sensitive(false);
+  // The atoms can be many; give them room beyond the default.
+  int64 size = 0;
+  for (int i = 0; i < atoms_.size(); i++)
+    size += atoms_[i].size();
+  options.set_max_mem(min<int64>(RE2::Options::kDefaultMaxMem + 256*size,
+                                 1<<30));
+  Regexp::ParseFlags pf = static_cast<Regexp::ParseFlags>(
+    options.ParseFlags());
+
+  vector<re2::Regexp*> re;
+  for (int i = 0; i < atoms_.size(); i++) {
+    bool ascii = true;
+    for (int j = 0; j < atoms_[i].size(); j++) {
+      if (atoms_[i][j] & 0x80)
+        ascii = false;
+    }
+    re2::Regexp* sub[2];
+    sub[0] = NULL;
+    if (ascii || !has_latin1_ || !has_utf8_)
+      sub[0] = Regexp::Parse(atoms_[i], pf, NULL);
+    if (sub[0] == NULL) {
+      unsearched_atoms_.push_back(i);
+      continue;
+    }
+    sub[1] = Regexp::HaveMatch(i, pf);
+    re.push_back(Regexp::Concat(sub, 2, pf));
+  }
+  if (re.empty())
+    return;
+
+  re2::Regexp* alt = Regexp::Alternate(&re[0], re.size(), pf);
+  re2::Regexp* sre = alt->Simplify();
+  alt->Decref();
+  if (sre != NULL)
+    atom_prog_ = Prog::CompileSet(options, RE2::UNANCHORED, sre, true);
+  if (atom_prog_ == NULL) {
+    LOG(ERROR) << "Cannot compile FilteredRE2 atoms; "
+               << "MatchAtoms will report all of them";
+    unsearched_atoms_.clear();
+    for (int i = 0; i < atoms_.size(); i++)
+      unsearched_atoms_.push_back(i);
+  }
+}
+
+void FilteredRE2::MatchAtoms(const StringPiece& text,
+                             vector<int>* atoms) const {
+  atoms->clear();
+  if (!compiled_) {
+    LOG(DFATAL) << "MatchAtoms called before Compile";
+    return;
+  }
+  // The atoms left out of the program are taken to be present;
+  // marking them found up front lets the search stop early.
+  vector<const char*> ends(atoms_.size());
+  for (int i = 0; i < unsearched_atoms_.size(); i++)
+    ends[unsearched_atoms_[i]] = atoms_[unsearched_atoms_[i]].data();
+  if (atom_prog_ != NULL) {
+    bool failed;
+    atom_prog_->SearchDFAMatchEnds(text, Prog::kUnanchored, false, &ends,
+                                   &failed);
+    if (failed) {
+      LOG(ERROR) << "DFA out of memory in FilteredRE2::MatchAtoms";
+      for (int i = 0; i < atoms_.size(); i++)
+        atoms->push_back(i);
+      return;
+    }
+  }
+  for (int i = 0; i < ends.size(); i++) {
+    if (ends[i] != NULL)
+      atoms->push_back(i);
+  }
+}
+
+int FilteredRE2::FirstMatch(const StringPiece& text) const {
+  vector<int> atoms;
+  MatchAtoms(text, &atoms);
+  return FirstMatch(text, atoms);
+}
+
+bool FilteredRE2::AllMatches(const StringPiece& text,
+                             vector<int>* matching_regexps) const {
+  vector<int> atoms;
+  MatchAtoms(text, &atoms);
+  return AllMatches(text, atoms, matching_regexps);
+}
+
 void FilteredRE2::RegexpsGivenStrings(const vector<int>& matched_atoms,
                                       vector<int>* passed_regexps) {
   prefilter_tree_->RegexpsGivenStrings(matched_atoms, passed_regexps);
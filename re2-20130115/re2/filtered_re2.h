@@ -6,17 +6,19 @@
 // It provides a prefilter mechanism that helps in cutting down the
 // number of regexps that need to be actually searched.
 //
-// By design, it does not include a string matching engine. This is to
-// allow the user of the class to use their favorite string match
-// engine. The overall flow is: Add all the regexps using Add, then
-// Compile the FilteredRE2. The compile returns strings that need to
-// be matched. Note that all returned strings are lowercase. For
-// applying regexps to a search text, the caller does the string
-// matching using the strings returned. When doing the string match,
-// note that the caller has to do that on lower cased version of the
-// search text. Then call FirstMatch or AllMatches with a vector of
-// indices of strings that were found in the text to get the actual
-// regexp matches.
+// The overall flow is: Add all the regexps using Add, then Compile
+// the FilteredRE2. The compile returns strings that need to be
+// matched. Note that all returned strings are lowercase. For applying
+// regexps to a search text, the caller does the string matching using
+// the strings returned. When doing the string match, note that the
+// caller has to do that on lower cased version of the search text.
+// Then call FirstMatch or AllMatches with a vector of indices of
+// strings that were found in the text to get the actual regexp
+// matches.
+//
+// Callers without a string matching engine of their own can use the
+// built-in one: MatchAtoms finds the strings in a text, and the
+// FirstMatch and AllMatches that take only a text do all three steps.
 
 #ifndef RE2_FILTERED_RE2_H_
 #define RE2_FILTERED_RE2_H_
@@ -28,6 +30,7 @@ namespace re2 {
 using std::vector;
 
 class PrefilterTree;
+class Prog;
 
 class FilteredRE2 {
  public:
@@ -67,6 +70,20 @@ class FilteredRE2 {
                   const vector<int>& atoms,
                   vector<int>* matching_regexps) const;
 
+  // Fills atoms with the indices, in increasing order, of the strings
+  // returned by Compile that occur in text, ignoring case as described
+  // above.  Compile builds the matcher from those strings; it finds
+  // them all in one pass over text.  It may report strings that
+  // do not occur (which only costs extra regexp searches), but never
+  // misses one.  Compile has to be called before calling this.
+  void MatchAtoms(const StringPiece& text, vector<int>* atoms) const;
+
+  // Like FirstMatch and AllMatches above, but finding the
+  // strings with MatchAtoms.
+  int FirstMatch(const StringPiece& text) const;
+  bool AllMatches(const StringPiece& text,
+                  vector<int>* matching_regexps) const;
+
   // The number of regexps added.
   int NumRegexps() const { return re2_vec_.size(); }
 
@@ -82,6 +99,9 @@ class FilteredRE2 {
   void RegexpsGivenStrings(const vector<int>& matched_atoms,
                            vector<int>* passed_regexps);
 
+  // Builds atom_prog_ and unsearched_atoms_ for MatchAtoms.
+  void BuildAtomProg();
+
   // All the regexps in the FilteredRE2.
   vector<RE2*> re2_vec_;
 
@@ -91,6 +111,15 @@ class FilteredRE2 {
   // An AND-OR tree of string atoms used for filtering regexps.
   PrefilterTree* prefilter_tree_;
 
+  // The atoms returned by Compile, and whether the regexps added
+  // include Latin-1 ones and UTF-8 ones, for MatchAtoms.
+  vector<string> atoms_;
+  bool has_latin1_;
+  bool has_utf8_;
+
+  re2::Prog* atom_prog_;          // finds atoms, or NULL
+  vector<int> unsearched_atoms_;  // atoms not in atom_prog_
+
   //DISALLOW_EVIL_CONSTRUCTORS(FilteredRE2);
   FilteredRE2(const FilteredRE2&);
   void operator=(const FilteredRE2&);
@@ -10,6 +10,13 @@
 #include "thirdparty/re2-20130115/re2/prog.h"
 #include "thirdparty/re2-20130115/re2/stringpiece.h"
 
+// The SSSE3 prefix scan is compiled with a target attribute and picked
+// at run time, so it does not need -mssse3.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RE2_PREFIX_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
 namespace re2 {
 
 // Constructors per Inst opcode
@@ -103,27 +110,60 @@ Prog::Prog()
     flags_(0),
     onepass_statesize_(0),
     inst_(NULL),
+    dfa_cache_shards_(0),
     dfa_first_(NULL),
     dfa_longest_(NULL),
     dfa_mem_(0),
     delete_dfa_(NULL),
+    dfa_failures_(0),
+    dfa_event_callback_(NULL),
+    dfa_event_arg_(NULL),
     unbytemap_(NULL),
     onepass_nodes_(NULL),
-    onepass_start_(NULL) {
+    onepass_start_(NULL),
+    prefix_fingerprint_len_(0) {
+  set_dfa_cache_shards(1);
+  memset(prefix_first_, 0, sizeof prefix_first_);
 }
 
 Prog::~Prog() {
-  if (delete_dfa_) {
-    if (dfa_first_)
-      delete_dfa_(dfa_first_);
-    if (dfa_longest_)
-      delete_dfa_(dfa_longest_);
+  for (int i = 0; i < dfa_cache_shards_; i++) {
+    if (delete_dfa_) {
+      if (dfa_first_[i])
+        delete_dfa_(dfa_first_[i]);
+      if (dfa_longest_[i])
+        delete_dfa_(dfa_longest_[i]);
+    }
   }
+  delete[] dfa_first_;
+  delete[] dfa_longest_;
   delete[] onepass_nodes_;
   delete[] inst_;
   delete[] unbytemap_;
 }
 
+void Prog::set_dfa_cache_shards(int n) {
+  if (n < 1)
+    n = 1;
+  if (n == dfa_cache_shards_)
+    return;
+  for (int i = 0; i < dfa_cache_shards_; i++) {
+    if (dfa_first_[i] != NULL || dfa_longest_[i] != NULL) {
+      LOG(DFATAL) << "set_dfa_cache_shards called after DFA was built";
+      return;
+    }
+  }
+  delete[] dfa_first_;
+  delete[] dfa_longest_;
+  dfa_cache_shards_ = n;
+  dfa_first_ = new DFA* volatile[n];
+  dfa_longest_ = new DFA* volatile[n];
+  for (int i = 0; i < n; i++) {
+    dfa_first_[i] = NULL;
+    dfa_longest_[i] = NULL;
+  }
+}
+
 typedef SparseSet Workq;
 
 static inline void AddToQueue(Workq* q, int id) {
@@ -337,5 +377,385 @@ void Prog::ComputeByteMap() {
   }
 }
 
-}  // namespace re2
+// The prefix accelerator is a small version of the "Teddy" algorithm
+// from Hyperscan.  Each prefix gets one bit.  For each of the first
+// prefix_fingerprint_len_ (up to 3) bytes of the prefixes, two 16-entry
+// tables record which prefixes have that byte's low nibble and which
+// have its high nibble.  PSHUFB looks both up for 16 text positions at
+// once; ANDing the results over the fingerprint bytes leaves, for each
+// position, the prefixes that might begin there, which are then
+// checked with memcmp.  On CPUs without SSSE3 a byte-at-a-time loop
+// does the same using prefix_first_.
+
+void Prog::ConfigurePrefixAccel(const vector<string>& prefixes) {
+  DCHECK_LE(prefixes.size(), 8);
+  prefix_literals_.clear();
+  memset(prefix_first_, 0, sizeof prefix_first_);
+  memset(prefix_lo_, 0, sizeof prefix_lo_);
+  memset(prefix_hi_, 0, sizeof prefix_hi_);
+  prefix_fingerprint_len_ = 3;
+  if (prefixes.empty() || prefixes.size() > 8)
+    return;
+  for (int i = 0; i < prefixes.size(); i++) {
+    if (prefixes[i].empty())
+      return;
+    if (prefixes[i].size() < prefix_fingerprint_len_)
+      prefix_fingerprint_len_ = prefixes[i].size();
+  }
+
+  prefix_literals_ = prefixes;
+  for (int i = 0; i < prefixes.size(); i++) {
+    const uint8* p = reinterpret_cast<const uint8*>(prefixes[i].data());
+    prefix_first_[p[0]] |= 1 << i;
+    for (int j = 0; j < prefix_fingerprint_len_; j++) {
+      prefix_lo_[j][p[j] & 0x0F] |= 1 << i;
+      prefix_hi_[j][p[j] >> 4] |= 1 << i;
+    }
+  }
+}
 
+// Returns whether one of the prefixes in the bit set mask
+// occurs in full at p, with ep the end of the text.
+static inline bool PrefixAt(const vector<string>& prefixes, int mask,
+                            const uint8* p, const uint8* ep) {
+  for (int i = 0; mask != 0; i++, mask >>= 1) {
+    if ((mask & 1) == 0)
+      continue;
+    const string& s = prefixes[i];
+    if (s.size() <= ep - p && memcmp(p, s.data(), s.size()) == 0)
+      return true;
+  }
+  return false;
+}
+
+#if defined(RE2_PREFIX_SSSE3)
+
+static bool HaveSSSE3() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("ssse3");
+}
+
+// Scans [*pp, ep) 16 positions at a time, as described above, using
+// the nibble tables lo_table and hi_table for the first n bytes.
+// Returns the first position where one of the prefixes occurs, or NULL
+// after advancing *pp to the first position it did not look at.
+__attribute__((target("ssse3")))
+static const uint8* PrefixScanSSSE3(const uint8 (*lo_table)[16],
+                                    const uint8 (*hi_table)[16], int n,
+                                    const vector<string>& prefixes,
+                                    const uint8** pp, const uint8* ep) {
+  const uint8* p = *pp;
+  const __m128i nibble = _mm_set1_epi8(0x0F);
+  __m128i lo[3], hi[3];
+  for (int j = 0; j < n; j++) {
+    lo[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo_table[j]));
+    hi[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi_table[j]));
+  }
+  // Each step reads 16 + n - 1 bytes.
+  while (ep - p >= 16 + n - 1) {
+    __m128i m = _mm_set1_epi8(-1);
+    for (int j = 0; j < n; j++) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j));
+      __m128i l = _mm_shuffle_epi8(lo[j], _mm_and_si128(v, nibble));
+      __m128i h = _mm_shuffle_epi8(hi[j],
+                                   _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+      m = _mm_and_si128(m, _mm_and_si128(l, h));
+    }
+    int bits = _mm_movemask_epi8(_mm_cmpeq_epi8(m, _mm_setzero_si128()));
+    bits ^= 0xFFFF;
+    if (bits != 0) {
+      uint8 masks[16];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(masks), m);
+      do {
+        int i = __builtin_ctz(bits);
+        if (PrefixAt(prefixes, masks[i], p + i, ep))
+          return p + i;
+        bits &= bits - 1;
+      } while (bits != 0);
+    }
+    p += 16;
+  }
+  *pp = p;
+  return NULL;
+}
+
+#endif  // defined(RE2_PREFIX_SSSE3)
+
+const void* Prog::PrefixAccel(const void* data, size_t size) {
+  DCHECK(can_prefix_accel());
+  const uint8* p = reinterpret_cast<const uint8*>(data);
+  const uint8* ep = p + size;
+
+#if defined(RE2_PREFIX_SSSE3)
+  static const bool have_ssse3 = HaveSSSE3();
+  if (have_ssse3) {
+    const uint8* q = PrefixScanSSSE3(prefix_lo_, prefix_hi_,
+                                     prefix_fingerprint_len_,
+                                     prefix_literals_, &p, ep);
+    if (q != NULL)
+      return q;
+  }
+#endif
+
+  for (; p < ep; p++) {
+    int mask = prefix_first_[*p];
+    if (mask != 0 && PrefixAt(prefix_literals_, mask, p, ep))
+      return p;
+  }
+  return NULL;
+}
+
+// Serialization.
+//
+// A serialized Prog is a sequence of little-endian 32-bit words
+// (and the bytes of the prefix strings):
+//
+//   kProgMagic, kProgVersion,
+//   anchor_start | anchor_end<<1 | reversed<<2,
+//   start, start_unanchored, size, byte_inst_count, flags,
+//   dfa_mem (low word, high word),
+//   byterange (8 words),
+//   number of prefixes, then each prefix's length and bytes,
+//   size instructions, each as out_opcode and argument,
+//   DFA states for dfa_first_ and for dfa_longest_, each as
+//     a count of words followed by the words (see DFA::SaveStates).
+//
+// kProgVersion must change whenever the format does, or whenever
+// the meaning of the instructions or DFA states does.
+
+static const uint32 kProgMagic = 0x50324552;  // "RE2P"
+static const uint32 kProgVersion = 1;
+
+// PutWord appends w to *out.  GetWord reads a word from the front of
+// *data, removing it, or returns false if there is none.
+static void PutWord(string* out, uint32 w) {
+  char buf[4];
+  buf[0] = w & 0xFF;
+  buf[1] = (w >> 8) & 0xFF;
+  buf[2] = (w >> 16) & 0xFF;
+  buf[3] = (w >> 24) & 0xFF;
+  out->append(buf, 4);
+}
+
+static bool GetWord(StringPiece* data, uint32* w) {
+  if (data->size() < 4)
+    return false;
+  const uint8* p = reinterpret_cast<const uint8*>(data->data());
+  *w = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32>(p[3]) << 24);
+  data->remove_prefix(4);
+  return true;
+}
+
+void Prog::Serialize(bool with_dfa, string* out) {
+  PutWord(out, kProgMagic);
+  PutWord(out, kProgVersion);
+  PutWord(out, anchor_start_ | anchor_end_ << 1 | reversed_ << 2);
+  PutWord(out, start_);
+  PutWord(out, start_unanchored_);
+  PutWord(out, size_);
+  PutWord(out, byte_inst_count_);
+  PutWord(out, flags_);
+  PutWord(out, static_cast<uint64>(dfa_mem_) & 0xFFFFFFFF);
+  PutWord(out, static_cast<uint64>(dfa_mem_) >> 32);
+  for (int i = 0; i < 8; i++)
+    PutWord(out, byterange_.Word(i));
+
+  PutWord(out, prefix_literals_.size());
+  for (int i = 0; i < prefix_literals_.size(); i++) {
+    PutWord(out, prefix_literals_[i].size());
+    out->append(prefix_literals_[i]);
+  }
+
+  for (int id = 0; id < size_; id++) {
+    Inst* ip = inst(id);
+    uint32 arg = 0;
+    switch (ip->opcode()) {
+      case kInstAlt:
+      case kInstAltMatch:
+        arg = ip->out1_;
+        break;
+      case kInstByteRange:
+        arg = ip->lo_ | ip->hi_ << 8 | ip->foldcase_ << 16;
+        break;
+      case kInstCapture:
+        arg = ip->cap_;
+        break;
+      case kInstEmptyWidth:
+        arg = ip->empty_;
+        break;
+      case kInstMatch:
+        arg = ip->match_id_;
+        break;
+      default:
+        break;
+    }
+    PutWord(out, ip->out_opcode_);
+    PutWord(out, arg);
+  }
+
+  vector<uint32> v[2];
+  if (with_dfa) {
+    SaveDFAStates(dfa_first_, &v[0]);
+    SaveDFAStates(dfa_longest_, &v[1]);
+  }
+  for (int i = 0; i < 2; i++) {
+    PutWord(out, v[i].size());
+    for (int j = 0; j < v[i].size(); j++)
+      PutWord(out, v[i][j]);
+  }
+}
+
+Prog* Prog::Deserialize(const StringPiece& data, int nmatch, int64 max_mem,
+                         string* error) {
+  StringPiece d = data;
+  const char* why = NULL;
+  Prog* prog = new Prog;
+  uint32 w[10];
+  for (int i = 0; i < 10; i++) {
+    if (!GetWord(&d, &w[i])) {
+      why = "truncated";
+      goto Bad;
+    }
+  }
+  if (w[0] != kProgMagic) {
+    why = "not a serialized Prog";
+    goto Bad;
+  }
+  if (w[1] != kProgVersion) {
+    why = "serialized by a different version";
+    goto Bad;
+  }
+  prog->anchor_start_ = (w[2] & 1) != 0;
+  prog->anchor_end_ = (w[2] & 2) != 0;
+  prog->reversed_ = (w[2] & 4) != 0;
+  prog->start_ = w[3];
+  prog->start_unanchored_ = w[4];
+  prog->size_ = w[5];
+  prog->byte_inst_count_ = w[6];
+  prog->flags_ = w[7];
+  prog->dfa_mem_ = static_cast<int64>(w[8] | static_cast<uint64>(w[9]) << 32);
+  if (w[5] < 1 || w[5] > Inst::kMaxInst || w[3] >= w[5] || w[4] >= w[5]) {
+    why = "bad program size or start";
+    goto Bad;
+  }
+  if (prog->dfa_mem_ < 0) {
+    why = "bad DFA memory";
+    goto Bad;
+  }
+  {
+    // No more than compiling with max_mem would have left for the DFAs.
+    int64 m = 1<<20;
+    if (max_mem > 0) {
+      m = max_mem - sizeof(Prog) - w[5]*sizeof(Inst);
+      if (m < 0)
+        m = 0;
+    }
+    if (prog->dfa_mem_ > m)
+      prog->dfa_mem_ = m;
+  }
+
+  for (int i = 0; i < 256; i += 32) {
+    uint32 bits;
+    if (!GetWord(&d, &bits)) {
+      why = "truncated";
+      goto Bad;
+    }
+    for (int j = 0; j < 32; j++) {
+      if (bits & (1u << j))
+        prog->byterange_.Set(i + j);
+    }
+  }
+  prog->ComputeByteMap();
+
+  {
+    uint32 n, len;
+    vector<string> prefixes;
+    if (!GetWord(&d, &n) || n > 8) {
+      why = "bad prefixes";
+      goto Bad;
+    }
+    for (int i = 0; i < n; i++) {
+      if (!GetWord(&d, &len) || len == 0 || len > d.size()) {
+        why = "bad prefixes";
+        goto Bad;
+      }
+      prefixes.push_back(string(d.data(), len));
+      d.remove_prefix(len);
+    }
+    if (!prefixes.empty())
+      prog->ConfigurePrefixAccel(prefixes);
+  }
+
+  if (d.size() / 8 < prog->size_) {
+    why = "truncated";
+    goto Bad;
+  }
+  prog->inst_ = new Inst[prog->size_];
+  for (int id = 0; id < prog->size_; id++) {
+    Inst* ip = prog->inst(id);
+    uint32 oo, arg;
+    GetWord(&d, &oo);
+    GetWord(&d, &arg);
+    ip->out_opcode_ = oo;
+    if (ip->opcode() > kInstFail || ip->out() >= prog->size_) {
+      why = "bad instruction";
+      goto Bad;
+    }
+    switch (ip->opcode()) {
+      case kInstAlt:
+      case kInstAltMatch:
+        if (arg >= prog->size_) {
+          why = "bad instruction";
+          goto Bad;
+        }
+        ip->out1_ = arg;
+        break;
+      case kInstByteRange:
+        ip->lo_ = arg & 0xFF;
+        ip->hi_ = (arg >> 8) & 0xFF;
+        ip->foldcase_ = (arg >> 16) & 0xFF;
+        break;
+      case kInstCapture:
+        ip->cap_ = arg;
+        break;
+      case kInstEmptyWidth:
+        ip->empty_ = static_cast<EmptyOp>(arg & kEmptyAllFlags);
+        break;
+      case kInstMatch:
+        // Callers index by the match id, so it must be in range.
+        if (arg >= static_cast<uint32>(nmatch)) {
+          why = "bad match id";
+          goto Bad;
+        }
+        ip->match_id_ = arg;
+        break;
+      default:
+        break;
+    }
+  }
+
+  // The DFA states are checked when they are loaded.
+  for (int i = 0; i < 2; i++) {
+    uint32 n;
+    if (!GetWord(&d, &n) || n > d.size() / 4) {
+      why = "truncated";
+      goto Bad;
+    }
+    prog->dfa_states_[i].resize(n);
+    for (int j = 0; j < n; j++)
+      GetWord(&d, &prog->dfa_states_[i][j]);
+  }
+  if (!d.empty()) {
+    why = "trailing data";
+    goto Bad;
+  }
+  return prog;
+
+Bad:
+  if (error != NULL)
+    *error = StringPrintf("cannot deserialize Prog: %s", why);
+  delete prog;
+  return NULL;
+}
+
+}  // namespace re2
@@ -74,6 +74,17 @@ class Regexp;
 class DFA;
 struct OneState;
 
+// Where a DFA search over text that arrives in pieces has got to,
+// between calls to Prog::SearchDFAStream.  Only the DFA looks inside.
+struct DFAStreamState {
+  DFAStreamState() : prevbyte(-1), started(false), done(false), flag(0) {}
+  int prevbyte;      // byte before the next piece, or -1 for none
+  bool started;      // whether flag and inst hold a DFA state
+  bool done;         // whether there is nothing more to find
+  uint flag;         // the DFA state's flags
+  vector<int> inst;  // the DFA state's instructions
+};
+
 // Compiled form of regexp program.
 class Prog {
  public:
@@ -207,6 +218,39 @@ class Prog {
   const Bitmap<256>& byterange() { return byterange_; }
   void set_dfa_mem(int64 dfa_mem) { dfa_mem_ = dfa_mem; }
   int64 dfa_mem() { return dfa_mem_; }
+  // Splits each DFA into n caches, each with 1/n of its memory.
+  // Threads pick a cache by a per-thread number, so up to n threads
+  // searching at once never share a cache lock.
+  // Must be called before the first search.
+  void set_dfa_cache_shards(int n);
+  int dfa_cache_shards() { return dfa_cache_shards_; }
+
+  // Counts of what this Prog's DFAs have done, for RE2::GetDFAStats.
+  struct DFAStats {
+    DFAStats() : states(0), cache_resets(0), failures(0), bytes_used(0) {}
+    int64 states;        // States built
+    int64 cache_resets;  // times a DFA discarded its States for room
+    int64 failures;      // searches a DFA gave up on
+    int64 bytes_used;    // memory in use by the DFAs
+  };
+
+  // Adds the counts for this Prog's DFAs to *stats.
+  void AddDFAStats(DFAStats* stats);
+
+  // What a DFA event callback is told about.
+  enum DFAEvent {
+    kDFACacheReset,  // a DFA discarded its States for room
+    kDFAFailure,     // a DFA gave up on a search
+  };
+  typedef void (*DFAEventCallback)(void* arg, DFAEvent event);
+
+  // Sets a function to call, with arg, for each DFA event.  It is
+  // called in the thread that searched, once the search is over and
+  // the DFA's locks are released.  Must be called before the first search.
+  void set_dfa_event_callback(DFAEventCallback cb, void* arg) {
+    dfa_event_callback_ = cb;
+    dfa_event_arg_ = arg;
+  }
   int flags() { return flags_; }
   void set_flags(int flags) { flags_ = flags; }
   bool anchor_start() { return anchor_start_; }
@@ -216,6 +260,19 @@ class Prog {
   int bytemap_range() { return bytemap_range_; }
   const uint8* bytemap() { return bytemap_; }
 
+  // Records that every match of an unanchored search must begin
+  // with one of prefixes (at most 8 nonempty strings), so that
+  // the DFA can use PrefixAccel to skip over text in its start state.
+  void ConfigurePrefixAccel(const vector<string>& prefixes);
+  bool can_prefix_accel() { return !prefix_literals_.empty(); }
+
+  // Returns whether byte c is the first byte of one of the prefixes.
+  bool IsPrefixFirstByte(int c) { return prefix_first_[c] != 0; }
+
+  // Returns a pointer to the first position in data at which one of
+  // the prefixes occurs in full, or NULL if there is no such position.
+  const void* PrefixAccel(const void* data, size_t size);
+
   // Returns string representation of program for debugging.
   string Dump();
   string DumpUnanchored();
@@ -274,6 +331,60 @@ class Prog {
                  StringPiece* match0, bool* failed,
                  vector<int>* matches);
 
+  // Like calling SearchDFA(texts[i], contexts[i], anchor, kind, NULL, ...)
+  // for each i < n and setting matched[i] to the result, but decides how
+  // to search only once and takes the DFA's locks once per batch, which
+  // matters when the texts are short.  Returns the number of texts
+  // searched: fewer than n only if the DFA failed on the next one,
+  // which the caller must search some other way.
+  int SearchDFABatch(const StringPiece* texts, const StringPiece* contexts,
+                     int n, Anchor anchor, MatchKind kind, bool* matched);
+
+  // For a Prog made by CompileSet with match_ends: runs a kManyMatch
+  // DFA forward over text, recording in (*ends)[id] where a match of
+  // regexp id ends -- the earliest such place or, if longest, the
+  // latest.  ends must have an entry for every id, initially NULL;
+  // entries for regexps that do not match are left alone.
+  // Returns whether any regexp matched.  Sets *failed if the DFA
+  // runs out of memory.
+  bool SearchDFAMatchEnds(const StringPiece& text, Anchor anchor,
+                          bool longest, vector<const char*>* ends,
+                          bool* failed);
+
+  // Searches text as the next piece of a stream, resuming where the
+  // last call with *ss left off; at_end says that it is the last piece.
+  // Only the DFA state is kept between calls, so the memory used does
+  // not grow with the stream.  Because the DFA notices a match one
+  // byte late, a match ending at the end of a piece is found with the
+  // next one and reported as ending at its beginning.
+  // If ends == NULL, returns whether a match ends in this piece,
+  // stopping at the first and setting *ep to its end.  Otherwise the
+  // Prog must come from CompileSet with match_ends, and ends is filled
+  // in with the first end of each regexp, as by SearchDFAMatchEnds.
+  // Once nothing more can be found, sets ss->done.
+  bool SearchDFAStream(DFAStreamState* ss, const StringPiece& text,
+                       bool at_end, Anchor anchor, const char** ep,
+                       vector<const char*>* ends, bool* failed);
+
+  // Serialize appends to *out a description of the program, so that
+  // it can be compiled once, ahead of time, and loaded quickly later.
+  // If with_dfa, it also describes the DFA states built so far, so
+  // that the loaded program's DFAs start out with them.
+  void Serialize(bool with_dfa, string* out);
+
+  // Deserialize makes a Prog from the output of Serialize, which must
+  // have been written by the same version of this code.  Returns NULL,
+  // setting *error if error != NULL, if data is not such a description
+  // or if it has a match id that is not in [0, nmatch).  nmatch is 1
+  // for the Prog of a single regexp, and the number of regexps for
+  // the Prog of a set.  The memory for its DFAs is what the serialized
+  // Prog had, but no more than compiling with max_mem would leave them
+  // (if max_mem <= 0, the default of Regexp::CompileToProg).  The Prog
+  // does not refer to data once it is made, so data can be a mapped file
+  // that is unmapped afterward.
+  static Prog* Deserialize(const StringPiece& data, int nmatch,
+                           int64 max_mem, string* error);
+
   // Build the entire DFA for the given match kind.  FOR TESTING ONLY.
   // Usually the DFA is built out incrementally, as needed, which
   // avoids lots of unnecessary work.  This function is useful only
@@ -300,6 +411,14 @@ class Prog {
                       Anchor anchor, MatchKind kind,
                       StringPiece* match, int nmatch);
 
+  // Like SearchBitState, but if max_stack > 0, gives up, setting
+  // *failed to true, rather than let its job stack use more than
+  // about max_stack bytes.  The caller can then use the NFA.
+  bool SearchBitState(const StringPiece& text, const StringPiece& context,
+                      Anchor anchor, MatchKind kind,
+                      StringPiece* match, int nmatch,
+                      int64 max_stack, bool* failed);
+
   static const int kMaxOnePassCapture = 5;  // $0 through $4
 
   // Backtracking search: the gold standard against which the other
@@ -331,14 +450,27 @@ class Prog {
 
   // Compiles a collection of regexps to Prog.  Each regexp will have
   // its own Match instruction recording the index in the vector.
+  // Normally those are only reached at the end of the text, for
+  // SearchDFA with kManyMatch.  If match_ends is set, each is reached
+  // where a match of its regexp ends, for SearchDFAMatchEnds.
   static Prog* CompileSet(const RE2::Options& options, RE2::Anchor anchor,
-                          Regexp* re);
+                          Regexp* re, bool match_ends);
 
  private:
   friend class Compiler;
 
   DFA* GetDFA(MatchKind kind);
 
+  // Saves the states of dfa[0], the first shard of dfa_first_ or
+  // dfa_longest_, for Serialize, appending them to *v.
+  // Saves nothing if there is no such DFA yet.
+  void SaveDFAStates(DFA* volatile* dfa, vector<uint32>* v);
+
+  // Counts a DFA search that failed and tells the DFA event callback
+  // about it and about any cache resets it did, found by comparing
+  // resets with the calling thread's count of resets.
+  void NoteDFASearch(int64 resets, bool failed);
+
   bool anchor_start_;       // regexp has explicit start anchor
   bool anchor_end_;         // regexp has explicit end anchor
   bool reversed_;           // whether program runs backward over input
@@ -355,10 +487,14 @@ class Prog {
   Inst* inst_;              // pointer to instruction array
 
   Mutex dfa_mutex_;    // Protects dfa_first_, dfa_longest_
-  DFA* volatile dfa_first_;     // DFA cached for kFirstMatch
-  DFA* volatile dfa_longest_;   // DFA cached for kLongestMatch and kFullMatch
+  int dfa_cache_shards_;         // Number of DFAs of each kind.
+  DFA* volatile* dfa_first_;     // DFAs cached for kFirstMatch
+  DFA* volatile* dfa_longest_;   // DFAs cached for kLongestMatch and kFullMatch
   int64 dfa_mem_;      // Maximum memory for DFAs.
   void (*delete_dfa_)(DFA* dfa);
+  int64 dfa_failures_;  // DFA searches that failed, protected by dfa_mutex_
+  DFAEventCallback dfa_event_callback_;
+  void* dfa_event_arg_;
 
   Bitmap<256> byterange_;    // byterange.Get(x) true if x ends a
                              // commonly-treated byte range.
@@ -368,6 +504,16 @@ class Prog {
   uint8* onepass_nodes_;     // data for OnePass nodes
   OneState* onepass_start_;  // start node for OnePass program
 
+  vector<string> prefix_literals_;  // required prefixes, if any
+  uint8 prefix_first_[256];         // bit i set: byte begins prefix i
+  int prefix_fingerprint_len_;      // bytes compared by the SIMD scan
+  uint8 prefix_lo_[3][16];          // prefixes by low nibble of byte j
+  uint8 prefix_hi_[3][16];          // prefixes by high nibble of byte j
+
+  vector<uint32> dfa_states_[2];    // DFA states from Deserialize, to
+                                    // load into new DFAs: [0] for
+                                    // dfa_first_, [1] for dfa_longest_
+
   DISALLOW_EVIL_CONSTRUCTORS(Prog);
 };
 
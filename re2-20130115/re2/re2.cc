@@ -48,7 +48,8 @@ RE2::Options::Options(RE2::CannedOptions opt)
     case_sensitive_(true),
     perl_classes_(false),
     word_boundary_(false),
-    one_line_(false) {
+    one_line_(false),
+    dfa_cache_shards_(1) {
 }
 
 // static empty things for use as const references.
@@ -180,6 +181,7 @@ void RE2::Init(const StringPiece& pattern, const Options& options) {
   entire_regexp_ = NULL;
   prog_ = NULL;
   rprog_ = NULL;
+  dfa_event_hook_ = NULL;
   named_groups_ = NULL;
   group_names_ = NULL;
   num_captures_ = -1;
@@ -220,6 +222,7 @@ void RE2::Init(const StringPiece& pattern, const Options& options) {
     error_code_ = RE2::ErrorPatternTooLarge;
     return;
   }
+  prog_->set_dfa_cache_shards(options_.dfa_cache_shards());
 
   // Could delay this until the first match call that
   // cares about submatch information, but the one-pass
@@ -229,6 +232,19 @@ void RE2::Init(const StringPiece& pattern, const Options& options) {
   is_one_pass_ = prog_->IsOnePass();
 }
 
+struct RE2::DFAEventHook {
+  const RE2* re;
+  DFAEventCallback cb;
+  void* arg;
+
+  // The Prog::DFAEventCallback, with hook as arg.
+  static void Report(void* hook, Prog::DFAEvent event) {
+    DFAEventHook* h = static_cast<DFAEventHook*>(hook);
+    h->cb(*h->re, event == Prog::kDFAFailure ? DFAFailure : DFACacheReset,
+          h->arg);
+  }
+};
+
 // Returns rprog_, computing it if needed.
 re2::Prog* RE2::ReverseProg() const {
   MutexLock l(mutex_);
@@ -241,6 +257,9 @@ re2::Prog* RE2::ReverseProg() const {
       error_code_ = RE2::ErrorPatternTooLarge;
       return NULL;
     }
+    rprog_->set_dfa_cache_shards(options_.dfa_cache_shards());
+    if (dfa_event_hook_ != NULL)
+      rprog_->set_dfa_event_callback(DFAEventHook::Report, dfa_event_hook_);
   }
   return rprog_;
 }
@@ -253,6 +272,7 @@ RE2::~RE2() {
   delete mutex_;
   delete prog_;
   delete rprog_;
+  delete dfa_event_hook_;
   if (error_ != empty_string)
     delete error_;
   if (named_groups_ != NULL && named_groups_ != empty_named_groups)
@@ -261,6 +281,39 @@ RE2::~RE2() {
     delete group_names_;
 }
 
+void RE2::GetDFAStats(DFAStats* stats) const {
+  Prog::DFAStats s;
+  if (prog_ != NULL)
+    prog_->AddDFAStats(&s);
+  {
+    MutexLock l(mutex_);
+    if (rprog_ != NULL)
+      rprog_->AddDFAStats(&s);
+  }
+  stats->states = s.states;
+  stats->cache_resets = s.cache_resets;
+  stats->failures = s.failures;
+  stats->bytes_used = s.bytes_used;
+}
+
+void RE2::SetDFAEventCallback(DFAEventCallback cb, void* arg) {
+  MutexLock l(mutex_);
+  DFAEventHook* hook = NULL;
+  if (cb != NULL) {
+    hook = new DFAEventHook;
+    hook->re = this;
+    hook->cb = cb;
+    hook->arg = arg;
+  }
+  Prog::DFAEventCallback report = hook != NULL ? DFAEventHook::Report : NULL;
+  if (prog_ != NULL)
+    prog_->set_dfa_event_callback(report, hook);
+  if (rprog_ != NULL)
+    rprog_->set_dfa_event_callback(report, hook);
+  delete dfa_event_hook_;
+  dfa_event_hook_ = hook;
+}
+
 int RE2::ProgramSize() const {
   if (prog_ == NULL)
     return -1;
@@ -346,19 +399,82 @@ int RE2::MaxSubmatch(const StringPiece& rewrite) {
   return max;
 }
 
+// A rewrite string broken up, once, into what Replace, GlobalReplace
+// and Extract copy for each match: pieces of literal text,
+// each followed by a submatch (\N), if any.
+struct RewritePiece {
+  StringPiece literal;  // text to copy
+  int group;            // then submatch to copy, or -1 for none
+};
+
+// Parses rewrite into *pieces and sets *nvec to the number of
+// submatches the pieces need.  Returns false if rewrite has an
+// invalid escape, logging it if log_errors.
+static bool ParseRewrite(const StringPiece& rewrite, bool log_errors,
+                         vector<RewritePiece>* pieces, int* nvec) {
+  pieces->clear();
+  *nvec = 1;
+  const char* lit = rewrite.data();
+  const char* end = lit + rewrite.size();
+  for (const char* s = lit; s < end; s++) {
+    if (*s != '\\')
+      continue;
+    RewritePiece piece;
+    piece.literal = StringPiece(lit, s - lit);
+    piece.group = -1;
+    s++;
+    int c = (s < end) ? *s : -1;
+    if (isdigit(c)) {
+      piece.group = c - '0';
+      if (piece.group + 1 > *nvec)
+        *nvec = piece.group + 1;
+      lit = s + 1;
+    } else if (c == '\\') {
+      // Keep the second backslash as the start of the next literal.
+      lit = s;
+    } else {
+      if (log_errors)
+        LOG(ERROR) << "invalid rewrite pattern: " << rewrite.data();
+      return false;
+    }
+    pieces->push_back(piece);
+  }
+  if (lit < end) {
+    RewritePiece piece;
+    piece.literal = StringPiece(lit, end - lit);
+    piece.group = -1;
+    pieces->push_back(piece);
+  }
+  return true;
+}
+
+// Appends the rewrite parsed into pieces, with submatches from vec,
+// to *out.
+static void ApplyRewrite(const vector<RewritePiece>& pieces,
+                         const StringPiece* vec, string* out) {
+  for (int i = 0; i < pieces.size(); i++) {
+    const RewritePiece& piece = pieces[i];
+    out->append(piece.literal.data(), piece.literal.size());
+    if (piece.group >= 0)
+      out->append(vec[piece.group].data(), vec[piece.group].size());
+  }
+}
+
 bool RE2::Replace(string *str,
                  const RE2& re,
                  const StringPiece& rewrite) {
   StringPiece vec[kVecSize];
-  int nvec = 1 + MaxSubmatch(rewrite);
+  vector<RewritePiece> pieces;
+  int nvec;
+  if (!ParseRewrite(rewrite, re.options().log_errors(), &pieces, &nvec))
+    return false;
   if (nvec > arraysize(vec))
     return false;
   if (!re.Match(*str, 0, str->size(), UNANCHORED, vec, nvec))
     return false;
 
   string s;
-  if (!re.Rewrite(&s, rewrite, vec, nvec))
-    return false;
+  ApplyRewrite(pieces, vec, &s);
 
   assert(vec[0].begin() >= str->data());
   assert(vec[0].end() <= str->data()+str->size());
@@ -366,32 +482,39 @@ bool RE2::Replace(string *str,
   return true;
 }
 
-int RE2::GlobalReplace(string *str,
-                      const RE2& re,
-                      const StringPiece& rewrite) {
+// Appends text, with the non-overlapping matches of re replaced by
+// the rewrite parsed into pieces, to *out.  Returns the number of
+// replacements; if that is 0, *out is left alone, since the in-place
+// GlobalReplace would only throw the copy away.
+static int GlobalReplaceMatches(const StringPiece& text,
+                                const RE2& re,
+                                const vector<RewritePiece>& pieces,
+                                int nvec,
+                                string* out) {
   StringPiece vec[kVecSize];
-  int nvec = 1 + MaxSubmatch(rewrite);
-  if (nvec > arraysize(vec))
-    return false;
-
-  const char* p = str->data();
-  const char* ep = p + str->size();
+  const char* p = text.data();
+  const char* ep = p + text.size();
   const char* lastend = NULL;
-  string out;
   int count = 0;
   while (p <= ep) {
-    if (!re.Match(*str, p - str->data(), str->size(), UNANCHORED, vec, nvec))
+    if (!re.Match(text, p - text.data(), text.size(),
+                  RE2::UNANCHORED, vec, nvec))
       break;
+    if (lastend == NULL) {
+      // The result is usually about as long as text.  Don't reserve it
+      // before there is a match, since then nothing is replaced.
+      out->reserve(out->size() + text.size());
+    }
     if (p < vec[0].begin())
-      out.append(p, vec[0].begin() - p);
+      out->append(p, vec[0].begin() - p);
     if (vec[0].begin() == lastend && vec[0].size() == 0) {
       // Disallow empty match at end of last match: skip ahead.
       if (p < ep)
-        out.append(p, 1);
+        out->append(p, 1);
       p++;
       continue;
     }
-    re.Rewrite(&out, rewrite, vec, nvec);
+    ApplyRewrite(pieces, vec, out);
     p = vec[0].end();
     lastend = p;
     count++;
@@ -399,19 +522,55 @@ int RE2::GlobalReplace(string *str,
 
   if (count == 0)
     return 0;
-
   if (p < ep)
-    out.append(p, ep - p);
+    out->append(p, ep - p);
+  return count;
+}
+
+int RE2::GlobalReplace(string *str,
+                      const RE2& re,
+                      const StringPiece& rewrite) {
+  vector<RewritePiece> pieces;
+  int nvec;
+  if (!ParseRewrite(rewrite, re.options().log_errors(), &pieces, &nvec))
+    return 0;
+  if (nvec > kVecSize)
+    return 0;
+
+  string out;
+  int count = GlobalReplaceMatches(*str, re, pieces, nvec, &out);
+  if (count == 0)
+    return 0;
   swap(out, *str);
   return count;
 }
 
+int RE2::GlobalReplace(const StringPiece& text,
+                       const RE2& re,
+                       const StringPiece& rewrite,
+                       string* out) {
+  vector<RewritePiece> pieces;
+  int nvec;
+  if (!ParseRewrite(rewrite, re.options().log_errors(), &pieces, &nvec))
+    return -1;
+  if (nvec > kVecSize)
+    return -1;
+
+  int count = GlobalReplaceMatches(text, re, pieces, nvec, out);
+  if (count == 0)
+    out->append(text.data(), text.size());
+  return count;
+}
+
 bool RE2::Extract(const StringPiece &text,
                  const RE2& re,
                  const StringPiece &rewrite,
                  string *out) {
   StringPiece vec[kVecSize];
-  int nvec = 1 + MaxSubmatch(rewrite);
+  vector<RewritePiece> pieces;
+  int nvec;
+  if (!ParseRewrite(rewrite, re.options().log_errors(), &pieces, &nvec))
+    return false;
   if (nvec > arraysize(vec))
     return false;
 
@@ -419,7 +578,8 @@ bool RE2::Extract(const StringPiece &text,
     return false;
 
   out->clear();
-  return re.Rewrite(out, rewrite, vec, nvec);
+  ApplyRewrite(pieces, vec, out);
+  return true;
 }
 
 string RE2::QuoteMeta(const StringPiece& unquoted) {
@@ -606,6 +766,13 @@ bool RE2::Match(const StringPiece& text,
   const int MaxBitStateVector = 256*1024;  // bit vector size <= Max (bits)
   bool can_bit_state = prog_->size() <= MaxBitStateProg;
   int bit_state_text_max = MaxBitStateVector / prog_->size();
+  // Once the DFA has found the match, SearchBitState only has to run
+  // over the match itself, anchored at both ends, so it is allowed
+  // a bigger bit vector: up to max_mem/8 bytes.  Its job stack may use
+  // up to max_mem/4 bytes; past that, as on (a|aa)* where it holds
+  // about a job per byte, SearchBitState gives up and the NFA runs.
+  int64 bit_state_match_max = options_.max_mem() / prog_->size();
+  int64 bit_state_max_stack = options_.max_mem() / 4;
 
   bool dfa_failed = false;
   switch (re_anchor) {
@@ -744,26 +911,40 @@ bool RE2::Match(const StringPiece& text,
           LOG(ERROR) << "SearchOnePass inconsistency";
         return false;
       }
-    } else if (can_bit_state && subtext1.size() <= bit_state_text_max) {
-      if (FLAGS_trace_re2)
-        LOG(INFO) << "Match " << trunc(pattern_)
-                  << " [" << CEscape(subtext) << "]"
-                  << " using BitState.";
-      if (!prog_->SearchBitState(subtext1, text, anchor,
-                                 kind, submatch, ncap)) {
-        if (!skipped_test && options_.log_errors())
-          LOG(ERROR) << "SearchBitState inconsistency";
-        return false;
-      }
     } else {
-      if (FLAGS_trace_re2)
-        LOG(INFO) << "Match " << trunc(pattern_)
-                  << " [" << CEscape(subtext) << "]"
-                  << " using NFA.";
-      if (!prog_->SearchNFA(subtext1, text, anchor, kind, submatch, ncap)) {
-        if (!skipped_test && options_.log_errors())
-          LOG(ERROR) << "SearchNFA inconsistency";
-        return false;
+      bool use_nfa = true;
+      if (can_bit_state &&
+          subtext1.size() <= (skipped_test ? bit_state_text_max
+                                           : bit_state_match_max)) {
+        if (FLAGS_trace_re2)
+          LOG(INFO) << "Match " << trunc(pattern_)
+                    << " [" << CEscape(subtext) << "]"
+                    << " using BitState.";
+        bool bit_state_failed = false;
+        if (prog_->SearchBitState(subtext1, text, anchor, kind,
+                                  submatch, ncap, bit_state_max_stack,
+                                  &bit_state_failed)) {
+          use_nfa = false;
+        } else if (!bit_state_failed) {
+          if (!skipped_test && options_.log_errors())
+            LOG(ERROR) << "SearchBitState inconsistency";
+          return false;
+        } else if (FLAGS_trace_re2) {
+          LOG(INFO) << "Match " << trunc(pattern_)
+                    << " [" << CEscape(subtext) << "]"
+                    << " BitState gave up.";
+        }
+      }
+      if (use_nfa) {
+        if (FLAGS_trace_re2)
+          LOG(INFO) << "Match " << trunc(pattern_)
+                    << " [" << CEscape(subtext) << "]"
+                    << " using NFA.";
+        if (!prog_->SearchNFA(subtext1, text, anchor, kind, submatch, ncap)) {
+          if (!skipped_test && options_.log_errors())
+            LOG(ERROR) << "SearchNFA inconsistency";
+          return false;
+        }
       }
     }
   }
@@ -779,6 +960,101 @@ bool RE2::Match(const StringPiece& text,
   return true;
 }
 
+// Number of texts MatchBatch hands to the DFA at a time.
+// The DFA holds its cache lock across each group, so this
+// bounds how long other threads' cache resets can be held up.
+static const int kMatchBatchSize = 64;
+
+int RE2::MatchBatch(const StringPiece* texts,
+                    int n,
+                    Anchor re_anchor,
+                    bool* matched) const {
+  if (n <= 0)
+    return 0;
+
+  if (!ok() || suffix_regexp_ == NULL) {
+    if (options_.log_errors())
+      LOG(ERROR) << "Invalid RE2: " << *error_;
+    for (int i = 0; i < n; i++)
+      matched[i] = false;
+    return 0;
+  }
+
+  // Make the choices Match makes with startpos == 0 and nsubmatch == 0,
+  // once for the whole batch.
+  Anchor batch_anchor = re_anchor;
+  if (prog_->anchor_start() && prog_->anchor_end())
+    batch_anchor = ANCHOR_BOTH;
+  else if (prog_->anchor_start() && batch_anchor != ANCHOR_BOTH)
+    batch_anchor = ANCHOR_START;
+  if (!prefix_.empty() && batch_anchor != ANCHOR_BOTH)
+    batch_anchor = ANCHOR_START;
+
+  Prog::Anchor anchor = Prog::kUnanchored;
+  Prog::MatchKind kind = Prog::kFirstMatch;
+  if (options_.longest_match())
+    kind = Prog::kLongestMatch;
+  if (batch_anchor != UNANCHORED)
+    anchor = Prog::kAnchored;
+  if (batch_anchor == ANCHOR_BOTH)
+    kind = Prog::kFullMatch;
+
+  int prefixlen = prefix_.size();
+  int nmatched = 0;
+  StringPiece subtexts[kMatchBatchSize];
+  StringPiece contexts[kMatchBatchSize];
+  bool submatched[kMatchBatchSize];
+  int index[kMatchBatchSize];
+  for (int i = 0; i < n; ) {
+    // Gather a group of texts that have the required prefix, if any.
+    int k = 0;
+    for (; i < n && k < kMatchBatchSize; i++) {
+      matched[i] = false;
+      StringPiece subtext = texts[i];
+      if (prefixlen > 0) {
+        if (prefixlen > subtext.size())
+          continue;
+        if (prefix_foldcase_) {
+          if (ascii_strcasecmp(&prefix_[0], subtext.data(), prefixlen) != 0)
+            continue;
+        } else {
+          if (memcmp(&prefix_[0], subtext.data(), prefixlen) != 0)
+            continue;
+        }
+        subtext.remove_prefix(prefixlen);
+      }
+      subtexts[k] = subtext;
+      contexts[k] = texts[i];
+      index[k] = i;
+      k++;
+    }
+
+    int done = 0;
+    while (done < k) {
+      done += prog_->SearchDFABatch(subtexts + done, contexts + done,
+                                    k - done, anchor, kind,
+                                    submatched + done);
+      if (done < k) {
+        // The DFA failed: let Match fall back to the NFA for this text.
+        if (FLAGS_trace_re2)
+          LOG(INFO) << "MatchBatch " << trunc(pattern_)
+                    << " [" << CEscape(contexts[done]) << "]"
+                    << " DFA failed.";
+        submatched[done] = Match(contexts[done], 0, contexts[done].size(),
+                                 re_anchor, NULL, 0);
+        done++;
+      }
+    }
+    for (int j = 0; j < k; j++) {
+      if (submatched[j]) {
+        matched[index[j]] = true;
+        nmatched++;
+      }
+    }
+  }
+  return nmatched;
+}
+
 // Internal matcher - like Match() but takes Args not StringPieces.
 bool RE2::DoMatch(const StringPiece& text,
                   Anchor anchor,
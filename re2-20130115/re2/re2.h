@@ -221,6 +221,9 @@ class RE2 {
   // Defined in set.h.
   class Set;
 
+  // Defined in stream.h.
+  class Stream;
+
   enum ErrorCode {
     NoError = 0,
 
@@ -290,6 +293,39 @@ class RE2 {
   // Larger numbers are more expensive than smaller numbers.
   int ProgramSize() const;
 
+  // Counts of what the DFAs that do most of this RE2's searching have
+  // done.  A DFA builds its states as it needs them, within the memory
+  // budget set by max_mem.  When the budget is used up, it discards
+  // its states and starts over (a cache reset); if that happens too
+  // often, or there is too little memory to start at all, it gives up
+  // on the search (a failure), and RE2 falls back to a much slower
+  // matcher.  Either shows up only as searches that take 10-100x longer,
+  // so these counts are the way to find the RE2s that need more max_mem
+  // or a simpler pattern.
+  struct DFAStats {
+    int64_t states;        // states built
+    int64_t cache_resets;  // times a DFA discarded its states
+    int64_t failures;      // searches a DFA gave up on
+    int64_t bytes_used;    // memory the DFAs are using now
+  };
+
+  // Fills in *stats with the counts so far.
+  void GetDFAStats(DFAStats* stats) const;
+
+  // The events reported to a DFAEventCallback.
+  enum DFAEvent {
+    DFACacheReset,  // a DFA discarded its states
+    DFAFailure,     // a DFA gave up on a search
+  };
+  typedef void (*DFAEventCallback)(const RE2& re, DFAEvent event, void* arg);
+
+  // Sets a function to call, with arg, on each cache reset and failure,
+  // or none if cb is NULL.  It is called in the thread that searched,
+  // once the search is over, so it may use the RE2, but it must be
+  // thread-safe if the RE2 is.  Must be called before the RE2 is used
+  // from other threads.
+  void SetDFAEventCallback(DFAEventCallback cb, void* arg);
+
   // Returns the underlying Regexp; not for general use.
   // Returns entire_regexp_ so that callers don't need
   // to know about prefix_ and prefix_foldcase_.
@@ -388,6 +424,18 @@ class RE2 {
                            const RE2& pattern,
                            const StringPiece& rewrite);
 
+  // Like GlobalReplace, but reads "text" and appends the result to
+  // "out" -- "text" itself if there are no matches -- so that a caller
+  // can reuse one buffer for many texts.  "text" must not point into
+  // "out".
+  //
+  // Returns the number of replacements made, or -1 (leaving "out"
+  // unchanged) if "rewrite" is not valid.
+  static int GlobalReplace(const StringPiece& text,
+                           const RE2& pattern,
+                           const StringPiece& rewrite,
+                           string* out);
+
   // Like Replace, except that if the pattern matches, "rewrite"
   // is copied into "out" with substitutions.  The non-matching
   // portions of "text" are ignored.
@@ -476,6 +524,21 @@ class RE2 {
              StringPiece *match,
              int nmatch) const;
 
+  // Matches each of texts[0], ..., texts[n-1] against the regexp, as
+  // Match(texts[i], 0, texts[i].size(), anchor, NULL, 0) would, and sets
+  // matched[i] to the result.  Returns the number of texts that matched.
+  // For many short texts -- log lines, keys, tokens -- this is much
+  // faster than calling Match (or PartialMatch) for each one: the
+  // checks and choices Match makes on every call are made once, and
+  // the DFA's lock is taken once per group of texts.
+  // MatchBatch runs in the calling thread.  To spread a large batch
+  // over a thread pool, call it on a piece of the batch from each
+  // thread; the RE2 can be shared.
+  int MatchBatch(const StringPiece* texts,
+                 int n,
+                 Anchor anchor,
+                 bool* matched) const;
+
   // Check that the given rewrite string is suitable for use with this
   // regular expression.  It checks that:
   //   * The regular expression has enough parenthesized subexpressions
@@ -523,6 +586,8 @@ class RE2 {
     //   word_boundary    (false) allow Perl's \b \B (word boundary and not)
     //   one_line         (false) ^ and $ only match beginning and end of text
     //
+    //   dfa_cache_shards (1)     number of DFA state caches (see below)
+    //
     // The max_mem option controls how much memory can be used
     // to hold the compiled form of the regexp (the Prog) and
     // its cached DFA graphs.  Code Search placed limits on the number
@@ -550,6 +615,16 @@ class RE2 {
     //
     // Once a DFA fills its budget, it flushes its cache and starts over.
     // If this happens too often, RE2 falls back on the NFA implementation.
+    //
+    // Every search takes a reader lock on its DFA's cache, and a flush
+    // takes the writer lock, so many threads sharing one RE2 contend
+    // on it.  Setting dfa_cache_shards to N > 1 gives each of those
+    // DFAs N independent caches, each with 1/N of its budget.  A thread
+    // always uses the same cache, and threads are handed caches in
+    // turn, so up to N threads never share one.  Each cache costs a
+    // fixed overhead proportional to the Prog size on top of its
+    // states, so raise max_mem along with dfa_cache_shards or the
+    // caches may be too small to use, and RE2 will fall back on the NFA.
 
     // For now, make the default budget something close to Code Search.
     static const int kDefaultMaxMem = 8<<20;
@@ -571,7 +646,8 @@ class RE2 {
       case_sensitive_(true),
       perl_classes_(false),
       word_boundary_(false),
-      one_line_(false) {
+      one_line_(false),
+      dfa_cache_shards_(1) {
     }
     
     /*implicit*/ Options(CannedOptions);
@@ -623,6 +699,9 @@ class RE2 {
     bool one_line() const { return one_line_; }
     void set_one_line(bool b) { one_line_ = b; }
 
+    int dfa_cache_shards() const { return dfa_cache_shards_; }
+    void set_dfa_cache_shards(int n) { dfa_cache_shards_ = n; }
+
     void Copy(const Options& src) {
       encoding_ = src.encoding_;
       posix_syntax_ = src.posix_syntax_;
@@ -636,6 +715,7 @@ class RE2 {
       perl_classes_ = src.perl_classes_;
       word_boundary_ = src.word_boundary_;
       one_line_ = src.one_line_;
+      dfa_cache_shards_ = src.dfa_cache_shards_;
     }
 
     int ParseFlags() const;
@@ -653,6 +733,7 @@ class RE2 {
     bool perl_classes_;
     bool word_boundary_;
     bool one_line_;
+    int dfa_cache_shards_;
 
     //DISALLOW_EVIL_CONSTRUCTORS(Options);
     Options(const Options&);
@@ -701,6 +782,9 @@ class RE2 {
 
   re2::Prog* ReverseProg() const;
 
+  // Passes the Progs' DFA events on, for SetDFAEventCallback.
+  struct DFAEventHook;
+
   mutable Mutex*           mutex_;
   string                   pattern_;       // string regular expression
   Options                  options_;       // option flags
@@ -710,6 +794,7 @@ class RE2 {
   re2::Regexp*  suffix_regexp_;    // parsed regular expression, prefix removed
   re2::Prog*    prog_;             // compiled program for regexp
   mutable re2::Prog* rprog_;       // reverse program for regexp
+  DFAEventHook* dfa_event_hook_;   // DFA event callback, or NULL
   bool                     is_one_pass_;   // can use prog_->SearchOnePass?
   mutable const string*    error_;         // Error indicator
                                            // (or points to empty string)
@@ -17,12 +17,61 @@ RE2::Set::Set(const RE2::Options& options, RE2::Anchor anchor) {
   anchor_ = anchor;
   prog_ = NULL;
   compiled_ = false;
+  mutex_ = new Mutex;
+  ends_prog_ = NULL;
+  ends_prog_failed_ = false;
 }
 
 RE2::Set::~Set() {
   for (int i = 0; i < re_.size(); i++)
     re_[i]->Decref();
+  for (int i = 0; i < rprog_.size(); i++)
+    delete rprog_[i];
   delete prog_;
+  delete ends_prog_;
+  delete mutex_;
+}
+
+// Concatenates re with a HaveMatch for index n.  Consumes re.
+static re2::Regexp* WithMatchId(re2::Regexp* re, int n,
+                                Regexp::ParseFlags pf) {
+  re2::Regexp* m = re2::Regexp::HaveMatch(n, pf);
+  if (re->op() == kRegexpConcat) {
+    int nsub = re->nsub();
+    re2::Regexp** sub = new re2::Regexp*[nsub + 1];
+    for (int i = 0; i < nsub; i++)
+      sub[i] = re->sub()[i]->Incref();
+    sub[nsub] = m;
+    re->Decref();
+    re = re2::Regexp::Concat(sub, nsub + 1, pf);
+    delete[] sub;
+  } else {
+    re2::Regexp* sub[2];
+    sub[0] = re;
+    sub[1] = m;
+    re = re2::Regexp::Concat(sub, 2, pf);
+  }
+  return re;
+}
+
+// Compiles the alternation of the regexps in re into a Set program.
+// Consumes the regexps.
+static Prog* CompileAlternation(const RE2::Options& options,
+                                RE2::Anchor anchor,
+                                vector<re2::Regexp*>* re,
+                                bool match_ends) {
+  Regexp::ParseFlags pf = static_cast<Regexp::ParseFlags>(
+    options.ParseFlags());
+  re2::Regexp* alt = re2::Regexp::Alternate(&(*re)[0], re->size(), pf);
+  re->clear();
+  re2::Regexp* sre = alt->Simplify();
+  alt->Decref();
+  if (sre == NULL) {
+    if (options.log_errors())
+      LOG(ERROR) << "Error simplifying during Compile.";
+    return NULL;
+  }
+  return Prog::CompileSet(options, anchor, sre, match_ends);
 }
 
 int RE2::Set::Add(const StringPiece& pattern, string* error) {
@@ -45,24 +94,12 @@ int RE2::Set::Add(const StringPiece& pattern, string* error) {
   }
 
   // Concatenate with match index and push on vector.
+  // The pattern is kept too: the programs for match positions must
+  // parse it again, because Compile's Alternate takes the regexps
+  // apart as it factors out common prefixes.
   int n = re_.size();
-  re2::Regexp* m = re2::Regexp::HaveMatch(n, pf);
-  if (re->op() == kRegexpConcat) {
-    int nsub = re->nsub();
-    re2::Regexp** sub = new re2::Regexp*[nsub + 1];
-    for (int i = 0; i < nsub; i++)
-      sub[i] = re->sub()[i]->Incref();
-    sub[nsub] = m;
-    re->Decref();
-    re = re2::Regexp::Concat(sub, nsub + 1, pf);
-    delete[] sub;
-  } else {
-    re2::Regexp* sub[2];
-    sub[0] = re;
-    sub[1] = m;
-    re = re2::Regexp::Concat(sub, 2, pf);
-  }
-  re_.push_back(re);
+  re_.push_back(WithMatchId(re, n, pf));
+  pattern_.push_back(pattern.as_string());
   return n;
 }
 
@@ -72,23 +109,232 @@ bool RE2::Set::Compile() {
     return false;
   }
   compiled_ = true;
+  rprog_.resize(pattern_.size());
 
-  Regexp::ParseFlags pf = static_cast<Regexp::ParseFlags>(
-    options_.ParseFlags());
-  re2::Regexp* re = re2::Regexp::Alternate(const_cast<re2::Regexp**>(&re_[0]),
-                                           re_.size(), pf);
-  re_.clear();
-  re2::Regexp* sre = re->Simplify();
-  re->Decref();
-  re = sre;
-  if (re == NULL) {
-    if (options_.log_errors())
-      LOG(ERROR) << "Error simplifying during Compile.";
+  prog_ = CompileAlternation(options_, anchor_, &re_, false);
+  return prog_ != NULL;
+}
+
+// Returns ends_prog_, computing it if needed.
+// It gets 2/3 of the memory budget, like an RE2's forward prog;
+// the reverse progs get the rest.
+re2::Prog* RE2::Set::MatchEndsProg() const {
+  MutexLock l(mutex_);
+  if (ends_prog_ == NULL && !ends_prog_failed_) {
+    Regexp::ParseFlags pf = static_cast<Regexp::ParseFlags>(
+      options_.ParseFlags());
+    vector<re2::Regexp*> re;
+    for (int i = 0; i < pattern_.size(); i++) {
+      re2::Regexp* sub = Regexp::Parse(pattern_[i], pf, NULL);
+      if (sub == NULL)
+        break;
+      re.push_back(WithMatchId(sub, i, pf));
+    }
+    RE2::Options options;
+    options.Copy(options_);
+    options.set_max_mem(options_.max_mem()/3*2);
+    if (re.size() == pattern_.size()) {
+      ends_prog_ = CompileAlternation(options, anchor_, &re, true);
+    } else {
+      for (int i = 0; i < re.size(); i++)
+        re[i]->Decref();
+    }
+    if (ends_prog_ == NULL) {
+      if (options_.log_errors())
+        LOG(ERROR) << "Error compiling RE2::Set for match positions";
+      ends_prog_failed_ = true;
+    }
+  }
+  return ends_prog_;
+}
+
+// Returns rprog_[i], computing it if needed.
+re2::Prog* RE2::Set::ReverseProg(int i) const {
+  MutexLock l(mutex_);
+  if (rprog_[i] == NULL) {
+    Regexp::ParseFlags pf = static_cast<Regexp::ParseFlags>(
+      options_.ParseFlags());
+    re2::Regexp* re = Regexp::Parse(pattern_[i], pf, NULL);
+    if (re != NULL) {
+      rprog_[i] = re->CompileToReverseProg(options_.max_mem()/3);
+      re->Decref();
+    }
+    if (rprog_[i] == NULL) {
+      if (options_.log_errors())
+        LOG(ERROR) << "Error reverse compiling RE2::Set regexp " << i;
+      return NULL;
+    }
+    rprog_[i]->set_dfa_cache_shards(options_.dfa_cache_shards());
+  }
+  return rprog_[i];
+}
+
+// A serialized Set is a sequence of little-endian 32-bit words,
+// with the pattern and program bytes in between:
+//   kSetMagic, kSetVersion, anchor, parse flags, max_mem,
+//   number of patterns, then each pattern's length and bytes,
+//   length and bytes of the serialized prog_,
+//   length and bytes of the serialized ends_prog_ (0 if not built).
+// The Prog serialization has its own version check.
+
+static const uint32 kSetMagic = 0x53324552;  // "RE2S"
+static const uint32 kSetVersion = 1;
+
+// Little-endian words, as in the Prog serialization.
+static void PutWord(string* out, uint32 w) {
+  char buf[4];
+  buf[0] = w & 0xFF;
+  buf[1] = (w >> 8) & 0xFF;
+  buf[2] = (w >> 16) & 0xFF;
+  buf[3] = (w >> 24) & 0xFF;
+  out->append(buf, 4);
+}
+
+static bool GetWord(StringPiece* data, uint32* w) {
+  if (data->size() < 4)
+    return false;
+  const uint8* p = reinterpret_cast<const uint8*>(data->data());
+  *w = p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32>(p[3]) << 24);
+  data->remove_prefix(4);
+  return true;
+}
+
+// Reads a length and that many bytes from the front of *data.
+static bool GetBytes(StringPiece* data, StringPiece* bytes) {
+  uint32 n;
+  if (!GetWord(data, &n) || n > data->size())
+    return false;
+  bytes->set(data->data(), n);
+  data->remove_prefix(n);
+  return true;
+}
+
+bool RE2::Set::Serialize(string* out) const {
+  if (!compiled_ || prog_ == NULL) {
+    LOG(DFATAL) << "RE2::Set::Serialize without Compile";
     return false;
   }
+  PutWord(out, kSetMagic);
+  PutWord(out, kSetVersion);
+  PutWord(out, anchor_);
+  PutWord(out, options_.ParseFlags());
+  PutWord(out, options_.max_mem());
+  PutWord(out, pattern_.size());
+  for (int i = 0; i < pattern_.size(); i++) {
+    PutWord(out, pattern_[i].size());
+    out->append(pattern_[i]);
+  }
 
-  prog_ = Prog::CompileSet(options_, anchor_, re);
-  return prog_ != NULL;
+  // The length of each Prog goes in front of it.
+  re2::Prog* prog[2];
+  prog[0] = prog_;
+  {
+    MutexLock l(mutex_);
+    prog[1] = ends_prog_;
+  }
+  for (int i = 0; i < 2; i++) {
+    int n = out->size();
+    PutWord(out, 0);
+    if (prog[i] == NULL)
+      continue;
+    prog[i]->Serialize(true, out);
+    uint32 len = out->size() - n - 4;
+    string w;
+    PutWord(&w, len);
+    out->replace(n, 4, w);
+  }
+  return true;
+}
+
+bool RE2::Set::Deserialize(const StringPiece& data, string* error) {
+  if (compiled_ || !pattern_.empty()) {
+    LOG(DFATAL) << "RE2::Set::Deserialize into a used Set";
+    return false;
+  }
+
+  StringPiece d = data;
+  string why;
+  uint32 w[6];
+  StringPiece bytes[2];
+  vector<string> pattern;
+  for (int i = 0; i < 6; i++) {
+    if (!GetWord(&d, &w[i])) {
+      why = "truncated";
+      goto Bad;
+    }
+  }
+  if (w[0] != kSetMagic) {
+    why = "not a serialized RE2::Set";
+    goto Bad;
+  }
+  if (w[1] != kSetVersion) {
+    why = "serialized by a different version";
+    goto Bad;
+  }
+  if (w[2] != anchor_ || w[3] != options_.ParseFlags() ||
+      w[4] != static_cast<uint32>(options_.max_mem())) {
+    why = "serialized with different options";
+    goto Bad;
+  }
+  for (int i = 0; i < w[5]; i++) {
+    StringPiece p;
+    if (!GetBytes(&d, &p)) {
+      why = "truncated";
+      goto Bad;
+    }
+    pattern.push_back(p.as_string());
+  }
+  for (int i = 0; i < 2; i++) {
+    if (!GetBytes(&d, &bytes[i])) {
+      why = "truncated";
+      goto Bad;
+    }
+  }
+  if (!d.empty()) {
+    why = "trailing data";
+    goto Bad;
+  }
+
+  prog_ = Prog::Deserialize(bytes[0], pattern.size(), options_.max_mem(),
+                                &why);
+  if (prog_ == NULL)
+    goto Bad;
+  prog_->set_dfa_cache_shards(options_.dfa_cache_shards());
+  {
+    // As in Compile, make sure the DFA has enough memory to operate.
+    bool failed;
+    StringPiece sp = "hello, world";
+    prog_->SearchDFA(sp, sp, Prog::kAnchored, Prog::kManyMatch,
+                     NULL, &failed, NULL);
+    if (failed) {
+      why = "out of memory";
+      delete prog_;
+      prog_ = NULL;
+      goto Bad;
+    }
+  }
+  if (!bytes[1].empty()) {
+    ends_prog_ = Prog::Deserialize(bytes[1], pattern.size(),
+                                   options_.max_mem(), &why);
+    if (ends_prog_ == NULL) {
+      delete prog_;
+      prog_ = NULL;
+      goto Bad;
+    }
+    ends_prog_->set_dfa_cache_shards(options_.dfa_cache_shards());
+  }
+
+  pattern_.swap(pattern);
+  rprog_.resize(pattern_.size());
+  compiled_ = true;
+  return true;
+
+Bad:
+  if (error != NULL)
+    *error = why;
+  if (options_.log_errors())
+    LOG(ERROR) << "Error deserializing RE2::Set: " << why;
+  return false;
 }
 
 bool RE2::Set::Match(const StringPiece& text, vector<int>* v) const {
@@ -111,3 +357,91 @@ bool RE2::Set::Match(const StringPiece& text, vector<int>* v) const {
   }
   return true;
 }
+
+bool RE2::Set::Match(const StringPiece& text, vector<int>* v,
+                     vector<StringPiece>* matches) const {
+  if (!compiled_) {
+    LOG(DFATAL) << "RE2::Set::Match without Compile";
+    return false;
+  }
+  v->clear();
+  matches->clear();
+  Prog* prog = MatchEndsProg();
+  if (prog == NULL)
+    return false;
+
+  // One forward pass finds where each regexp's first match ends.
+  vector<const char*> ends(pattern_.size());
+  bool failed;
+  bool ret = prog->SearchDFAMatchEnds(text, Prog::kUnanchored, false,
+                                      &ends, &failed);
+  if (failed) {
+    LOG(DFATAL) << "RE2::Set::Match: DFA ran out of cache space";
+    return false;
+  }
+  if (ret == false)
+    return false;
+
+  for (int i = 0; i < ends.size(); i++) {
+    if (ends[i] == NULL)
+      continue;
+    StringPiece match(text.begin(), ends[i] - text.begin());
+    if (anchor_ == RE2::UNANCHORED) {
+      // Run the regexp backward from the end to find the start.
+      Prog* rprog = ReverseProg(i);
+      if (rprog == NULL)
+        return false;
+      if (!rprog->SearchDFA(match, text, Prog::kAnchored,
+                            Prog::kLongestMatch, &match, &failed, NULL)) {
+        if (failed)
+          LOG(DFATAL) << "RE2::Set::Match: reverse DFA ran out of cache space";
+        else
+          LOG(DFATAL) << "RE2::Set::Match: no reverse match for regexp " << i;
+        return false;
+      }
+    }
+    v->push_back(i);
+    matches->push_back(match);
+  }
+  if (v->size() == 0) {
+    LOG(DFATAL) << "RE2::Set::Match: match but unknown regexp set";
+    return false;
+  }
+  return true;
+}
+
+bool RE2::Set::LongestMatch(const StringPiece& text, int* index,
+                            StringPiece* match) const {
+  if (!compiled_) {
+    LOG(DFATAL) << "RE2::Set::LongestMatch without Compile";
+    return false;
+  }
+  Prog* prog = MatchEndsProg();
+  if (prog == NULL)
+    return false;
+
+  // The anchored search stops as soon as no regexp can match further.
+  vector<const char*> ends(pattern_.size());
+  bool failed;
+  bool ret = prog->SearchDFAMatchEnds(text, Prog::kAnchored, true,
+                                      &ends, &failed);
+  if (failed) {
+    LOG(DFATAL) << "RE2::Set::LongestMatch: DFA ran out of cache space";
+    return false;
+  }
+  if (ret == false)
+    return false;
+
+  int best = -1;
+  for (int i = 0; i < ends.size(); i++) {
+    if (ends[i] != NULL && (best < 0 || ends[i] > ends[best]))
+      best = i;
+  }
+  if (best < 0) {
+    LOG(DFATAL) << "RE2::Set::LongestMatch: match but unknown regexp set";
+    return false;
+  }
+  *index = best;
+  *match = StringPiece(text.begin(), ends[best] - text.begin());
+  return true;
+}
@@ -39,12 +39,61 @@ class RE2::Set {
   // If so, it fills v with the indices of the matching regexps.
   bool Match(const StringPiece& text, vector<int>* v) const;
 
+  // Like Match, but also says where each regexp matched, in one pass
+  // over text: matches is filled in parallel with v.  For an UNANCHORED
+  // Set, each match is the one that ends first; its start is found
+  // by running that regexp backward from there, which also gives the
+  // leftmost start among the matches ending at that point.  For an
+  // anchored Set, each match starts at text.begin().
+  // The first call builds the programs this needs, which use memory
+  // in addition to that used by Match.
+  bool Match(const StringPiece& text, vector<int>* v,
+             vector<StringPiece>* matches) const;
+
+  // LongestMatch is for lexers: it looks for the regexps that match at
+  // the start of text and picks the one with the longest match,
+  // preferring the lowest index when several are equally long.
+  // Unless the Set is ANCHOR_BOTH, the match need not extend to the
+  // end of text, even for an UNANCHORED Set.  If a regexp matches,
+  // returns true and sets *index and *match.
+  bool LongestMatch(const StringPiece& text, int* index,
+                    StringPiece* match) const;
+
+  // Serialize appends to *out a description of the compiled Set,
+  // along with the DFA states its searches have built so far, so that
+  // a Set can be compiled (and warmed up) ahead of time and loaded
+  // quickly by Deserialize.  Returns false if the Set is not compiled.
+  bool Serialize(string* out) const;
+
+  // Deserialize does the work of Add and Compile for a new Set, from
+  // the output of Serialize.  The Set must have been made with the
+  // same options and anchor as the one serialized, and data must come
+  // from the same version of RE2.  Returns false if not, or if data
+  // is not valid; if error != NULL, *error will hold an error message.
+  // The Set does not refer to data afterward.
+  bool Deserialize(const StringPiece& data, string* error);
+
  private:
+  friend class RE2::Stream;
+
+  // Returns the program used by the positional Match and LongestMatch,
+  // building it if needed, or NULL if it cannot be built.
+  re2::Prog* MatchEndsProg() const;
+
+  // Returns the reverse program for regexp i, building it if needed.
+  re2::Prog* ReverseProg(int i) const;
+
   RE2::Options options_;
   RE2::Anchor anchor_;
   vector<re2::Regexp*> re_;
+  vector<string> pattern_;  // the patterns, for the programs built later
   re2::Prog* prog_;
   bool compiled_;
+
+  mutable Mutex* mutex_;
+  mutable re2::Prog* ends_prog_;      // for SearchDFAMatchEnds
+  mutable bool ends_prog_failed_;     // whether ends_prog_ could not be built
+  mutable vector<re2::Prog*> rprog_;  // reverse programs, for match starts
   //DISALLOW_EVIL_CONSTRUCTORS(Set);
   Set(const Set&);
   void operator=(const Set&);
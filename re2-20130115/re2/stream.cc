@@ -0,0 +1,152 @@
+// Copyright 2013 The RE2 Authors.  All Rights Reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "thirdparty/re2-20130115/re2/stream.h"
+
+#include "thirdparty/re2-20130115/util/util.h"
+#include "thirdparty/re2-20130115/re2/prog.h"
+#include "thirdparty/re2-20130115/re2/re2.h"
+#include "thirdparty/re2-20130115/re2/set.h"
+
+using namespace re2;
+
+RE2::Stream::Stream(const RE2& re) {
+  // The Prog leaves out any required prefix (as in ^abc),
+  // so match that here and then run the Prog anchored.
+  prog_ = re.ok() ? re.prog_ : NULL;
+  prefix_ = re.prefix_;
+  prefix_foldcase_ = re.prefix_foldcase_;
+  anchored_ = !prefix_.empty();
+  many_ = false;
+  match_end_.resize(1);
+  state_ = new DFAStreamState;
+  Reset();
+}
+
+RE2::Stream::Stream(const RE2::Set& set) {
+  if (!set.compiled_)
+    LOG(DFATAL) << "RE2::Stream of a Set without Compile";
+  prog_ = set.compiled_ ? set.MatchEndsProg() : NULL;
+  prefix_foldcase_ = false;
+  anchored_ = false;
+  many_ = true;
+  match_end_.resize(set.pattern_.size());
+  ends_.resize(set.pattern_.size());
+  state_ = new DFAStreamState;
+  Reset();
+}
+
+RE2::Stream::~Stream() {
+  delete state_;
+}
+
+void RE2::Stream::Reset() {
+  *state_ = DFAStreamState();
+  nprefix_ = 0;
+  failed_ = prog_ == NULL;
+  position_ = 0;
+  nmatched_ = 0;
+  for (int i = 0; i < match_end_.size(); i++)
+    match_end_[i] = -1;
+  for (int i = 0; i < ends_.size(); i++)
+    ends_[i] = NULL;
+}
+
+int64_t RE2::Stream::match_end(int i) const {
+  if (i < 0 || i >= match_end_.size())
+    return -1;
+  return match_end_[i];
+}
+
+bool RE2::Stream::Feed(const StringPiece& text, vector<int>* v) {
+  return Search(text, false, v);
+}
+
+bool RE2::Stream::Finish(vector<int>* v) {
+  return Search(StringPiece(), true, v);
+}
+
+int RE2::Stream::MatchPrefix(const StringPiece& text) {
+  int n = prefix_.size() - nprefix_;
+  if (n > text.size())
+    n = text.size();
+  // As in RE2::Match, a case-folded prefix is all lowercase.
+  const char* p = prefix_.data() + nprefix_;
+  for (int i = 0; i < n; i++) {
+    uint8 c = text[i];
+    if (prefix_foldcase_ && 'A' <= c && c <= 'Z')
+      c += 'a' - 'A';
+    if (static_cast<uint8>(p[i]) != c)
+      return -1;
+  }
+  nprefix_ += n;
+  return n;
+}
+
+bool RE2::Stream::Search(const StringPiece& const_text, bool at_end,
+                         vector<int>* v) {
+  if (v != NULL)
+    v->clear();
+  if (failed_)
+    return false;
+  // Match ends are worked out from pointers into text,
+  // so text must point somewhere even when it is empty.
+  StringPiece text = const_text;
+  if (text.data() == NULL)
+    text = StringPiece("", 0);
+  int64_t base = position_;
+  position_ += text.size();
+  if (state_->done)
+    return true;
+
+  // Take the required prefix out of the text first.
+  if (nprefix_ < prefix_.size()) {
+    int n = MatchPrefix(text);
+    if (n < 0 || (at_end && nprefix_ < prefix_.size())) {
+      state_->done = true;
+      return true;
+    }
+    text.remove_prefix(n);
+    base += n;
+    if (nprefix_ < prefix_.size())
+      return true;
+    state_->prevbyte = prefix_[nprefix_ - 1] & 0xFF;
+  }
+
+  bool failed;
+  const char* ep;
+  bool ret = prog_->SearchDFAStream(state_, text, at_end,
+                                    anchored_ ? Prog::kAnchored
+                                              : Prog::kUnanchored,
+                                    &ep, many_ ? &ends_ : NULL, &failed);
+  if (failed) {
+    LOG(DFATAL) << "RE2::Stream: DFA ran out of cache space";
+    failed_ = true;
+    return false;
+  }
+  if (!ret)
+    return true;
+
+  if (!many_) {
+    match_end_[0] = base + (ep - text.data());
+    nmatched_ = 1;
+    if (v != NULL)
+      v->push_back(0);
+    return true;
+  }
+
+  // Translate the ends found in this piece into stream offsets.
+  // Entries from earlier pieces stay in ends_ so that the DFA
+  // does not look for them again, but they point into those
+  // pieces and must not be used.
+  for (int i = 0; i < ends_.size(); i++) {
+    if (ends_[i] == NULL || match_end_[i] >= 0)
+      continue;
+    match_end_[i] = base + (ends_[i] - text.data());
+    nmatched_++;
+    if (v != NULL)
+      v->push_back(i);
+  }
+  return true;
+}
@@ -0,0 +1,105 @@
+// Copyright 2013 The RE2 Authors.  All Rights Reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#ifndef RE2_STREAM_H
+#define RE2_STREAM_H
+
+#include <vector>
+
+#include "thirdparty/re2-20130115/re2/re2.h"
+
+namespace re2 {
+using std::vector;
+
+struct DFAStreamState;
+
+// An RE2::Stream matches an RE2 or an RE2::Set against text that
+// arrives in pieces -- network buffers, windows of a mapped file --
+// without copying the pieces together.  Between pieces it keeps only
+// the state of the DFA, so its memory does not grow with the text.
+//
+//   RE2::Stream stream(set);
+//   vector<int> v;
+//   while (ReadBuffer(&buffer)) {
+//     if (!stream.Feed(buffer, &v))
+//       ... out of memory ...
+//     for (int i = 0; i < v.size(); i++)
+//       ... regexp v[i] matched, ending at stream.match_end(v[i]) ...
+//   }
+//   stream.Finish(&v);
+//
+// A Stream reports whether each regexp matches, the way Set::Match and
+// RE2::PartialMatch do, and where the first match of each ends.
+// Because the DFA notices the end of a match only at the byte after
+// it, a match that ends with a piece is reported by the next Feed, and
+// one that must end at the end of the text (as with $ or \z) is only
+// reported by Finish.
+//
+// The RE2 or Set must outlive the Stream.  Any number of Streams can
+// share an RE2 or Set, from any number of threads, but each Stream
+// must be used by one thread at a time.
+class RE2::Stream {
+ public:
+  // Matches re, as RE2::PartialMatch would, reporting it as index 0.
+  explicit Stream(const RE2& re);
+
+  // Matches the regexps in set, which must be compiled.
+  explicit Stream(const RE2::Set& set);
+
+  ~Stream();
+
+  // Feed searches text as the next piece of the stream.
+  // It fills v, if not NULL, with the indices of the regexps that
+  // matched for the first time, in increasing order.
+  // Feed returns false if the search ran out of memory; the Stream
+  // is no longer usable after that.
+  bool Feed(const StringPiece& text, vector<int>* v);
+
+  // Finish marks the end of the stream and reports the last matches,
+  // like Feed.  Feed and Finish must not be called again after Finish
+  // until Reset.
+  bool Finish(vector<int>* v);
+
+  // Reset starts the Stream over, for a new stream of text.
+  void Reset();
+
+  // Returns whether any regexp has matched so far.
+  bool matched() const { return nmatched_ > 0; }
+
+  // Returns the number of bytes fed so far.
+  int64_t position() const { return position_; }
+
+  // Returns the offset in the stream at which the first match of
+  // regexp i ended, or -1 if it has not matched.
+  int64_t match_end(int i) const;
+
+ private:
+  bool Search(const StringPiece& text, bool at_end, vector<int>* v);
+
+  // Matches text against prefix_ and returns how many bytes of text
+  // the prefix accounts for, or -1 if it does not match.
+  int MatchPrefix(const StringPiece& text);
+
+  re2::Prog* prog_;             // program to run, NULL if none
+  bool anchored_;               // whether matches must start at the start
+  bool many_;                   // whether prog_ is a Set's program
+  string prefix_;               // required prefix, for an RE2
+  bool prefix_foldcase_;        // prefix is ASCII case-insensitive
+  int nprefix_;                 // bytes of prefix_ matched so far
+  bool failed_;                 // whether there was an error
+
+  DFAStreamState* state_;       // DFA state between pieces
+  int64_t position_;            // bytes fed so far
+  int nmatched_;                // regexps matched so far
+  vector<int64_t> match_end_;   // match ends, -1 if none
+  vector<const char*> ends_;    // match ends in the current piece
+
+  //DISALLOW_EVIL_CONSTRUCTORS(Stream);
+  Stream(const Stream&);
+  void operator=(const Stream&);
+};
+
+}  // namespace re2
+
+#endif  // RE2_STREAM_H
@@ -168,4 +168,109 @@ TEST(TestCompile, ByteRanges) {
   re->Decref();
 }
 
+// Regexps whose matches must begin with one of a few literals
+// get a prefix accelerator; others do not.
+static struct PrefixAccelTest {
+  const char* regexp;
+  const char* text;
+  int pos;  // position of first prefix in text, -1 for none, -2 if no accel
+} prefix_accel_tests[] = {
+  { "foo|bar|baz", "xxxxxxxxxxxxxxxxxxxbaxxbaz", 23 },
+  { "foo|bar|baz", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxba", -1 },
+  { "(foo|bar)\\d+", "fobarfoo", 2 },
+  { "(?i)error", "xxxxxxxxxxxxxxxxxx ErRoR", 19 },
+  { "[Ee]rr(or)?|fail", "faierr", 3 },
+  { "a", "bbbbbbbbbbbbbbbbbbbbbbbba", 24 },
+  { "^foo|bar", "foo", -2 },
+  { "\\bfoo", "foo", -2 },
+  { "foo|x*", "foo", -2 },
+  { "[a-z]foo", "foo", -2 },
+  { "a|b|c|d|e|f|g|h|i", "i", -2 },
+};
+
+TEST(TestCompile, PrefixAccel) {
+  for (int i = 0; i < arraysize(prefix_accel_tests); i++) {
+    const PrefixAccelTest& t = prefix_accel_tests[i];
+    Regexp* re = Regexp::Parse(t.regexp, Regexp::LikePerl, NULL);
+    CHECK(re != NULL);
+    Prog* prog = re->CompileToProg(0);
+    CHECK(prog != NULL);
+    if (t.pos == -2) {
+      EXPECT_FALSE(prog->can_prefix_accel()) << t.regexp;
+    } else {
+      EXPECT_TRUE(prog->can_prefix_accel()) << t.regexp;
+      if (prog->can_prefix_accel()) {
+        const char* p = reinterpret_cast<const char*>(
+            prog->PrefixAccel(t.text, strlen(t.text)));
+        EXPECT_EQ(p == NULL ? -1 : p - t.text, t.pos) << t.regexp;
+      }
+    }
+    delete prog;
+    re->Decref();
+  }
+}
+
+// A Prog read back by Deserialize must be the one serialized,
+// and damaged data must be rejected.
+TEST(TestCompile, Serialize) {
+  vector<const char*> regexps;
+  for (int i = 0; i < arraysize(tests); i++)
+    regexps.push_back(tests[i].regexp);
+  for (int i = 0; i < arraysize(prefix_accel_tests); i++)
+    regexps.push_back(prefix_accel_tests[i].regexp);
+
+  for (int i = 0; i < regexps.size(); i++) {
+    Regexp* re = Regexp::Parse(regexps[i], Regexp::LikePerl, NULL);
+    CHECK(re != NULL);
+    for (int reversed = 0; reversed < 2; reversed++) {
+      Prog* prog = reversed ? re->CompileToReverseProg(0)
+                            : re->CompileToProg(0);
+      CHECK(prog != NULL);
+      string data;
+      prog->Serialize(false, &data);
+      string error;
+      Prog* prog1 = Prog::Deserialize(data, 1, 0, &error);
+      CHECK(prog1 != NULL) << regexps[i] << ": " << error;
+      EXPECT_EQ(prog1->Dump(), prog->Dump());
+      EXPECT_EQ(prog1->DumpUnanchored(), prog->DumpUnanchored());
+      EXPECT_EQ(prog1->reversed(), prog->reversed());
+      EXPECT_EQ(prog1->anchor_start(), prog->anchor_start());
+      EXPECT_EQ(prog1->anchor_end(), prog->anchor_end());
+      EXPECT_EQ(prog1->bytemap_range(), prog->bytemap_range());
+      EXPECT_EQ(memcmp(prog1->bytemap(), prog->bytemap(), 256), 0);
+      EXPECT_EQ(prog1->can_prefix_accel(), prog->can_prefix_accel());
+      string data1;
+      prog1->Serialize(false, &data1);
+      EXPECT_EQ(data1, data);
+      delete prog1;
+
+      for (int n = 0; n < data.size(); n++)
+        CHECK(Prog::Deserialize(StringPiece(data.data(), n), 1, 0, NULL) ==
+              NULL);
+      string bad = data;
+      bad[4]++;  // version
+      CHECK(Prog::Deserialize(bad, 1, 0, &error) == NULL);
+      EXPECT_TRUE(error.find("version") != string::npos) << error;
+
+      // The DFA memory, words 8 and 9, must not be negative, and it
+      // is limited by the caller's max_mem.
+      bad = data;
+      bad[39] = 0x80;
+      CHECK(Prog::Deserialize(bad, 1, 0, &error) == NULL);
+      EXPECT_TRUE(error.find("DFA memory") != string::npos) << error;
+      bad[39] = 0x7F;
+      prog1 = Prog::Deserialize(bad, 1, 0, &error);
+      CHECK(prog1 != NULL) << error;
+      EXPECT_EQ(prog1->dfa_mem(), 1<<20);
+      delete prog1;
+      prog1 = Prog::Deserialize(bad, 1, 1<<16, &error);
+      CHECK(prog1 != NULL) << error;
+      EXPECT_LT(prog1->dfa_mem(), 1<<16);
+      delete prog1;
+      delete prog;
+    }
+    re->Decref();
+  }
+}
+
 }  // namespace re2
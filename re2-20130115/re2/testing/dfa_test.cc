@@ -306,6 +306,40 @@ TEST(Multithreaded, SearchDFA) {
   re->Decref();
 }
 
+// Same again, with a DFA cache per thread.
+TEST(Multithreaded, ShardedSearchDFA) {
+  const int n = 18;
+  Regexp* re = Regexp::Parse(StringPrintf("0[01]{%d}$", n),
+                             Regexp::LikePerl, NULL);
+  CHECK(re);
+  string no_match = DeBruijnString(n);
+  string match = no_match + "0";
+  FLAGS_re2_dfa_bail_when_slow = false;
+
+  for (int i = 0; i < FLAGS_repeat; i++) {
+    // Each shard gets 1/FLAGS_threads of the budget.
+    Prog* prog = re->CompileToProg(FLAGS_threads << n);
+    CHECK(prog);
+    prog->set_dfa_cache_shards(FLAGS_threads);
+    CHECK_EQ(prog->dfa_cache_shards(), FLAGS_threads);
+
+    vector<SearchThread*> threads;
+    for (int j = 0; j < FLAGS_threads; j++) {
+      SearchThread *t = new SearchThread(prog, match, no_match);
+      t->SetJoinable(true);
+      threads.push_back(t);
+    }
+    for (int j = 0; j < FLAGS_threads; j++)
+      threads[j]->Start();
+    for (int j = 0; j < FLAGS_threads; j++) {
+      threads[j]->Join();
+      delete threads[j];
+    }
+    delete prog;
+  }
+  re->Decref();
+}
+
 struct ReverseTest {
   const char *regexp;
   const char *text;
@@ -341,4 +375,54 @@ TEST(DFA, ReverseMatch) {
   EXPECT_EQ(nfail, 0);
 }
 
+// DFA states saved by Serialize must be loaded by Deserialize
+// and must give the same answers.
+TEST(DFA, SerializeStates) {
+  Regexp* re = Regexp::Parse("a[bc]*d|(?m)x\\by$|[0-9]+z", Regexp::LikePerl,
+                             NULL);
+  CHECK(re);
+  Prog* prog = re->CompileToProg(0);
+  CHECK(prog);
+  CHECK_GT(prog->BuildEntireDFA(Prog::kFirstMatch), 0);
+  CHECK_GT(prog->BuildEntireDFA(Prog::kLongestMatch), 0);
+
+  string data;
+  prog->Serialize(true, &data);
+  string nodfa;
+  prog->Serialize(false, &nodfa);
+  CHECK_GT(data.size(), nodfa.size());
+  Prog* prog1 = Prog::Deserialize(data, 1, 0, NULL);
+  CHECK(prog1);
+
+  const char* texts[] = {
+    "", "abcbd", "abcb", "x y", "x\ny", "x y\nz", "12", "12z", "a12zd",
+  };
+  for (int i = 0; i < arraysize(texts); i++) {
+    for (int longest = 0; longest < 2; longest++) {
+      Prog::MatchKind kind = longest ? Prog::kLongestMatch : Prog::kFirstMatch;
+      StringPiece m, m1;
+      bool failed = false, failed1 = false;
+      bool matched = prog->SearchDFA(texts[i], NULL, Prog::kUnanchored, kind,
+                                     &m, &failed, NULL);
+      bool matched1 = prog1->SearchDFA(texts[i], NULL, Prog::kUnanchored,
+                                       kind, &m1, &failed1, NULL);
+      CHECK(!failed);
+      CHECK(!failed1);
+      CHECK_EQ(matched, matched1) << texts[i];
+      if (matched)
+        CHECK_EQ(m.end() - texts[i], m1.end() - texts[i]) << texts[i];
+    }
+  }
+
+  // Every state was loaded, so the new DFAs have saved
+  // as many states (perhaps in a different order).
+  string data1;
+  prog1->Serialize(true, &data1);
+  EXPECT_EQ(data1.size(), data.size());
+
+  delete prog1;
+  delete prog;
+  re->Decref();
+}
+
 }  // namespace re2
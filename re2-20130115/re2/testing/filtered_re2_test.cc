@@ -272,4 +272,92 @@ TEST(FilteredRE2Test, MatchTests) {
   EXPECT_EQ(2, matching_regexps.size());
 }
 
+// Returns whether atom occurs in text, lowercasing ASCII letters.
+static bool ContainsAtom(const string& text, const string& atom) {
+  string lower = text;
+  for (int i = 0; i < lower.size(); i++) {
+    if ('A' <= lower[i] && lower[i] <= 'Z')
+      lower[i] += 'a' - 'A';
+  }
+  return lower.find(atom) != string::npos;
+}
+
+TEST(FilteredRE2Test, MatchAtoms) {
+  FLAGS_filtered_re2_min_atom_len = 3;
+
+  const char* texts[] = {
+    "",
+    "abc121212xyz",
+    "ABC12312yyyZZZ",
+    "abcd12yyy32yyyzzz",
+    "mnmnpp mbfn XBCDEB and more text around madn",
+    "nothing to see here",
+  };
+  for (int i = 1; i < 4; i++) {
+    FilterTestVars v;
+    AtomTest* t = &atom_tests[i];
+    int nregexp;
+    for (nregexp = 0; nregexp < arraysize(t->regexps); nregexp++)
+      if (t->regexps[nregexp] == NULL)
+        break;
+    AddRegexpsAndCompile(t->regexps, nregexp, &v);
+
+    for (int j = 0; j < arraysize(texts); j++) {
+      vector<int> want;
+      for (int k = 0; k < v.atoms.size(); k++)
+        if (ContainsAtom(texts[j], v.atoms[k]))
+          want.push_back(k);
+      vector<int> atoms;
+      v.f.MatchAtoms(texts[j], &atoms);
+      EXPECT_TRUE(atoms == want) << t->testname << " on " << texts[j];
+
+      // Filtering must not change which regexps match.
+      vector<int> matches;
+      v.f.AllMatches(texts[j], &matches);
+      vector<int> slow;
+      for (int k = 0; k < nregexp; k++)
+        if (RE2::PartialMatch(texts[j], t->regexps[k]))
+          slow.push_back(k);
+      sort(matches.begin(), matches.end());
+      EXPECT_TRUE(matches == slow) << t->testname << " on " << texts[j];
+      EXPECT_EQ(v.f.FirstMatch(texts[j]), slow.empty() ? -1 : slow[0]);
+    }
+  }
+}
+
+TEST(FilteredRE2Test, MatchAtomsCase) {
+  FLAGS_filtered_re2_min_atom_len = 3;
+
+  // UTF-8 atoms are lowercased rune by rune.
+  FilterTestVars v;
+  int id;
+  v.f.Add("(?i)ΔδΠϖπΣςσ", v.opts, &id);
+  v.f.Add("ψρστυ", v.opts, &id);
+  v.f.Compile(&v.atoms);
+  vector<int> atoms;
+  v.f.MatchAtoms("xxΔΔΠΠΠΣΣΣxx", &atoms);
+  EXPECT_EQ(1, atoms.size());
+  vector<int> matches;
+  EXPECT_TRUE(v.f.AllMatches("xxΔΔΠϖΠΣΣΣxx", &matches));
+  EXPECT_EQ(1, matches.size());
+  EXPECT_EQ(0, matches[0]);
+  EXPECT_FALSE(v.f.AllMatches("ΨΡΣΤΥ", &matches));
+
+  // With Latin-1 regexps too, atoms outside ASCII are always reported.
+  FilterTestVars w;
+  w.f.Add("ψρστυ", w.opts, &id);
+  w.opts.set_utf8(false);
+  w.f.Add("\xde\xadQ\xbe\xef", w.opts, &id);
+  w.f.Add("hello", w.opts, &id);
+  w.f.Compile(&w.atoms);
+  EXPECT_EQ(3, w.atoms.size());
+  w.f.MatchAtoms("HeLLo", &atoms);
+  EXPECT_EQ(3, atoms.size());
+  w.f.MatchAtoms("goodbye", &atoms);
+  EXPECT_EQ(2, atoms.size());
+  EXPECT_TRUE(w.f.AllMatches("say HELLO \xde\xadQ\xbe\xef", &matches));
+  EXPECT_EQ(1, matches.size());
+  EXPECT_EQ(1, matches[0]);
+}
+
 }  //  namespace re2
@@ -11,6 +11,7 @@
 #include <errno.h>
 #include <vector>
 #include "util/test.h"
+#include "util/thread.h"
 #include "re2/re2.h"
 #include "re2/regexp.h"
 
@@ -182,9 +183,43 @@ TEST(RE2, Replace) {
     CHECK_EQ(RE2::GlobalReplace(&all, t->regexp, t->rewrite), t->greplace_count)
       << "Got: " << all;
     CHECK_EQ(all, t->global);
+    // Appending to a buffer gives the same result after what was there.
+    string buf("x");
+    CHECK_EQ(RE2::GlobalReplace(t->original, t->regexp, t->rewrite, &buf),
+             t->greplace_count);
+    CHECK_EQ(buf, string("x") + t->global);
   }
 }
 
+TEST(RE2, GlobalReplaceRewrites) {
+  string buf;
+  CHECK_EQ(RE2::GlobalReplace("a1 b22 c333", "([a-z])(\\d+)",
+                              "<\\2\\\\\\1>", &buf), 3);
+  CHECK_EQ(buf, "<1\\a> <22\\b> <333\\c>");
+
+  // No matches: the text is copied.
+  buf.clear();
+  CHECK_EQ(RE2::GlobalReplace("abc", "x", "y", &buf), 0);
+  CHECK_EQ(buf, "abc");
+
+  // No matches in place: the string is not copied or touched.
+  string t(100, 'a');
+  const char* data = t.data();
+  CHECK_EQ(RE2::GlobalReplace(&t, "x", "y"), 0);
+  CHECK_EQ(t, string(100, 'a'));
+  CHECK(t.data() == data);
+
+  // An invalid rewrite changes nothing.
+  buf = "keep";
+  CHECK_EQ(RE2::GlobalReplace("abc", "b", "\\x", &buf), -1);
+  CHECK_EQ(buf, "keep");
+  string s("abc");
+  CHECK_EQ(RE2::GlobalReplace(&s, "b", "\\x"), 0);
+  CHECK_EQ(s, "abc");
+  CHECK(!RE2::Replace(&s, "b", "b\\"));
+  CHECK_EQ(s, "abc");
+}
+
 static void TestCheckRewriteString(const char* regexp, const char* rewrite,
                               bool expect_ok) {
   string error;
@@ -1368,4 +1403,188 @@ TEST(RE2, RegexpToStringLossOfAnchor) {
   EXPECT_EQ(RE2("ca[t-z]$").Regexp()->ToString(), "ca[t-z](?-m:$)");
 }
 
+// Runs MatchBatch on a piece of a batch, for the MatchBatch test.
+class MatchBatchThread : public Thread {
+ public:
+  MatchBatchThread(const RE2* re, const StringPiece* texts, int n,
+                   RE2::Anchor anchor, bool* matched)
+    : re_(re), texts_(texts), n_(n), anchor_(anchor), matched_(matched),
+      nmatched_(0) {}
+
+  virtual void Run() {
+    nmatched_ = re_->MatchBatch(texts_, n_, anchor_, matched_);
+  }
+
+  int nmatched() const { return nmatched_; }
+
+ private:
+  const RE2* re_;
+  const StringPiece* texts_;
+  int n_;
+  RE2::Anchor anchor_;
+  bool* matched_;
+  int nmatched_;
+
+  DISALLOW_EVIL_CONSTRUCTORS(MatchBatchThread);
+};
+
+// MatchBatch must agree with Match on every text, whether it gets
+// the whole batch or pieces of it from several threads at once.
+TEST(RE2, MatchBatch) {
+  const char* patterns[] = {
+    "abc",
+    "^abc",
+    "abc$",
+    "^abc$",
+    "a+b",
+    "(?i)abc.*x",
+    "(?i)^abc[0-9]+",
+    "x*",
+    "\\bfoo\\b",
+    "(?s).*z",
+  };
+  vector<string> strs;
+  for (int i = 0; i < 1000; i++)
+    strs.push_back(StringPrintf("%s%d %s", i % 3 ? "abc" : "ABC", i,
+                                i % 5 ? "foo" : "aab zx"));
+  strs.push_back("");
+  strs.push_back("abc");
+  vector<StringPiece> texts(strs.begin(), strs.end());
+  int n = texts.size();
+
+  for (int i = 0; i < arraysize(patterns); i++) {
+    RE2 re(patterns[i], RE2::Latin1);
+    CHECK(re.ok());
+    for (int a = 0; a < 3; a++) {
+      RE2::Anchor anchor = static_cast<RE2::Anchor>(a);
+      int want = 0;
+      for (int j = 0; j < n; j++)
+        want += re.Match(texts[j], 0, texts[j].size(), anchor, NULL, 0);
+      for (int nthreads = 1; nthreads <= 4; nthreads += 3) {
+        bool* matched = new bool[n];
+        int got = 0;
+        if (nthreads == 1) {
+          got = re.MatchBatch(&texts[0], n, anchor, matched);
+        } else {
+          int piece = (n + nthreads - 1) / nthreads;
+          vector<MatchBatchThread*> threads;
+          for (int j = 0; j < n; j += piece) {
+            MatchBatchThread* t = new MatchBatchThread(
+                &re, &texts[j], min(piece, n - j), anchor, &matched[j]);
+            t->SetJoinable(true);
+            t->Start();
+            threads.push_back(t);
+          }
+          for (int j = 0; j < threads.size(); j++) {
+            threads[j]->Join();
+            got += threads[j]->nmatched();
+            delete threads[j];
+          }
+        }
+        EXPECT_EQ(want, got);
+        for (int j = 0; j < n; j++)
+          EXPECT_EQ(re.Match(texts[j], 0, texts[j].size(), anchor, NULL, 0),
+                    matched[j])
+              << patterns[i] << " on " << texts[j];
+        delete[] matched;
+      }
+    }
+  }
+
+  // When the DFA runs out of memory, MatchBatch falls back to Match.
+  RE2::Options opt;
+  opt.set_max_mem(20000);
+  RE2 re("(_________$)", opt);
+  StringPiece text[2] = { "xxxxxxxxxxxxxxxxxxxxxxxxxx_________x",
+                          "xxxxxxxxxxxxxxxxxxxxxxxxxx_________" };
+  bool matched[2];
+  EXPECT_EQ(1, re.MatchBatch(text, 2, RE2::UNANCHORED, matched));
+  EXPECT_FALSE(matched[0]);
+  EXPECT_TRUE(matched[1]);
+}
+
+// Submatches of long matches of a pattern that is not one-pass,
+// which BitState finds once the DFA has found the match.  Texts of
+// different sizes, one after another, reuse BitState's scratch space.
+TEST(RE2, LongMatchSubmatches) {
+  RE2 re("(\\w+)\\s(.*)\\s(\\w+)");
+  int sizes[] = { 100, 50000, 10, 5000, 300000 };
+  for (int i = 0; i < arraysize(sizes); i++) {
+    string middle;
+    while (middle.size() < sizes[i])
+      middle += "some words ";
+    string text = "  first " + middle + "last!";
+    StringPiece m[4];
+    CHECK(re.Match(text, 0, text.size(), RE2::UNANCHORED, m, 4));
+    EXPECT_EQ(m[0], StringPiece(text.data() + 2, text.size() - 3));
+    EXPECT_EQ(m[1], "first");
+    EXPECT_EQ(m[2], middle.substr(0, middle.size() - 1));
+    EXPECT_EQ(m[3], "last");
+  }
+}
+
+// Submatches of long matches of alternations, for which BitState
+// would need a job per byte of text.  It gives up at max_mem/8 bytes
+// of jobs and the NFA finds the submatches instead.
+TEST(RE2, LongAlternationSubmatches) {
+  RE2 re("((?:x|a|aa)*a)");
+  int sizes[] = { 1000, 100000, 600000 };
+  for (int i = 0; i < arraysize(sizes); i++) {
+    string text(sizes[i], 'a');
+    StringPiece m;
+    CHECK(RE2::FullMatch(text, re, &m));
+    EXPECT_EQ(m.size(), text.size());
+  }
+}
+
+// Counts DFA events, for the DFAStats test.
+static void CountDFAEvent(const RE2& re, RE2::DFAEvent event, void* arg) {
+  int* counts = static_cast<int*>(arg);
+  counts[event]++;
+}
+
+TEST(RE2, DFAStats) {
+  RE2::DFAStats stats;
+  RE2 re("a+b");
+  re.GetDFAStats(&stats);
+  EXPECT_EQ(0, stats.states);
+  EXPECT_EQ(0, stats.bytes_used);
+  EXPECT_TRUE(RE2::PartialMatch("xaaab", re));
+  re.GetDFAStats(&stats);
+  EXPECT_GT(stats.states, 0);
+  EXPECT_EQ(0, stats.cache_resets);
+  EXPECT_EQ(0, stats.failures);
+  EXPECT_GT(stats.bytes_used, 0);
+
+  // A pattern whose DFA has millions of states, with too little memory
+  // for more than a few of them, must reset its cache and then fail.
+  RE2::Options opt;
+  opt.set_max_mem(100<<10);
+  RE2 big("(a|b)*a(a|b){20}c", opt);
+  CHECK(big.ok());
+  int counts[2] = { 0, 0 };
+  big.SetDFAEventCallback(CountDFAEvent, counts);
+  string text;
+  uint32 x = 1;
+  for (int i = 0; i < 100000; i++) {
+    x = x * 1103515245 + 12345;
+    text += "ab"[(x >> 16) & 1];
+  }
+  EXPECT_FALSE(big.Match(text, 0, text.size(), RE2::UNANCHORED, NULL, 0));
+  big.GetDFAStats(&stats);
+  EXPECT_GT(stats.cache_resets, 0);
+  EXPECT_GT(stats.failures, 0);
+  EXPECT_EQ(stats.cache_resets, counts[RE2::DFACacheReset]);
+  EXPECT_EQ(stats.failures, counts[RE2::DFAFailure]);
+  EXPECT_LE(stats.bytes_used, 100<<10);
+
+  // Without a callback, the counts still go up.
+  big.SetDFAEventCallback(NULL, NULL);
+  EXPECT_FALSE(big.Match(text, 0, text.size(), RE2::UNANCHORED, NULL, 0));
+  RE2::DFAStats stats2;
+  big.GetDFAStats(&stats2);
+  EXPECT_GT(stats2.failures, stats.failures);
+  EXPECT_EQ(stats.failures, counts[RE2::DFAFailure]);
+}
+
 }  // namespace re2
@@ -5,9 +5,12 @@
 // Benchmarks for regular expression implementations.
 
 #include "util/test.h"
+#include "util/thread.h"
 #include "re2/prog.h"
 #include "re2/re2.h"
 #include "re2/regexp.h"
+#include "re2/filtered_re2.h"
+#include "re2/set.h"
 #include "util/pcre.h"
 #include "util/benchmark.h"
 
@@ -163,10 +166,13 @@ void Search(int iters, int nbytes, const char* regexp, SearchImpl* search) {
 #define EASY1      "A[AB]B[BC]C[CD]D[DE]E[EF]F[FG]G[GH]H[HI]I[IJ]J$"
 
 // This is a little harder, since it starts with a character class
-// and thus can't be memchr'ed.  Could look for ABC and work backward,
-// but no one does that.
+// and thus can't be memchr'ed.  The DFA looks for XABC..., YABC...
+// and ZABC... all at once instead.
 #define MEDIUM     "[XYZ]ABCDEFGHIJKLMNOPQRSTUVWXYZ$"
 
+// Like a log scanner: one of several words, none of which is there.
+#define LITERALS   "(?:ERROR|WARNING|FATAL|PANIC): [a-z]+$"
+
 // This is a fair amount harder, because of the leading [ -~]*.
 // A bad backtracking implementation will take O(text^2) time to
 // figure out there's no match.
@@ -212,6 +218,18 @@ BENCHMARK_RANGE(Search_Medium_CachedPCRE,    8, 256<<10)->ThreadRange(1, NumCPUs
 #endif
 BENCHMARK_RANGE(Search_Medium_CachedRE2,     8, 16<<20)->ThreadRange(1, NumCPUs());
 
+void Search_Literals_CachedDFA(int i, int n)     { Search(i, n, LITERALS, SearchCachedDFA); }
+void Search_Literals_CachedNFA(int i, int n)     { Search(i, n, LITERALS, SearchCachedNFA); }
+void Search_Literals_CachedPCRE(int i, int n)    { Search(i, n, LITERALS, SearchCachedPCRE); }
+void Search_Literals_CachedRE2(int i, int n)     { Search(i, n, LITERALS, SearchCachedRE2); }
+
+BENCHMARK_RANGE(Search_Literals_CachedDFA,     8, 16<<20)->ThreadRange(1, NumCPUs());
+BENCHMARK_RANGE(Search_Literals_CachedNFA,     8, 256<<10)->ThreadRange(1, NumCPUs());
+#ifdef USEPCRE
+BENCHMARK_RANGE(Search_Literals_CachedPCRE,    8, 16<<20)->ThreadRange(1, NumCPUs());
+#endif
+BENCHMARK_RANGE(Search_Literals_CachedRE2,     8, 16<<20)->ThreadRange(1, NumCPUs());
+
 void Search_Hard_CachedDFA(int i, int n)     { Search(i, n, HARD, SearchCachedDFA); }
 void Search_Hard_CachedNFA(int i, int n)     { Search(i, n, HARD, SearchCachedNFA); }
 void Search_Hard_CachedPCRE(int i, int n)    { Search(i, n, HARD, SearchCachedPCRE); }
@@ -560,6 +578,23 @@ BENCHMARK(Parse_CachedSplitBig2_PCRE)->ThreadRange(1, NumCPUs());
 #endif
 BENCHMARK(Parse_CachedSplitBig2_RE2)->ThreadRange(1, NumCPUs());
 
+// Benchmark: a long match of an alternation, for which BitState
+// would push a job for nearly every byte of text.
+
+void Parse1LongAlternation(int iters, int nbytes,
+                  void (*run)(int, const char*, const StringPiece&)) {
+  string s(nbytes, 'a');
+  BenchmarkMemoryUsage();
+  run(iters, "((?:x|a|aa)*a)", s);
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+void Parse_CachedLongAlternation_NFA(int i, int n)  { Parse1LongAlternation(i, n, Parse1CachedNFA); }
+void Parse_CachedLongAlternation_RE2(int i, int n)  { Parse1LongAlternation(i, n, Parse1CachedRE2); }
+
+BENCHMARK_RANGE(Parse_CachedLongAlternation_NFA, 8, 1<<20)->ThreadRange(1, NumCPUs());
+BENCHMARK_RANGE(Parse_CachedLongAlternation_RE2, 8, 1<<20)->ThreadRange(1, NumCPUs());
+
 // Benchmark: measure time required to parse (but not execute)
 // a simple regular expression.
 
@@ -1366,6 +1401,344 @@ BENCHMARK(SmallHTTPPartialMatchPCRE)->ThreadRange(1, NumCPUs());
 #endif
 BENCHMARK(SmallHTTPPartialMatchRE2)->ThreadRange(1, NumCPUs());
 
+// Many threads sharing one RE2, as a server matching request paths
+// against a routing table would.  The benchmark's range is the number
+// of threads; each does n searches.  With a single DFA cache they all
+// take its mutex on every search; with dfa_cache_shards set, each
+// thread gets a cache of its own.  The threads are started here, so
+// the harness runs each case once.
+
+static const char* kRoutes =
+  "/(?:api|v[0-9]+)/(?:users|groups|items)/[0-9]+(?:/[a-z]+)?"
+  "|/static/[a-z0-9_/.-]+\\.(?:css|js|png)"
+  "|/(?:login|logout|search)(?:\\?.*)?";
+
+static const char* kPaths[] = {
+  "/api/users/12345/profile",
+  "/v2/items/9",
+  "/static/css/site.min.css",
+  "/search?q=regular+expressions",
+  "/nowhere/in/particular",
+};
+
+class RouteThread : public Thread {
+ public:
+  RouteThread(const RE2* re, int n) : re_(re), n_(n) {}
+  virtual void Run() {
+    for (int i = 0; i < n_; i++)
+      RE2::FullMatch(kPaths[i % arraysize(kPaths)], *re_);
+  }
+
+ private:
+  const RE2* re_;
+  int n_;
+};
+
+void RouteMatchThreads(int n, int nthreads, int shards) {
+  StopBenchmarkTiming();
+  RE2::Options opt;
+  opt.set_dfa_cache_shards(shards);
+  opt.set_max_mem(shards * opt.max_mem());
+  RE2 re(kRoutes, opt);
+  CHECK(re.ok());
+  vector<RouteThread*> threads;
+  for (int i = 0; i < nthreads; i++) {
+    RouteThread* t = new RouteThread(&re, n);
+    t->SetJoinable(true);
+    threads.push_back(t);
+  }
+  StartBenchmarkTiming();
+  for (int i = 0; i < nthreads; i++)
+    threads[i]->Start();
+  for (int i = 0; i < nthreads; i++) {
+    threads[i]->Join();
+    delete threads[i];
+  }
+}
+
+void RouteMatchSharedCache(int n, int nthreads) {
+  RouteMatchThreads(n, nthreads, 1);
+}
+
+void RouteMatchShardedCache(int n, int nthreads) {
+  RouteMatchThreads(n, nthreads, nthreads);
+}
+
+BENCHMARK_RANGE(RouteMatchSharedCache, 1, 64)->ThreadRange(1, 1);
+BENCHMARK_RANGE(RouteMatchShardedCache, 1, 64)->ThreadRange(1, 1);
+
+// A lexer's token patterns, matched with one RE2::Set or with one RE2
+// per pattern.  Tokenize_Set takes each token with Set::LongestMatch;
+// Tokenize_PerPattern tries every pattern at every token and keeps the
+// longest.  Text that no pattern matches is skipped a byte at a time.
+
+static const char* kTokens[] = {
+  "if|else|while|return",
+  "[A-Za-z_][A-Za-z0-9_]*",
+  "[0-9]+",
+  "[0-9]+\\.[0-9]+",
+  "\"[^\"\\n]*\"",
+  "==|!=|<=|>=|[-+*/=<>(){};,]",
+  "[ \\t\\n]+",
+};
+
+static const char kSource[] =
+  "while (count != 0) {\n"
+  "  if (x1 >= 3.25) return \"done\";\n"
+  "  else total = total + count * 42;\n"
+  "}\n";
+
+void MakeSource(string* text, int nbytes) {
+  text->clear();
+  while (text->size() < nbytes)
+    text->append(kSource);
+  text->resize(nbytes);
+}
+
+void Tokenize_Set(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  MakeSource(&s, nbytes);
+  RE2::Set set(RE2::DefaultOptions, RE2::ANCHOR_START);
+  for (int i = 0; i < arraysize(kTokens); i++)
+    CHECK_EQ(set.Add(kTokens[i], NULL), i);
+  CHECK(set.Compile());
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++) {
+    StringPiece text(s);
+    int index;
+    StringPiece token;
+    while (!text.empty()) {
+      if (set.LongestMatch(text, &index, &token) && !token.empty())
+        text.remove_prefix(token.size());
+      else
+        text.remove_prefix(1);
+    }
+  }
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+void Tokenize_PerPattern(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  MakeSource(&s, nbytes);
+  RE2::Options opt;
+  opt.set_longest_match(true);
+  vector<RE2*> res;
+  for (int i = 0; i < arraysize(kTokens); i++) {
+    res.push_back(new RE2(kTokens[i], opt));
+    CHECK(res.back()->ok());
+  }
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++) {
+    int pos = 0;
+    while (pos < s.size()) {
+      int longest = 0;
+      for (int j = 0; j < res.size(); j++) {
+        StringPiece token;
+        if (res[j]->Match(s, pos, s.size(), RE2::ANCHOR_START, &token, 1) &&
+            token.size() > longest)
+          longest = token.size();
+      }
+      pos += max(longest, 1);
+    }
+  }
+  StopBenchmarkTiming();
+  for (int i = 0; i < res.size(); i++)
+    delete res[i];
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+BENCHMARK_RANGE(Tokenize_Set,        8, 1<<20)->ThreadRange(1, NumCPUs());
+BENCHMARK_RANGE(Tokenize_PerPattern, 8, 1<<20)->ThreadRange(1, NumCPUs());
+
+// Where in random text each of several patterns first matches:
+// SetPositions_Set finds them all in one pass with Set::Match,
+// SetPositions_PerPattern searches for each pattern in turn.
+// The patterns rarely match, so both read all of the text.
+
+static const char* kNeedles[] = {
+  "ABCDEFGHIJ",
+  "[XYZ]ABC[0-9]+",
+  "(?i)regexp",
+  "\\bneedle\\b",
+  "0x[0-9a-f]{8}g",
+};
+
+void SetPositions_Set(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  MakeText(&s, nbytes);
+  RE2::Set set(RE2::DefaultOptions, RE2::UNANCHORED);
+  for (int i = 0; i < arraysize(kNeedles); i++)
+    CHECK_EQ(set.Add(kNeedles[i], NULL), i);
+  CHECK(set.Compile());
+  StartBenchmarkTiming();
+  vector<int> v;
+  vector<StringPiece> matches;
+  for (int i = 0; i < iters; i++)
+    set.Match(s, &v, &matches);
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+void SetPositions_PerPattern(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  MakeText(&s, nbytes);
+  vector<RE2*> res;
+  for (int i = 0; i < arraysize(kNeedles); i++) {
+    res.push_back(new RE2(kNeedles[i]));
+    CHECK(res.back()->ok());
+  }
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++) {
+    for (int j = 0; j < res.size(); j++) {
+      StringPiece match;
+      res[j]->Match(s, 0, s.size(), RE2::UNANCHORED, &match, 1);
+    }
+  }
+  StopBenchmarkTiming();
+  for (int i = 0; i < res.size(); i++)
+    delete res[i];
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+BENCHMARK_RANGE(SetPositions_Set,        8, 1<<20)->ThreadRange(1, NumCPUs());
+BENCHMARK_RANGE(SetPositions_PerPattern, 8, 1<<20)->ThreadRange(1, NumCPUs());
+
+// Which of many rules match random text: FilteredRE2_AllMatches
+// finds the rules' atoms with the built-in matcher and searches
+// only the rules whose atoms are present, FilteredRE2_PerRegexp
+// searches for every rule.
+
+static void AddRules(FilteredRE2* f, vector<RE2*>* res) {
+  RE2::Options opt;
+  for (int i = 0; i < 1000; i++) {
+    string rule = StringPrintf("rule%dx[0-9]+|(?i)alert-%d-[a-z]+", i, i*7);
+    if (f != NULL) {
+      int id;
+      CHECK_EQ(f->Add(rule, opt, &id), RE2::NoError);
+    }
+    if (res != NULL)
+      res->push_back(new RE2(rule, opt));
+  }
+}
+
+void FilteredRE2_AllMatches(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  MakeText(&s, nbytes);
+  FilteredRE2 f;
+  AddRules(&f, NULL);
+  vector<string> atoms;
+  f.Compile(&atoms);
+  vector<int> v;
+  f.AllMatches(s, &v);  // build the atom matcher
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++)
+    f.AllMatches(s, &v);
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+void FilteredRE2_PerRegexp(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  MakeText(&s, nbytes);
+  vector<RE2*> res;
+  AddRules(NULL, &res);
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++) {
+    for (int j = 0; j < res.size(); j++)
+      RE2::PartialMatch(s, *res[j]);
+  }
+  StopBenchmarkTiming();
+  for (int i = 0; i < res.size(); i++)
+    delete res[i];
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+BENCHMARK_RANGE(FilteredRE2_AllMatches, 8, 1<<20)->ThreadRange(1, NumCPUs());
+BENCHMARK_RANGE(FilteredRE2_PerRegexp,  8, 1<<20)->ThreadRange(1, NumCPUs());
+
+// Matching many short texts, one per iteration, so that the time per
+// iteration is mostly per-text overhead: MatchBatch_PerText calls
+// PartialMatch on each text, MatchBatch hands the texts over in batches.
+
+static const int kNumBatchTexts = 1024;
+
+static void MakeBatchTexts(int nbytes, string* s, vector<StringPiece>* texts) {
+  MakeText(s, kNumBatchTexts * nbytes);
+  for (int i = 0; i < kNumBatchTexts; i++)
+    texts->push_back(StringPiece(s->data() + i*nbytes, nbytes));
+}
+
+void MatchBatch_PerText(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  vector<StringPiece> texts;
+  MakeBatchTexts(nbytes, &s, &texts);
+  RE2 re("[a-z]+@[a-z]+\\.com");
+  CHECK(re.ok());
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++)
+    RE2::PartialMatch(texts[i % kNumBatchTexts], re);
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+void MatchBatch(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string s;
+  vector<StringPiece> texts;
+  MakeBatchTexts(nbytes, &s, &texts);
+  RE2 re("[a-z]+@[a-z]+\\.com");
+  CHECK(re.ok());
+  bool matched[kNumBatchTexts];
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i += kNumBatchTexts)
+    re.MatchBatch(&texts[0], min(kNumBatchTexts, iters - i),
+                  RE2::UNANCHORED, matched);
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+BENCHMARK_RANGE(MatchBatch_PerText, 8, 1<<10)->ThreadRange(1, NumCPUs());
+BENCHMARK_RANGE(MatchBatch,         8, 1<<10)->ThreadRange(1, NumCPUs());
+
+// Replacing every digit run in random text, in place and into
+// a reused buffer.
+
+void GlobalReplace_InPlace(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string text;
+  MakeText(&text, nbytes);
+  RE2 re("([0-9]+)");
+  CHECK(re.ok());
+  string s;
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++) {
+    s = text;
+    RE2::GlobalReplace(&s, re, "<\\1>");
+  }
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+void GlobalReplace_Buffer(int iters, int nbytes) {
+  StopBenchmarkTiming();
+  string text;
+  MakeText(&text, nbytes);
+  RE2 re("([0-9]+)");
+  CHECK(re.ok());
+  string buf;
+  StartBenchmarkTiming();
+  for (int i = 0; i < iters; i++) {
+    buf.clear();
+    RE2::GlobalReplace(text, re, "<\\1>", &buf);
+  }
+  SetBenchmarkBytesProcessed(static_cast<int64>(iters)*nbytes);
+}
+
+BENCHMARK_RANGE(GlobalReplace_InPlace, 8, 1<<20)->ThreadRange(1, NumCPUs());
+BENCHMARK_RANGE(GlobalReplace_Buffer,  8, 1<<20)->ThreadRange(1, NumCPUs());
+
 void DotMatchPCRE(int n) {
   StringPiece a;
   PCRE re("(?-s)^(.+)");
@@ -300,6 +300,20 @@ RegexpTest simple_tests[] = {
   
   // Former bugs.
   { "a\\C*|ba\\C", "baba" },
+
+  // Prefix acceleration: several literals, some past the first
+  // 16 bytes, some cut off by the end of the text.
+  { "foo|bar|baz", "xxxxxxxxxxxxxxxxxxxxbazxxxxfoo" },
+  { "foo|bar|baz", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxba" },
+  { "(foo|bar)[0-9]+", "foo bar barfoo bar12 foo345 xxxxxxxxxxxxxxxxxxx" },
+  { "(?i)error|warn", "xxxxxxxxxxxxxxxxxxxxxxxxxxx WaRn ERROR" },
+  { "(?i)sk", "xxxxxxxxxxxxxxxxxxxxxxxxxxx \xC5\xBFK" },
+  { "[Ee]rr(or)?|fail", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx Error failed" },
+  { "(ab|cd)\\b", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx abc cd" },
+  { "(ab|cd)$", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx ab\ncd" },
+  { "(?m)(ab|cd)$", "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx ab\ncd" },
+  { "\xE2\x98\xBA|\xE2\x98\xB9", "xxxxxxxxxxxxxxxxxxxxxxxxxxx \xE2\x98\xBA" },
+  { "aaa|aab", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab" },
 };
 
 TEST(Regexp, SearchTests) {
@@ -322,4 +336,38 @@ TEST(Regexp, SearchTests) {
   EXPECT_EQ(failures, 0);
 }
 
+// SearchBitState gives up, rather than grow its job stack past
+// the limit, on an alternation that pushes a job for nearly every
+// byte of text.
+TEST(BitState, StackLimit) {
+  Regexp* re = Regexp::Parse("((?:x|a|aa)*a)", Regexp::LikePerl, NULL);
+  CHECK(re);
+  Prog* prog = re->CompileToProg(0);
+  CHECK(prog);
+  string text(100000, 'a');
+  StringPiece m[2];
+  bool failed;
+  EXPECT_FALSE(prog->SearchBitState(text, text, Prog::kAnchored,
+                                    Prog::kFullMatch, m, 2,
+                                    64*1024, &failed));
+  EXPECT_TRUE(failed);
+
+  // With no limit, it finds the match.
+  EXPECT_TRUE(prog->SearchBitState(text, text, Prog::kAnchored,
+                                   Prog::kFullMatch, m, 2,
+                                   0, &failed));
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(m[1].size(), text.size());
+
+  // A short text fits.
+  StringPiece small(text.data(), 1000);
+  EXPECT_TRUE(prog->SearchBitState(small, small, Prog::kAnchored,
+                                   Prog::kFullMatch, m, 2,
+                                   64*1024, &failed));
+  EXPECT_FALSE(failed);
+  EXPECT_EQ(m[1].size(), small.size());
+  delete prog;
+  re->Decref();
+}
+
 }  // namespace re2
@@ -110,5 +110,207 @@ TEST(Set, Anchored) {
 
 }
 
-}  // namespace re2
+// Returns the offsets of match in text as "begin-end".
+static string Offsets(const StringPiece& text, const StringPiece& match) {
+  return StringPrintf("%d-%d",
+                      static_cast<int>(match.begin() - text.begin()),
+                      static_cast<int>(match.end() - text.begin()));
+}
+
+TEST(Set, UnanchoredPositions) {
+  RE2::Set s(RE2::DefaultOptions, RE2::UNANCHORED);
+
+  CHECK_EQ(s.Add("foo", NULL), 0);
+  CHECK_EQ(s.Add("b+ar", NULL), 1);
+  CHECK_EQ(s.Add("a+", NULL), 2);
+  CHECK_EQ(s.Add("\\bz\\b", NULL), 3);
+  CHECK_EQ(s.Add("x$", NULL), 4);
+
+  CHECK_EQ(s.Compile(), true);
+
+  StringPiece text("xbbar foo aaa z x");
+  vector<int> v;
+  vector<StringPiece> m;
+  CHECK_EQ(s.Match(text, &v, &m), true);
+  CHECK_EQ(v.size(), 5);
+  CHECK_EQ(m.size(), 5);
+  CHECK_EQ(v[0], 0);
+  CHECK_EQ(Offsets(text, m[0]), "6-9");
+  CHECK_EQ(v[1], 1);
+  CHECK_EQ(Offsets(text, m[1]), "1-5");
+  // The first match to end is the a in bar, not the aaa.
+  CHECK_EQ(v[2], 2);
+  CHECK_EQ(Offsets(text, m[2]), "3-4");
+  CHECK_EQ(v[3], 3);
+  CHECK_EQ(Offsets(text, m[3]), "14-15");
+  CHECK_EQ(v[4], 4);
+  CHECK_EQ(Offsets(text, m[4]), "16-17");
+
+  // The plain Match must agree about which regexps match.
+  vector<int> v2;
+  CHECK_EQ(s.Match(text, &v2), true);
+  CHECK_EQ(v2.size(), 5);
+
+  text = "zz foo";
+  CHECK_EQ(s.Match(text, &v, &m), true);
+  CHECK_EQ(v.size(), 1);
+  CHECK_EQ(v[0], 0);
+  CHECK_EQ(Offsets(text, m[0]), "3-6");
 
+  CHECK_EQ(s.Match("zz", &v, &m), false);
+  CHECK_EQ(v.size(), 0);
+  CHECK_EQ(m.size(), 0);
+}
+
+TEST(Set, AnchoredPositions) {
+  RE2::Set s(RE2::DefaultOptions, RE2::ANCHOR_START);
+
+  CHECK_EQ(s.Add("[a-z]+", NULL), 0);
+  CHECK_EQ(s.Add("if", NULL), 1);
+  CHECK_EQ(s.Add("[0-9]+", NULL), 2);
+
+  CHECK_EQ(s.Compile(), true);
+
+  StringPiece text("iffy 12");
+  vector<int> v;
+  vector<StringPiece> m;
+  CHECK_EQ(s.Match(text, &v, &m), true);
+  CHECK_EQ(v.size(), 2);
+  CHECK_EQ(v[0], 0);
+  CHECK_EQ(Offsets(text, m[0]), "0-1");
+  CHECK_EQ(v[1], 1);
+  CHECK_EQ(Offsets(text, m[1]), "0-2");
+
+  CHECK_EQ(s.Match("12", &v, &m), true);
+  CHECK_EQ(v.size(), 1);
+  CHECK_EQ(v[0], 2);
+
+  CHECK_EQ(s.Match(" 12", &v, &m), false);
+}
+
+TEST(Set, LongestMatch) {
+  RE2::Set s(RE2::DefaultOptions, RE2::ANCHOR_START);
+
+  CHECK_EQ(s.Add("if", NULL), 0);
+  CHECK_EQ(s.Add("[a-z]+", NULL), 1);
+  CHECK_EQ(s.Add("[0-9]+", NULL), 2);
+  CHECK_EQ(s.Add("[0-9]+\\.[0-9]+", NULL), 3);
+  CHECK_EQ(s.Add(" +", NULL), 4);
+  CHECK_EQ(s.Add("=|==", NULL), 5);
+
+  CHECK_EQ(s.Compile(), true);
+
+  // Tokenize a string, consuming the longest match each time.
+  StringPiece text("if iffy == 3.14 12 =");
+  const char* want[] = {
+    "0:if", "4: ", "1:iffy", "4: ", "5:==", "4: ", "3:3.14", "4: ",
+    "2:12", "4: ", "5:=",
+  };
+  int ntoken = 0;
+  while (!text.empty()) {
+    int index;
+    StringPiece match;
+    CHECK(s.LongestMatch(text, &index, &match));
+    CHECK(match.begin() == text.begin());
+    CHECK_LT(ntoken, arraysize(want));
+    CHECK_EQ(StringPrintf("%d:%s", index, match.as_string().c_str()),
+             want[ntoken]);
+    ntoken++;
+    text.remove_prefix(match.size());
+  }
+  CHECK_EQ(ntoken, arraysize(want));
+
+  int index;
+  StringPiece match;
+  CHECK_EQ(s.LongestMatch("+1", &index, &match), false);
+
+  // An unanchored Set is anchored for LongestMatch.
+  RE2::Set u(RE2::DefaultOptions, RE2::UNANCHORED);
+  CHECK_EQ(u.Add("a+", NULL), 0);
+  CHECK_EQ(u.Compile(), true);
+  CHECK_EQ(u.LongestMatch("baa", &index, &match), false);
+  CHECK_EQ(u.LongestMatch("aab", &index, &match), true);
+  CHECK_EQ(index, 0);
+  CHECK_EQ(match.size(), 2);
+}
+
+TEST(Set, AnchoredBothPositions) {
+  RE2::Set s(RE2::DefaultOptions, RE2::ANCHOR_BOTH);
+
+  CHECK_EQ(s.Add("a+", NULL), 0);
+  CHECK_EQ(s.Add("a", NULL), 1);
+
+  CHECK_EQ(s.Compile(), true);
+
+  StringPiece text("aaa");
+  vector<int> v;
+  vector<StringPiece> m;
+  CHECK_EQ(s.Match(text, &v, &m), true);
+  CHECK_EQ(v.size(), 1);
+  CHECK_EQ(v[0], 0);
+  CHECK_EQ(Offsets(text, m[0]), "0-3");
+
+  int index;
+  StringPiece match;
+  CHECK_EQ(s.LongestMatch("aab", &index, &match), false);
+  CHECK_EQ(s.LongestMatch("a", &index, &match), true);
+  CHECK_EQ(index, 0);
+}
+
+TEST(Set, Serialize) {
+  RE2::Set s(RE2::DefaultOptions, RE2::UNANCHORED);
+  CHECK_EQ(s.Add("foo", NULL), 0);
+  CHECK_EQ(s.Add("(b+)ar", NULL), 1);
+  CHECK_EQ(s.Add("\\bz\\b", NULL), 2);
+  CHECK_EQ(s.Compile(), true);
+
+  // Serialize before and after the positional programs are built.
+  string text = "xbbar foo aaa z";
+  vector<int> v0, v;
+  vector<StringPiece> m;
+  for (int built = 0; built < 2; built++) {
+    string data;
+    CHECK(s.Serialize(&data));
+    CHECK(s.Match(text, &v0));
+    CHECK(s.Match(text, &v, &m));
+
+    RE2::Set s1(RE2::DefaultOptions, RE2::UNANCHORED);
+    string error;
+    CHECK(s1.Deserialize(data, &error)) << error;
+    vector<int> v1;
+    vector<StringPiece> m1;
+    CHECK(s1.Match(text, &v1));
+    CHECK(v1 == v0);
+    CHECK(s1.Match(text, &v1, &m1));
+    CHECK(v1 == v);
+    for (int i = 0; i < m.size(); i++)
+      CHECK_EQ(Offsets(text, m1[i]), Offsets(text, m[i]));
+    CHECK(!s1.Match("nothing here", &v1));
+  }
+
+  // The options and anchor must agree.
+  string data;
+  CHECK(s.Serialize(&data));
+  RE2::Set anchored(RE2::DefaultOptions, RE2::ANCHOR_START);
+  CHECK(!anchored.Deserialize(data, NULL));
+  RE2::Options opt;
+  opt.set_case_sensitive(false);
+  opt.set_log_errors(false);
+  RE2::Set folded(opt, RE2::UNANCHORED);
+  string error;
+  CHECK(!folded.Deserialize(data, &error));
+  CHECK_EQ(error, "serialized with different options");
+  RE2::Set truncated(opt, RE2::UNANCHORED);
+  CHECK(!truncated.Deserialize(StringPiece(data.data(), data.size() - 1),
+                               &error));
+
+  // Dropping the last pattern leaves match ids that are out of range.
+  string dropped = data;
+  dropped[20] = 2;
+  dropped.erase(24 + (4 + 3) + (4 + 6), 4 + 5);
+  RE2::Set fewer(RE2::DefaultOptions, RE2::UNANCHORED);
+  CHECK(!fewer.Deserialize(dropped, &error));
+  CHECK(error.find("bad match id") != string::npos) << error;
+}
+
+}  // namespace re2
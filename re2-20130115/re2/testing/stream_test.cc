@@ -0,0 +1,178 @@
+// Copyright 2013 The RE2 Authors.  All Rights Reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "util/test.h"
+#include "re2/re2.h"
+#include "re2/set.h"
+#include "re2/stream.h"
+
+namespace re2 {
+
+// Feeds text to stream in pieces of the given sizes (the rest
+// in a final piece), then finishes it.  Returns the indices
+// reported, in order, as a string like "0 2".
+static string FeedPieces(RE2::Stream* stream, const string& text,
+                         const vector<int>& sizes) {
+  string reported;
+  vector<int> v;
+  int pos = 0;
+  for (int i = 0; i <= sizes.size(); i++) {
+    int n = i < sizes.size() ? sizes[i] : text.size() - pos;
+    CHECK(stream->Feed(StringPiece(text.data() + pos, n), &v));
+    pos += n;
+    for (int j = 0; j < v.size(); j++)
+      reported += StringPrintf("%s%d", reported.empty() ? "" : " ", v[j]);
+  }
+  CHECK(stream->Finish(&v));
+  for (int j = 0; j < v.size(); j++)
+    reported += StringPrintf("%s%d", reported.empty() ? "" : " ", v[j]);
+  CHECK_EQ(stream->position(), text.size());
+  return reported;
+}
+
+// Checks that streaming re over text, split into two pieces at
+// every possible place, agrees with RE2::Match.
+static void TestSplits(const char* pattern, const string& text) {
+  RE2 re(pattern, RE2::Latin1);
+  CHECK(re.ok());
+  StringPiece m;
+  bool want = re.Match(text, 0, text.size(), RE2::UNANCHORED, &m, 1);
+
+  // RE2::Match finds the leftmost match; the stream reports the
+  // one that ends first, which is no later.
+  for (int i = 0; i <= text.size(); i++) {
+    RE2::Stream stream(re);
+    vector<int> sizes(1, i);
+    string reported = FeedPieces(&stream, text, sizes);
+    CHECK_EQ(stream.matched(), want) << pattern << " on " << text
+                                     << " split at " << i;
+    CHECK_EQ(reported, want ? "0" : "");
+    if (want) {
+      CHECK_LE(stream.match_end(0), m.end() - text.data());
+      // Some match must end there.
+      bool found = false;
+      int end = stream.match_end(0);
+      for (int start = 0; start <= end && !found; start++)
+        found = re.Match(text, start, end, RE2::ANCHOR_BOTH, NULL, 0);
+      CHECK(found) << pattern << " on " << text << " ends at " << end;
+    } else {
+      CHECK_EQ(stream.match_end(0), -1);
+    }
+  }
+}
+
+TEST(Stream, Splits) {
+  TestSplits("hello world", "say hello world!");
+  TestSplits("hello world", "say hello worl");
+  TestSplits("\\bfoo\\b", "a foo b");
+  TestSplits("\\bfoo\\b", "afoo b");
+  TestSplits("\\bfoo\\b", "a foob");
+  TestSplits("\\bfoo\\b", "foo");
+  TestSplits("foo$", "foo");
+  TestSplits("foo$", "foo bar");
+  TestSplits("(?m)foo$", "foo\nbar");
+  TestSplits("^foo", "foo");
+  TestSplits("^foo", " foo");
+  TestSplits("^abc[0-9]+", "abc12");
+  TestSplits("^abc[0-9]+", "abd12");
+  TestSplits("^abc[0-9]+", "ab");
+  TestSplits("(?i)^abc[0-9]+", "ABc12");
+  TestSplits("a+b", "caaab");
+  TestSplits("x*", "abc");
+  TestSplits("(?s).*", "");
+  TestSplits("abc|bcd|cde|def", "zzcdef");
+}
+
+TEST(Stream, OneByteAtATime) {
+  RE2 re("needle[0-9]+");
+  RE2::Stream stream(re);
+  string text = "hay hay needle hay needle42 hay";
+  vector<int> v;
+  for (int i = 0; i < text.size(); i++) {
+    CHECK(stream.Feed(StringPiece(text.data() + i, 1), &v));
+    // The first match to end is needle4, seen only at the 2.
+    if (i == text.find("42") + 1) {
+      CHECK_EQ(v.size(), 1);
+      CHECK_EQ(v[0], 0);
+    } else {
+      CHECK_EQ(v.size(), 0);
+    }
+  }
+  CHECK(stream.matched());
+  CHECK_EQ(stream.match_end(0), text.find("42") + 1);
+
+  // After Reset, the stream starts over.
+  stream.Reset();
+  CHECK(!stream.matched());
+  CHECK(stream.Feed("needle", &v));
+  CHECK(stream.Feed("7", &v));
+  CHECK(!stream.matched());
+  CHECK(stream.Finish(&v));
+  CHECK(stream.matched());
+  CHECK_EQ(v.size(), 1);
+  CHECK_EQ(stream.match_end(0), 7);
+}
+
+TEST(Stream, Set) {
+  RE2::Set s(RE2::DefaultOptions, RE2::UNANCHORED);
+  CHECK_EQ(s.Add("foo", NULL), 0);
+  CHECK_EQ(s.Add("b+ar", NULL), 1);
+  CHECK_EQ(s.Add("\\bz\\b", NULL), 2);
+  CHECK_EQ(s.Add("x$", NULL), 3);
+  CHECK_EQ(s.Add("nowhere", NULL), 4);
+  CHECK(s.Compile());
+
+  string text = "xbbar foo aaa z x";
+  vector<int> v;
+  vector<StringPiece> m;
+  CHECK(s.Match(text, &v, &m));
+
+  // Every way of cutting the text in three must agree with Match.
+  for (int i = 0; i <= text.size(); i++) {
+    for (int j = i; j <= text.size(); j++) {
+      RE2::Stream stream(s);
+      vector<int> sizes;
+      sizes.push_back(i);
+      sizes.push_back(j - i);
+      string reported = FeedPieces(&stream, text, sizes);
+      CHECK(stream.matched());
+      for (int k = 0; k < v.size(); k++)
+        CHECK_EQ(stream.match_end(v[k]), m[k].end() - text.data())
+            << "regexp " << v[k] << " split at " << i << ", " << j;
+      CHECK_EQ(stream.match_end(4), -1);
+      // x$ can only match at the end, so it is reported last.
+      CHECK_EQ(reported.size(), 7);
+      CHECK_EQ(reported.substr(reported.size() - 1), "3");
+    }
+  }
+}
+
+TEST(Stream, AnchoredSet) {
+  RE2::Set s(RE2::DefaultOptions, RE2::ANCHOR_START);
+  CHECK_EQ(s.Add("GET ", NULL), 0);
+  CHECK_EQ(s.Add("POST ", NULL), 1);
+  CHECK_EQ(s.Add("[A-Z]+ /admin", NULL), 2);
+  CHECK(s.Compile());
+
+  RE2::Stream stream(s);
+  vector<int> v;
+  CHECK(stream.Feed("PO", &v));
+  CHECK_EQ(v.size(), 0);
+  CHECK(stream.Feed("ST /adm", &v));
+  CHECK_EQ(v.size(), 1);
+  CHECK_EQ(v[0], 1);
+  CHECK(stream.Feed("in/x GET ", &v));
+  CHECK_EQ(v.size(), 1);
+  CHECK_EQ(v[0], 2);
+  CHECK(stream.Finish(&v));
+  CHECK_EQ(v.size(), 0);
+  CHECK_EQ(stream.match_end(0), -1);
+  CHECK_EQ(stream.match_end(1), 5);
+  CHECK_EQ(stream.match_end(2), 11);
+}
+
+}  // namespace re2
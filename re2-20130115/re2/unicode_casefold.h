@@ -70,6 +70,9 @@ extern CaseFold* LookupCaseFold(CaseFold*, int, Rune rune);
 // Returns the result of applying the fold f to the rune r.
 extern Rune ApplyFold(CaseFold *f, Rune r);
 
+// Returns the next Rune in r's folding cycle, or r if it has none.
+extern Rune CycleFoldRune(Rune r);
+
 }  // namespace re2
 
 #endif  // RE2_UNICODE_CASEFOLD_H__
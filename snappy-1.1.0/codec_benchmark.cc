@@ -0,0 +1,324 @@
+// Compression codec benchmark harness.
+//
+// Runs snappy, the LZO1X levels and zlib over the snappy testdata files
+// (or any files and directories given on the command line) and reports,
+// per codec, direction and file:
+//   bytes_per_second   compress/decompress throughput, counted on the
+//                      uncompressed size
+//   ratio              compressed size / uncompressed size
+//   p50_us .. max_us   latency percentiles of a single block
+//
+// The input is cut into --block_size blocks (64KiB by default, the
+// Hadoop codec buffer size), each compressed independently.  All of the
+// standard google benchmark flags apply, so machine readable output for
+// regression tracking is
+//
+//   codec_benchmark --benchmark_out=result.json --benchmark_out_format=json
+//                   [--block_size=N] [--benchmark_filter=lzo] [file_or_dir ...]
+//
+// which writes the report through benchmark::JSONReporter.
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "thirdparty/benchmark/benchmark.h"
+#include "thirdparty/lzo/lzo1x.h"
+#include "thirdparty/snappy/snappy.h"
+
+namespace {
+
+typedef std::vector<std::string> Blocks;
+
+// A codec compresses and decompresses one block at a time.  Decompress
+// is given the uncompressed size and a buffer of exactly that size.
+struct Codec {
+  const char* name;
+  void (*compress)(const std::string& input, std::string* output);
+  bool (*decompress)(const std::string& input, char* output, size_t size);
+};
+
+void SnappyCompress(const std::string& input, std::string* output) {
+  snappy::Compress(input.data(), input.size(), output);
+}
+
+bool SnappyDecompress(const std::string& input, char* output,
+                      size_t /* size */) {
+  return snappy::RawUncompress(input.data(), input.size(), output);
+}
+
+template <int (*kCompress)(const lzo_bytep, lzo_uint, lzo_bytep, lzo_uintp,
+                           lzo_voidp),
+          size_t kMem>
+void LzoCompress(const std::string& input, std::string* output) {
+  static std::vector<unsigned char> wrkmem(kMem);
+  output->resize(input.size() + input.size() / 16 + 64 + 3);
+  lzo_uint size = output->size();
+  int ret = kCompress(reinterpret_cast<const lzo_bytep>(input.data()),
+                      input.size(),
+                      reinterpret_cast<lzo_bytep>(&(*output)[0]),
+                      &size, &wrkmem[0]);
+  if (ret != LZO_E_OK) {
+    fprintf(stderr, "lzo compression failed: %d\n", ret);
+    abort();
+  }
+  output->resize(size);
+}
+
+bool LzoDecompress(const std::string& input, char* output, size_t size) {
+  lzo_uint out_len = size;
+  int ret = lzo1x_decompress_wild_safe(
+      reinterpret_cast<const lzo_bytep>(input.data()), input.size(),
+      reinterpret_cast<lzo_bytep>(output), &out_len, NULL);
+  return ret == LZO_E_OK && out_len == size;
+}
+
+template <int kLevel>
+void ZlibCompress(const std::string& input, std::string* output) {
+  uLongf size = compressBound(input.size());
+  output->resize(size);
+  int ret = compress2(reinterpret_cast<Bytef*>(&(*output)[0]), &size,
+                      reinterpret_cast<const Bytef*>(input.data()),
+                      input.size(), kLevel);
+  if (ret != Z_OK) {
+    fprintf(stderr, "zlib compression failed: %d\n", ret);
+    abort();
+  }
+  output->resize(size);
+}
+
+bool ZlibDecompress(const std::string& input, char* output, size_t size) {
+  uLongf out_len = size;
+  int ret = uncompress(reinterpret_cast<Bytef*>(output), &out_len,
+                       reinterpret_cast<const Bytef*>(input.data()),
+                       input.size());
+  return ret == Z_OK && out_len == size;
+}
+
+const Codec kCodecs[] = {
+  { "snappy", &SnappyCompress, &SnappyDecompress },
+  { "lzo1x_1",
+    &LzoCompress<lzo1x_1_compress, LZO1X_1_MEM_COMPRESS>, &LzoDecompress },
+  { "lzo1x_1_15",
+    &LzoCompress<lzo1x_1_15_compress, LZO1X_1_15_MEM_COMPRESS>,
+    &LzoDecompress },
+  { "lzo1x_999",
+    &LzoCompress<lzo1x_999_compress, LZO1X_999_MEM_COMPRESS>, &LzoDecompress },
+  { "zlib_1", &ZlibCompress<1>, &ZlibDecompress },
+  { "zlib_6", &ZlibCompress<6>, &ZlibDecompress },
+};
+
+const char* const kTestDataFiles[] = {
+  "html", "urls.10K", "house.jpg", "mapreduce-osdi-1.pdf", "html_x_4",
+  "cp.html", "fields.c", "grammar.lsp", "kennedy.xls", "alice29.txt",
+  "asyoulik.txt", "lcet10.txt", "plrabn12.txt", "ptt5", "sum", "xargs.1",
+  "geo.protodata", "kppkn.gtb",
+};
+
+size_t block_size = 64 << 10;
+
+bool ReadFile(const std::string& path, std::string* contents) {
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (fp == NULL)
+    return false;
+  contents->clear();
+  char buf[1 << 16];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+    contents->append(buf, n);
+  bool ok = !ferror(fp);
+  fclose(fp);
+  return ok;
+}
+
+// Expands directories one level deep; plain files are kept as they are.
+void ExpandPath(const std::string& path, std::vector<std::string>* files) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+    files->push_back(path);
+    return;
+  }
+  DIR* dir = opendir(path.c_str());
+  if (dir == NULL)
+    return;
+  std::vector<std::string> entries;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string file = path + "/" + entry->d_name;
+    if (entry->d_name[0] != '.' && stat(file.c_str(), &st) == 0 &&
+        S_ISREG(st.st_mode))
+      entries.push_back(file);
+  }
+  closedir(dir);
+  std::sort(entries.begin(), entries.end());
+  files->insert(files->end(), entries.begin(), entries.end());
+}
+
+std::string BaseName(const std::string& path) {
+  size_t slash = path.rfind('/');
+  return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+Blocks SplitBlocks(const std::string& contents) {
+  Blocks blocks;
+  for (size_t pos = 0; pos < contents.size(); pos += block_size)
+    blocks.push_back(contents.substr(pos, block_size));
+  return blocks;
+}
+
+size_t TotalSize(const Blocks& blocks) {
+  size_t total = 0;
+  for (size_t i = 0; i < blocks.size(); ++i)
+    total += blocks[i].size();
+  return total;
+}
+
+double Micros(std::chrono::steady_clock::duration d) {
+  return std::chrono::duration<double, std::micro>(d).count();
+}
+
+// Times run_block(i) on each block by itself and publishes the latency
+// distribution as user counters.  This runs after the benchmark loop, so
+// the clock reads do not count against bytes_per_second.  It takes as
+// many samples as the loop ran blocks, but no more passes than needed
+// for about 1000 samples.
+template <typename RunBlock>
+void ReportLatencies(size_t nblocks, RunBlock run_block,
+                     benchmark::State& state) {
+  if (nblocks == 0)
+    return;
+  const int64_t passes = std::max<int64_t>(
+      1, std::min<int64_t>(state.iterations(), 1000 / nblocks));
+  std::vector<double> latencies;
+  for (int64_t pass = 0; pass < passes; ++pass) {
+    for (size_t i = 0; i < nblocks; ++i) {
+      std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      run_block(i);
+      latencies.push_back(Micros(std::chrono::steady_clock::now() - start));
+    }
+  }
+  std::sort(latencies.begin(), latencies.end());
+  const size_t n = latencies.size();
+  state.counters["p50_us"] = latencies[n / 2];
+  state.counters["p90_us"] = latencies[n * 90 / 100];
+  state.counters["p99_us"] = latencies[n * 99 / 100];
+  state.counters["max_us"] = latencies[n - 1];
+}
+
+void BM_Compress(benchmark::State& state, const Codec* codec,
+                 const Blocks* blocks) {
+  std::string output;
+  size_t compressed = 0;
+  for (auto _ : state) {
+    compressed = 0;
+    for (size_t i = 0; i < blocks->size(); ++i) {
+      codec->compress((*blocks)[i], &output);
+      compressed += output.size();
+    }
+  }
+  const size_t total = TotalSize(*blocks);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * total);
+  state.counters["ratio"] = total ? static_cast<double>(compressed) / total : 0;
+  ReportLatencies(blocks->size(), [&](size_t i) {
+    codec->compress((*blocks)[i], &output);
+  }, state);
+}
+
+void BM_Decompress(benchmark::State& state, const Codec* codec,
+                   const Blocks* blocks) {
+  Blocks compressed(blocks->size());
+  size_t compressed_size = 0;
+  for (size_t i = 0; i < blocks->size(); ++i) {
+    codec->compress((*blocks)[i], &compressed[i]);
+    compressed_size += compressed[i].size();
+  }
+  std::string output(block_size, '\0');
+  for (size_t i = 0; i < blocks->size(); ++i) {
+    const std::string& block = (*blocks)[i];
+    if (!codec->decompress(compressed[i], &output[0], block.size()) ||
+        memcmp(output.data(), block.data(), block.size()) != 0) {
+      state.SkipWithError("round trip mismatch");
+      return;
+    }
+  }
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < blocks->size(); ++i)
+      codec->decompress(compressed[i], &output[0], (*blocks)[i].size());
+  }
+  const size_t total = TotalSize(*blocks);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * total);
+  state.counters["ratio"] =
+      total ? static_cast<double>(compressed_size) / total : 0;
+  ReportLatencies(blocks->size(), [&](size_t i) {
+    codec->decompress(compressed[i], &output[0], (*blocks)[i].size());
+  }, state);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--block_size=", 13) == 0) {
+      block_size = strtoul(argv[i] + 13, NULL, 10);
+      if (block_size == 0) {
+        fprintf(stderr, "invalid %s\n", argv[i]);
+        return 1;
+      }
+    } else if (argv[i][0] == '-') {
+      fprintf(stderr, "unrecognized argument: %s\n", argv[i]);
+      return 1;
+    } else {
+      ExpandPath(argv[i], &files);
+    }
+  }
+  if (files.empty()) {
+    const char* srcdir = getenv("srcdir");  // Same lookup as snappy-test.cc.
+    std::string testdata = srcdir ? std::string(srcdir) + "/testdata/"
+                                  : std::string("testdata/");
+    for (size_t i = 0; i < sizeof(kTestDataFiles) / sizeof(*kTestDataFiles);
+         ++i)
+      files.push_back(testdata + kTestDataFiles[i]);
+  }
+
+  if (lzo_init() != LZO_E_OK) {
+    fprintf(stderr, "lzo_init failed\n");
+    return 1;
+  }
+
+  // Registered benchmarks keep pointers into this, so it must not move.
+  std::vector<Blocks> corpora(files.size());
+  for (size_t f = 0; f < files.size(); ++f) {
+    std::string contents;
+    if (!ReadFile(files[f], &contents)) {
+      fprintf(stderr, "cannot read %s\n", files[f].c_str());
+      return 1;
+    }
+    corpora[f] = SplitBlocks(contents);
+    const std::string base = BaseName(files[f]);
+    for (size_t c = 0; c < sizeof(kCodecs) / sizeof(*kCodecs); ++c) {
+      const Codec* codec = &kCodecs[c];
+      benchmark::RegisterBenchmark(
+          (std::string(codec->name) + "/compress/" + base).c_str(),
+          BM_Compress, codec, &corpora[f]);
+      benchmark::RegisterBenchmark(
+          (std::string(codec->name) + "/decompress/" + base).c_str(),
+          BM_Decompress, codec, &corpora[f]);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -22,6 +22,23 @@ void uint32_array_to_c_hex(const uint32_t* ary, size_t sz, const char* name)
     printf("\n};\n");
 }
 
+// dump uint64_t as hex digits, two per line
+void uint64_array_to_c_hex(const uint64_t* ary, size_t sz, const char* name)
+{
+    printf("static const uint64_t %s[%d] = {\n", name, (int)sz);
+    size_t i = 0;
+    for (;;) {
+        printf("0x%016llxull", (unsigned long long) ary[i]);
+        ++i;
+        if (i == sz) break;
+        if (i % 2 == 0) {
+            printf(",\n");
+        } else {
+            printf(", ");
+        }
+    }
+    printf("\n};\n\n");
+}
 
 /**
  * prints char array as a c program snippet
@@ -35,6 +35,15 @@ void uint32_array_to_c(const uint32_t* ary, size_t size, const char* name);
  */
 void uint32_array_to_c_hex(const uint32_t* ary, size_t size, const char* name);
 
+/** \brief output an uint64_t array into source code as hex values
+ *
+ * \param[in] ary the input array
+ * \param[in] size number of elements in array
+ * \param[in] name the name of the struct for source code
+ *
+ */
+void uint64_array_to_c_hex(const uint64_t* ary, size_t size, const char* name);
+
 /** \brief output a char array into source code
  *
  * \param[in] ary the input array
@@ -46,8 +46,90 @@
 #include "modp_stdint.h"
 #include "modp_ascii_data.h"
 
+/*
+ * SSE2 and AVX2 case conversion, 16 or 32 bytes per step, picked at
+ * runtime.  Adding 0x80 - 'a' (or 'A') moves the 26 letters to the
+ * bottom of the signed byte range, where one compare finds them, and
+ * flipping 0x20 changes their case.  Tails go through the code below.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ASCII_SIMD 1
+#include <immintrin.h>
+
+#define ASCII_SSE2 __attribute__((target("sse2")))
+#define ASCII_AVX2 __attribute__((target("avx2")))
+
+/*
+ * 0: portable code only, 1: SSE2, 2: AVX2
+ */
+static int ascii_simd_level(void)
+{
+    static int level = -1;
+    if (level < 0) {
+        __builtin_cpu_init();
+        level = __builtin_cpu_supports("avx2") ? 2 :
+            __builtin_cpu_supports("sse2") ? 1 : 0;
+    }
+    return level;
+}
+
+/*
+ * flips the case of chars in first..first+25, returns bytes done
+ */
+ASCII_SSE2 static inline size_t ascii_flip_sse2(char* dest, const char* str,
+                                         size_t len, char first)
+{
+    const __m128i shift = _mm_set1_epi8((char)(0x80 - first));
+    const __m128i limit = _mm_set1_epi8(-128 + 26);
+    const __m128i flip = _mm_set1_epi8(0x20);
+    size_t i;
+    for (i = 0; i + 16 <= len; i += 16) {
+        const __m128i in = _mm_loadu_si128((const __m128i*)(str + i));
+        const __m128i hit = _mm_cmpgt_epi8(limit, _mm_add_epi8(in, shift));
+        _mm_storeu_si128((__m128i*)(dest + i),
+                         _mm_xor_si128(in, _mm_and_si128(hit, flip)));
+    }
+    return i;
+}
+
+ASCII_AVX2 static size_t ascii_flip_avx2(char* dest, const char* str,
+                                         size_t len, char first)
+{
+    const __m256i shift = _mm256_set1_epi8((char)(0x80 - first));
+    const __m256i limit = _mm256_set1_epi8(-128 + 26);
+    const __m256i flip = _mm256_set1_epi8(0x20);
+    size_t i;
+    for (i = 0; i + 32 <= len; i += 32) {
+        const __m256i in = _mm256_loadu_si256((const __m256i*)(str + i));
+        const __m256i hit = _mm256_cmpgt_epi8(limit,
+                                              _mm256_add_epi8(in, shift));
+        _mm256_storeu_si256((__m256i*)(dest + i),
+                            _mm256_xor_si256(in, _mm256_and_si256(hit, flip)));
+    }
+    return i + ascii_flip_sse2(dest + i, str + i, len - i, first);
+}
+
+static size_t ascii_flip(char* dest, const char* str, size_t len, char first)
+{
+    switch (ascii_simd_level()) {
+    case 2:
+        return ascii_flip_avx2(dest, str, len, first);
+    case 1:
+        return ascii_flip_sse2(dest, str, len, first);
+    }
+    return 0;
+}
+#endif /* __GNUC__ && x86 */
+
 void modp_toupper_copy(char* dest, const char* str, size_t len)
 {
+#ifdef ASCII_SIMD
+    const size_t done = ascii_flip(dest, str, len, 'a');
+    dest += done;
+    str += done;
+    len -= done;
+#endif
+
     size_t i;
     uint32_t eax, ebx;
     const uint8_t* ustr = (const uint8_t*) str;
@@ -79,6 +161,13 @@ void modp_toupper_copy(char* dest, const char* str, size_t len)
 
 void modp_tolower_copy(char* dest, const char* str, size_t len)
 {
+#ifdef ASCII_SIMD
+    const size_t done = ascii_flip(dest, str, len, 'A');
+    dest += done;
+    str += done;
+    len -= done;
+#endif
+
     size_t i;
     uint32_t eax, ebx;
     const uint8_t* ustr = (const uint8_t*) str;
@@ -46,15 +46,110 @@
 #include "modp_stdint.h"
 #include "modp_b16_data.h"
 
+/*
+ * SSE2 and AVX2 encoders, 16 or 32 input bytes per step, picked at
+ * runtime.  Each nibble n becomes n + '0', plus 7 when it is over 9,
+ * and the high and low nibbles are interleaved back into byte order.
+ * Tails go through the table code below.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define B16_SIMD 1
+#include <immintrin.h>
+
+#define B16_SSE2 __attribute__((target("sse2")))
+#define B16_AVX2 __attribute__((target("avx2")))
+
+/*
+ * 0: table code only, 1: SSE2, 2: AVX2
+ */
+static int b16_simd_level(void)
+{
+    static int level = -1;
+    if (level < 0) {
+        __builtin_cpu_init();
+        level = __builtin_cpu_supports("avx2") ? 2 :
+            __builtin_cpu_supports("sse2") ? 1 : 0;
+    }
+    return level;
+}
+
+B16_SSE2 static inline __m128i b16_hexchars(__m128i n)
+{
+    const __m128i letters = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(n, _mm_set1_epi8('0')),
+                        _mm_and_si128(letters, _mm_set1_epi8('A' - '0' - 10)));
+}
+
+/*
+ * returns the number of input bytes encoded
+ */
+B16_SSE2 static inline size_t b16_encode_sse2(uint8_t* p, const uint8_t* s,
+                                       size_t len)
+{
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t i;
+    for (i = 0; i + 16 <= len; i += 16) {
+        const __m128i in = _mm_loadu_si128((const __m128i*)(s + i));
+        const __m128i hi = b16_hexchars(
+            _mm_and_si128(_mm_srli_epi16(in, 4), nibble));
+        const __m128i lo = b16_hexchars(_mm_and_si128(in, nibble));
+        _mm_storeu_si128((__m128i*) p, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(p + 16), _mm_unpackhi_epi8(hi, lo));
+        p += 32;
+    }
+    return i;
+}
+
+B16_AVX2 static inline __m256i b16_hexchars_avx2(__m256i n)
+{
+    const __m256i letters = _mm256_cmpgt_epi8(n, _mm256_set1_epi8(9));
+    return _mm256_add_epi8(_mm256_add_epi8(n, _mm256_set1_epi8('0')),
+                           _mm256_and_si256(letters,
+                                            _mm256_set1_epi8('A' - '0' - 10)));
+}
+
+B16_AVX2 static size_t b16_encode_avx2(uint8_t* p, const uint8_t* s,
+                                       size_t len)
+{
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t i;
+    for (i = 0; i + 32 <= len; i += 32) {
+        const __m256i in = _mm256_loadu_si256((const __m256i*)(s + i));
+        const __m256i hi = b16_hexchars_avx2(
+            _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble));
+        const __m256i lo = b16_hexchars_avx2(_mm256_and_si256(in, nibble));
+        /* unpack works per 128 bit lane, so put the lanes back in order */
+        const __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        const __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i*) p, _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i*)(p + 32),
+                            _mm256_permute2x128_si256(a, b, 0x31));
+        p += 64;
+    }
+    return i + b16_encode_sse2(p, s + i, len - i);
+}
+#endif /* __GNUC__ && x86 */
+
 size_t modp_b16_encode(char* dest, const char* str, size_t len)
 {
     size_t i;
-    const size_t buckets = len >> 2; // i.e. i / 4
-    const size_t leftover = len & 0x03; // i.e. i % 4
+    size_t done = 0;
+#ifdef B16_SIMD
+    switch (b16_simd_level()) {
+    case 2:
+        done = b16_encode_avx2((uint8_t*) dest, (const uint8_t*) str, len);
+        break;
+    case 1:
+        done = b16_encode_sse2((uint8_t*) dest, (const uint8_t*) str, len);
+        break;
+    }
+#endif
+    const size_t buckets = (len - done) >> 2; // i.e. i / 4
+    const size_t leftover = (len - done) & 0x03; // i.e. i % 4
 
-    uint8_t* p = (uint8_t*) dest;
+    uint8_t* p = (uint8_t*) dest + 2 * done;
     uint8_t t1, t2, t3, t4;
-    const uint32_t* srcInt = (const uint32_t*) str;
+    const uint32_t* srcInt = (const uint32_t*)(str + done);
     uint32_t x;
     for (i = 0; i < buckets; ++i) {
         x = *srcInt++;
@@ -82,6 +82,57 @@ size_t modp_b64_encode(char* dest, const char* str, size_t len);
  */
 size_t modp_b64_decode(char* dest, const char* src, size_t len);
 
+/**
+ * \brief State for decoding a b64 string that arrives in pieces
+ *
+ * Holds the trailing partial (or last) quad between calls, so memory
+ * use does not depend on the size of the input.
+ */
+struct modp_b64_stream_t {
+    char buf[4];
+    size_t n;
+    int error;
+};
+
+/**
+ * \brief Start a new streaming decode
+ */
+void modp_b64_decode_stream_init(struct modp_b64_stream_t* st);
+
+/**
+ * \brief Decode the next piece of a b64 string
+ *
+ * The input may be split anywhere.  Concatenating the output of all
+ * calls and of modp_b64_decode_stream_finish gives the same bytes as
+ * modp_b64_decode on the whole input, and -1 is returned (by this
+ * call or a later one) exactly when modp_b64_decode would fail.
+ *
+ * \param[in,out] st state from modp_b64_decode_stream_init
+ * \param[out] dest at least modp_b64_decode_stream_len(len) bytes.
+ *   Must not overlap src.
+ * \param[in] src the next len chars of input
+ * \param[in] len length of src
+ * \return the number of bytes written, or -1 on a decoding error
+ */
+size_t modp_b64_decode_stream(struct modp_b64_stream_t* st, char* dest,
+                              const char* src, size_t len);
+
+/**
+ * \brief Decode whatever is held back at the end of the input
+ *
+ * \param[in,out] st state from modp_b64_decode_stream_init
+ * \param[out] dest at least 3 bytes
+ * \return the number of bytes written, or -1 if the input as a whole
+ *   was not valid
+ */
+size_t modp_b64_decode_stream_finish(struct modp_b64_stream_t* st,
+                                     char* dest);
+
+/**
+ * \brief Output space for one modp_b64_decode_stream call
+ */
+#define modp_b64_decode_stream_len(A) ((A + 4) / 4 * 3 + 2)
+
 /**
  * Given a source string of length len, this returns the amount of
  * memory the destination string should have.
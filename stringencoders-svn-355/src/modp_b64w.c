@@ -76,9 +76,257 @@
 #define CHARPAD '\0'
 #endif
 
-size_t modp_b64w_encode(char* dest, const char* str, size_t len)
+/*
+ * SIMD kernels for x86 (SSSE3 and AVX2), picked at runtime.
+ *
+ * Encoding turns 12 (24) input bytes into 16 (32) chars per iteration:
+ * pshufb spreads each 3 byte group over 4 bytes, two multiplies move
+ * the 6 bit fields into place, and a pshufb lookup adds the per-range
+ * offset that maps 0..63 onto the alphabet.
+ *
+ * Decoding validates 16 (32) chars with two pshufb lookups, one on the
+ * low and one on the high nibble, whose AND is non-zero for any char
+ * outside the alphabet.  A third lookup on the high nibble gives the
+ * offset back to 0..63, CHAR62 and CHAR63 are patched in, and two
+ * multiply-adds and a pshufb pack the fields into bytes.
+ *
+ * All tables are built by the macros below from CHAR62 and CHAR63, so
+ * the b64ww and b64wr versions generated from this file work unchanged.
+ * The kernels handle whole blocks; tails go through the table code and
+ * the output is byte for byte the same.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(WORDS_BIGENDIAN)
+#define B64_SIMD 1
+#endif
+
+#ifdef B64_SIMD
+#include <immintrin.h>
+
+#define B64_SSSE3 __attribute__((target("ssse3")))
+#define B64_AVX2 __attribute__((target("avx2")))
+
+/*
+ * encode: 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+ */
+#define B64_ENC_OFFSETS                                                 \
+    'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,         \
+    '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,                   \
+    (char)(CHAR62 - 62), (char)(CHAR63 - 63), 'A', 0, 0
+
+#define B64_ENC_SHUFFLE                                                 \
+    1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10
+
+/*
+ * decode: high nibbles 0, 1 and 8..15 never hold a valid char and
+ * share bit 0x01; 2..7 get a bit each.  The low nibble table has the
+ * bit set for every high nibble where that char is invalid.
+ */
+#define B64_VALID(c)                                                    \
+    (((c) >= 'A' && (c) <= 'Z') || ((c) >= 'a' && (c) <= 'z') ||        \
+     ((c) >= '0' && (c) <= '9') || (c) == CHAR62 || (c) == CHAR63)
+
+#define B64_BAD(l)                                                      \
+    (0x01 | (B64_VALID(0x20 | (l)) ? 0 : 0x02) |                        \
+     (B64_VALID(0x30 | (l)) ? 0 : 0x04) |                               \
+     (B64_VALID(0x40 | (l)) ? 0 : 0x08) |                               \
+     (B64_VALID(0x50 | (l)) ? 0 : 0x10) |                               \
+     (B64_VALID(0x60 | (l)) ? 0 : 0x20) |                               \
+     (B64_VALID(0x70 | (l)) ? 0 : 0x40))
+
+#define B64_DEC_BAD_LO                                                  \
+    B64_BAD(0), B64_BAD(1), B64_BAD(2), B64_BAD(3),                     \
+    B64_BAD(4), B64_BAD(5), B64_BAD(6), B64_BAD(7),                     \
+    B64_BAD(8), B64_BAD(9), B64_BAD(10), B64_BAD(11),                   \
+    B64_BAD(12), B64_BAD(13), B64_BAD(14), B64_BAD(15)
+
+#define B64_DEC_BAD_HI                                                  \
+    0x01, 0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,                     \
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01
+
+#define B64_SHIFT(h)                                                    \
+    ((h) == 3 ? 52 - '0' : (h) == 4 || (h) == 5 ? -'A' :                \
+     (h) == 6 || (h) == 7 ? 26 - 'a' : 0)
+
+#define B64_DEC_SHIFT                                                   \
+    0, 0, 0, B64_SHIFT(3), B64_SHIFT(4), B64_SHIFT(5), B64_SHIFT(6),    \
+    B64_SHIFT(7), 0, 0, 0, 0, 0, 0, 0, 0
+
+/* what CHAR62 and CHAR63 need on top of their high nibble shift */
+#define B64_FIX62 ((char)(62 - CHAR62 - B64_SHIFT(CHAR62 >> 4)))
+#define B64_FIX63 ((char)(63 - CHAR63 - B64_SHIFT(CHAR63 >> 4)))
+
+#define B64_DEC_SHUFFLE                                                 \
+    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1
+
+/*
+ * 0: table code only, 1: SSSE3, 2: AVX2
+ */
+static int b64w_simd_level(void)
 {
+    static int level = -1;
+    if (level < 0) {
+        __builtin_cpu_init();
+        level = __builtin_cpu_supports("avx2") ? 2 :
+            __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+    return level;
+}
+
+B64_SSSE3 static inline __m128i b64w_enc_block(__m128i in)
+{
+    /* bytes s0 s1 s2 -> s1 s0 s2 s1, then move the 4 fields to the
+     * low bits of each output byte */
+    in = _mm_shuffle_epi8(in, _mm_setr_epi8(B64_ENC_SHUFFLE));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    in = _mm_or_si128(t1, t3);
+
+    __m128i idx = _mm_subs_epu8(in, _mm_set1_epi8(51));
+    const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), in);
+    idx = _mm_or_si128(idx, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(in, _mm_shuffle_epi8(
+                            _mm_setr_epi8(B64_ENC_OFFSETS), idx));
+}
+
+/*
+ * returns the number of input bytes consumed, always a multiple of 3
+ */
+B64_SSSE3 static size_t b64w_encode_ssse3(uint8_t* p, const uint8_t* s,
+                                         size_t len)
+{
+    size_t i;
+    /* 16 bytes are loaded, 12 used */
+    for (i = 0; i + 16 <= len; i += 12) {
+        _mm_storeu_si128((__m128i*) p,
+                         b64w_enc_block(_mm_loadu_si128((const __m128i*)(s + i))));
+        p += 16;
+    }
+    return i;
+}
+
+/*
+ * Decodes whole 4 char chunks.  Returns the number of chunks decoded or
+ * -1 on a char outside the alphabet.  Each block writes 4 bytes past its
+ * output, so at least one chunk is always left for the table code.
+ */
+B64_SSSE3 static size_t b64w_decode_ssse3(uint8_t* p, const char* src,
+                                         size_t chunks)
+{
+    const __m128i bad_lo = _mm_setr_epi8(B64_DEC_BAD_LO);
+    const __m128i bad_hi = _mm_setr_epi8(B64_DEC_BAD_HI);
+    const __m128i shifts = _mm_setr_epi8(B64_DEC_SHIFT);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    size_t i;
+    for (i = 0; i + 4 < chunks; i += 4) {
+        const __m128i in = _mm_loadu_si128((const __m128i*)(src + 4*i));
+        const __m128i hi = _mm_and_si128(_mm_srli_epi32(in, 4), nibble);
+        const __m128i lo = _mm_and_si128(in, nibble);
+        const __m128i bad = _mm_and_si128(_mm_shuffle_epi8(bad_lo, lo),
+                                          _mm_shuffle_epi8(bad_hi, hi));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(bad, _mm_setzero_si128()))
+            != 0xFFFF) {
+            return (size_t)-1;
+        }
+        __m128i x = _mm_add_epi8(in, _mm_shuffle_epi8(shifts, hi));
+        x = _mm_add_epi8(x, _mm_and_si128(
+                             _mm_cmpeq_epi8(in, _mm_set1_epi8(CHAR62)),
+                             _mm_set1_epi8(B64_FIX62)));
+        x = _mm_add_epi8(x, _mm_and_si128(
+                             _mm_cmpeq_epi8(in, _mm_set1_epi8(CHAR63)),
+                             _mm_set1_epi8(B64_FIX63)));
+        /* 4 x 6 bits -> one 24 bit value per 32 bit lane -> 3 bytes */
+        x = _mm_maddubs_epi16(x, _mm_set1_epi32(0x01400140));
+        x = _mm_madd_epi16(x, _mm_set1_epi32(0x00011000));
+        x = _mm_shuffle_epi8(x, _mm_setr_epi8(B64_DEC_SHUFFLE));
+        _mm_storeu_si128((__m128i*) p, x);
+        p += 12;
+    }
+    return i;
+}
+
+/*
+ * AVX2 versions: the same steps on two 128 bit lanes
+ */
+B64_AVX2 static size_t b64w_encode_avx2(uint8_t* p, const uint8_t* s,
+                                       size_t len)
+{
+    const __m256i shuffle = _mm256_setr_epi8(B64_ENC_SHUFFLE,
+                                             B64_ENC_SHUFFLE);
+    const __m256i offsets = _mm256_setr_epi8(B64_ENC_OFFSETS,
+                                             B64_ENC_OFFSETS);
     size_t i;
+    /* bytes i..i+11 go to the low lane, i+12..i+23 to the high one */
+    for (i = 0; i + 28 <= len; i += 24) {
+        __m256i in = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(s + i))),
+            _mm_loadu_si128((const __m128i*)(s + i + 12)), 1);
+        in = _mm256_shuffle_epi8(in, shuffle);
+        const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        const __m256i t1 = _mm256_mulhi_epu16(t0,
+                                              _mm256_set1_epi32(0x04000040));
+        const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        const __m256i t3 = _mm256_mullo_epi16(t2,
+                                              _mm256_set1_epi32(0x01000010));
+        in = _mm256_or_si256(t1, t3);
+
+        __m256i idx = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+        const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), in);
+        idx = _mm256_or_si256(idx,
+                              _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        _mm256_storeu_si256((__m256i*) p, _mm256_add_epi8(
+                                in, _mm256_shuffle_epi8(offsets, idx)));
+        p += 32;
+    }
+    return i + b64w_encode_ssse3(p, s + i, len - i);
+}
+
+B64_AVX2 static size_t b64w_decode_avx2(uint8_t* p, const char* src,
+                                       size_t chunks)
+{
+    const __m256i bad_lo = _mm256_setr_epi8(B64_DEC_BAD_LO, B64_DEC_BAD_LO);
+    const __m256i bad_hi = _mm256_setr_epi8(B64_DEC_BAD_HI, B64_DEC_BAD_HI);
+    const __m256i shifts = _mm256_setr_epi8(B64_DEC_SHIFT, B64_DEC_SHIFT);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    size_t i;
+    for (i = 0; i + 8 <= chunks; i += 8) {
+        const __m256i in = _mm256_loadu_si256((const __m256i*)(src + 4*i));
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi32(in, 4), nibble);
+        const __m256i lo = _mm256_and_si256(in, nibble);
+        const __m256i bad = _mm256_and_si256(_mm256_shuffle_epi8(bad_lo, lo),
+                                             _mm256_shuffle_epi8(bad_hi, hi));
+        if (!_mm256_testz_si256(bad, bad)) {
+            return (size_t)-1;
+        }
+        __m256i x = _mm256_add_epi8(in, _mm256_shuffle_epi8(shifts, hi));
+        x = _mm256_add_epi8(x, _mm256_and_si256(
+                                _mm256_cmpeq_epi8(in, _mm256_set1_epi8(CHAR62)),
+                                _mm256_set1_epi8(B64_FIX62)));
+        x = _mm256_add_epi8(x, _mm256_and_si256(
+                                _mm256_cmpeq_epi8(in, _mm256_set1_epi8(CHAR63)),
+                                _mm256_set1_epi8(B64_FIX63)));
+        x = _mm256_maddubs_epi16(x, _mm256_set1_epi32(0x01400140));
+        x = _mm256_madd_epi16(x, _mm256_set1_epi32(0x00011000));
+        x = _mm256_shuffle_epi8(x, _mm256_setr_epi8(B64_DEC_SHUFFLE,
+                                                    B64_DEC_SHUFFLE));
+        /* 12 bytes per lane -> 24 contiguous bytes, stored exactly */
+        x = _mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 1, 2, 4, 5, 6,
+                                                             3, 7));
+        _mm_storeu_si128((__m128i*) p, _mm256_castsi256_si128(x));
+        _mm_storel_epi64((__m128i*)(p + 16), _mm256_extracti128_si256(x, 1));
+        p += 24;
+    }
+    const size_t rest = b64w_decode_ssse3(p, src + 4*i, chunks - i);
+    return rest == (size_t)-1 ? rest : i + rest;
+}
+
+#endif /* B64_SIMD */
+
+size_t modp_b64w_encode(char* dest, const char* str, size_t len)
+{
+    size_t i = 0;
     const uint8_t* s = (const uint8_t*) str;
     uint8_t* p = (uint8_t*) dest;
 
@@ -87,12 +335,26 @@ size_t modp_b64w_encode(char* dest, const char* str, size_t len)
     /* uint32_t is fastest on Intel */
     uint32_t t1, t2, t3;
 
-    for (i = 0; i < len - 2; i += 3) {
-        t1 = s[i]; t2 = s[i+1]; t3 = s[i+2];
-        *p++ = e0[t1];
-        *p++ = e1[((t1 & 0x03) << 4) | ((t2 >> 4) & 0x0F)];
-        *p++ = e1[((t2 & 0x0F) << 2) | ((t3 >> 6) & 0x03)];
-        *p++ = e2[t3];
+#ifdef B64_SIMD
+    switch (b64w_simd_level()) {
+    case 2:
+        i = b64w_encode_avx2(p, s, len);
+        break;
+    case 1:
+        i = b64w_encode_ssse3(p, s, len);
+        break;
+    }
+    p += i / 3 * 4;
+#endif
+
+    if (len > 2) {
+        for (; i < len - 2; i += 3) {
+            t1 = s[i]; t2 = s[i+1]; t3 = s[i+2];
+            *p++ = e0[t1];
+            *p++ = e1[((t1 & 0x03) << 4) | ((t2 >> 4) & 0x0F)];
+            *p++ = e1[((t2 & 0x0F) << 2) | ((t3 >> 6) & 0x03)];
+            *p++ = e2[t3];
+        }
     }
 
     switch (len - i) {
@@ -114,7 +376,7 @@ size_t modp_b64w_encode(char* dest, const char* str, size_t len)
     }
 
     *p = '\0';
-    return (int)(p - (uint8_t*)dest);
+    return (size_t)(p - (uint8_t*)dest);
 }
 
 #ifdef WORDS_BIGENDIAN   /* BIG ENDIAN -- SUN / IBM / MOTOROLA */
@@ -136,8 +398,8 @@ size_t modp_b64w_decode(char* dest, const char* src, size_t len)
     }
 #endif  /* DOPAD */
 
-    int leftover = len % 4;
-    int chunks = (leftover == 0) ? len / 4 - 1 : len /4;
+    size_t leftover = len % 4;
+    size_t chunks = (leftover == 0) ? len / 4 - 1 : len /4;
 
     uint8_t* p = (uint8_t*) dest;
     uint32_t x = 0;
@@ -198,7 +460,9 @@ size_t modp_b64w_decode(char* dest, const char* src, size_t len)
      * if padding is used, then the message must be at least
      * 4 chars and be a multiple of 4
      */
-    if (len < 4 || (len % 4 != 0)) return -1; /* error */
+    if (len < 4 || (len % 4 != 0)) {
+        return (size_t)-1; /* error */
+    }
     /* there can be at most 2 pad chars at the end */
     if (src[len-1] == CHARPAD) {
         len--;
@@ -212,17 +476,36 @@ size_t modp_b64w_decode(char* dest, const char* src, size_t len)
     size_t chunks = (leftover == 0) ? len / 4 - 1 : len /4;
 
     uint8_t* p = (uint8_t*) dest;
+    i = 0;
+
+#ifdef B64_SIMD
+    switch (b64w_simd_level()) {
+    case 2:
+        i = b64w_decode_avx2(p, src, chunks);
+        break;
+    case 1:
+        i = b64w_decode_ssse3(p, src, chunks);
+        break;
+    }
+    if (i == (size_t)-1) {
+        return (size_t)-1;
+    }
+    p += 3*i;
+#endif
+
     uint32_t x = 0;
     uint32_t* destInt = (uint32_t*) p;
-    uint32_t* srcInt = (uint32_t*) src;
+    const uint32_t* srcInt = (const uint32_t*) (src + 4*i);
     uint32_t y = *srcInt++;
-    for (i = 0; i < chunks; ++i) {
+    for (; i < chunks; ++i) {
         x = d0[y & 0xff] |
             d1[(y >> 8) & 0xff] |
             d2[(y >> 16) & 0xff] |
             d3[(y >> 24) & 0xff];
 
-        if (x >= BADCHAR) return -1;
+        if (x >= BADCHAR) {
+            return (size_t)-1;
+        }
         *destInt = x ;
         p += 3;
         destInt = (uint32_t*)p;
@@ -236,7 +519,9 @@ size_t modp_b64w_decode(char* dest, const char* src, size_t len)
             d2[(y >> 16) & 0xff] |
             d3[(y >> 24) & 0xff];
 
-        if (x >= BADCHAR) return -1;
+        if (x >= BADCHAR) {
+            return (size_t)-1;
+        }
         *p++ =  ((uint8_t*)(&x))[0];
         *p++ =  ((uint8_t*)(&x))[1];
         *p =    ((uint8_t*)(&x))[2];
@@ -261,9 +546,95 @@ size_t modp_b64w_decode(char* dest, const char* src, size_t len)
         break;
     }
 
-    if (x >= BADCHAR) return -1;
+    if (x >= BADCHAR) {
+        return (size_t)-1;
+    }
 
     return 3*chunks + (6*leftover)/8;
 }
 
 #endif  /* if bigendian / else / endif */
+
+/*
+ * Streaming decode.  The last quad seen is always held back since it
+ * is the only one that may carry padding; every quad before it goes
+ * through modp_b64w_decode and must not end in a pad char.
+ */
+static size_t b64w_decode_quads(char* dest, const char* src, size_t len)
+{
+    if (len == 0) {
+        return 0;
+    }
+    if (src[len - 1] == CHARPAD) {
+        return (size_t)-1;
+    }
+    return modp_b64w_decode(dest, src, len);
+}
+
+void modp_b64w_decode_stream_init(struct modp_b64w_stream_t* st)
+{
+    st->n = 0;
+    st->error = 0;
+}
+
+size_t modp_b64w_decode_stream(struct modp_b64w_stream_t* st, char* dest,
+                              const char* src, size_t len)
+{
+    size_t d, total, keep, ndec;
+    char* p = dest;
+
+    if (st->error) {
+        return (size_t)-1;
+    }
+
+    total = st->n + len;
+    if (total <= 4) {
+        memcpy(st->buf + st->n, src, len);
+        st->n = total;
+        return 0;
+    }
+
+    /* hold back the partial quad, or the last full one */
+    keep = (total % 4 != 0) ? total % 4 : 4;
+    ndec = total - keep;
+
+    if (st->n != 0) {
+        const size_t take = 4 - st->n;
+        memcpy(st->buf + st->n, src, take);
+        src += take;
+        len -= take;
+        ndec -= 4;
+        d = b64w_decode_quads(p, st->buf, 4);
+        if (d == (size_t)-1) {
+            st->error = 1;
+            return d;
+        }
+        p += d;
+    }
+
+    d = b64w_decode_quads(p, src, ndec);
+    if (d == (size_t)-1) {
+        st->error = 1;
+        return d;
+    }
+    p += d;
+
+    memcpy(st->buf, src + ndec, len - ndec);
+    st->n = len - ndec;
+    return (size_t)(p - dest);
+}
+
+size_t modp_b64w_decode_stream_finish(struct modp_b64w_stream_t* st,
+                                     char* dest)
+{
+    size_t d;
+    if (st->error) {
+        return (size_t)-1;
+    }
+    d = modp_b64w_decode(dest, st->buf, st->n);
+    st->n = 0;
+    if (d == (size_t)-1) {
+        st->error = 1;
+    }
+    return d;
+}
@@ -83,6 +83,63 @@ size_t modp_b85_decode(char* out, const char* data, size_t len)
     return 4 * buckets;
 }
 
+/*
+ * Streaming decode: whole 5 char buckets go straight to
+ * modp_b85_decode, a partial one waits in the state.
+ */
+void modp_b85_decode_stream_init(struct modp_b85_stream_t* st)
+{
+    st->n = 0;
+    st->error = 0;
+}
+
+size_t modp_b85_decode_stream(struct modp_b85_stream_t* st, char* dest,
+                              const char* src, size_t len)
+{
+    size_t d, bulk;
+    char* p = dest;
+
+    if (st->error) {
+        return (size_t)-1;
+    }
+    if (st->n != 0) {
+        const size_t take = (len < 5 - st->n) ? len : 5 - st->n;
+        memcpy(st->buf + st->n, src, take);
+        st->n += take;
+        src += take;
+        len -= take;
+        if (st->n < 5) {
+            return 0;
+        }
+        if (modp_b85_decode(p, st->buf, 5) == (size_t)-1) {
+            st->error = 1;
+            return (size_t)-1;
+        }
+        p += 4;
+        st->n = 0;
+    }
+
+    bulk = len - len % 5;
+    d = modp_b85_decode(p, src, bulk);
+    if (d == (size_t)-1) {
+        st->error = 1;
+        return d;
+    }
+    p += d;
+    memcpy(st->buf, src + bulk, len - bulk);
+    st->n = len - bulk;
+    return (size_t)(p - dest);
+}
+
+size_t modp_b85_decode_stream_finish(struct modp_b85_stream_t* st)
+{
+    if (st->error || st->n != 0) {
+        st->error = 1;
+        return (size_t)-1;
+    }
+    return 0;
+}
+
 /**
  * src != out
  */
@@ -73,6 +73,46 @@ size_t modp_b85_decode(char* dest, const char* src, size_t len);
  */
 #define modp_b85_decode_len(A) ((A + 4) / 5 * 4)
 
+/**
+ * \brief State for decoding a base 85 string that arrives in pieces
+ *
+ * Holds a partial 5 char bucket between calls.
+ */
+struct modp_b85_stream_t {
+    char buf[5];
+    size_t n;
+    int error;
+};
+
+/**
+ * \brief Start a new streaming decode
+ */
+void modp_b85_decode_stream_init(struct modp_b85_stream_t* st);
+
+/**
+ * \brief Decode the next piece of a base 85 string
+ *
+ * The input may be split anywhere.  The output of all calls put
+ * together is the same as modp_b85_decode on the whole input.
+ *
+ * \param[in,out] st state from modp_b85_decode_stream_init
+ * \param[out] dest at least modp_b85_decode_len(len + 4) bytes.
+ *   Must not overlap src.
+ * \param[in] src the next len chars of input
+ * \param[in] len length of src
+ * \return the number of bytes written, or -1 on a decoding error
+ */
+size_t modp_b85_decode_stream(struct modp_b85_stream_t* st, char* dest,
+                              const char* src, size_t len);
+
+/**
+ * \brief Finish a streaming decode
+ *
+ * \return 0, or -1 if there was an error or the input length was not
+ *   a multiple of 5
+ */
+size_t modp_b85_decode_stream_finish(struct modp_b85_stream_t* st);
+
 #include "extern_c_end.h"
 
 #ifdef __cplusplus
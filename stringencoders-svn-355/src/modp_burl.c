@@ -44,6 +44,140 @@
 #include "modp_stdint.h"
 #include "modp_burl_data.h"
 
+/*
+ * SSSE3 and AVX2 encoders, picked at runtime.  Each block of 16 or 32
+ * chars is classified with two nibble lookups (see modp_burl_gen.c):
+ * a block with nothing to escape is stored as is, with space turned
+ * into '+', and any other block is encoded char by char.  Text that
+ * is mostly safe, which is the common case, runs at copy speed.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BURL_SIMD 1
+#include <immintrin.h>
+
+#define BURL_SSSE3 __attribute__((target("ssse3")))
+#define BURL_AVX2 __attribute__((target("avx2")))
+
+/*
+ * 0: portable code only, 1: SSSE3, 2: AVX2
+ */
+static int burl_simd_level(void)
+{
+    static int level = -1;
+    if (level < 0) {
+        __builtin_cpu_init();
+        level = __builtin_cpu_supports("avx2") ? 2 :
+            __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+    return level;
+}
+
+static char* burl_encode_chars(char* dest, const uint8_t* s, size_t len,
+                               const unsigned char* map)
+{
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        const uint8_t x = s[i];
+        const char c = (char) map[x];
+        if (c) {
+            *dest++ = c;
+        } else {
+            *dest++ = '%';
+            *dest++ = (char) gsHexEncodeMap1[x];
+            *dest++ = (char) gsHexEncodeMap2[x];
+        }
+    }
+    return dest;
+}
+
+/*
+ * bit h of hibits[h] is set for h < 8, so (lo & hi) != 0 exactly when
+ * the char is safe; chars >= 0x80 always look up 0
+ */
+#define BURL_HIBITS 1, 2, 4, 8, 16, 32, 64, (char) 128, 0, 0, 0, 0, 0, 0, 0, 0
+
+/*
+ * encodes whole blocks, returns the number of source bytes done
+ */
+BURL_SSSE3 static inline size_t burl_encode_ssse3(char** destp, const uint8_t* s,
+                                           size_t len,
+                                           const unsigned char* map,
+                                           const unsigned char* nibbles)
+{
+    const __m128i lut_lo = _mm_loadu_si128((const __m128i*) nibbles);
+    const __m128i lut_hi = _mm_setr_epi8(BURL_HIBITS);
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i plus = _mm_set1_epi8('+' - ' ');
+    char* dest = *destp;
+    size_t i;
+    for (i = 0; i + 16 <= len; i += 16) {
+        const __m128i in = _mm_loadu_si128((const __m128i*)(s + i));
+        const __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, mask));
+        const __m128i hi = _mm_shuffle_epi8(lut_hi,
+            _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+        const __m128i bad = _mm_cmpeq_epi8(_mm_and_si128(lo, hi),
+                                           _mm_setzero_si128());
+        if (_mm_movemask_epi8(bad) == 0) {
+            const __m128i sp = _mm_and_si128(_mm_cmpeq_epi8(in, space), plus);
+            _mm_storeu_si128((__m128i*) dest, _mm_add_epi8(in, sp));
+            dest += 16;
+        } else {
+            dest = burl_encode_chars(dest, s + i, 16, map);
+        }
+    }
+    *destp = dest;
+    return i;
+}
+
+BURL_AVX2 static size_t burl_encode_avx2(char** destp, const uint8_t* s,
+                                         size_t len,
+                                         const unsigned char* map,
+                                         const unsigned char* nibbles)
+{
+    const __m256i lut_lo = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) nibbles));
+    const __m256i lut_hi = _mm256_setr_epi8(BURL_HIBITS, BURL_HIBITS);
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i plus = _mm256_set1_epi8('+' - ' ');
+    char* dest = *destp;
+    size_t i;
+    for (i = 0; i + 32 <= len; i += 32) {
+        const __m256i in = _mm256_loadu_si256((const __m256i*)(s + i));
+        const __m256i lo = _mm256_shuffle_epi8(lut_lo,
+                                               _mm256_and_si256(in, mask));
+        const __m256i hi = _mm256_shuffle_epi8(lut_hi,
+            _mm256_and_si256(_mm256_srli_epi16(in, 4), mask));
+        const __m256i bad = _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi),
+                                              _mm256_setzero_si256());
+        if (_mm256_movemask_epi8(bad) == 0) {
+            const __m256i sp = _mm256_and_si256(_mm256_cmpeq_epi8(in, space),
+                                                plus);
+            _mm256_storeu_si256((__m256i*) dest, _mm256_add_epi8(in, sp));
+            dest += 32;
+        } else {
+            dest = burl_encode_chars(dest, s + i, 32, map);
+        }
+    }
+    *destp = dest;
+    return i + burl_encode_ssse3(destp, s + i, len - i, map, nibbles);
+}
+
+static size_t burl_encode_simd(char** destp, const uint8_t* s, size_t len,
+                               const unsigned char* map,
+                               const unsigned char* nibbles)
+{
+    switch (burl_simd_level()) {
+    case 2:
+        return burl_encode_avx2(destp, s, len, map, nibbles);
+    case 1:
+        return burl_encode_ssse3(destp, s, len, map, nibbles);
+    }
+    return 0;
+}
+#endif /* __GNUC__ && x86 */
+
 size_t modp_burl_encode(char* dest, const char* src, size_t len)
 {
 
@@ -53,6 +187,9 @@ size_t modp_burl_encode(char* dest, const char* src, size_t len)
     char c;
     uint8_t x;
 
+#ifdef BURL_SIMD
+    s += burl_encode_simd(&dest, s, len, gsUrlEncodeMap, gsUrlSafeNibbles);
+#endif
     while (s < srcend) {
         x = *s++;
         c = (char)gsUrlEncodeMap[x];
@@ -87,6 +224,9 @@ size_t modp_burl_min_encode(char* dest, const char* src, size_t len)
     char c;
     uint8_t x;
 
+#ifdef BURL_SIMD
+    s += burl_encode_simd(&dest, s, len, gsUrlEncodeMinMap, gsUrlMinSafeNibbles);
+#endif
     while (s < srcend) {
         x = *s++;
         c = (char)(gsUrlEncodeMinMap[x]); /** CHANGE HERE **/
@@ -226,3 +366,90 @@ size_t modp_burl_decode_raw(char* dest, const char* s, size_t len)
     *dest = '\0';
     return (size_t)(dest - deststart); // compute "strlen" of dest.
 }
+
+/*
+ * Streaming decode.  A '%' in the last two chars of a piece cannot be
+ * decided yet, so it is held back (with the char after it) until the
+ * next piece arrives.  A '%' can never be a hex digit of an earlier
+ * escape, so everything before it decodes exactly as in the one-shot
+ * functions.
+ */
+void modp_burl_decode_stream_init(struct modp_burl_stream_t* st)
+{
+    st->n = 0;
+    st->raw = 0;
+}
+
+void modp_burl_decode_raw_stream_init(struct modp_burl_stream_t* st)
+{
+    st->n = 0;
+    st->raw = 1;
+}
+
+size_t modp_burl_decode_stream(struct modp_burl_stream_t* st, char* dest,
+                               const char* src, size_t len)
+{
+    char* p = dest;
+    size_t cut;
+
+    /* settle a held back '%' once the two chars after it are here */
+    while (st->n != 0 && st->n + len >= 3) {
+        char tmp[3];
+        const size_t take = 3 - st->n;
+        memcpy(tmp, st->buf, st->n);
+        memcpy(tmp + st->n, src, take);
+        const uint32_t d = (gsHexDecodeMap[(uint8_t) tmp[1]] << 4) |
+            gsHexDecodeMap[(uint8_t) tmp[2]];
+        if (d < 256) {
+            *p++ = (char) d;
+            src += take;
+            len -= take;
+            st->n = 0;
+        } else {
+            *p++ = '%';
+            if (st->n == 2) {
+                const char c = st->buf[1];
+                if (c == '%') {
+                    st->n = 1;
+                    continue;
+                }
+                *p++ = (c == '+' && !st->raw) ? ' ' : c;
+            }
+            st->n = 0;
+        }
+    }
+    if (st->n != 0) {
+        memcpy(st->buf + st->n, src, len);
+        st->n += len;
+        *p = '\0';
+        return (size_t)(p - dest);
+    }
+
+    cut = len;
+    if (len >= 2 && src[len - 2] == '%') {
+        cut = len - 2;
+    } else if (len >= 1 && src[len - 1] == '%') {
+        cut = len - 1;
+    }
+    if (st->raw) {
+        p += modp_burl_decode_raw(p, src, cut);
+    } else {
+        p += modp_burl_decode(p, src, cut);
+    }
+    memcpy(st->buf, src + cut, len - cut);
+    st->n = len - cut;
+    *p = '\0';
+    return (size_t)(p - dest);
+}
+
+size_t modp_burl_decode_stream_finish(struct modp_burl_stream_t* st,
+                                      char* dest)
+{
+    size_t i;
+    for (i = 0; i < st->n; ++i) {
+        dest[i] = (st->buf[i] == '+' && !st->raw) ? ' ' : st->buf[i];
+    }
+    dest[i] = '\0';
+    st->n = 0;
+    return i;
+}
@@ -118,6 +118,59 @@ size_t modp_burl_decode_raw(char* dest, const char* str, size_t len);
  */
 #define modp_burl_decode_len(A) (A + 1)
 
+/**
+ * \brief State for URL decoding a string that arrives in pieces
+ *
+ * Holds back at most a '%' and the char after it between calls.
+ */
+struct modp_burl_stream_t {
+    char buf[2];
+    size_t n;
+    int raw;
+};
+
+/**
+ * \brief Start a streaming decode that works like modp_burl_decode
+ */
+void modp_burl_decode_stream_init(struct modp_burl_stream_t* st);
+
+/**
+ * \brief Start a streaming decode that works like modp_burl_decode_raw
+ */
+void modp_burl_decode_raw_stream_init(struct modp_burl_stream_t* st);
+
+/**
+ * \brief URL decode the next piece of a string
+ *
+ * The input may be split anywhere.  Concatenating the output of all
+ * calls and of modp_burl_decode_stream_finish gives the same string as
+ * decoding the whole input at once.
+ *
+ * \param[in,out] st state from one of the init functions
+ * \param[out] dest at least modp_burl_decode_stream_len(len) bytes.
+ *   Must not overlap src.  The output is null terminated.
+ * \param[in] src the next len chars of input
+ * \param[in] len length of src
+ * \return the strlen of the output
+ */
+size_t modp_burl_decode_stream(struct modp_burl_stream_t* st, char* dest,
+                               const char* src, size_t len);
+
+/**
+ * \brief Write out anything held back at the end of the input
+ *
+ * \param[in,out] st state from one of the init functions
+ * \param[out] dest at least 3 bytes
+ * \return the strlen of the output
+ */
+size_t modp_burl_decode_stream_finish(struct modp_burl_stream_t* st,
+                                      char* dest);
+
+/**
+ * \brief Output space for one modp_burl_decode_stream call
+ */
+#define modp_burl_decode_stream_len(A) (A + 3)
+
 #include "extern_c_end.h"
 
 #ifdef __cplusplus
@@ -27,6 +27,11 @@ static const unsigned char gsUrlEncodeMap[256] = {
 '\0', '\0', '\0', '\0', '\0', '\0'
 };
 
+static const unsigned char gsUrlSafeNibbles[16] = {
+0xac, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8, 0xf8,
+0xf0,  'P',  'P',  'T',  'T',  'p'
+};
+
 static const unsigned char gsUrlEncodeMinMap[256] = {
 '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
 '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
@@ -56,6 +61,11 @@ static const unsigned char gsUrlEncodeMinMap[256] = {
 '\0', '\0', '\0', '\0', '\0', '\0'
 };
 
+static const unsigned char gsUrlMinSafeNibbles[16] = {
+0xbc, 0xfc, 0xf8, 0xf8, 0xfc, 0xf8, 0xf8, 0xf8, 0xfc, 0xfc,
+0xfc,  'X',  'T',  'T', 0xd4,  '|'
+};
+
 static const uint32_t gsHexDecodeMap[256] = {
 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
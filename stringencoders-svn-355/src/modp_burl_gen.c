@@ -18,6 +18,26 @@ static void hexencodemap(void)
     char_array_to_c(hexEncode2, sizeof(hexEncode2), "gsHexEncodeMap2");
 }
 
+/*
+ * For the SIMD encoders: bit h of entry l is set when the char
+ * (h << 4) | l does not need a %XX escape.  Only chars below 0x80 can
+ * be safe, so one byte covers every high nibble.
+ */
+static void safenibblemap(const char* urlEncodeMap, const char* name)
+{
+    int i;
+    char map[16];
+    for (i = 0; i < 16; ++i) {
+        map[i] = 0;
+    }
+    for (i = 0; i < 128; ++i) {
+        if (urlEncodeMap[i]) {
+            map[i & 0x0f] = (char)(map[i & 0x0f] | (1 << (i >> 4)));
+        }
+    }
+    char_array_to_c(map, sizeof(map), name);
+}
+
 static void urlencodemap(void)
 {
     uint32_t i;
@@ -48,6 +68,7 @@ static void urlencodemap(void)
     urlEncodeMap[(int)' '] = '+';
 
     char_array_to_c(urlEncodeMap, sizeof(urlEncodeMap), "gsUrlEncodeMap");
+    safenibblemap(urlEncodeMap, "gsUrlSafeNibbles");
 };
 
 static void urlencodeminmap(void)
@@ -86,6 +107,7 @@ static void urlencodeminmap(void)
 
 
     char_array_to_c(urlEncodeMap, sizeof(urlEncodeMap), "gsUrlEncodeMinMap");
+    safenibblemap(urlEncodeMap, "gsUrlMinSafeNibbles");
 };
 
 static void hexdecodemap(void)
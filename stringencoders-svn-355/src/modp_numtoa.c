@@ -343,3 +343,703 @@ char* modp_uitoa16(uint32_t value, char* str, int isfinal)
         return str + 8;
     }
 }
+
+/*
+ * Shortest round-trip double to string, and the exact inverse.
+ *
+ * modp_dtoa_shortest is Ryu (Ulf Adams, "Ryu: fast float-to-string
+ * conversion", PLDI 2018).  modp_strtod is Clinger's fast path, then
+ * the Eisel-Lemire algorithm (as in Daniel Lemire's fast_float), then
+ * an exact big integer comparison for inputs with more than 19
+ * significant digits that land near a halfway point.  The power of
+ * five tables are made by modp_numtoa_gen.
+ */
+
+#include <float.h>
+#include <errno.h>
+#include "modp_numtoa_data.h"
+
+#define DOUBLE_MANTISSA_BITS 52
+#define DOUBLE_EXPONENT_BITS 11
+#define DOUBLE_BIAS 1023
+#define DOUBLE_POW5_INV_BITCOUNT 125
+#define DOUBLE_POW5_BITCOUNT 125
+
+static inline uint64_t umul128(uint64_t a, uint64_t b, uint64_t* hi)
+{
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 p = (unsigned __int128) a * b;
+    *hi = (uint64_t)(p >> 64);
+    return (uint64_t) p;
+#else
+    const uint64_t alo = (uint32_t) a, ahi = a >> 32;
+    const uint64_t blo = (uint32_t) b, bhi = b >> 32;
+    const uint64_t b00 = alo * blo, b01 = alo * bhi;
+    const uint64_t b10 = ahi * blo, b11 = ahi * bhi;
+    const uint64_t mid1 = b10 + (b00 >> 32);
+    const uint64_t mid2 = b01 + (uint32_t) mid1;
+    *hi = b11 + (mid1 >> 32) + (mid2 >> 32);
+    return (mid2 << 32) | (uint32_t) b00;
+#endif
+}
+
+/* ceil(log2(5^e)), or 1 for e == 0; 0 <= e <= 3528 */
+static inline int32_t pow5bits(int32_t e)
+{
+    return (int32_t)(((uint32_t) e * 1217359) >> 19) + 1;
+}
+
+/* floor(log10(2^e)); 0 <= e <= 1650 */
+static inline uint32_t log10pow2(int32_t e)
+{
+    return ((uint32_t) e * 78913) >> 18;
+}
+
+/* floor(log10(5^e)); 0 <= e <= 2620 */
+static inline uint32_t log10pow5(int32_t e)
+{
+    return ((uint32_t) e * 732923) >> 20;
+}
+
+static inline uint32_t pow5factor(uint64_t value)
+{
+    uint32_t count = 0;
+    while (value % 5 == 0) {
+        value /= 5;
+        ++count;
+    }
+    return count;
+}
+
+static inline int multiple_of_pow5(uint64_t value, uint32_t p)
+{
+    return pow5factor(value) >= p;
+}
+
+static inline int multiple_of_pow2(uint64_t value, uint32_t p)
+{
+    return (value & ((1ull << p) - 1)) == 0;
+}
+
+/* (m * mul) >> j, mul being a 128-bit table entry, low word first */
+static inline uint64_t mulshift64(uint64_t m, const uint64_t* mul, int32_t j)
+{
+    uint64_t high0, high1;
+    uint64_t low1 = umul128(m, mul[1], &high1);
+    umul128(m, mul[0], &high0);
+    const uint64_t sum = high0 + low1;
+    if (sum < high0) {
+        ++high1;
+    }
+    /* 64 < j < 128 for every double */
+    return (high1 << (128 - j)) | (sum >> (j - 64));
+}
+
+static inline uint32_t decimal_length17(uint64_t v)
+{
+    uint32_t n = 1;
+    while (n < 17 && v >= 10) {
+        v /= 10;
+        ++n;
+    }
+    return n;
+}
+
+/*
+ * The shortest output * 10^exponent that reads back as the double
+ * with the given fields (not zero, inf or nan).
+ */
+static uint64_t ryu_d2d(uint64_t ieee_mantissa, uint32_t ieee_exponent,
+                        int32_t* exponent)
+{
+    int32_t e2;
+    uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = (int32_t) ieee_exponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS - 2;
+        m2 = (1ull << DOUBLE_MANTISSA_BITS) | ieee_mantissa;
+    }
+    const int accept_bounds = (m2 & 1) == 0;
+
+    // the interval of decimal representations that round to the input
+    const uint64_t mv = 4 * m2;
+    const uint32_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+
+    uint64_t vr, vp, vm;
+    int32_t e10;
+    int vm_trailing_zeros = 0;
+    int vr_trailing_zeros = 0;
+    if (e2 >= 0) {
+        const uint32_t q = log10pow2(e2) - (e2 > 3);
+        const int32_t k = DOUBLE_POW5_INV_BITCOUNT + pow5bits((int32_t) q) - 1;
+        const int32_t i = -e2 + (int32_t) q + k;
+        const uint64_t* mul = gsDoublePow5InvSplit + 2 * q;
+        e10 = (int32_t) q;
+        vr = mulshift64(4 * m2, mul, i);
+        vp = mulshift64(4 * m2 + 2, mul, i);
+        vm = mulshift64(4 * m2 - 1 - mm_shift, mul, i);
+        if (q <= 21) {
+            // only one of mp, mv and mm can be a multiple of 5, if any
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= (uint64_t) multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        const uint32_t q = log10pow5(-e2) - (-e2 > 1);
+        const int32_t i = -e2 - (int32_t) q;
+        const int32_t k = pow5bits(i) - DOUBLE_POW5_BITCOUNT;
+        const int32_t j = (int32_t) q - k;
+        const uint64_t* mul = gsDoublePow5Split + 2 * i;
+        e10 = (int32_t) q + e2;
+        vr = mulshift64(4 * m2, mul, j);
+        vp = mulshift64(4 * m2 + 2, mul, j);
+        vm = mulshift64(4 * m2 - 1 - mm_shift, mul, j);
+        if (q <= 1) {
+            // mv = 4 * m2 always has at least two trailing 0 bits
+            vr_trailing_zeros = 1;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                --vp;
+            }
+        } else if (q < 63) {
+            vr_trailing_zeros = multiple_of_pow2(mv, q);
+        }
+    }
+
+    // drop digits while the interval still holds more than one number
+    int32_t removed = 0;
+    uint32_t last_removed = 0;
+    uint64_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        // rare, exact halfway handling
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = (uint32_t)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = (uint32_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                ++removed;
+            }
+        }
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) {
+            // exactly .5, round to even
+            last_removed = 4;
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) ||
+                       last_removed >= 5);
+    } else {
+        // common case
+        int round_up = 0;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    *exponent = e10 + removed;
+    return output;
+}
+
+size_t modp_dtoa_shortest(double value, char* str)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const int neg = (int)(bits >> 63);
+    const uint64_t ieee_mantissa = bits & ((1ull << DOUBLE_MANTISSA_BITS) - 1);
+    const uint32_t ieee_exponent = (uint32_t)
+        ((bits >> DOUBLE_MANTISSA_BITS) & ((1u << DOUBLE_EXPONENT_BITS) - 1));
+    char* wstr = str;
+
+    if (ieee_exponent == ((1u << DOUBLE_EXPONENT_BITS) - 1)) {
+        if (ieee_mantissa) {
+            memcpy(str, "nan", 4);
+            return (size_t) 3;
+        }
+        if (neg) {
+            *wstr++ = '-';
+        }
+        memcpy(wstr, "inf", 4);
+        return (size_t)(wstr + 3 - str);
+    }
+    if (neg) {
+        *wstr++ = '-';
+    }
+    if (ieee_exponent == 0 && ieee_mantissa == 0) {
+        *wstr++ = '0';
+        *wstr = '\0';
+        return (size_t)(wstr - str);
+    }
+
+    uint64_t output;
+    int32_t exponent;
+    const int32_t e2 = (int32_t) ieee_exponent - DOUBLE_BIAS - DOUBLE_MANTISSA_BITS;
+    const uint64_t m2 = (1ull << DOUBLE_MANTISSA_BITS) | ieee_mantissa;
+    if (e2 <= 0 && e2 >= -DOUBLE_MANTISSA_BITS &&
+        (m2 & ((1ull << -e2) - 1)) == 0) {
+        // integers below 2^53 are exact, only trailing zeros to drop
+        output = m2 >> -e2;
+        exponent = 0;
+        while (output % 10 == 0) {
+            output /= 10;
+            ++exponent;
+        }
+    } else {
+        output = ryu_d2d(ieee_mantissa, ieee_exponent, &exponent);
+    }
+
+    char digits[17];
+    const uint32_t olength = decimal_length17(output);
+    uint32_t i;
+    for (i = olength; i > 0; --i) {
+        digits[i - 1] = (char)('0' + output % 10);
+        output /= 10;
+    }
+
+    /*
+     * Same layout as JavaScript's Number.prototype.toString: plain
+     * notation when the decimal point is at most 21 digits left of or
+     * 6 zeros right of the first digit, otherwise d.ddde+XX.
+     */
+    const int32_t point = (int32_t) olength + exponent;
+    if ((int32_t) olength <= point && point <= 21) {
+        memcpy(wstr, digits, olength);
+        wstr += olength;
+        for (i = olength; i < (uint32_t) point; ++i) {
+            *wstr++ = '0';
+        }
+    } else if (0 < point && point <= 21) {
+        memcpy(wstr, digits, (size_t) point);
+        wstr += point;
+        *wstr++ = '.';
+        memcpy(wstr, digits + point, olength - (uint32_t) point);
+        wstr += olength - (uint32_t) point;
+    } else if (-6 < point && point <= 0) {
+        *wstr++ = '0';
+        *wstr++ = '.';
+        for (i = 0; i < (uint32_t) -point; ++i) {
+            *wstr++ = '0';
+        }
+        memcpy(wstr, digits, olength);
+        wstr += olength;
+    } else {
+        int32_t e = point - 1;
+        *wstr++ = digits[0];
+        if (olength > 1) {
+            *wstr++ = '.';
+            memcpy(wstr, digits + 1, olength - 1);
+            wstr += olength - 1;
+        }
+        *wstr++ = 'e';
+        if (e < 0) {
+            *wstr++ = '-';
+            e = -e;
+        } else {
+            *wstr++ = '+';
+        }
+        if (e >= 100) {
+            *wstr++ = (char)('0' + e / 100);
+            e %= 100;
+            *wstr++ = (char)('0' + e / 10);
+        } else if (e >= 10) {
+            *wstr++ = (char)('0' + e / 10);
+        }
+        *wstr++ = (char)('0' + e % 10);
+    }
+    *wstr = '\0';
+    return (size_t)(wstr - str);
+}
+
+/*
+ * Eisel-Lemire: w * 10^q rounded to nearest even, w != 0 and exact.
+ * Returns the double's bits without the sign; 0 and inf included.
+ */
+static uint64_t lemire_d2b(int64_t q, uint64_t w)
+{
+    if (q < -342) {
+        return 0;
+    }
+    if (q > 308) {
+        return 0x7ffull << DOUBLE_MANTISSA_BITS;
+    }
+
+    int lz = 0;
+    while (!(w & (1ull << 63))) {
+        w <<= 1;
+        ++lz;
+    }
+
+    // 55 bits are enough: the mantissa, the hidden bit and two spare
+    const uint64_t* pow5 = gsPow5_128 + 2 * (q + 342);
+    uint64_t hi;
+    uint64_t lo = umul128(w, pow5[0], &hi);
+    const uint64_t precision_mask = ~0ull >> 55;
+    if ((hi & precision_mask) == precision_mask) {
+        uint64_t hi2;
+        umul128(w, pow5[1], &hi2);
+        lo += hi2;
+        if (hi2 > lo) {
+            ++hi;
+        }
+    }
+
+    const int upperbit = (int)(hi >> 63);
+    const int shift = upperbit + 64 - DOUBLE_MANTISSA_BITS - 3;
+    uint64_t mantissa = hi >> shift;
+    // floor(log2(10^q)) + 63, written for a right shift that floors
+    const int32_t pow10log2 = (int32_t)(((152170 + 65536) * q) >> 16) + 63;
+    int32_t power2 = pow10log2 + upperbit - lz + 1023;
+
+    if (power2 <= 0) {
+        // subnormal
+        if (-power2 + 1 >= 64) {
+            return 0;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        // rounding may have carried into the smallest normal
+        power2 = (mantissa < (1ull << DOUBLE_MANTISSA_BITS)) ? 0 : 1;
+        return ((uint64_t) power2 << DOUBLE_MANTISSA_BITS) |
+            (mantissa & ((1ull << DOUBLE_MANTISSA_BITS) - 1));
+    }
+
+    // exactly halfway is only possible when 5^q fits in 64 bits
+    if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << shift) == hi) {
+        mantissa &= ~1ull;
+    }
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (2ull << DOUBLE_MANTISSA_BITS)) {
+        mantissa = 1ull << DOUBLE_MANTISSA_BITS;
+        ++power2;
+    }
+    mantissa &= ~(1ull << DOUBLE_MANTISSA_BITS);
+    if (power2 >= 0x7ff) {
+        return 0x7ffull << DOUBLE_MANTISSA_BITS;
+    }
+    return ((uint64_t) power2 << DOUBLE_MANTISSA_BITS) | mantissa;
+}
+
+/*
+ * Unsigned big integers for the slow path, 32-bit limbs least
+ * significant first.  800 digits and 5^1150 fit with room to spare.
+ */
+#define BIG_LIMBS 120
+#define BIG_MAX_DIGITS 800
+
+struct bignum_t {
+    uint32_t v[BIG_LIMBS];
+    int n;
+};
+
+static void big_muladd(struct bignum_t* a, uint32_t m, uint32_t add)
+{
+    int i;
+    uint64_t carry = add;
+    for (i = 0; i < a->n; ++i) {
+        carry += (uint64_t) a->v[i] * m;
+        a->v[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    if (carry) {
+        a->v[a->n++] = (uint32_t) carry;
+    }
+}
+
+static void big_mulpow5(struct bignum_t* a, int64_t e)
+{
+    // 5^13 is the largest power of 5 below 2^32
+    for (; e >= 13; e -= 13) {
+        big_muladd(a, 1220703125u, 0);
+    }
+    if (e > 0) {
+        uint32_t m = 1;
+        while (e-- > 0) {
+            m *= 5;
+        }
+        big_muladd(a, m, 0);
+    }
+}
+
+static void big_shl(struct bignum_t* a, int64_t s)
+{
+    const int words = (int)(s / 32);
+    const int bits = (int)(s % 32);
+    int i;
+    if (bits) {
+        a->v[a->n] = 0;
+        for (i = a->n; i > 0; --i) {
+            a->v[i] = (a->v[i] << bits) | (a->v[i - 1] >> (32 - bits));
+        }
+        a->v[0] <<= bits;
+        if (a->v[a->n]) {
+            ++a->n;
+        }
+    }
+    if (words) {
+        memmove(a->v + words, a->v, (size_t) a->n * sizeof(uint32_t));
+        memset(a->v, 0, (size_t) words * sizeof(uint32_t));
+        a->n += words;
+    }
+}
+
+static int big_cmp(const struct bignum_t* a, const struct bignum_t* b)
+{
+    int i;
+    if (a->n != b->n) {
+        return a->n < b->n ? -1 : 1;
+    }
+    for (i = a->n - 1; i >= 0; --i) {
+        if (a->v[i] != b->v[i]) {
+            return a->v[i] < b->v[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Corrects bits, which may be low, for the decimal in
+ * [digits, digits_end) times 10^exp10.  Compares against the halfway
+ * point to the next double until it is above the input.
+ */
+static uint64_t strtod_slow(const char* digits, const char* digits_end,
+                            int64_t exp10, uint64_t bits)
+{
+    static const uint32_t pow10[] = {1, 10, 100, 1000, 10000, 100000,
+                                     1000000, 10000000, 100000000,
+                                     1000000000};
+    struct bignum_t d;
+    int count = 0;
+    int in_frac = 0;
+    int sticky = 0;
+    uint32_t chunk = 0;
+    int chunk_n = 0;
+
+    d.n = 0;
+    for (; digits < digits_end; ++digits) {
+        if (*digits == '.') {
+            in_frac = 1;
+            continue;
+        }
+        const uint32_t c = (uint32_t)(*digits - '0');
+        if (count == 0 && c == 0) {
+            exp10 -= in_frac;
+        } else if (count < BIG_MAX_DIGITS) {
+            chunk = chunk * 10 + c;
+            if (++chunk_n == 9) {
+                big_muladd(&d, pow10[9], chunk);
+                chunk = 0;
+                chunk_n = 0;
+            }
+            ++count;
+            exp10 -= in_frac;
+        } else {
+            // past any digit a halfway point can have, only != 0 matters
+            exp10 += !in_frac;
+            sticky |= c != 0;
+        }
+    }
+    if (sticky) {
+        chunk = chunk * 10 + 1;
+        ++chunk_n;
+        --exp10;
+    }
+    big_muladd(&d, pow10[chunk_n], chunk);
+    if (exp10 > 0) {
+        big_mulpow5(&d, exp10);
+    }
+
+    while (bits < (0x7ffull << DOUBLE_MANTISSA_BITS)) {
+        // halfway to the next double is (2m + 1) * 2^(e - 1)
+        const uint32_t ieee_exponent = (uint32_t)(bits >> DOUBLE_MANTISSA_BITS);
+        uint64_t m = bits & ((1ull << DOUBLE_MANTISSA_BITS) - 1);
+        int64_t e = -1074;
+        if (ieee_exponent) {
+            m |= 1ull << DOUBLE_MANTISSA_BITS;
+            e = (int64_t) ieee_exponent - 1075;
+        }
+        struct bignum_t lhs = d;
+        struct bignum_t rhs;
+        rhs.v[0] = (uint32_t)(2 * m + 1);
+        rhs.v[1] = (uint32_t)((2 * m + 1) >> 32);
+        rhs.n = rhs.v[1] ? 2 : 1;
+        if (exp10 < 0) {
+            big_mulpow5(&rhs, -exp10);
+        }
+        const int64_t s = (e - 1) - exp10;
+        if (s > 0) {
+            big_shl(&rhs, s);
+        } else if (s < 0) {
+            big_shl(&lhs, -s);
+        }
+        const int c = big_cmp(&lhs, &rhs);
+        if (c < 0 || (c == 0 && (m & 1) == 0)) {
+            break;
+        }
+        ++bits;
+        if (c == 0) {
+            break;
+        }
+    }
+    return bits;
+}
+
+size_t modp_strtod(const char* str, size_t len, double* value)
+{
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7,
+                                   1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+                                   1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+                                   1e21, 1e22};
+    const char* p = str;
+    const char* end = str + len;
+    int neg = 0;
+    uint64_t bits;
+
+    while (p < end && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) {
+        ++p;
+    }
+    if (p < end && (*p == '-' || *p == '+')) {
+        neg = *p == '-';
+        ++p;
+    }
+
+    // at most 19 significant digits go in w, the rest only count
+    const char* digits = p;
+    uint64_t w = 0;
+    int ndigits = 0;
+    int64_t exp10 = 0;
+    int truncated = 0;
+    int any = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        const uint32_t c = (uint32_t)(*p - '0');
+        any = 1;
+        if (ndigits < 19) {
+            w = w * 10 + c;
+            ndigits += w != 0;
+        } else {
+            ++exp10;
+            truncated |= c != 0;
+        }
+    }
+    if (p < end && *p == '.') {
+        ++p;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+            const uint32_t c = (uint32_t)(*p - '0');
+            any = 1;
+            if (ndigits < 19) {
+                w = w * 10 + c;
+                ndigits += w != 0;
+                --exp10;
+            } else {
+                truncated |= c != 0;
+            }
+        }
+    }
+    if (!any) {
+        // inf, infinity and nan, any case, as strtod
+        static const char inf[] = "infinity";
+        size_t n = 0;
+        p = digits;
+        while (n < 8 && p + n < end && (p[n] | 0x20) == inf[n]) {
+            ++n;
+        }
+        if (n >= 3) {
+            bits = 0x7ffull << DOUBLE_MANTISSA_BITS;
+            p += n == 8 ? 8 : 3;
+        } else if (p + 3 <= end && (p[0] | 0x20) == 'n' &&
+                   (p[1] | 0x20) == 'a' && (p[2] | 0x20) == 'n') {
+            bits = 0x7ff8ull << 48;
+            p += 3;
+            if (p < end && *p == '(') {
+                // nan(chars), the chars are ignored
+                const char* q = p + 1;
+                while (q < end && (((*q | 0x20) >= 'a' && (*q | 0x20) <= 'z') ||
+                                   (*q >= '0' && *q <= '9') || *q == '_')) {
+                    ++q;
+                }
+                if (q < end && *q == ')') {
+                    p = q + 1;
+                }
+            }
+        } else {
+            return 0;
+        }
+        bits |= (uint64_t) neg << 63;
+        memcpy(value, &bits, sizeof(bits));
+        return (size_t)(p - str);
+    }
+    const char* digits_end = p;
+
+    int64_t explicit_exp = 0;
+    if (p + 1 < end && (*p == 'e' || *p == 'E')) {
+        const char* e = p + 1;
+        int eneg = 0;
+        int64_t ev = 0;
+        if (*e == '-' || *e == '+') {
+            eneg = *e == '-';
+            ++e;
+        }
+        if (e < end && *e >= '0' && *e <= '9') {
+            for (; e < end && *e >= '0' && *e <= '9'; ++e) {
+                if (ev < 100000) {
+                    ev = ev * 10 + (*e - '0');
+                }
+            }
+            explicit_exp = eneg ? -ev : ev;
+            exp10 += explicit_exp;
+            p = e;
+        }
+    }
+    if (w == 0) {
+        bits = 0;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    } else if (!truncated && w <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+        // both w and 10^|exp10| are exact doubles: one rounding
+        double d = (double) w;
+        d = exp10 < 0 ? d / pow10[(size_t) -exp10] : d * pow10[(size_t) exp10];
+        memcpy(&bits, &d, sizeof(bits));
+#endif
+    } else {
+        bits = lemire_d2b(exp10, w);
+        if (truncated && bits != lemire_d2b(exp10, w + 1)) {
+            bits = strtod_slow(digits, digits_end, explicit_exp, bits);
+        }
+    }
+    // overflow to infinity, and underflow to zero or a subnormal,
+    // as glibc's strtod
+    if (bits == 0x7ffull << DOUBLE_MANTISSA_BITS ||
+        (bits >> DOUBLE_MANTISSA_BITS == 0 && w != 0)) {
+        errno = ERANGE;
+    }
+    bits |= (uint64_t) neg << 63;
+    memcpy(value, &bits, sizeof(bits));
+    return (size_t)(p - str);
+}
@@ -3,7 +3,8 @@
 
 /**
  * \file modp_numtoa.h
- * \brief Fast integer and floating-point numbers to string conversion
+ * \brief Fast integer and floating-point numbers to string conversion,
+ *        and string to double
  *
  * This defines signed/unsigned integer, and 'double' to char buffer
  * converters.  The standard way of doing this is with "sprintf", however
@@ -94,6 +95,38 @@ size_t modp_dtoa(double value, char* buf, int precision);
  */
 size_t modp_dtoa2(double value, char* buf, int precision);
 
+/** \brief convert a double to the shortest string that reads back
+ *         as exactly the same double
+ *
+ * Uses plain notation ("0.1", "123", "1e+21" is the first exponent
+ * form) with the same switch-over points as JavaScript, so the output
+ * is valid JSON for finite values.  Negative zero is "-0"; infinities
+ * and NaN are written as "inf", "-inf" and "nan", which JSON callers
+ * must handle themselves.
+ *
+ * \param[in] value
+ * \param[out] buf  The output buffer.  Should be 26 chars or more.
+ * \return the string length, not counting the final null
+ */
+size_t modp_dtoa_shortest(double value, char* buf);
+
+/** \brief parse a decimal floating point number, correctly rounded
+ *
+ * Gives the same double as strtod in the "C" locale for decimal
+ * input: leading whitespace, an optional sign, digits with an
+ * optional '.', an optional exponent, or "inf", "infinity" and "nan"
+ * in any case ("nan(chars)" parses as a plain NaN).  Hex floats are
+ * not supported.  The input need not be null terminated.  errno is
+ * set to ERANGE when the result overflows to infinity or underflows
+ * to zero or to a subnormal number, and is left alone otherwise.
+ *
+ * \param[in] str  The input.
+ * \param[in] len  Number of chars available.
+ * \param[out] value  The result, only set when something was parsed.
+ * \return number of chars used, 0 if str does not start with a number
+ */
+size_t modp_strtod(const char* str, size_t len, double* value);
+
 /**
  * adds a 8-character hexadecimal representation of value
  *
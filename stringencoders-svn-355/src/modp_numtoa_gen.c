@@ -0,0 +1,235 @@
+/* -*- mode: c; c-basic-offset: 4; indent-tabs-mode: nil; tab-width: 4 -*- */
+/* vi: set expandtab shiftwidth=4 tabstop=4: */
+
+/*
+ * Generates the 128-bit powers of five used by modp_dtoa_shortest
+ * (Ryu, Ulf Adams 2018) and modp_strtod (Eisel-Lemire, as in
+ * fast_float).  Each entry is two uint64_t.
+ */
+
+#include "arraytoc.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Just enough of an unsigned bignum: 32-bit limbs, least significant
+ * first.  2^1720 is the largest number needed.
+ */
+#define LIMBS 64
+
+struct big_t {
+    uint32_t v[LIMBS];
+};
+
+static void big_set(struct big_t* a, uint32_t x)
+{
+    memset(a->v, 0, sizeof(a->v));
+    a->v[0] = x;
+}
+
+static void big_mul(struct big_t* a, uint32_t x)
+{
+    int i;
+    uint64_t carry = 0;
+    for (i = 0; i < LIMBS; ++i) {
+        carry += (uint64_t) a->v[i] * x;
+        a->v[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    if (carry) {
+        abort();
+    }
+}
+
+static int big_bits(const struct big_t* a)
+{
+    int i, b;
+    for (i = LIMBS - 1; i >= 0; --i) {
+        if (a->v[i]) {
+            for (b = 31; !(a->v[i] & (1u << b)); --b) {
+            }
+            return i * 32 + b + 1;
+        }
+    }
+    return 0;
+}
+
+static int big_bit(const struct big_t* a, int n)
+{
+    return (int)((a->v[n / 32] >> (n % 32)) & 1);
+}
+
+static void big_setbit(struct big_t* a, int n)
+{
+    a->v[n / 32] |= 1u << (n % 32);
+}
+
+static int big_cmp(const struct big_t* a, const struct big_t* b)
+{
+    int i;
+    for (i = LIMBS - 1; i >= 0; --i) {
+        if (a->v[i] != b->v[i]) {
+            return a->v[i] < b->v[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static void big_sub(struct big_t* a, const struct big_t* b)
+{
+    int i;
+    uint64_t borrow = 0;
+    for (i = 0; i < LIMBS; ++i) {
+        uint64_t d = (uint64_t) a->v[i] - b->v[i] - borrow;
+        a->v[i] = (uint32_t) d;
+        borrow = (d >> 63) & 1;
+    }
+}
+
+/* a = a * 2^n when n > 0, a / 2^-n (truncated) when n < 0 */
+static void big_shift(struct big_t* a, int n)
+{
+    struct big_t r;
+    int i, bits = big_bits(a);
+    big_set(&r, 0);
+    for (i = 0; i < bits; ++i) {
+        if (big_bit(a, i) && i + n >= 0) {
+            if (i + n >= LIMBS * 32) {
+                abort();
+            }
+            big_setbit(&r, i + n);
+        }
+    }
+    *a = r;
+}
+
+static void big_shl1(struct big_t* a)
+{
+    int i;
+    if (a->v[LIMBS - 1] >> 31) {
+        abort();
+    }
+    for (i = LIMBS - 1; i > 0; --i) {
+        a->v[i] = (a->v[i] << 1) | (a->v[i - 1] >> 31);
+    }
+    a->v[0] <<= 1;
+}
+
+/* q = 2^n / d, truncated, by shift and subtract */
+static void big_pow2_div(struct big_t* q, int n, const struct big_t* d)
+{
+    struct big_t rem;
+    int i;
+    big_set(q, 0);
+    big_set(&rem, 0);
+    for (i = n; i >= 0; --i) {
+        big_shl1(&rem);
+        if (i == n) {
+            rem.v[0] |= 1;
+        }
+        if (big_cmp(&rem, d) >= 0) {
+            big_sub(&rem, d);
+            big_setbit(q, i);
+        }
+    }
+}
+
+static void big_pow5(struct big_t* a, int n)
+{
+    big_set(a, 1);
+    while (n-- > 0) {
+        big_mul(a, 5);
+    }
+}
+
+static void big_add1(struct big_t* a)
+{
+    int i;
+    for (i = 0; i < LIMBS && ++a->v[i] == 0; ++i) {
+    }
+}
+
+/* the low 128 bits as two words */
+static void big_get128(const struct big_t* a, uint64_t* hi, uint64_t* lo)
+{
+    *lo = ((uint64_t) a->v[1] << 32) | a->v[0];
+    *hi = ((uint64_t) a->v[3] << 32) | a->v[2];
+}
+
+/*
+ * Ryu: 5^i in its top 125 bits, and 2^(bits(5^i) - 1 + 125) / 5^i,
+ * plus one.  Stored low word first.
+ */
+#define RYU_POW5_BITCOUNT 125
+#define RYU_POW5_TABLE_SIZE 326
+#define RYU_POW5_INV_TABLE_SIZE 342
+
+static void ryutables(void)
+{
+    static uint64_t split[2 * RYU_POW5_TABLE_SIZE];
+    static uint64_t inv[2 * RYU_POW5_INV_TABLE_SIZE];
+    struct big_t p, x;
+    int i;
+
+    for (i = 0; i < RYU_POW5_TABLE_SIZE; ++i) {
+        big_pow5(&p, i);
+        x = p;
+        big_shift(&x, RYU_POW5_BITCOUNT - big_bits(&p));
+        big_get128(&x, &split[2 * i + 1], &split[2 * i]);
+    }
+    for (i = 0; i < RYU_POW5_INV_TABLE_SIZE; ++i) {
+        big_pow5(&p, i);
+        big_pow2_div(&x, big_bits(&p) - 1 + RYU_POW5_BITCOUNT, &p);
+        big_add1(&x);
+        big_get128(&x, &inv[2 * i + 1], &inv[2 * i]);
+    }
+    uint64_array_to_c_hex(split, 2 * RYU_POW5_TABLE_SIZE, "gsDoublePow5Split");
+    uint64_array_to_c_hex(inv, 2 * RYU_POW5_INV_TABLE_SIZE,
+                          "gsDoublePow5InvSplit");
+}
+
+/*
+ * Eisel-Lemire: 5^q for q in [-342, 308], normalized so the top bit
+ * of a 128-bit word is set.  Positive powers are truncated, negative
+ * ones are the reciprocal rounded up (then truncated when it still
+ * needs more than 128 bits).  Stored high word first.
+ */
+#define LEMIRE_MIN_Q -342
+#define LEMIRE_MAX_Q 308
+
+static void lemiretable(void)
+{
+    static uint64_t table[2 * (LEMIRE_MAX_Q - LEMIRE_MIN_Q + 1)];
+    struct big_t p, x;
+    int q, z, bits;
+    uint64_t* out = table;
+
+    for (q = LEMIRE_MIN_Q; q <= LEMIRE_MAX_Q; ++q) {
+        if (q < 0) {
+            big_pow5(&p, -q);
+            /* z = bits such that 2^z >= 5^-q */
+            z = big_bits(&p);
+            if (q >= -27) {
+                big_pow2_div(&x, z + 127, &p);
+            } else {
+                big_pow2_div(&x, 2 * z + 2 * 64, &p);
+            }
+            big_add1(&x);
+        } else {
+            big_pow5(&x, q);
+        }
+        bits = big_bits(&x);
+        big_shift(&x, 128 - bits);
+        big_get128(&x, &out[0], &out[1]);
+        out += 2;
+    }
+    uint64_array_to_c_hex(table, 2 * (LEMIRE_MAX_Q - LEMIRE_MIN_Q + 1),
+                          "gsPow5_128");
+}
+
+int main(void)
+{
+    ryutables();
+    lemiretable();
+    return 0;
+}
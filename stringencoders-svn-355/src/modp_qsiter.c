@@ -43,6 +43,111 @@
  */
 
 #include "modp_qsiter.h"
+#include "modp_qsiter_data.h"
+
+/* char classes in gsQsCharClass, see modp_qsiter_gen.c */
+#define QS_AMP 1
+#define QS_EQ 2
+#define QS_ESC 4
+
+/*
+ * One pass over a pair finds the '&' that ends it, the first '=' and
+ * the first char that needs decoding.  SSE2 looks at 16 chars at a
+ * time, the tail and other CPUs use the char class table.  SSE2 is
+ * always there on x86-64, so no runtime check is needed.
+ */
+#if defined(__GNUC__) && defined(__SSE2__)
+#define QS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+ * returns the offset of the first '&' in s, or len.  *eq and *esc are
+ * the offsets of the first '=' and of the first '%' or '+' before
+ * that, or len if there are none.
+ */
+static size_t qs_scan(const char* s, size_t len, size_t* eq, size_t* esc)
+{
+    size_t i = 0;
+    *eq = len;
+    *esc = len;
+
+#ifdef QS_SSE2
+    const __m128i amp = _mm_set1_epi8('&');
+    const __m128i equal = _mm_set1_epi8('=');
+    const __m128i pct = _mm_set1_epi8('%');
+    const __m128i plus = _mm_set1_epi8('+');
+    for (; i + 16 <= len; i += 16) {
+        const __m128i in = _mm_loadu_si128((const __m128i*)(s + i));
+        const unsigned int ma =
+            (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(in, amp));
+        unsigned int me =
+            (unsigned int) _mm_movemask_epi8(_mm_cmpeq_epi8(in, equal));
+        unsigned int mp = (unsigned int) _mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(in, pct), _mm_cmpeq_epi8(in, plus)));
+        if (ma) {
+            /* only what comes before the '&' */
+            const unsigned int before = (ma & (0u - ma)) - 1u;
+            me &= before;
+            mp &= before;
+        }
+        if (me && *eq == len) {
+            *eq = i + (size_t) __builtin_ctz(me);
+        }
+        if (mp && *esc == len) {
+            *esc = i + (size_t) __builtin_ctz(mp);
+        }
+        if (ma) {
+            return i + (size_t) __builtin_ctz(ma);
+        }
+    }
+#endif
+
+    for (; i < len; ++i) {
+        const unsigned char c = gsQsCharClass[(uint8_t) s[i]];
+        if (c) {
+            if (c & QS_AMP) {
+                return i;
+            }
+            if ((c & QS_EQ) && *eq == len) {
+                *eq = i;
+            }
+            if ((c & QS_ESC) && *esc == len) {
+                *esc = i;
+            }
+        }
+    }
+    return len;
+}
+
+/*
+ * decodes s in place the same as modp_burl_decode, but without the
+ * trailing null.  s[0..start) has nothing to decode.  returns the new
+ * length.
+ */
+static size_t qs_decode(char* s, size_t start, size_t len)
+{
+    size_t i = start;
+    size_t j = start;
+    uint32_t d;
+
+    while (i < len) {
+        const char c = s[i];
+        if (c == '+') {
+            s[j++] = ' ';
+            ++i;
+        } else if (c == '%' && i + 2 < len &&
+                   (d = (gsHexDecodeMap[(uint8_t) s[i + 1]] << 4) |
+                    gsHexDecodeMap[(uint8_t) s[i + 2]]) < 256) {
+            s[j++] = (char) d;
+            i += 3;
+        } else {
+            s[j++] = c;
+            ++i;
+        }
+    }
+    return j;
+}
 
 void qsiter_reset(struct qsiter_t* qsi, const char* s, size_t len)
 {
@@ -54,10 +159,20 @@ void qsiter_reset(struct qsiter_t* qsi, const char* s, size_t len)
     qsi->keylen = 0;
     qsi->val = NULL;
     qsi->vallen = 0;
+
+    qsi->buf = NULL;
+}
+
+void qsiter_reset_inplace(struct qsiter_t* qsi, char* s, size_t len)
+{
+    qsiter_reset(qsi, s, len);
+    qsi->buf = s;
 }
 
 bool qsiter_next(struct qsiter_t* qsi)
 {
+    size_t eq, esc;
+
     if (qsi->pos >= qsi->len) {
         qsi->key = NULL;
         qsi->keylen = 0;
@@ -66,39 +181,107 @@ bool qsiter_next(struct qsiter_t* qsi)
         return false;
     }
 
-    const char* charstart = qsi->s + qsi->pos;
-    const char* ends = (const char*) memchr(charstart, '&', qsi->len - qsi->pos);
+    // &&foo=bar
+    const size_t start = qsi->pos;
+    const size_t n = qsi->len - start;
+    const size_t end = qs_scan(qsi->s + start, n, &eq, &esc);
 
-    if (ends == NULL) {
-        const char* eq = (const char*) memchr(charstart, '=', qsi->len - qsi->pos);
-        if (eq == NULL) {
-            qsi->key = charstart;
-            qsi->keylen = (size_t)(qsi->len - qsi->pos);
-            qsi->val = NULL;
-            qsi->vallen = (size_t)0;
-        } else {
-            qsi->key = charstart;
-            qsi->keylen = (size_t)(eq - charstart);
-            qsi->val = eq + 1;
-            qsi->vallen = (size_t)((qsi->s + qsi->len) - qsi->val);
-        }
-        qsi->pos = qsi->len;
-        return true;
+    qsi->key = qsi->s + start;
+    if (eq < end) {
+        qsi->keylen = eq;
+        qsi->val = qsi->key + eq + 1;
+        qsi->vallen = end - eq - 1;
     } else {
-        // &&foo=bar
-        const char* eq = (const char*) memchr(charstart, '=', (size_t)(ends - charstart));
-        if (eq == NULL) {
-            qsi->key = charstart;
-            qsi->keylen = (size_t)(ends - charstart);
-            qsi->val = NULL;
-            qsi->vallen = (size_t)0;
-        } else {
-            qsi->key = charstart;
-            qsi->keylen = (size_t)(eq - charstart);
-            qsi->val = eq + 1;
-            qsi->vallen = (size_t)(ends - eq - 1);
+        qsi->keylen = end;
+        qsi->val = NULL;
+        qsi->vallen = 0;
+    }
+    qsi->pos = (end < n) ? start + end + 1 : qsi->len;
+
+    if (qsi->buf != NULL && esc < end) {
+        char* key = qsi->buf + start;
+        if (esc < qsi->keylen) {
+            qsi->keylen = qs_decode(key, esc, qsi->keylen);
+        }
+        if (qsi->val != NULL) {
+            qsi->vallen = qs_decode(key + eq + 1, esc > eq ? esc - eq - 1 : 0,
+                                    qsi->vallen);
         }
-        qsi->pos = (size_t)((ends - qsi->s) + 1);
-        return true;
     }
+    return true;
+}
+
+#define QS_INDEX_SLOTS (2 * QS_INDEX_MAX)
+
+/* FNV-1a, keys are short */
+static size_t qs_hash(const char* s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    size_t i;
+    for (i = 0; i < len; ++i) {
+        h = (h ^ (uint8_t) s[i]) * 16777619u;
+    }
+    return h;
+}
+
+/*
+ * returns the slot holding key, or the empty slot where it goes.
+ * At most half the slots are used, so there always is one.
+ */
+static size_t qs_index_find(const struct qs_index_t* idx, const char* key,
+                            size_t keylen)
+{
+    size_t i = qs_hash(key, keylen) & (QS_INDEX_SLOTS - 1);
+    while (idx->slots[i] != 0) {
+        const size_t k = (size_t)(idx->slots[i] - 1);
+        if (idx->pairs[k].keylen == keylen &&
+            memcmp(idx->pairs[k].key, key, keylen) == 0) {
+            break;
+        }
+        i = (i + 1) & (QS_INDEX_SLOTS - 1);
+    }
+    return i;
+}
+
+bool qs_index_build(struct qs_index_t* idx, struct qsiter_t* qsi)
+{
+    size_t slot;
+
+    idx->n = 0;
+    memset(idx->slots, 0, sizeof(idx->slots));
+
+    while (qsiter_next(qsi)) {
+        if (qsi->keylen == 0 && qsi->val == NULL) {
+            continue;
+        }
+        slot = qs_index_find(idx, qsi->key, qsi->keylen);
+        if (idx->slots[slot] != 0) {
+            continue;
+        }
+        if (idx->n == QS_INDEX_MAX) {
+            return false;
+        }
+        idx->pairs[idx->n].key = qsi->key;
+        idx->pairs[idx->n].keylen = qsi->keylen;
+        idx->pairs[idx->n].val = qsi->val;
+        idx->pairs[idx->n].vallen = qsi->vallen;
+        idx->n += 1;
+        idx->slots[slot] = (uint8_t) idx->n;
+    }
+    return true;
+}
+
+bool qs_index_get(const struct qs_index_t* idx, const char* key,
+                  size_t keylen, const char** val, size_t* vallen)
+{
+    const size_t slot = qs_index_find(idx, key, keylen);
+    if (idx->slots[slot] == 0) {
+        *val = NULL;
+        *vallen = 0;
+        return false;
+    }
+    const size_t k = (size_t)(idx->slots[slot] - 1);
+    *val = idx->pairs[k].val;
+    *vallen = idx->pairs[k].vallen;
+    return true;
 }
@@ -13,7 +13,10 @@
  *        no copy, makes no modification of input.  Think of this as a
  *        super-strtok_r.
  *
- * This also does not do query-string un-escaping.
+ * This also does not do query-string un-escaping, unless started with
+ * qsiter_reset_inplace, which decodes each key and value in the
+ * caller's buffer as it goes.  For repeated lookups on the same query
+ * string, see qs_index_build.
  *
  * \code
  * qsiiter_t qsi;
@@ -46,6 +49,9 @@ struct qsiter_t {
 
   const char* val;
   size_t vallen;
+
+  /* same as s when decoding in place, NULL otherwise */
+  char* buf;
 };
 
 
@@ -61,6 +67,22 @@ struct qsiter_t {
  */
 void qsiter_reset(struct qsiter_t* qsi, const char* s, size_t len);
 
+/**
+ * Reset a qsiter to decode keys and values in place
+ *
+ * As qsiter_next finds each pair, "+" and "%XX" in its key and value
+ * are decoded the same as modp_burl_decode, overwriting the input.
+ * Splitting happens first, so "%26" and "%3D" decode to '&' and '='
+ * without ending a pair.  key and val point into s, and the decoded
+ * text is never longer than the original.  Nothing is written past
+ * the end of a key or value, so s needs no trailing null.
+ *
+ * \param[out] qsi data struct used in iterator
+ * \param[in,out] s input string, decoded in place
+ * \param[in] len input string length
+ */
+void qsiter_reset_inplace(struct qsiter_t* qsi, char* s, size_t len);
+
 /**
  * Get next key/value pair in query string
  *
@@ -69,6 +91,74 @@ void qsiter_reset(struct qsiter_t* qsi, const char* s, size_t len);
  */
 bool qsiter_next(struct qsiter_t* qsi);
 
+/**
+ * Number of pairs a qs_index_t holds directly
+ */
+#define QS_INDEX_MAX 64
+
+/**
+ * A small hash of the keys in a query string, built once with no heap,
+ * so that looking up a key costs O(1) instead of a scan.
+ *
+ * \code
+ * struct qsiter_t qsi;
+ * struct qs_index_t idx;
+ * const char* val;
+ * size_t vallen;
+ * qsiter_reset(&qsi, qs, strlen(qs));
+ * qs_index_build(&idx, &qsi);
+ * if (qs_index_get(&idx, "user", 4, &val, &vallen)) {
+ *     ...
+ * }
+ * \endcode
+ *
+ * At most QS_INDEX_MAX distinct keys are indexed.  Servers usually cap
+ * the number of parameters anyway, and qs_index_build says when the
+ * cap was hit.
+ */
+struct qs_index_t {
+  size_t n;
+  struct {
+    const char* key;
+    size_t keylen;
+    const char* val;
+    size_t vallen;
+  } pairs[QS_INDEX_MAX];
+
+  /* open addressing, 0 is empty, otherwise an index into pairs + 1 */
+  uint8_t slots[2 * QS_INDEX_MAX];
+};
+
+/**
+ * Index the pairs of a query string
+ *
+ * qsi is read from its current position, so it may be started with
+ * either qsiter_reset or qsiter_reset_inplace.  Empty segments such as
+ * "&&" are skipped.  When a key repeats, lookups find the first value.
+ * The index points into the original string, which must outlive it.
+ *
+ * \param[out] idx the index
+ * \param[in,out] qsi iterator over the query string
+ * \return true if every key was indexed.  Otherwise the index is
+ *   full and qsi holds the first pair whose key is not in it, as if
+ *   qsiter_next had just returned it, so the caller may reject the
+ *   query or handle that pair and go on with qsiter_next.
+ */
+bool qs_index_build(struct qs_index_t* idx, struct qsiter_t* qsi);
+
+/**
+ * Look up a key
+ *
+ * \param[in] idx the index
+ * \param[in] key key to find (does not need to be 0-terminated)
+ * \param[in] keylen key length
+ * \param[out] val start of the value, NULL if the key had no '='
+ * \param[out] vallen value length
+ * \return true if the key is present
+ */
+bool qs_index_get(const struct qs_index_t* idx, const char* key,
+                  size_t keylen, const char** val, size_t* vallen);
+
 #include "extern_c_end.h"
 
 #endif  /* MODP_QSITER */
@@ -0,0 +1,54 @@
+static const unsigned char gsQsCharClass[256] = {
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', 0x04, 0x01, '\0',
+'\0', '\0', '\0', 0x04, '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', 0x02, '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0', '\0',
+'\0', '\0', '\0', '\0', '\0', '\0'
+};
+
+static const uint32_t gsHexDecodeMap[256] = {
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+  0,   1,   2,   3,   4,   5,   6,   7,   8,   9, 256, 256,
+256, 256, 256, 256, 256,  10,  11,  12,  13,  14,  15, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256,  10,  11,  12,  13,  14,  15, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+256, 256, 256, 256
+};
+
@@ -0,0 +1,58 @@
+/* -*- mode: c; c-basic-offset: 4; indent-tabs-mode: nil; tab-width: 4 -*- */
+/* vi: set expandtab shiftwidth=4 tabstop=4: */
+
+#include "arraytoc.h"
+
+/*
+ * Char classes for the query string scanner, see modp_qsiter.c
+ *   1: '&' ends a pair
+ *   2: '=' ends a key
+ *   4: '%' or '+' needs decoding
+ */
+static void charclassmap(void)
+{
+    int i;
+    char map[256];
+    for (i = 0; i < 256; ++i) {
+        map[i] = 0;
+    }
+    map[(int)'&'] = 1;
+    map[(int)'='] = 2;
+    map[(int)'%'] = 4;
+    map[(int)'+'] = 4;
+
+    char_array_to_c(map, sizeof(map), "gsQsCharClass");
+}
+
+static void hexdecodemap(void)
+{
+    uint32_t i;
+    uint32_t map[256];
+    for (i = 0; i <= 255; ++i) {
+        map[i] = 256;
+    }
+
+    // digits
+    for (i = '0'; i <= '9'; ++i) {
+        map[i] = i - '0';
+    }
+
+    // upper
+    for (i = 'A'; i <= 'F'; ++i) {
+        map[i] = i - 'A' + 10;
+    }
+
+    // lower
+    for (i = 'a'; i <= 'f'; ++i) {
+        map[i] = i - 'a' + 10;
+    }
+
+    uint32_array_to_c(map, sizeof(map)/sizeof(uint32_t), "gsHexDecodeMap");
+}
+
+int main(void)
+{
+    charclassmap();
+    hexdecodemap();
+    return 0;
+}
@@ -345,3 +345,162 @@ size_t modp_xml_min_encode_strlen(const char* src, const size_t len)
     }
     return count;
 }
+
+/*
+ * Streaming decode.
+ *
+ * modp_xml_decode decides on an '&' by looking ahead to the next ';'.
+ * Streaming keeps the entity seen so far instead, and gives up as soon
+ * as the next char means it cannot decode (which is also what the
+ * one-shot version concludes once it reaches the ';').  What is held
+ * back never contains another '&' or a ';', so giving up only means
+ * writing it out as is.
+ *
+ * Named entities are at most "&quot", numeric ones keep at most 7
+ * significant digits before they overflow.  Leading zeros of numeric
+ * entities are only counted, which keeps the state small for any
+ * input.
+ */
+#define XML_STREAM_NAMED 0
+#define XML_STREAM_DEC 1
+#define XML_STREAM_HEX 2
+
+static const char* const gsXmlNames[] = {"quot", "apos", "amp", "lt", "gt"};
+static const char gsXmlNameChars[] = {'"', '\'', '&', '<', '>'};
+
+void modp_xml_decode_stream_init(struct modp_xml_stream_t* st)
+{
+    st->n = 0;
+}
+
+/* writes the held back text as is */
+static char* xml_stream_flush(struct modp_xml_stream_t* st, char* dest)
+{
+    const size_t prefix = (st->mode == XML_STREAM_NAMED) ? st->n :
+        (st->mode == XML_STREAM_DEC) ? 2 : 3;
+    memcpy(dest, st->buf, prefix);
+    dest += prefix;
+    memset(dest, '0', st->zeros);
+    dest += st->zeros;
+    memcpy(dest, st->buf + prefix, st->n - prefix);
+    dest += st->n - prefix;
+    st->n = 0;
+    return dest;
+}
+
+/*
+ * Feeds one char to a pending entity.  Returns 1 if it was taken, 0 if
+ * the entity cannot decode and c has to be handled as plain text.
+ */
+static int xml_stream_feed(struct modp_xml_stream_t* st, char** dest,
+                           uint8_t c)
+{
+    size_t i;
+    uint32_t d;
+
+    if (st->mode == XML_STREAM_NAMED) {
+        if (st->n == 1 && c == '#') {
+            st->buf[st->n++] = '#';
+            st->mode = XML_STREAM_DEC;
+            return 1;
+        }
+        /* st->buf + 1 holds a prefix of one of the names */
+        for (i = 0; i < sizeof(gsXmlNames) / sizeof(gsXmlNames[0]); ++i) {
+            const char* name = gsXmlNames[i];
+            const size_t namelen = strlen(name);
+            if (st->n - 1 > namelen ||
+                memcmp(st->buf + 1, name, st->n - 1) != 0) {
+                continue;
+            }
+            if (c == ';' && st->n - 1 == namelen) {
+                *(*dest)++ = gsXmlNameChars[i];
+                st->n = 0;
+                return 1;
+            }
+            if (st->n - 1 < namelen && name[st->n - 1] == (char) c) {
+                st->buf[st->n++] = (char) c;
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    if (st->mode == XML_STREAM_DEC && st->n == 2 && st->zeros == 0 &&
+        (c == 'x' || c == 'X')) {
+        st->buf[st->n++] = (char) c;
+        st->mode = XML_STREAM_HEX;
+        return 1;
+    }
+    if (c == ';') {
+        const uint32_t unichar = modp_xml_validate_unicode(st->val);
+        if (unichar == 0) {
+            return 0;
+        }
+        *dest += modp_xml_unicode_char_to_utf8(*dest, unichar);
+        st->n = 0;
+        return 1;
+    }
+    d = gsHexDecodeMap[c];
+    if (d > (st->mode == XML_STREAM_DEC ? 9u : 15u)) {
+        return 0;
+    }
+    st->val = st->val * (st->mode == XML_STREAM_DEC ? 10 : 16) + d;
+    if (st->val > 0x1000FF) {
+        return 0;
+    }
+    if (st->val == 0) {
+        st->zeros++;
+    } else {
+        st->buf[st->n++] = (char) c;
+    }
+    return 1;
+}
+
+size_t modp_xml_decode_stream(struct modp_xml_stream_t* st, char* dest,
+                              const char* s, size_t len)
+{
+    const uint8_t* src = (const uint8_t*) s;
+    const uint8_t* srcend = src + len;
+    char* p = dest;
+
+    while (src < srcend) {
+        if (st->n != 0) {
+            if (xml_stream_feed(st, &p, *src)) {
+                src++;
+            } else {
+                p = xml_stream_flush(st, p);
+            }
+            continue;
+        }
+        const uint8_t* amp = (const uint8_t*) memchr(src, '&',
+                                                     (size_t)(srcend - src));
+        if (amp == NULL) {
+            amp = srcend;
+        }
+        memcpy(p, src, (size_t)(amp - src));
+        p += amp - src;
+        src = amp;
+        if (src < srcend) {
+            st->buf[0] = '&';
+            st->n = 1;
+            st->mode = XML_STREAM_NAMED;
+            st->zeros = 0;
+            st->val = 0;
+            src++;
+        }
+    }
+
+    *p = '\0';
+    return (size_t)(p - dest);
+}
+
+size_t modp_xml_decode_stream_finish(struct modp_xml_stream_t* st,
+                                     char* dest)
+{
+    char* p = dest;
+    if (st->n != 0) {
+        p = xml_stream_flush(st, p);
+    }
+    *p = '\0';
+    return (size_t)(p - dest);
+}
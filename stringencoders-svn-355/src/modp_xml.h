@@ -119,6 +119,59 @@ size_t modp_xml_encode(char* dest, const char* str, size_t len);
 
 size_t modp_xml_min_encode_strlen(const char* str, size_t len);
 
+/**
+ * \brief State for XML decoding a string that arrives in pieces
+ *
+ * Holds back a partial entity between calls.
+ */
+struct modp_xml_stream_t {
+    char buf[12];
+    size_t n;
+    size_t zeros;
+    uint32_t val;
+    int mode;
+};
+
+/**
+ * \brief Start a new streaming decode
+ */
+void modp_xml_decode_stream_init(struct modp_xml_stream_t* st);
+
+/**
+ * \brief XML decode the next piece of a string
+ *
+ * The input may be split anywhere.  Concatenating the output of all
+ * calls and of modp_xml_decode_stream_finish gives the same string as
+ * modp_xml_decode on the whole input.
+ *
+ * \param[in,out] st state from modp_xml_decode_stream_init
+ * \param[out] dest at least modp_xml_decode_stream_len(st, len) bytes.
+ *   Must not overlap src.  The output is null terminated.
+ * \param[in] src the next len chars of input
+ * \param[in] len length of src
+ * \return the strlen of the output
+ */
+size_t modp_xml_decode_stream(struct modp_xml_stream_t* st, char* dest,
+                              const char* src, size_t len);
+
+/**
+ * \brief Write out a partial entity left at the end of the input
+ *
+ * \param[in,out] st state from modp_xml_decode_stream_init
+ * \param[out] dest at least modp_xml_decode_stream_len(st, 0) bytes
+ * \return the strlen of the output
+ */
+size_t modp_xml_decode_stream_finish(struct modp_xml_stream_t* st,
+                                     char* dest);
+
+/**
+ * \brief Output space for the next modp_xml_decode_stream call
+ *
+ * A held back entity is written out as is when it turns out not to
+ * decode, which includes any leading zeros it had.
+ */
+#define modp_xml_decode_stream_len(ST, A) ((A) + (ST)->n + (ST)->zeros + 1)
+
 END_C
 
 #ifdef __cplusplus
@@ -253,6 +253,40 @@ static char* testToLowerCopy(void)
     return 0;
 }
 
+/**
+ * long inputs run through the 16 and 32 byte blocks, check every
+ * length and alignment around them against the simple definition
+ */
+static char* testLongCopy(void)
+{
+    size_t i, len, off;
+    char buf1[300];
+    char upper[300];
+    char lower[300];
+    char output[300];
+    for (i = 0; i < sizeof(buf1); ++i) {
+        buf1[i] = (char)(i * 7 + 11);
+        upper[i] = (char)((buf1[i] >= 'a' && buf1[i] <= 'z') ?
+                          buf1[i] - 32 : buf1[i]);
+        lower[i] = (char)((buf1[i] >= 'A' && buf1[i] <= 'Z') ?
+                          buf1[i] + 32 : buf1[i]);
+    }
+    for (off = 0; off < 4; ++off) {
+        for (len = 0; len + off < 200; ++len) {
+            memset(output, 1, sizeof(output));
+            modp_toupper_copy(output, buf1 + off, len);
+            mu_assert(memcmp(upper + off, output, len) == 0);
+            mu_assert_int_equals(output[len], 0);
+
+            memset(output, 1, sizeof(output));
+            modp_tolower_copy(output, buf1 + off, len);
+            mu_assert(memcmp(lower + off, output, len) == 0);
+            mu_assert_int_equals(output[len], 0);
+        }
+    }
+    return 0;
+}
+
 static char* all_tests(void) {
     mu_run_test(testUpperHighBits);
     mu_run_test(testUpperSimple);
@@ -262,6 +296,7 @@ static char* all_tests(void) {
     mu_run_test(testToLowerCopy);
     mu_run_test(testToUpper);
     mu_run_test(testToLower);
+    mu_run_test(testLongCopy);
     return 0;
 }
 
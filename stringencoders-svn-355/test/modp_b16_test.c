@@ -263,11 +263,39 @@ static char* testValgrind(void) {
     return 0;
 }
 
+/**
+ * long inputs go through the 16 and 32 byte blocks, check every
+ * length and alignment around them
+ */
+static char* testLongEncode(void)
+{
+    static const char hex[] = "0123456789ABCDEF";
+    size_t i, len, off;
+    char buf[200];
+    char expected[400];
+    char output[410];
+    for (i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (char)(i * 37 + 5);
+        expected[2 * i] = hex[(uint8_t) buf[i] >> 4];
+        expected[2 * i + 1] = hex[(uint8_t) buf[i] & 0x0f];
+    }
+    for (off = 0; off < 4; ++off) {
+        for (len = 0; len + off < sizeof(buf); ++len) {
+            memset(output, 1, sizeof(output));
+            mu_assert(2 * len == modp_b16_encode(output, buf + off, len));
+            mu_assert(memcmp(expected + 2 * off, output, 2 * len) == 0);
+            mu_assert_int_equals(output[2 * len], 0);
+        }
+    }
+    return 0;
+}
+
 static char* all_tests(void)
 {
     mu_run_test(testEndian);
     mu_run_test(testEncodeDecode);
     mu_run_test(testLengths);
+    mu_run_test(testLongEncode);
     mu_run_test(testEmptyInput);
     mu_run_test(testBadDecode);
     mu_run_test(testOddDecode);
@@ -253,6 +253,119 @@ static char* testDecodeErrors(void)
     return 0;
 }
 
+/**
+ * Long inputs go through the SIMD kernels (when the CPU has them),
+ * short ones through the table code.  Check both give the same chars
+ * for every length and alignment, round trip, and that a bad char
+ * anywhere is caught.
+ */
+static char* testLong(void)
+{
+    char ibuf[300];
+    char obuf[modp_b64_encode_len(300) + 16];
+    char ebuf[modp_b64_encode_len(300)];
+    char rbuf[300 + 16];
+    char msg[100];
+    size_t i, j, len, d;
+
+    srand(0);
+    for (i = 0; i < sizeof(ibuf); ++i) {
+        ibuf[i] = (char)(rand() & 0xFF);
+    }
+
+    for (len = 0; len < 256; ++len) {
+        for (j = 0; j < 8; ++j) {
+            sprintf(msg, "len=%d, offset=%d", (int)len, (int)j);
+
+            /* expected: encode 3 bytes at a time */
+            for (i = 0; i < len; i += 3) {
+                modp_b64_encode(ebuf + i / 3 * 4, ibuf + j + i,
+                                 len - i < 3 ? len - i : 3);
+            }
+
+            d = modp_b64_encode(obuf + j, ibuf + j, len);
+            mu_assert_int_equals_msg(msg, (len + 2) / 3 * 4, d);
+            mu_assert_int_equals_msg(msg, 0, obuf[j + d]);
+            mu_assert_msg(msg, memcmp(obuf + j, ebuf, d) == 0);
+
+            memset(rbuf, 1, sizeof(rbuf));
+            d = modp_b64_decode(rbuf + j, obuf + j, d);
+            mu_assert_int_equals_msg(msg, len, d);
+            mu_assert_msg(msg, memcmp(rbuf + j, ibuf + j, len) == 0);
+            mu_assert_int_equals_msg(msg, 1, rbuf[j + len]);
+        }
+    }
+
+    /* a bad char in every position of a long string */
+    len = modp_b64_encode(obuf, ibuf, (size_t)240);
+    for (i = 0; i < len; ++i) {
+        const char saved = obuf[i];
+        sprintf(msg, "pos=%d", (int)i);
+        obuf[i] = '~';
+        d = modp_b64_decode(rbuf, obuf, len);
+        mu_assert_int_equals_msg(msg, (size_t)-1, d);
+        obuf[i] = (char)0xC1;
+        d = modp_b64_decode(rbuf, obuf, len);
+        mu_assert_int_equals_msg(msg, (size_t)-1, d);
+        obuf[i] = saved;
+    }
+    d = modp_b64_decode(rbuf, obuf, len);
+    mu_assert_int_equals(240, d);
+
+    return 0;
+}
+
+/**
+ * Streaming decode, with the input cut into three pieces at every
+ * possible place, must give what a one-shot decode gives.
+ */
+static char* testDecodeStream(void)
+{
+    const char* inputs[] = {
+        "", "A", "AA==", "AAA=", "AAAA", "AAAAAA==", "QUJDREVGR0hJSktMTU5PUA==",
+        "AA==AAAA", "AAA=AAAA", "AAAA=", "AAAAA===", "AAAA~AAA", "AAAAAAA"
+    };
+    char one[100];
+    char out[100];
+    char msg[100];
+    size_t i, a, b, len, d, o;
+    struct modp_b64_stream_t st;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const char* in = inputs[i];
+        len = strlen(in);
+        const size_t expected = modp_b64_decode(one, in, len);
+        for (a = 0; a <= len; ++a) {
+            for (b = a; b <= len; ++b) {
+                sprintf(msg, "%s, cuts %d %d", in, (int)a, (int)b);
+                modp_b64_decode_stream_init(&st);
+                o = 0;
+                d = modp_b64_decode_stream(&st, out, in, a);
+                if (d != (size_t)-1) {
+                    o += d;
+                    d = modp_b64_decode_stream(&st, out + o, in + a, b - a);
+                }
+                if (d != (size_t)-1) {
+                    o += d;
+                    d = modp_b64_decode_stream(&st, out + o, in + b, len - b);
+                }
+                if (d != (size_t)-1) {
+                    o += d;
+                    d = modp_b64_decode_stream_finish(&st, out + o);
+                }
+                if (expected == (size_t)-1) {
+                    mu_assert_int_equals_msg(msg, (size_t)-1, d);
+                } else {
+                    mu_assert_msg(msg, d != (size_t)-1);
+                    mu_assert_int_equals_msg(msg, expected, o + d);
+                    mu_assert_msg(msg, memcmp(one, out, expected) == 0);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
 static char* all_tests(void)
 {
     mu_run_test(testEndian);
@@ -260,6 +373,8 @@ static char* all_tests(void)
     mu_run_test(testPadding);
     mu_run_test(testEncodeDecode);
     mu_run_test(testDecodeErrors);
+    mu_run_test(testLong);
+    mu_run_test(testDecodeStream);
     return 0;
 }
 
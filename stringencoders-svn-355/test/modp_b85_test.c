@@ -115,6 +115,57 @@ static char* testEncodeDecode(void)
     return 0;
 }
 
+/**
+ * Streaming decode, with the input cut into three pieces at every
+ * possible place, must give what a one-shot decode gives.
+ */
+static char* testDecodeStream(void)
+{
+    const char* inputs[] = {
+        "", "0000", "00000", "%nSc0", "%nSc0%nSc0", "%nSc0%nSc", "%nSc0~nSc0",
+        "%nSc0%nSc0%nSc0"
+    };
+    char one[100];
+    char out[100];
+    char msg[100];
+    size_t i, a, b, len, d, o;
+    struct modp_b85_stream_t st;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const char* in = inputs[i];
+        len = strlen(in);
+        const size_t expected = modp_b85_decode(one, in, len);
+        for (a = 0; a <= len; ++a) {
+            for (b = a; b <= len; ++b) {
+                sprintf(msg, "%s, cuts %d %d", in, (int)a, (int)b);
+                modp_b85_decode_stream_init(&st);
+                o = 0;
+                d = modp_b85_decode_stream(&st, out, in, a);
+                if (d != (size_t)-1) {
+                    o += d;
+                    d = modp_b85_decode_stream(&st, out + o, in + a, b - a);
+                }
+                if (d != (size_t)-1) {
+                    o += d;
+                    d = modp_b85_decode_stream(&st, out + o, in + b, len - b);
+                }
+                if (d != (size_t)-1) {
+                    o += d;
+                    d = modp_b85_decode_stream_finish(&st);
+                }
+                if (expected == (size_t)-1) {
+                    mu_assert_int_equals_msg(msg, (size_t)-1, d);
+                } else {
+                    mu_assert_int_equals_msg(msg, 0, d);
+                    mu_assert_int_equals_msg(msg, expected, o);
+                    mu_assert_msg(msg, memcmp(one, out, expected) == 0);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
 static char* all_tests(void)
 {
     mu_run_test(testEndian);
@@ -122,6 +173,7 @@ static char* all_tests(void)
     mu_run_test(testBadInputLength);
     mu_run_test(testBadCharDecode);
     mu_run_test(testEncodeDecode);
+    mu_run_test(testDecodeStream);
     return 0;
 }
 
@@ -386,6 +386,92 @@ static char* testEncodeMinStrlen(void)
     return 0;
 }
 
+/**
+ * Streaming decode, with the input cut into three pieces at every
+ * possible place, must give what a one-shot decode gives.
+ */
+static char* testUrlDecodeStream(void)
+{
+    const char* inputs[] = {
+        "", "%", "%4", "%41", "a%41b", "%%41", "%%%", "%4%41", "%+", "%4+",
+        "+%2B+", "%zz%41%", "%4g%", "100%%200%", "%41%42%43"
+    };
+    char one[100];
+    char out[100];
+    char msg[100];
+    size_t i, a, b, len, o;
+    int raw;
+    struct modp_burl_stream_t st;
+
+    for (raw = 0; raw < 2; ++raw) {
+        for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+            const char* in = inputs[i];
+            len = strlen(in);
+            const size_t expected = raw ? modp_burl_decode_raw(one, in, len) :
+                modp_burl_decode(one, in, len);
+            for (a = 0; a <= len; ++a) {
+                for (b = a; b <= len; ++b) {
+                    sprintf(msg, "%s, raw %d, cuts %d %d", in, raw, (int)a, (int)b);
+                    if (raw) {
+                        modp_burl_decode_raw_stream_init(&st);
+                    } else {
+                        modp_burl_decode_stream_init(&st);
+                    }
+                    o = modp_burl_decode_stream(&st, out, in, a);
+                    o += modp_burl_decode_stream(&st, out + o, in + a, b - a);
+                    o += modp_burl_decode_stream(&st, out + o, in + b, len - b);
+                    o += modp_burl_decode_stream_finish(&st, out + o);
+                    mu_assert_int_equals_msg(msg, expected, o);
+                    mu_assert_str_equals_msg(msg, one, out);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * Mixes runs of safe chars, which the SIMD encoders copy a block at a
+ * time, with chars that need escaping, and compares against encoding
+ * one char at a time.
+ */
+static char* testUrlLong(void)
+{
+    static const char safe[] = "abcXYZ019 -._~!$*";
+    size_t i, len, off, n;
+    char buf[200];
+    char expected[610];
+    char output[610];
+    size_t elen;
+    for (i = 0; i < sizeof(buf); ++i) {
+        buf[i] = (i % 41 == 40) ? (char)(i + 100) : safe[i % (sizeof(safe) - 1)];
+    }
+    for (off = 0; off < 4; ++off) {
+        for (len = 0; len + off < sizeof(buf); ++len) {
+            elen = 0;
+            expected[0] = '\0';
+            for (i = 0; i < len; ++i) {
+                elen += modp_burl_encode(expected + elen, buf + off + i, (size_t)1);
+            }
+            memset(output, 1, sizeof(output));
+            n = modp_burl_encode(output, buf + off, len);
+            mu_assert_int_equals(elen, n);
+            mu_assert(memcmp(expected, output, n + 1) == 0);
+
+            elen = 0;
+            expected[0] = '\0';
+            for (i = 0; i < len; ++i) {
+                elen += modp_burl_min_encode(expected + elen, buf + off + i, (size_t)1);
+            }
+            memset(output, 1, sizeof(output));
+            n = modp_burl_min_encode(output, buf + off, len);
+            mu_assert_int_equals(elen, n);
+            mu_assert(memcmp(expected, output, n + 1) == 0);
+        }
+    }
+    return 0;
+}
+
 static char* all_tests(void)
 {
     mu_run_test(testUrlUntouched);
@@ -397,7 +483,9 @@ static char* all_tests(void)
     mu_run_test(testEncodeStrlen);
     mu_run_test(testUrlMinUntouched);
     mu_run_test(testUrlMinEncodeHex);
+    mu_run_test(testUrlLong);
     mu_run_test(testEncodeMinStrlen);
+    mu_run_test(testUrlDecodeStream);
     return 0;
 }
 
@@ -2,6 +2,7 @@
 /* vi: set expandtab shiftwidth=4 tabstop=4: */
 
 #include "modp_numtoa.h"
+#include <errno.h>
 #include <stdio.h>
 #include <limits.h>
 #include <stdlib.h>
@@ -507,6 +508,134 @@ static char* testRoundingPrecisionOverflow(void) {
     return 0;
 }
 
+static char* testDTOAShortest(void)
+{
+    char buf[64];
+    size_t i;
+    double d;
+    struct {
+        double value;
+        const char* expected;
+    } cases[] = {
+        {0.0, "0"},
+        {-0.0, "-0"},
+        {1.0, "1"},
+        {-1.5, "-1.5"},
+        {0.1, "0.1"},
+        {0.3, "0.3"},
+        {0.1 + 0.2, "0.30000000000000004"},
+        {1.0 / 3.0, "0.3333333333333333"},
+        {123456789.0, "123456789"},
+        {9007199254740992.0, "9007199254740992"},
+        {1e20, "100000000000000000000"},
+        {1e21, "1e+21"},
+        {1.5e21, "1.5e+21"},
+        {1e-6, "0.000001"},
+        {1.25e-6, "0.00000125"},
+        {1e-7, "1e-7"},
+        {1e23, "1e+23"},
+        {5e-324, "5e-324"},
+        {2.2250738585072014e-308, "2.2250738585072014e-308"},
+        {1.7976931348623157e308, "1.7976931348623157e+308"},
+        {-1.7976931348623157e308, "-1.7976931348623157e+308"},
+        {1e100, "1e+100"}
+    };
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        size_t len = modp_dtoa_shortest(cases[i].value, buf);
+        mu_assert_str_equals(cases[i].expected, buf);
+        mu_assert(len == strlen(buf));
+    }
+
+    d = 1e200 * 1e200;
+    modp_dtoa_shortest(d, buf);
+    mu_assert_str_equals("inf", buf);
+    modp_dtoa_shortest(-d, buf);
+    mu_assert_str_equals("-inf", buf);
+    d = d - d;
+    modp_dtoa_shortest(d, buf);
+    mu_assert_str_equals("nan", buf);
+
+    /* round trips through the libc parser, and through ours */
+    d = 1e-310;
+    for (i = 0; i < 2000; ++i) {
+        double back;
+        size_t len = modp_dtoa_shortest(d, buf);
+        mu_assert(strtod(buf, NULL) == d);
+        mu_assert(modp_strtod(buf, len, &back) == len);
+        mu_assert(back == d);
+        d = d * -1.4142135623730951 + 1e-300;
+        if (d > 1e300 || d < -1e300) {
+            d = 1e-310 * (double) i;
+        }
+    }
+    return 0;
+}
+
+static char* testStrtod(void)
+{
+    size_t i;
+    double d;
+    const char* cases[] = {
+        "0", "-0", "1", "+1.5", "0.1", ".5", "5.", "1e10", "1E-10",
+        "  \t42", "123456789012345678901234567890",
+        "0.000000000000000000000000000000000000000001",
+        "9007199254740993",
+        "2.2250738585072011e-308",
+        "2.4703282292062327e-324", "2.4703282292062328e-324",
+        "1.7976931348623158e308", "1.7976931348623159e308",
+        "1e400", "1e-400",
+        /* halfway between 1 and the next double, then just above it */
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203125000000001",
+        "inf", "-Infinity", "nan"
+    };
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        const size_t len = strlen(cases[i]);
+        char* end;
+        const double expected = strtod(cases[i], &end);
+        mu_assert(modp_strtod(cases[i], len, &d) == len);
+        mu_assert((size_t)(end - cases[i]) == len);
+        mu_assert(memcmp(&d, &expected, sizeof(d)) == 0 ||
+                  (d != d && expected != expected));
+    }
+
+    /* stops where strtod stops, and does not need a final null */
+    mu_assert(modp_strtod("12.5e", 5, &d) == 4);
+    mu_assert(d == 12.5);
+    mu_assert(modp_strtod("-7e+x", 5, &d) == 2);
+    mu_assert(d == -7.0);
+    mu_assert(modp_strtod("3.25", 3, &d) == 3);
+    mu_assert(d == 3.2);
+    mu_assert(modp_strtod("infinite", 8, &d) == 3);
+
+    /* ERANGE on overflow and on underflow to zero or a subnormal */
+    errno = 0;
+    mu_assert(modp_strtod("1e400", 5, &d) == 5);
+    mu_assert(errno == ERANGE);
+    errno = 0;
+    mu_assert(modp_strtod("-1e-400", 7, &d) == 7);
+    mu_assert(errno == ERANGE);
+    errno = 0;
+    mu_assert(modp_strtod("1e-310", 6, &d) == 6);
+    mu_assert(errno == ERANGE);
+    errno = 0;
+    mu_assert(modp_strtod("2.2250738585072011e-308", 23, &d) == 23);
+    mu_assert(errno == ERANGE);
+    errno = 0;
+    mu_assert(modp_strtod("2.2250738585072014e-308", 23, &d) == 23);
+    mu_assert(modp_strtod("0e-999", 6, &d) == 6);
+    mu_assert(modp_strtod("1.5", 3, &d) == 3);
+    mu_assert(errno == 0);
+
+    d = 99.0;
+    mu_assert(modp_strtod("", 0, &d) == 0);
+    mu_assert(modp_strtod("-", 1, &d) == 0);
+    mu_assert(modp_strtod(".", 1, &d) == 0);
+    mu_assert(modp_strtod("e5", 2, &d) == 0);
+    mu_assert(d == 99.0);
+    return 0;
+}
+
 static char* all_tests(void) {
     mu_run_test(testITOA);
     mu_run_test(testUITOA);
@@ -519,6 +648,8 @@ static char* all_tests(void) {
     mu_run_test(testDTOANonFinite);
     mu_run_test(testUITOA16);
     mu_run_test(testRoundingPrecisionOverflow);
+    mu_run_test(testDTOAShortest);
+    mu_run_test(testStrtod);
     return 0;
 }
 
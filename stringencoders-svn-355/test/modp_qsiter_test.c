@@ -5,6 +5,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "modp_qsiter.h"
+#include "modp_burl.h"
 #include "minunit.h"
 
 /**
@@ -264,6 +265,208 @@ static char* test_qs_parse9()
     return 0;
 }
 
+static char* test_qs_inplace1()
+{
+    struct qsiter_t qsi;
+
+    char s[] = "a%20b=c+d%3D&x=%zz&%26=%41%4&+";
+
+    qsiter_reset_inplace(&qsi, s, strlen(s));
+
+    bool ok = qsiter_next(&qsi);
+    mu_assert(ok);
+    mu_assert_int_equals(qsi.pos, 13);
+    mu_assert_int_equals(qsi.keylen, 3);
+    mu_assert_int_equals(qsi.vallen, 4);
+    mu_assert(!memcmp("a b", qsi.key, qsi.keylen));
+    mu_assert(!memcmp("c d=", qsi.val, qsi.vallen));
+
+    ok = qsiter_next(&qsi);
+    mu_assert(ok);
+    mu_assert_int_equals(qsi.keylen, 1);
+    mu_assert_int_equals(qsi.vallen, 3);
+    mu_assert(!memcmp("x", qsi.key, qsi.keylen));
+    mu_assert(!memcmp("%zz", qsi.val, qsi.vallen));
+
+    ok = qsiter_next(&qsi);
+    mu_assert(ok);
+    mu_assert_int_equals(qsi.keylen, 1);
+    mu_assert_int_equals(qsi.vallen, 3);
+    mu_assert(!memcmp("&", qsi.key, qsi.keylen));
+    mu_assert(!memcmp("A%4", qsi.val, qsi.vallen));
+
+    ok = qsiter_next(&qsi);
+    mu_assert(ok);
+    mu_assert_int_equals(qsi.keylen, 1);
+    mu_assert(qsi.val == NULL);
+    mu_assert(!memcmp(" ", qsi.key, qsi.keylen));
+
+    ok = qsiter_next(&qsi);
+    mu_assert(!ok);
+
+    /* nothing written past the end of the last value */
+    mu_assert_int_equals(s[sizeof(s) - 1], 0);
+
+    return 0;
+}
+
+/*
+ * Compare against a memchr splitter and modp_burl_decode on random
+ * strings made of the interesting chars, long enough to use the
+ * SIMD scanner.
+ */
+static char* test_qs_random()
+{
+    static const char chars[] = "&=%+a1Fz";
+    struct qsiter_t qsi;
+    char s[200];
+    char copy[200];
+    char expected[200];
+    const char* key;
+    const char* end;
+    const char* eq;
+    size_t i, len, n;
+    int trial;
+
+    srand(1);
+    for (trial = 0; trial < 20000; ++trial) {
+        len = (size_t)(rand() % (int) sizeof(s));
+        for (i = 0; i < len; ++i) {
+            s[i] = chars[rand() % (int)(sizeof(chars) - 1)];
+        }
+        memcpy(copy, s, len);
+
+        qsiter_reset_inplace(&qsi, s, len);
+        for (key = copy; key < copy + len; key = end + 1) {
+            end = (const char*) memchr(key, '&', (size_t)(copy + len - key));
+            if (end == NULL) {
+                end = copy + len;
+            }
+            eq = (const char*) memchr(key, '=', (size_t)(end - key));
+
+            mu_assert(qsiter_next(&qsi));
+            mu_assert(qsi.key == s + (key - copy));
+
+            n = modp_burl_decode(expected, key,
+                                 (size_t)((eq ? eq : end) - key));
+            mu_assert(qsi.keylen == n);
+            mu_assert(!memcmp(expected, qsi.key, n));
+
+            if (eq == NULL) {
+                mu_assert(qsi.val == NULL);
+            } else {
+                mu_assert(qsi.val == s + (eq + 1 - copy));
+                n = modp_burl_decode(expected, eq + 1, (size_t)(end - eq - 1));
+                mu_assert(qsi.vallen == n);
+                mu_assert(!memcmp(expected, qsi.val, n));
+            }
+        }
+        mu_assert(!qsiter_next(&qsi));
+    }
+    return 0;
+}
+
+static char* test_qs_index1()
+{
+    struct qsiter_t qsi;
+    struct qs_index_t idx;
+    const char* val;
+    size_t vallen;
+
+    const char* s = "foo=bar&&ding=bat&flag&foo=dup&=empty&z=";
+
+    qsiter_reset(&qsi, s, strlen(s));
+    mu_assert(qs_index_build(&idx, &qsi));
+    mu_assert_int_equals(idx.n, 5);
+
+    mu_assert(qs_index_get(&idx, "foo", 3, &val, &vallen));
+    mu_assert_int_equals(vallen, 3);
+    mu_assert(!memcmp("bar", val, vallen));
+
+    mu_assert(qs_index_get(&idx, "ding", 4, &val, &vallen));
+    mu_assert_int_equals(vallen, 3);
+    mu_assert(!memcmp("bat", val, vallen));
+
+    mu_assert(qs_index_get(&idx, "flag", 4, &val, &vallen));
+    mu_assert(val == NULL);
+    mu_assert_int_equals(vallen, 0);
+
+    mu_assert(qs_index_get(&idx, "", 0, &val, &vallen));
+    mu_assert(!memcmp("empty", val, vallen));
+
+    mu_assert(qs_index_get(&idx, "z", 1, &val, &vallen));
+    mu_assert(val != NULL);
+    mu_assert_int_equals(vallen, 0);
+
+    mu_assert(!qs_index_get(&idx, "fo", 2, &val, &vallen));
+    mu_assert(!qs_index_get(&idx, "bar", 3, &val, &vallen));
+    mu_assert(val == NULL);
+
+    return 0;
+}
+
+static char* test_qs_index2()
+{
+    struct qsiter_t qsi;
+    struct qs_index_t idx;
+    const char* val;
+    size_t vallen;
+    char s[1000];
+    char key[16];
+    size_t len = 0;
+    int i;
+
+    /* decoded keys: "k 0" .. "k 69", values "v0" .. "v69" */
+    for (i = 0; i < 70; ++i) {
+        len += (size_t) sprintf(s + len, "%sk+%d=v%%3%d", i ? "&" : "",
+                                i, i % 10);
+    }
+
+    qsiter_reset_inplace(&qsi, s, len);
+    mu_assert(!qs_index_build(&idx, &qsi));
+    mu_assert_int_equals(idx.n, QS_INDEX_MAX);
+
+    for (i = 0; i < QS_INDEX_MAX; ++i) {
+        sprintf(key, "k %d", i);
+        mu_assert(qs_index_get(&idx, key, strlen(key), &val, &vallen));
+        mu_assert_int_equals(vallen, 2);
+        mu_assert_int_equals(val[1], '0' + i % 10);
+    }
+    sprintf(key, "k %d", QS_INDEX_MAX);
+    mu_assert(!qs_index_get(&idx, key, strlen(key), &val, &vallen));
+
+    /* qsi holds the first pair left out, and goes on with the rest */
+    mu_assert_int_equals(qsi.keylen, strlen(key));
+    mu_assert(!memcmp(key, qsi.key, qsi.keylen));
+    mu_assert(qsiter_next(&qsi));
+    sprintf(key, "k %d", QS_INDEX_MAX + 1);
+    mu_assert_int_equals(qsi.keylen, strlen(key));
+    mu_assert(!memcmp(key, qsi.key, qsi.keylen));
+
+    return 0;
+}
+
+static char* test_qs_index3()
+{
+    struct qsiter_t qsi;
+    struct qs_index_t idx;
+    char s[1000];
+    size_t len = 0;
+    int i;
+
+    /* a full index, then only empty segments and repeated keys */
+    for (i = 0; i < QS_INDEX_MAX; ++i) {
+        len += (size_t) sprintf(s + len, "k%d=v&", i);
+    }
+    len += (size_t) sprintf(s + len, "&&k0=dup&k63&");
+
+    qsiter_reset(&qsi, s, len);
+    mu_assert(qs_index_build(&idx, &qsi));
+    mu_assert_int_equals(idx.n, QS_INDEX_MAX);
+
+    return 0;
+}
+
 static char* all_tests()
 {
     mu_run_test(test_qs_init);
@@ -276,6 +479,11 @@ static char* all_tests()
     mu_run_test(test_qs_parse7);
     mu_run_test(test_qs_parse8);
     mu_run_test(test_qs_parse9);
+    mu_run_test(test_qs_inplace1);
+    mu_run_test(test_qs_random);
+    mu_run_test(test_qs_index1);
+    mu_run_test(test_qs_index2);
+    mu_run_test(test_qs_index3);
     return 0;
 }
 
@@ -317,6 +317,45 @@ static char* testXmlDecodeHexEntities(void)
     return 0;
 }
 
+/**
+ * Streaming decode, with the input cut into three pieces at every
+ * possible place, must give what a one-shot decode gives.
+ */
+static char* testXmlDecodeStream(void)
+{
+    const char* inputs[] = {
+        "", "&", "&;", "&amp;", "&amp", "a&lt;b&gt;c", "&quot;&apos;",
+        "&quo;", "&ampx;", "&a&amp;", "&#65;", "&#x41;", "&#X41;",
+        "&#0000000000065;", "&#x0000000041;", "&#0x41;", "&#;", "&#x;",
+        "&#6a;", "&#99999999;", "&#x110000;", "&#1114111;", "&#0;",
+        "&#65&#66;", "&&amp;", "&#65", "&#x4"
+    };
+    char one[100];
+    char out[100];
+    char msg[100];
+    size_t i, a, b, len, o;
+    struct modp_xml_stream_t st;
+
+    for (i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const char* in = inputs[i];
+        len = strlen(in);
+        const size_t expected = modp_xml_decode(one, in, len);
+        for (a = 0; a <= len; ++a) {
+            for (b = a; b <= len; ++b) {
+                sprintf(msg, "%s, cuts %d %d", in, (int)a, (int)b);
+                modp_xml_decode_stream_init(&st);
+                o = modp_xml_decode_stream(&st, out, in, a);
+                o += modp_xml_decode_stream(&st, out + o, in + a, b - a);
+                o += modp_xml_decode_stream(&st, out + o, in + b, len - b);
+                o += modp_xml_decode_stream_finish(&st, out + o);
+                mu_assert_int_equals_msg(msg, expected, o);
+                mu_assert_str_equals_msg(msg, one, out);
+            }
+        }
+    }
+    return 0;
+}
+
 static char* all_tests(void)
 {
     mu_run_test(testXmlDecodeEmpty);
@@ -332,6 +371,7 @@ static char* all_tests(void)
     mu_run_test(testXmlUnicodeCharToUTF8);
     mu_run_test(testXmlDecodeDecimalEntities);
     mu_run_test(testXmlDecodeHexEntities);
+    mu_run_test(testXmlDecodeStream);
     return 0;
 }
 
@@ -0,0 +1,157 @@
+/* -*- mode: c; c-basic-offset: 4; indent-tabs-mode: nil; tab-width: 4 -*- */
+/* vi: set expandtab shiftwidth=4 tabstop=4: */
+
+/** \file speedtest_codecs.c
+ *
+ * http://code.google.com/p/stringencoders/
+ *
+ * Released under bsd license.  See modp_b64.c for details.
+ *
+ * Throughput of every encoder and decoder, in MB/s of unencoded data,
+ * for a few message sizes.  Each is run on "text" (letters, digits and
+ * spaces, which most encoders pass through) and on "binary" (all 256
+ * byte values).  Decoders are fed the output of the matching encoder.
+ * This does NOT test correctness.
+ */
+
+#include "modp_ascii.h"
+#include "modp_b2.h"
+#include "modp_b16.h"
+#include "modp_b64.h"
+#include "modp_b64w.h"
+#include "modp_b64r.h"
+#include "modp_b85.h"
+#include "modp_burl.h"
+#include "modp_bjavascript.h"
+#include "modp_xml.h"
+
+#include <time.h>
+#ifndef CLOCKS_PER_SEC
+# ifdef CLK_TCK
+#  define CLOCKS_PER_SEC (CLK_TCK)
+# endif
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef size_t (*codec_fn)(char* dest, const char* src, size_t len);
+
+static size_t toupper_copy(char* dest, const char* src, size_t len)
+{
+    modp_toupper_copy(dest, src, len);
+    return len;
+}
+
+static size_t tolower_copy(char* dest, const char* src, size_t len)
+{
+    modp_tolower_copy(dest, src, len);
+    return len;
+}
+
+static size_t toprint_copy(char* dest, const char* src, size_t len)
+{
+    modp_toprint_copy(dest, src, len);
+    return len;
+}
+
+struct codec_t {
+    const char* name;
+    codec_fn encode;
+    codec_fn decode; /* may be NULL */
+};
+
+static const struct codec_t codecs[] = {
+    { "toupper", toupper_copy, NULL },
+    { "tolower", tolower_copy, NULL },
+    { "toprint", toprint_copy, NULL },
+    { "b2", modp_b2_encode, modp_b2_decode },
+    { "b16", modp_b16_encode, modp_b16_decode },
+    { "b64", modp_b64_encode, modp_b64_decode },
+    { "b64w", modp_b64w_encode, modp_b64w_decode },
+    { "b64r", modp_b64r_encode, modp_b64r_decode },
+    { "b85", modp_b85_encode, modp_b85_decode },
+    { "burl", modp_burl_encode, modp_burl_decode },
+    { "burlmin", modp_burl_min_encode, modp_burl_decode },
+    { "js", modp_bjavascript_encode, NULL },
+    { "xml", modp_xml_encode, modp_xml_decode }
+};
+
+/* sizes must be multiples of 4 for b85 */
+static const size_t sizes[] = {20, 200, 2000, 20000};
+
+#define SZ 20000
+#define TOTAL (64 * 1024 * 1024)
+
+/**
+ * runs fn over TOTAL bytes of input in len sized calls, returns MB/s
+ */
+static double rate(codec_fn fn, char* dest, const char* src, size_t len,
+                   size_t inlen)
+{
+    size_t i;
+    const size_t reps = TOTAL / inlen + 1;
+    clock_t c0, c1;
+    double secs;
+
+    c0 = clock();
+    for (i = 0; i < reps; ++i) {
+        fn(dest, src, len);
+    }
+    c1 = clock();
+    secs = (double)(c1 - c0) * (1.0 / (double)CLOCKS_PER_SEC);
+    if (secs <= 0) {
+        return 0;
+    }
+    return (double)reps * (double)inlen / secs / (1024.0 * 1024.0);
+}
+
+int main(void)
+{
+    size_t i, j, k;
+    static char text[SZ];
+    static char binary[SZ];
+    /* xml and burl can grow 6x, b2 8x */
+    static char encoded[SZ * 8 + 1];
+    static char result[SZ * 8 + 1];
+    const char* inputs[2];
+    const char* names[] = {"text", "binary"};
+
+    for (i = 0; i < SZ; ++i) {
+        text[i] = (i % 9 == 8) ? ' ' : (char)("abcdefghijKLMNOP0123"[i % 20]);
+        binary[i] = (char)(rand() & 0xff);
+    }
+    inputs[0] = text;
+    inputs[1] = binary;
+
+    printf("MB/s of unencoded data\n");
+    printf("%-10s %-7s %-7s", "codec", "input", "op");
+    for (j = 0; j < sizeof(sizes) / sizeof(size_t); ++j) {
+        printf(" %9d", (int) sizes[j]);
+    }
+    printf("\n");
+
+    for (i = 0; i < sizeof(codecs) / sizeof(struct codec_t); ++i) {
+        for (k = 0; k < 2; ++k) {
+            printf("%-10s %-7s %-7s", codecs[i].name, names[k], "encode");
+            for (j = 0; j < sizeof(sizes) / sizeof(size_t); ++j) {
+                printf(" %9.0f", rate(codecs[i].encode, result, inputs[k],
+                                      sizes[j], sizes[j]));
+                fflush(stdout);
+            }
+            printf("\n");
+            if (codecs[i].decode == NULL) {
+                continue;
+            }
+            printf("%-10s %-7s %-7s", codecs[i].name, names[k], "decode");
+            for (j = 0; j < sizeof(sizes) / sizeof(size_t); ++j) {
+                size_t len = codecs[i].encode(encoded, inputs[k], sizes[j]);
+                printf(" %9.0f", rate(codecs[i].decode, result, encoded,
+                                      len, sizes[j]));
+                fflush(stdout);
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
@@ -3,6 +3,8 @@
 
 #include "modp_numtoa.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <stdint.h>
 
@@ -12,6 +14,8 @@ int main(void)
     uint32_t max = 1000000;
     clock_t t0,t1;
     double d, last;
+    double sum = 0;
+    size_t len;
     uint32_t i;
     uint8_t ju8;
     uint16_t ju16;
@@ -269,5 +273,55 @@ int main(void)
     printf("%.1fx\n", last/((double)(t1-t0)));
     fflush(stdout);
 
-    return 0;
+    /** SHORTEST ROUND-TRIP, AND BACK **/
+
+    printf("%s", "\n    type   \t%.17g\tshortest\timprovement\n");
+    printf("%s", "double\t\t");
+    t0 = clock();
+    for (i = 0; i < max; ++i) {
+        d = (double)i / 7.0;
+        snprintf(buf, sizeof(buf), "%.17g", d);
+    }
+    t1 = clock();
+    last = ((double)(t1-t0));
+    printf("%lu\t", ((t1-t0)));
+    fflush(stdout);
+
+    t0 = clock();
+    for (i = 0; i < max; ++i) {
+        d = (double)i / 7.0;
+        modp_dtoa_shortest(d, buf);
+    }
+    t1 = clock();
+    printf("%lu\t\t", ((t1-t0)));
+    printf("%.1fx\n", last/((double)(t1-t0)));
+    fflush(stdout);
+
+    printf("%s", "\n    type   \tstrtod\tmodp\timprovement\n");
+    printf("%s", "double\t\t");
+    modp_dtoa_shortest(1.0 / 7.0, buf);
+    len = strlen(buf);
+    t0 = clock();
+    for (i = 0; i < max; ++i) {
+        buf[3] = (char)('0' + i % 10);
+        sum += strtod(buf, NULL);
+    }
+    t1 = clock();
+    last = ((double)(t1-t0));
+    printf("%lu\t", ((t1-t0)));
+    fflush(stdout);
+
+    t0 = clock();
+    for (i = 0; i < max; ++i) {
+        buf[3] = (char)('0' + i % 10);
+        modp_strtod(buf, len, &d);
+        sum += d;
+    }
+    t1 = clock();
+    printf("%lu\t", ((t1-t0)));
+    printf("%.1fx\n", last/((double)(t1-t0)));
+    fflush(stdout);
+
+    /* keep the parse loops from being optimized away */
+    return sum == 0.5;
 }